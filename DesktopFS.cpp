@@ -11,9 +11,100 @@
 #include <ios>
 #include <iterator>
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
 namespace SVE
 {
 
+namespace
+{
+
+class MappedFileContent : public FileContent
+{
+public:
+    explicit MappedFileContent(const std::string& path)
+    {
+#ifdef _WIN32
+        _file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                            FILE_ATTRIBUTE_NORMAL, nullptr);
+        LARGE_INTEGER fileSize;
+        if (_file == INVALID_HANDLE_VALUE || !GetFileSizeEx(_file, &fileSize) || fileSize.QuadPart == 0)
+            return;
+
+        _mapping = CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!_mapping)
+            return;
+
+        _data = static_cast<const char*>(MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0));
+        if (_data)
+            _size = static_cast<size_t>(fileSize.QuadPart);
+#else
+        auto file = open(path.c_str(), O_RDONLY);
+        if (file < 0)
+            return;
+
+        struct stat fileStat {};
+        if (fstat(file, &fileStat) == 0 && fileStat.st_size > 0)
+        {
+            auto* data = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+            if (data != MAP_FAILED)
+            {
+                _data = static_cast<const char*>(data);
+                _size = static_cast<size_t>(fileStat.st_size);
+            }
+        }
+        close(file);
+#endif
+    }
+
+    ~MappedFileContent() override
+    {
+#ifdef _WIN32
+        if (_data)
+            UnmapViewOfFile(_data);
+        if (_mapping)
+            CloseHandle(_mapping);
+        if (_file != INVALID_HANDLE_VALUE)
+            CloseHandle(_file);
+#else
+        if (_data)
+            munmap(const_cast<char*>(_data), _size);
+#endif
+    }
+
+    const char* getData() const override
+    {
+        return _data;
+    }
+
+    size_t getSize() const override
+    {
+        return _size;
+    }
+
+    bool isMapped() const
+    {
+        return _data != nullptr;
+    }
+
+private:
+    const char* _data = nullptr;
+    size_t _size = 0;
+#ifdef _WIN32
+    HANDLE _file = INVALID_HANDLE_VALUE;
+    HANDLE _mapping = nullptr;
+#endif
+};
+
+} // anon namespace
+
 DesktopFSEntity::DesktopFSEntity(cppfs::FileHandle handle)
     : Handle(std::move(handle))
 {
@@ -75,6 +166,15 @@ std::string DesktopFS::getFileContent(std::shared_ptr<FileSystemEntity> file) co
     return s;
 }
 
+FileContentPtr DesktopFS::mapFileContent(std::shared_ptr<FileSystemEntity> file) const
+{
+    auto content = std::make_shared<MappedFileContent>(file->getPath());
+    if (!content->isMapped())
+        return FileSystem::mapFileContent(file);
+
+    return content;
+}
+
 std::shared_ptr<FileSystemEntity> DesktopFS::getEntity(const std::string& localPath, bool /*isDirectory*/) const
 {
     return std::make_shared<DesktopFSEntity>(cppfs::fs::open(localPath));
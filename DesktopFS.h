@@ -29,6 +29,7 @@ public:
     FSEntityPtr getContainingDirectory(FSEntityPtr file) const override;
     FSEntityList getFileList(FSEntityPtr dir) const override;
     std::string getFileContent(FSEntityPtr file) const override;
+    FileContentPtr mapFileContent(FSEntityPtr file) const override;
     FSEntityPtr getEntity(const std::string& localPath, bool isDirectory = false) const override;
     std::string getSavePath() const override;
 };
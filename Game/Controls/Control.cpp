@@ -403,7 +403,8 @@ std::string Control::createMaterial(const std::string& textureFile)
         SVE::MaterialSettings materialSettings{};
         materialSettings.name = name;
         materialSettings.vertexShaderName = "overlayVertexShader";
-        materialSettings.fragmentShaderName = _useColor ? "overlayColorFragmentShader" : "overlayFragmentShader";
+        // control materials differ only in texture, with texture table they share one pipeline
+        materialSettings.fragmentShaderName = _useColor ? "overlayColorFragmentShader" : "overlayBindlessFragmentShader";
         materialSettings.cullFace = SVE::MaterialCullFace::FrontFace;
         materialSettings.useAlphaBlending = true;
         materialSettings.srcBlendFactor = SVE::BlendFactor::SrcAlpha;
@@ -29,8 +29,14 @@ public:
         _renderLast = true;
     }
 
+    ~CustomEntity() override
+    {
+        _material->getVulkanMaterial()->deleteInstancesForEntity(this);
+    }
+
     void setMaterial(const std::string& materialName) override
     {
+        _material->getVulkanMaterial()->deleteInstancesForEntity(this);
         _material = SVE::Engine::getInstance()->getMaterialManager()->getMaterial(materialName);
         _materialIndex = _material->getVulkanMaterial()->getInstanceForEntity(this);
     }
@@ -45,9 +51,9 @@ public:
         return _currentInfo;
     }
 
-    void updateUniforms(SVE::UniformDataList uniformDataList) const override
+    void updateUniforms(const SVE::UniformDataList& uniformDataList) const override
     {
-        auto mainUniform = uniformDataList[toInt(SVE::CommandsType::MainPass)];
+        const auto& mainUniform = uniformDataList[toInt(SVE::CommandsType::MainPass)];
         mainUniform->customMat4 = _currentInfo.toMat4();
         mainUniform->spritesheetSize = _material->getVulkanMaterial()->getSpritesheetSize();
         mainUniform->materialInfo.diffuse = glm::vec4(1);
@@ -55,6 +61,13 @@ public:
         _material->getVulkanMaterial()->setUniformData(_materialIndex, *mainUniform);
     }
 
+    SVE::PassMask getPassMask() const override
+    {
+        return SVE::toPassMask(SVE::CommandsType::MainPass)
+               | SVE::toPassMask(SVE::CommandsType::ScreenQuadPass)
+               | SVE::toPassMask(SVE::CommandsType::ScreenQuadLatePass);
+    }
+
     void applyDrawingCommands(uint32_t bufferIndex, uint32_t imageIndex) const override
     {
         auto passType = SVE::Engine::getInstance()->getPassType();
@@ -17,6 +17,11 @@ FireLineEntity::FireLineEntity(const std::string& material, FireLineInfo startIn
     _materialIndex = _material->getVulkanMaterial()->getInstanceForEntity(this);
 }
 
+FireLineEntity::~FireLineEntity()
+{
+    _material->getVulkanMaterial()->deleteInstancesForEntity(this);
+}
+
 void FireLineEntity::updateInfo(FireLineInfo info)
 {
     _currentInfo = info;
@@ -27,6 +32,13 @@ FireLineInfo& FireLineEntity::getInfo()
     return _currentInfo;
 }
 
+SVE::PassMask FireLineEntity::getPassMask() const
+{
+    return SVE::toPassMask(SVE::CommandsType::MainPass)
+           | SVE::toPassMask(SVE::CommandsType::ScreenQuadPass)
+           | SVE::toPassMask(SVE::CommandsType::ScreenQuadLatePass);
+}
+
 void FireLineEntity::applyDrawingCommands(uint32_t bufferIndex, uint32_t imageIndex) const
 {
     auto passType = SVE::Engine::getInstance()->getPassType();
@@ -40,9 +52,9 @@ void FireLineEntity::applyDrawingCommands(uint32_t bufferIndex, uint32_t imageIn
     }
 }
 
-void FireLineEntity::updateUniforms(SVE::UniformDataList uniformDataList) const
+void FireLineEntity::updateUniforms(const SVE::UniformDataList& uniformDataList) const
 {
-    auto mainUniform = uniformDataList[toInt(SVE::CommandsType::MainPass)];
+    const auto& mainUniform = uniformDataList[toInt(SVE::CommandsType::MainPass)];
     mainUniform->customMat4 = glm::mat4(
             glm::vec4(_currentInfo.startPos, 1),
             glm::vec4(_currentInfo.direction, 1),
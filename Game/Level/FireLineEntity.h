@@ -26,11 +26,13 @@ class FireLineEntity : public SVE::Entity
 {
 public:
     FireLineEntity(const std::string& material, FireLineInfo startInfo);
+    ~FireLineEntity() override;
 
     void updateInfo(FireLineInfo info);
     FireLineInfo& getInfo();
-    void updateUniforms(SVE::UniformDataList uniformDataList) const override;
+    void updateUniforms(const SVE::UniformDataList& uniformDataList) const override;
     void applyDrawingCommands(uint32_t bufferIndex, uint32_t imageIndex) const override;
+    SVE::PassMask getPassMask() const override;
 
 private:
     SVE::Material* _material = nullptr;
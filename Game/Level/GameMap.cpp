@@ -38,6 +38,7 @@ GameMapProcessor::~GameMapProcessor()
 {
     SVE::Engine::getInstance()->getSceneManager()->getRootNode()->detachSceneNode(_gameMap->mapNode);
     _gameMap.reset();
+    SVE::Engine::getInstance()->releaseFreeResources();
 }
 
 void GameMapProcessor::update(float deltaTime)
@@ -29,6 +29,9 @@ namespace Chewman
 namespace
 {
 
+// enemies with different animation times share poses on low effects
+const uint32_t LowEffectsAnimationPhases = 16;
+
 glm::quat rotationBetweenVectors(glm::vec3 start, glm::vec3 dest)
 {
     start = normalize(start);
@@ -138,6 +141,12 @@ std::shared_ptr<GameMap> GameMapLoader::loadMap(const std::string& filename, con
     if (_callback)
         _callback(0);
 
+    auto* engine = SVE::Engine::getInstance();
+    engine->setAnimationPhaseBuckets(
+            Game::getInstance()->getGraphicsManager().getSettings().effectSettings == EffectSettings::Low
+            ? LowEffectsAnimationPhases
+            : engine->getEngineSettings().animationPhaseBuckets);
+
     std::stringstream fin(SVE::Engine::getInstance()->getResourceManager()->loadFileContent(filename));
     fin >> gameMap->width >> gameMap->height;
 
@@ -0,0 +1,14 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include <cstdint>
+
+namespace SVE
+{
+
+// Global heap allocations count since start.
+// Allocations are counted only if engine is built with SVE_COUNT_ALLOCATIONS, otherwise it's always 0.
+uint64_t getAllocationCount();
+
+} // namespace SVE
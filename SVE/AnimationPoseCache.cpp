@@ -0,0 +1,83 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+
+#include "AnimationPoseCache.h"
+#include <algorithm>
+#include <cmath>
+
+namespace SVE
+{
+
+namespace
+{
+
+// Lookup is linear, entities with times not matching others evaluate own poses when cache is full
+const uint32_t MaxCachedPoses = 64;
+
+} // anon namespace
+
+AnimationPoseCache::AnimationPoseCache(const SkeletalAnimation& skeletalAnimation)
+    : _skeletalAnimation(skeletalAnimation)
+{
+    // poses are never reallocated, so returned bones stay valid during the frame
+    _poses.reserve(MaxCachedPoses);
+}
+
+float AnimationPoseCache::getClipTime(uint32_t clip, float time, float timeStep, uint32_t phaseBuckets) const
+{
+    auto clipTime = _skeletalAnimation.getClipTime(clip, time);
+    auto clipTimeStep = timeStep * _skeletalAnimation.getAnimationSpeed();
+    if (phaseBuckets > 0)
+        clipTimeStep = std::max(clipTimeStep, _skeletalAnimation.getClipDuration(clip) / phaseBuckets);
+    if (clipTimeStep > 0.0f)
+        clipTime = std::floor(clipTime / clipTimeStep) * clipTimeStep;
+
+    return clipTime;
+}
+
+uint32_t AnimationPoseCache::addPose(uint32_t clip, float clipTime, uint64_t frameId, bool& isAdded)
+{
+    if (_frameId != frameId)
+    {
+        _frameId = frameId;
+        _usedPoses = 0;
+    }
+
+    isAdded = false;
+    for (auto i = 0u; i < _usedPoses; i++)
+    {
+        if (_poses[i].clip == clip && _poses[i].clipTime == clipTime)
+            return i;
+    }
+
+    if (_usedPoses == MaxCachedPoses)
+        return AnimationPose::NoCachedPose;
+
+    if (_usedPoses == _poses.size())
+        _poses.emplace_back();
+    auto& pose = _poses[_usedPoses];
+    pose.clip = clip;
+    pose.clipTime = clipTime;
+    isAdded = true;
+    return _usedPoses++;
+}
+
+void AnimationPoseCache::evaluatePose(uint32_t pose)
+{
+    auto& cachedPose = _poses[pose];
+    _skeletalAnimation.evaluatePose(cachedPose.clip, cachedPose.clipTime, cachedPose.instance, cachedPose.bones);
+}
+
+const std::vector<glm::mat4>& AnimationPoseCache::getBones(uint32_t pose) const
+{
+    return _poses[pose].bones;
+}
+
+void AnimationPoseCache::updateAttachments(uint32_t pose, BonesAttachments& bonesAttachments) const
+{
+    if (!bonesAttachments.empty())
+        _skeletalAnimation.updateAttachments(_poses[pose].instance, bonesAttachments);
+}
+
+} // namespace SVE
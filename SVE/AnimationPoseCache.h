@@ -0,0 +1,56 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include "SkeletalAnimation.h"
+
+namespace SVE
+{
+
+// Pose of skeletal entity selected in current frame's animation phase
+struct AnimationPose
+{
+    static const uint32_t NoCachedPose = UINT32_MAX;
+
+    uint64_t frameId = 0;
+    uint32_t clip = 0;
+    float clipTime = 0;
+    // pose shared with other entities, or NoCachedPose if entity evaluates own bones
+    uint32_t cachedPose = NoCachedPose;
+};
+
+// Poses of skeletal mesh evaluated in current frame. Entities playing the same clip at the same quantized
+// time share single evaluation and bone palette.
+class AnimationPoseCache
+{
+public:
+    explicit AnimationPoseCache(const SkeletalAnimation& skeletalAnimation);
+
+    // Clip time snapped to time step (seconds) and to phase buckets per clip duration (0 - not used)
+    float getClipTime(uint32_t clip, float time, float timeStep, uint32_t phaseBuckets) const;
+
+    // Finds pose with this clip time in current frame or adds new one (isAdded is set, pose should be evaluated),
+    // returns NoCachedPose if cache is full
+    uint32_t addPose(uint32_t clip, float clipTime, uint64_t frameId, bool& isAdded);
+    // Different poses can be evaluated in parallel
+    void evaluatePose(uint32_t pose);
+    const std::vector<glm::mat4>& getBones(uint32_t pose) const;
+    void updateAttachments(uint32_t pose, BonesAttachments& bonesAttachments) const;
+
+private:
+    struct Pose
+    {
+        uint32_t clip = 0;
+        float clipTime = 0;
+        AnimationInstance instance;
+        std::vector<glm::mat4> bones;
+    };
+
+    const SkeletalAnimation& _skeletalAnimation;
+    // poses are kept between frames, so their memory and key cursors are reused
+    std::vector<Pose> _poses;
+    uint32_t _usedPoses = 0;
+    uint64_t _frameId = 0;
+};
+
+} // namespace SVE
@@ -0,0 +1,82 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+
+#include "AnimationUpdater.h"
+#include "ThreadPool.h"
+#include <algorithm>
+
+namespace SVE
+{
+
+namespace
+{
+
+// Evaluations are split to several jobs per thread, so threads finish at about the same time
+const uint32_t MinJobsPerThread = 4;
+
+} // anon namespace
+
+AnimationUpdater::AnimationUpdater(uint32_t threadCount)
+    : _threadPool(std::make_unique<ThreadPool>(threadCount))
+{
+}
+
+AnimationUpdater::~AnimationUpdater() = default;
+
+uint32_t AnimationUpdater::getThreadCount() const
+{
+    return _threadPool->getThreadCount();
+}
+
+void AnimationUpdater::begin()
+{
+    _evaluations.clear();
+}
+
+void AnimationUpdater::addEvaluation(AnimationPoseCache* poseCache, uint32_t pose)
+{
+    _evaluations.push_back({ poseCache, pose, nullptr, 0, 0.0f, nullptr, nullptr });
+}
+
+void AnimationUpdater::addEvaluation(const SkeletalAnimation* skeletalAnimation,
+                                     uint32_t clip,
+                                     float clipTime,
+                                     AnimationInstance* instance,
+                                     std::vector<glm::mat4>* bones)
+{
+    _evaluations.push_back({ nullptr, 0, skeletalAnimation, clip, clipTime, instance, bones });
+}
+
+uint32_t AnimationUpdater::update()
+{
+    auto evaluationCount = static_cast<uint32_t>(_evaluations.size());
+    auto threadCount = getThreadCount();
+    if (threadCount == 1 || evaluationCount < 2)
+    {
+        for (const auto& evaluation : _evaluations)
+            evaluate(evaluation);
+        return evaluationCount;
+    }
+
+    auto jobSize = std::max(1u, evaluationCount / (threadCount * MinJobsPerThread));
+    auto jobCount = (evaluationCount + jobSize - 1) / jobSize;
+    _threadPool->run(jobCount, [this, jobSize, evaluationCount](uint32_t jobIndex, uint32_t /*threadIndex*/)
+    {
+        auto last = std::min(evaluationCount, (jobIndex + 1) * jobSize);
+        for (auto i = jobIndex * jobSize; i < last; i++)
+            evaluate(_evaluations[i]);
+    });
+
+    return evaluationCount;
+}
+
+void AnimationUpdater::evaluate(const Evaluation& evaluation) const
+{
+    if (evaluation.poseCache)
+        evaluation.poseCache->evaluatePose(evaluation.pose);
+    else
+        evaluation.skeletalAnimation->evaluatePose(evaluation.clip, evaluation.clipTime, *evaluation.instance, *evaluation.bones);
+}
+
+} // namespace SVE
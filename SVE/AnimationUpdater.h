@@ -0,0 +1,53 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include "AnimationPoseCache.h"
+#include <memory>
+
+namespace SVE
+{
+class ThreadPool;
+
+// Skeletal animation frame phase. Evaluations are added on calling thread in scene order (so pose sharing
+// doesn't depend on threads), then processed on thread pool. Every pose and entity palette is written by
+// a single evaluation and read only after the phase, so results match single-threaded update exactly.
+class AnimationUpdater
+{
+public:
+    explicit AnimationUpdater(uint32_t threadCount);
+    ~AnimationUpdater();
+
+    uint32_t getThreadCount() const;
+
+    void begin();
+    void addEvaluation(AnimationPoseCache* poseCache, uint32_t pose);
+    void addEvaluation(const SkeletalAnimation* skeletalAnimation,
+                       uint32_t clip,
+                       float clipTime,
+                       AnimationInstance* instance,
+                       std::vector<glm::mat4>* bones);
+    // Processes evaluations added since begin, returns their count
+    uint32_t update();
+
+private:
+    struct Evaluation
+    {
+        AnimationPoseCache* poseCache;
+        uint32_t pose;
+        const SkeletalAnimation* skeletalAnimation;
+        uint32_t clip;
+        float clipTime;
+        AnimationInstance* instance;
+        std::vector<glm::mat4>* bones;
+    };
+
+    void evaluate(const Evaluation& evaluation) const;
+
+private:
+    std::unique_ptr<ThreadPool> _threadPool;
+    // kept between frames, so adding evaluations doesn't allocate
+    std::vector<Evaluation> _evaluations;
+};
+
+} // namespace SVE
@@ -0,0 +1,148 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#include "CommandsRecorder.h"
+#include "ThreadPool.h"
+#include "Entity.h"
+#include "FrameStats.h"
+#include "Utils.h"
+#include "VulkanPassUniforms.h"
+#include <algorithm>
+
+namespace SVE
+{
+
+namespace
+{
+// entities per secondary command buffer
+const uint32_t RecordChunkSize = 64;
+} // anon namespace
+
+CommandsRecorder::CommandsRecorder(uint32_t threadCount)
+    : _threadPool(std::make_unique<ThreadPool>(threadCount))
+{
+}
+
+CommandsRecorder::~CommandsRecorder() = default;
+
+uint32_t CommandsRecorder::getThreadCount() const
+{
+    return _threadPool->getThreadCount();
+}
+
+bool CommandsRecorder::isParallel() const
+{
+    return getThreadCount() > 1;
+}
+
+VkSubpassContents CommandsRecorder::getSubpassContents() const
+{
+    return isParallel() ? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS : VK_SUBPASS_CONTENTS_INLINE;
+}
+
+void CommandsRecorder::begin(uint32_t imageIndex)
+{
+    _imageIndex = imageIndex;
+    _passList.clear();
+    _jobList.clear();
+}
+
+void CommandsRecorder::addPass(CommandsType passType,
+                               BufferIndex bufferIndex,
+                               const RenderPassRecordInfo& recordInfo,
+                               PassStage firstStage,
+                               PassStage lastStage,
+                               const Entity* firstEntity,
+                               std::function<void()> endPass)
+{
+    auto* engine = Engine::getInstance();
+    auto* renderList = engine->getRenderList();
+
+    if (!isParallel())
+    {
+        engine->setPassType(passType);
+        auto* vulkanInstance = engine->getVulkanInstance();
+        vulkanInstance->getPassUniforms()->bind(vulkanInstance->getCommandBuffer(bufferIndex), passType, _imageIndex);
+        if (firstEntity)
+            firstEntity->applyDrawingCommands(bufferIndex, _imageIndex);
+        for (auto stage = toInt(firstStage); stage <= toInt(lastStage); stage++)
+            renderList->applyDrawingCommands(passType, static_cast<PassStage>(stage), bufferIndex, _imageIndex);
+        endPass();
+        return;
+    }
+
+    PassRecord passRecord { passType, bufferIndex, recordInfo, firstEntity, std::move(endPass) };
+    passRecord.firstJob = static_cast<uint32_t>(_jobList.size());
+    auto passIndex = static_cast<uint32_t>(_passList.size());
+
+    if (firstEntity)
+        _jobList.push_back({ passIndex, firstStage, 0, 0, true, VK_NULL_HANDLE });
+
+    for (auto stage = toInt(firstStage); stage <= toInt(lastStage); stage++)
+    {
+        auto count = static_cast<uint32_t>(renderList->getDrawCount(passType, static_cast<PassStage>(stage)));
+        engine->getCurrentFrameStats().drawCount[toInt(passType)] += count;
+        for (auto first = 0u; first < count; first += RecordChunkSize)
+        {
+            _jobList.push_back({ passIndex, static_cast<PassStage>(stage), first,
+                                 std::min(RecordChunkSize, count - first), false, VK_NULL_HANDLE });
+        }
+    }
+
+    passRecord.jobCount = static_cast<uint32_t>(_jobList.size()) - passRecord.firstJob;
+    _passList.push_back(std::move(passRecord));
+}
+
+void CommandsRecorder::record(const std::function<void()>& mainThreadCommands)
+{
+    if (!isParallel())
+    {
+        if (mainThreadCommands)
+            mainThreadCommands();
+        return;
+    }
+
+    _threadPool->start(static_cast<uint32_t>(_jobList.size()), [this](uint32_t jobIndex, uint32_t threadIndex)
+    {
+        recordJob(jobIndex, threadIndex);
+    });
+    if (mainThreadCommands)
+        mainThreadCommands();
+    _threadPool->wait();
+
+    auto* vulkanInstance = Engine::getInstance()->getVulkanInstance();
+    for (auto& passRecord : _passList)
+    {
+        if (passRecord.jobCount > 0)
+        {
+            _executeList.clear();
+            for (auto i = passRecord.firstJob; i < passRecord.firstJob + passRecord.jobCount; i++)
+                _executeList.push_back(_jobList[i].commandBuffer);
+
+            vkCmdExecuteCommands(vulkanInstance->getCommandBuffer(passRecord.bufferIndex),
+                                 static_cast<uint32_t>(_executeList.size()),
+                                 _executeList.data());
+        }
+        passRecord.endPass();
+    }
+}
+
+void CommandsRecorder::recordJob(uint32_t jobIndex, uint32_t threadIndex)
+{
+    auto& job = _jobList[jobIndex];
+    const auto& passRecord = _passList[job.passIndex];
+    auto* engine = Engine::getInstance();
+    auto* vulkanInstance = engine->getVulkanInstance();
+
+    engine->setPassType(passRecord.passType);
+    job.commandBuffer = vulkanInstance->beginSecondaryCommandBuffer(passRecord.bufferIndex, passRecord.recordInfo, threadIndex);
+    vulkanInstance->getPassUniforms()->bind(job.commandBuffer, passRecord.passType, _imageIndex);
+    if (job.drawFirstEntity)
+        passRecord.firstEntity->applyDrawingCommands(passRecord.bufferIndex, _imageIndex);
+    else
+        engine->getRenderList()->applyDrawingCommands(
+                passRecord.passType, job.stage, job.first, job.count, passRecord.bufferIndex, _imageIndex);
+    vulkanInstance->endSecondaryCommandBuffer(job.commandBuffer);
+}
+
+} // namespace SVE
@@ -0,0 +1,76 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include <memory>
+#include <vector>
+#include <functional>
+#include "VulkanInstance.h"
+#include "RenderList.h"
+
+namespace SVE
+{
+class Entity;
+class ThreadPool;
+
+// Records render list passes to command buffers.
+// With several threads, pass entities are split to chunks, which are recorded to secondary command buffers
+// on the thread pool and then executed from pass primary buffer in the original order.
+// With single thread, passes are recorded to primary buffers right away.
+class CommandsRecorder
+{
+public:
+    explicit CommandsRecorder(uint32_t threadCount);
+    ~CommandsRecorder();
+
+    uint32_t getThreadCount() const;
+    bool isParallel() const;
+    // Contents, which should be used to begin render passes of added passes
+    VkSubpassContents getSubpassContents() const;
+
+    void begin(uint32_t imageIndex);
+    // Pass primary buffer should be started already, endPass is called after all pass commands are recorded.
+    // First entity (skybox) is drawn before render list stages.
+    void addPass(CommandsType passType,
+                 BufferIndex bufferIndex,
+                 const RenderPassRecordInfo& recordInfo,
+                 PassStage firstStage,
+                 PassStage lastStage,
+                 const Entity* firstEntity,
+                 std::function<void()> endPass);
+    // Records added passes, mainThreadCommands are recorded by calling thread in the meantime
+    void record(const std::function<void()>& mainThreadCommands);
+
+private:
+    struct PassRecord
+    {
+        CommandsType passType;
+        BufferIndex bufferIndex;
+        RenderPassRecordInfo recordInfo;
+        const Entity* firstEntity;
+        std::function<void()> endPass;
+        uint32_t firstJob;
+        uint32_t jobCount;
+    };
+
+    struct RecordJob
+    {
+        uint32_t passIndex;
+        PassStage stage;
+        uint32_t first;
+        uint32_t count;
+        bool drawFirstEntity;
+        VkCommandBuffer commandBuffer;
+    };
+
+    void recordJob(uint32_t jobIndex, uint32_t threadIndex);
+
+private:
+    std::unique_ptr<ThreadPool> _threadPool;
+    uint32_t _imageIndex = 0;
+    std::vector<PassRecord> _passList;
+    std::vector<RecordJob> _jobList;
+    std::vector<VkCommandBuffer> _executeList;
+};
+
+} // namespace SVE
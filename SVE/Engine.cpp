@@ -9,9 +9,16 @@
 #include "VulkanScreenQuad.h"
 #include "VulkanException.h"
 #include "VulkanMaterial.h"
+#include "VulkanPassUniforms.h"
+#include "VulkanDescriptorPoolSet.h"
+#include "VulkanInstanceCulling.h"
+#include "VulkanUploadManager.h"
+#include "VulkanGeometryArena.h"
 #include "MaterialManager.h"
 #include "SceneManager.h"
 #include "ShaderManager.h"
+#include "ShaderInfo.h"
+#include "VulkanShaderInfo.h"
 #include "MeshManager.h"
 #include "LightManager.h"
 #include "ParticleSystemManager.h"
@@ -26,8 +33,20 @@
 #include "Water.h"
 #include "Utils.h"
 #include "ComputeEntity.h"
+#include "RenderList.h"
+#include "RenderGraph.h"
+#include "FrameStats.h"
+#include "FrameBenchmark.h"
+#include "Frustum.h"
+#include "ShaderSettings.h"
+#include "CommandsRecorder.h"
+#include "AnimationUpdater.h"
+#include "AllocationCounter.h"
 #include <chrono>
 #include <utility>
+#include <thread>
+#include <algorithm>
+#include <iostream>
 
 namespace SVE
 {
@@ -35,12 +54,25 @@ namespace SVE
 namespace
 {
 
-enum class PassStage : uint8_t
+const uint32_t MaxRecordingThreads = 8;
+const uint32_t BenchmarkThreadCounts[] = { 1, 2, 4, 8 };
+const bool BenchmarkSubmitBatching[] = { false, true };
+
+thread_local CommandsType currentPassType = CommandsType::MainPass;
+
+template <typename T, size_t size>
+uint32_t getCount(const T (&)[size])
+{
+    return static_cast<uint32_t>(size);
+}
+
+uint32_t getRecordingThreadCount(int threadsSetting)
 {
-    Start,
-    Instanced,
-    Deferred
-};
+    if (threadsSetting == EngineSettings::BEST_THREADS_AVAILABLE)
+        return std::max(1u, std::min(std::thread::hardware_concurrency(), MaxRecordingThreads));
+
+    return static_cast<uint32_t>(std::max(1, threadsSetting));
+}
 
 } // anon namespace
 
@@ -51,26 +83,10 @@ Engine* Engine::getInstance()
     return _engineInstance;
 }
 
-Engine* Engine::createInstance(SDL_Window* window, EngineSettings settings, std::shared_ptr<FileSystem> fileSystem)
-{
-    if (_engineInstance == nullptr)
-    {
-        _engineInstance = new Engine(window, std::move(settings), std::move(fileSystem));
-    }
-    return _engineInstance;
-}
-
-Engine* Engine::createInstance(SDL_Window* window, const std::string& settingsPath, std::shared_ptr<FileSystem> fileSystem, glm::ivec2 framebufferResolution)
+Engine* Engine::createInstance(SDL_Window* window, EngineSettings settings, std::shared_ptr<FileSystem> fileSystem, glm::ivec2 framebufferResolution)
 {
     if (_engineInstance == nullptr)
     {
-        auto data = ResourceManager::getLoadDataFromFolder(settingsPath, false, fileSystem);
-        if (data.engine.empty())
-        {
-            throw VulkanException("Can't find SVE configuration file");
-        }
-
-        auto settings = data.engine.front();
         _engineInstance = new Engine(window, settings, std::move(fileSystem));
 
         //if (settings.initShadows)
@@ -86,6 +102,25 @@ Engine* Engine::createInstance(SDL_Window* window, const std::string& settingsPa
     return _engineInstance;
 }
 
+Engine* Engine::createInstance(SDL_Window* window, const std::string& settingsPath, std::shared_ptr<FileSystem> fileSystem, glm::ivec2 framebufferResolution)
+{
+    if (_engineInstance == nullptr)
+    {
+        createInstance(window, loadSettings(settingsPath, fileSystem), std::move(fileSystem), framebufferResolution);
+    }
+    return _engineInstance;
+}
+
+EngineSettings Engine::loadSettings(const std::string& settingsPath, const std::shared_ptr<FileSystem>& fileSystem)
+{
+    auto data = ResourceManager::getLoadDataFromFolder(settingsPath, false, fileSystem);
+    if (data.engine.empty())
+    {
+        throw VulkanException("Can't find SVE configuration file");
+    }
+    return data.engine.front();
+}
+
 VulkanInstance* Engine::getVulkanInstance()
 {
     return _vulkanInstance.get();
@@ -108,8 +143,22 @@ Engine::Engine(SDL_Window* window, EngineSettings settings, std::shared_ptr<File
     , _fontManager(std::make_unique<FontManager>())
     , _overlayManager(std::make_unique<OverlayManager>())
     , _pipelineCacheManager(std::make_unique<PipelineCacheManager>())
+    , _renderList(std::make_unique<RenderList>())
+    , _renderGraph(std::make_unique<RenderGraph>(_vulkanInstance.get()))
+    , _frameStats(std::make_unique<FrameStats>())
+    , _lastFrameStats(std::make_unique<FrameStats>())
+    , _uniformDataList(PassCount)
 {
+    for (auto& uniformData : _uniformDataList)
+    {
+        uniformData = std::make_shared<UniformData>();
+    }
     updateTime();
+    setRecordingThreadCount(getRecordingThreadCount(getEngineSettings().recordingThreads));
+    _renderGraph->setSubmitBatching(getEngineSettings().batchQueueSubmits);
+    _animationPhaseBuckets = getEngineSettings().animationPhaseBuckets;
+    _animationUpdater = std::make_unique<AnimationUpdater>(getRecordingThreadCount(getEngineSettings().animationThreads));
+    createFrameBenchmarks();
 }
 
 Engine::~Engine()
@@ -120,6 +169,9 @@ Engine::~Engine()
     _sceneManager.reset();
     _shaderManager.reset();
     _materialManager.reset();
+    _commandsRecorder.reset();
+    _instanceCulling.reset();
+    _renderGraph.reset();
     _vulkanInstance.reset();
     _postEffectManager.reset();
     _fontManager.reset();
@@ -176,6 +228,16 @@ PipelineCacheManager* Engine::getPipelineCacheManager()
     return _pipelineCacheManager.get();
 }
 
+RenderList* Engine::getRenderList()
+{
+    return _renderList.get();
+}
+
+VulkanInstanceCulling* Engine::getInstanceCulling()
+{
+    return _instanceCulling.get();
+}
+
 void Engine::resizeWindow()
 {
     _vulkanInstance->resizeWindow();
@@ -197,110 +259,46 @@ void Engine::finishRendering()
     _vulkanInstance->finishRendering();
 }
 
-void Engine::onPause()
-{
-
-}
-
-void Engine::onResume()
+void Engine::releaseFreeResources()
 {
+    // freed descriptor sets can still be used by frames in flight
+    finishRendering();
+    _materialManager->releaseFreeInstances();
 
-}
-
-void createNodeStageDrawCommands(const std::shared_ptr<SceneNode>& node, uint32_t bufferIndex, uint32_t imageIndex, PassStage stage)
-{
-    auto passType = Engine::getInstance()->getPassType();
-    for (auto& entity : node->getAttachedEntities())
+    if (getEngineSettings().reportFreeResources)
     {
-        bool isRenderLast = entity->isRenderLast();
-        bool isRenderDepth = entity->isRenderToDepth();
-        bool isInstanced = entity->isInstanceRendering();
-
-        if (!isRenderDepth && passType == CommandsType::ScreenQuadDepthPass)
-        {
-            continue;
-        }
-
-        switch (stage)
-        {
-            case PassStage::Start:
-                if (!isRenderLast && !isInstanced)
-                    entity->applyDrawingCommands(bufferIndex, imageIndex);
-                break;
-            case PassStage::Instanced:
-                if (!isRenderLast && isInstanced)
-                {
-                    entity->updateInstanceBuffers();
-                    entity->applyDrawingCommands(bufferIndex, imageIndex);
-                }
-                break;
-            case PassStage::Deferred:
-                if (isRenderLast)
-                    entity->applyDrawingCommands(bufferIndex, imageIndex);
-                break;
-        }
-    }
-
-    for (auto& child : node->getChildren())
-    {
-        createNodeStageDrawCommands(child, bufferIndex, imageIndex, stage);
+        auto resourceUsage = getResourceUsage();
+        std::cout << "Released free resources: " << resourceUsage.materialInstances << " material instances used, "
+                  << resourceUsage.descriptorPools << " descriptor pools, "
+                  << resourceUsage.geometrySlots << " meshes in " << resourceUsage.geometryBlocks << " geometry blocks, "
+                  << resourceUsage.vmaAllocations << " VMA allocations (" << resourceUsage.vmaUsedBytes << " bytes)"
+                  << std::endl;
     }
 }
 
-void createNodeDrawCommands(const std::shared_ptr<SceneNode>& node, uint32_t bufferIndex, uint32_t imageIndex)
+ResourceUsage Engine::getResourceUsage()
 {
-    createNodeStageDrawCommands(node, bufferIndex, imageIndex, PassStage::Start);
-    createNodeStageDrawCommands(node, bufferIndex, imageIndex, PassStage::Instanced);
-    createNodeStageDrawCommands(node, bufferIndex, imageIndex, PassStage::Deferred);
-}
-
-void createNodeComputeCommands(const std::shared_ptr<SceneNode>& node, uint32_t bufferIndex, uint32_t imageIndex)
-{
-
-    for (auto& entity : node->getAttachedEntities())
-    {
-        if (entity->isComputeEntity())
-        {
-            auto* computeEntity = static_cast<ComputeEntity*>(entity.get());
-            computeEntity->applyComputeCommands(bufferIndex, imageIndex);
-        }
-    }
+    VmaStats vmaStats {};
+    vmaCalculateStats(_vulkanInstance->getAllocator(), &vmaStats);
 
-    for (auto& child : node->getChildren())
-    {
-        createNodeComputeCommands(child, bufferIndex, imageIndex);
-    }
+    ResourceUsage resourceUsage {};
+    resourceUsage.materialInstances = _materialManager->getUsedInstanceCount();
+    resourceUsage.descriptorPools = _vulkanInstance->getDescriptorPoolSet()->getPoolCount();
+    resourceUsage.geometrySlots = _vulkanInstance->getGeometryArena()->getSlotCount();
+    resourceUsage.geometryBlocks = _vulkanInstance->getGeometryArena()->getBlockCount();
+    resourceUsage.vmaAllocations = vmaStats.total.allocationCount;
+    resourceUsage.vmaUsedBytes = vmaStats.total.usedBytes;
+    return resourceUsage;
 }
 
-void setFrameNumber(const std::shared_ptr<SceneNode>& node, uint64_t frameId)
+void Engine::onPause()
 {
-    node->setCurrentFrame(frameId);
-    for (auto& child : node->getChildren())
-    {
-        setFrameNumber(child, frameId);
-    }
+
 }
 
-void updateNode(const std::shared_ptr<SceneNode>& node, UniformDataList& uniformDataList)
+void Engine::onResume()
 {
-    auto oldModel = uniformDataList[0]->model;
-    uniformDataList[0]->model *= node->getNodeTransformation();
-    for (auto i = 1u; i < uniformDataList.size(); i++)
-        uniformDataList[i]->model = uniformDataList[0]->model;
-
-    // update uniforms
-    for (auto& entity : node->getAttachedEntities())
-    {
-        entity->updateUniforms(uniformDataList);
-    }
 
-    for (auto& child : node->getChildren())
-    {
-        updateNode(child, uniformDataList);
-    }
-
-    for (auto i = 0u; i < uniformDataList.size(); i++)
-        uniformDataList[i]->model = oldModel;
 }
 
 void Engine::renderFrame()
@@ -323,70 +321,137 @@ void Engine::renderFrame(float deltaTime)
 
 void Engine::renderFrameImpl()
 {
+    auto frameStartTime = std::chrono::high_resolution_clock::now();
+    auto frameStartAllocations = getAllocationCount();
     ++_frameId;
     auto skybox = _sceneManager->getSkybox();
     auto currentFrame = _vulkanInstance->getCurrentFrameIndex();
     auto currentImage = _vulkanInstance->getCurrentImageIndex();
 
+    _vulkanInstance->reallocateCommandBuffers();
+    _renderList->extract(_sceneManager->getRootNode(), _frameId);
+
+    _sceneManager->getLightManager()->setCurrentFrame(_frameId);
+
+    ////// Fill uniform data (from camera and lights)
+
+    auto mainCamera = _sceneManager->getMainCamera();
+    if (!mainCamera)
+        throw VulkanException("Camera not set");
+
+    // Per-pass data is shared by all entities, lists memory is kept between frames
+    auto& uniformDataList = _uniformDataList;
+    auto& mainUniform = uniformDataList[toInt(CommandsType::MainPass)];
+    resetUniformData(*mainUniform);
+
+    mainUniform->clipPlane = glm::vec4(0.0, 1.0, 0.0, 100);
+    mainUniform->time = getTime();
+    mainUniform->deltaTime = getDeltaTime();
+    mainUniform->imageSize = glm::ivec4(getRenderWindowSize(), 0, 0);
+    _sceneManager->getMainCamera()->fillUniformData(*mainUniform);
+    _sceneManager->getLightManager()->getDirectionLight()->updateViewMatrix(_sceneManager->getMainCamera()->getPosition(),
+                                                                            _sceneManager->getMainCamera()->getDirection());
+    // lights are filled once, other passes get them with camera data, only shadow passes take view from lights
+    _sceneManager->getLightManager()->fillUniformData(*mainUniform);
+
+    for (auto i = 1; i < PassCount; i++)
+    {
+        *uniformDataList[i] = *mainUniform;
+    }
+
+    // shadow passes are filled again with light as view source, lists copied from main pass are reset first
+    for (auto shadowPass : { CommandsType::ShadowPassDirectLight, CommandsType::ShadowPassPointLights })
+    {
+        auto& shadowUniform = *uniformDataList[toInt(shadowPass)];
+        shadowUniform.shadowPointLightList.clear();
+        shadowUniform.pointLightList.clear();
+        shadowUniform.lineLightList.clear();
+        shadowUniform.lightInfo = {};
+    }
+    _sceneManager->getLightManager()->fillUniformData(*uniformDataList[toInt(CommandsType::ShadowPassDirectLight)], LightType::SunLight);
+    _sceneManager->getLightManager()->fillUniformData(*uniformDataList[toInt(CommandsType::ShadowPassPointLights)], LightType::ShadowPointLight);
+
+    if (auto water = _sceneManager->getWater())
+    {
+        water->getVulkanWater()->fillUniformData(*uniformDataList[toInt(CommandsType::ReflectionPass)],
+                                                 VulkanWater::PassType::Reflection);
+        water->getVulkanWater()->fillUniformData(*uniformDataList[toInt(CommandsType::RefractionPass)],
+                                                 VulkanWater::PassType::Refraction);
+    }
+
+    ////// Frustum culling
+
+    if (getEngineSettings().useFrustumCulling)
+    {
+        cullRenderList(uniformDataList);
+    }
+
     ////// update command buffers
 
-    _vulkanInstance->reallocateCommandBuffers();
-    setFrameNumber(_sceneManager->getRootNode(), _frameId);
+    // Instance batches are assigned once, so passes recording doesn't modify shared state
+    if (getEngineSettings().useGpuCulling && !_instanceCulling)
+        createInstanceCulling();
+    if (_instanceCulling && getEngineSettings().validateGpuCulling)
+        _instanceCulling->validate();
+    _renderList->updateInstanceBatches();
 
     ComputeEntity::startComputeStep();
-    createNodeComputeCommands(_sceneManager->getRootNode(), BUFFER_INDEX_COMPUTE_PARTICLES, currentImage);
+    _renderList->applyComputeCommands(BUFFER_INDEX_COMPUTE_PARTICLES, currentImage);
+    _renderList->applyInstanceCullingCommands(BUFFER_INDEX_COMPUTE_PARTICLES, mainUniform->projection * mainUniform->view);
     ComputeEntity::finishComputeStep();
 
-    _commandsType = CommandsType::ShadowPassDirectLight;
-    _sceneManager->getLightManager()->setCurrentFrame(_frameId);
-    if (auto directLight = _sceneManager->getLightManager()->getDirectionLight())
+    declareRenderGraph();
+
+    _commandsRecorder->begin(currentImage);
+    auto subpassContents = _commandsRecorder->getSubpassContents();
+
+    if (_renderGraph->isPassActive(CommandsType::ShadowPassDirectLight))
     {
         if (auto sunLightShadowMap = _sceneManager->getLightManager()->getDirectLightShadowMap())
         {
-            sunLightShadowMap->getVulkanShadowMap()->reallocateCommandBuffers();
-
-            auto bufferIndex =
-                    sunLightShadowMap->getVulkanShadowMap()->startRenderCommandBufferCreation(
-                            _vulkanInstance->getCurrentFrameIndex(),
-                            _vulkanInstance->getCurrentImageIndex());
-            createNodeDrawCommands(_sceneManager->getRootNode(), bufferIndex, currentImage);
-            sunLightShadowMap->getVulkanShadowMap()->endRenderCommandBufferCreation(
-                    _vulkanInstance->getCurrentFrameIndex());
+            auto* vulkanShadowMap = sunLightShadowMap->getVulkanShadowMap();
+            vulkanShadowMap->reallocateCommandBuffers();
+
+            auto bufferIndex = vulkanShadowMap->startRenderCommandBufferCreation(currentFrame, currentImage, subpassContents);
+            _commandsRecorder->addPass(CommandsType::ShadowPassDirectLight, bufferIndex,
+                                       vulkanShadowMap->getRecordInfo(currentImage),
+                                       PassStage::Start, PassStage::Deferred, nullptr,
+                                       [=] { vulkanShadowMap->endRenderCommandBufferCreation(currentFrame); });
         }
     }
 
-    _commandsType = CommandsType::ShadowPassPointLights;
-    if (auto pointLightShadowMap = _sceneManager->getLightManager()->getPointLightShadowMap())
+    if (_renderGraph->isPassActive(CommandsType::ShadowPassPointLights))
     {
-        pointLightShadowMap->getVulkanShadowMap()->reallocateCommandBuffers();
-
-        auto bufferIndex =
-                pointLightShadowMap->getVulkanShadowMap()->startRenderCommandBufferCreation(
-                        _vulkanInstance->getCurrentFrameIndex(),
-                        _vulkanInstance->getCurrentImageIndex());
-        createNodeDrawCommands(_sceneManager->getRootNode(), bufferIndex, currentImage);
-        pointLightShadowMap->getVulkanShadowMap()->endRenderCommandBufferCreation(
-                _vulkanInstance->getCurrentFrameIndex());
+        auto* vulkanShadowMap = _sceneManager->getLightManager()->getPointLightShadowMap()->getVulkanShadowMap();
+        vulkanShadowMap->reallocateCommandBuffers();
+
+        auto bufferIndex = vulkanShadowMap->startRenderCommandBufferCreation(currentFrame, currentImage, subpassContents);
+        _commandsRecorder->addPass(CommandsType::ShadowPassPointLights, bufferIndex,
+                                   vulkanShadowMap->getRecordInfo(currentImage),
+                                   PassStage::Start, PassStage::Deferred, nullptr,
+                                   [=] { vulkanShadowMap->endRenderCommandBufferCreation(currentFrame); });
     }
 
     if (auto water = _sceneManager->getWater())
     {
-        water->getVulkanWater()->reallocateCommandBuffers();
-        _commandsType = CommandsType::ReflectionPass;
-        water->getVulkanWater()->startRenderCommandBufferCreation(VulkanWater::PassType::Reflection);
-        if (skybox)
-            skybox->applyDrawingCommands(BUFFER_INDEX_WATER_REFLECTION, currentImage);
-        createNodeDrawCommands(_sceneManager->getRootNode(), BUFFER_INDEX_WATER_REFLECTION, currentImage);
-        water->getVulkanWater()->endRenderCommandBufferCreation(VulkanWater::PassType::Reflection);
-
-        _commandsType = CommandsType::RefractionPass;
-        water->getVulkanWater()->startRenderCommandBufferCreation(VulkanWater::PassType::Refraction);
-        if (skybox)
-            skybox->applyDrawingCommands(BUFFER_INDEX_WATER_REFRACTION, currentImage);
-        createNodeDrawCommands(_sceneManager->getRootNode(), BUFFER_INDEX_WATER_REFRACTION, currentImage);
-        water->getVulkanWater()->endRenderCommandBufferCreation(VulkanWater::PassType::Refraction);
+        auto* vulkanWater = water->getVulkanWater();
+        vulkanWater->reallocateCommandBuffers();
+        for (auto passType : { VulkanWater::PassType::Reflection, VulkanWater::PassType::Refraction })
+        {
+            auto isReflection = passType == VulkanWater::PassType::Reflection;
+            if (!_renderGraph->isPassActive(isReflection ? CommandsType::ReflectionPass : CommandsType::RefractionPass))
+                continue;
+
+            vulkanWater->startRenderCommandBufferCreation(passType, subpassContents);
+            _commandsRecorder->addPass(isReflection ? CommandsType::ReflectionPass : CommandsType::RefractionPass,
+                                       isReflection ? BUFFER_INDEX_WATER_REFLECTION : BUFFER_INDEX_WATER_REFRACTION,
+                                       vulkanWater->getRecordInfo(passType),
+                                       PassStage::Start, PassStage::Deferred, skybox.get(),
+                                       [=] { vulkanWater->endRenderCommandBufferCreation(passType); });
+        }
     }
 
+    std::function<void()> mainThreadCommands;
     if (auto* screenQuad = _vulkanInstance->getScreenQuad())
     {
         /*_commandsType = CommandsType::ScreenQuadDepthPass;
@@ -396,143 +461,387 @@ void Engine::renderFrameImpl()
         createNodeStageDrawCommands(_sceneManager->getRootNode(), BUFFER_INDEX_SCREEN_QUAD_DEPTH, currentImage, PassStage::Instanced);
         screenQuad->endRenderCommandBufferCreation(VulkanScreenQuad::Depth);*/
 
-        _commandsType = CommandsType::ScreenQuadPass;
-        screenQuad->reallocateCommandBuffers(VulkanScreenQuad::Normal);
-        screenQuad->startRenderCommandBufferCreation(VulkanScreenQuad::Normal);
-        if (skybox)
-            skybox->applyDrawingCommands(BUFFER_INDEX_SCREEN_QUAD, currentImage);
-        createNodeStageDrawCommands(_sceneManager->getRootNode(), BUFFER_INDEX_SCREEN_QUAD, currentImage, PassStage::Start);
-        createNodeStageDrawCommands(_sceneManager->getRootNode(), BUFFER_INDEX_SCREEN_QUAD, currentImage, PassStage::Instanced);
-        screenQuad->endRenderCommandBufferCreation(VulkanScreenQuad::Normal);
-
-        _commandsType = CommandsType::ScreenQuadMRTPass;
-        screenQuad->reallocateCommandBuffers(VulkanScreenQuad::MRT);
-        screenQuad->startRenderCommandBufferCreation(VulkanScreenQuad::MRT);
-        createNodeStageDrawCommands(_sceneManager->getRootNode(), BUFFER_INDEX_SCREEN_QUAD_MRT, currentImage, PassStage::Start);
-        createNodeStageDrawCommands(_sceneManager->getRootNode(), BUFFER_INDEX_SCREEN_QUAD_MRT, currentImage, PassStage::Instanced);
-        screenQuad->endRenderCommandBufferCreation(VulkanScreenQuad::MRT);
-
-        _commandsType = CommandsType::ScreenQuadLatePass;
-        screenQuad->reallocateCommandBuffers(VulkanScreenQuad::Late);
-        screenQuad->startRenderCommandBufferCreation(VulkanScreenQuad::Late);
-        createNodeStageDrawCommands(_sceneManager->getRootNode(), BUFFER_INDEX_SCREEN_QUAD_LATE, currentImage, PassStage::Deferred);
-        screenQuad->endRenderCommandBufferCreation(VulkanScreenQuad::Late);
-
-        _commandsType = CommandsType::PostEffectPasses;
-        _engineInstance->getPostEffectManager()->createCommands(currentFrame, currentImage);
-    }
-
-    _commandsType = CommandsType::MainPass;
-    _vulkanInstance->startRenderCommandBufferCreation();
-    if (auto* screenQuad = _vulkanInstance->getScreenQuad())
-    {
-        auto index = _engineInstance->getMaterialManager()->getMaterial("ScreenQuad")->getVulkanMaterial()->getInstanceForEntity(nullptr);
-        _materialManager->getMaterial("ScreenQuad")->getVulkanMaterial()->applyDrawingCommands(currentFrame, currentImage, index);
-        auto commandBuffer = _vulkanInstance->getCommandBuffer(currentFrame);
-        vkCmdDraw(commandBuffer, 6, 1, 0, 0);
+        if (screenQuad->isMerged())
+        {
+            // all stages are recorded to Normal command buffer, next stage starts when previous pass is ended
+            if (_renderGraph->isPassActive(CommandsType::ScreenQuadPass))
+            {
+                screenQuad->reallocateCommandBuffers(VulkanScreenQuad::Normal);
+                screenQuad->startRenderCommandBufferCreation(VulkanScreenQuad::Normal, subpassContents);
+                _commandsRecorder->addPass(CommandsType::ScreenQuadPass, BUFFER_INDEX_SCREEN_QUAD,
+                                           screenQuad->getRecordInfo(VulkanScreenQuad::Normal),
+                                           PassStage::Start, PassStage::Instanced, skybox.get(),
+                                           [=] { screenQuad->nextSubpass(subpassContents); });
+                _commandsRecorder->addPass(CommandsType::ScreenQuadMRTPass, BUFFER_INDEX_SCREEN_QUAD,
+                                           screenQuad->getRecordInfo(VulkanScreenQuad::MRT),
+                                           PassStage::Start, PassStage::Instanced, nullptr,
+                                           [=] { screenQuad->nextSubpass(subpassContents); });
+                _commandsRecorder->addPass(CommandsType::ScreenQuadLatePass, BUFFER_INDEX_SCREEN_QUAD,
+                                           screenQuad->getRecordInfo(VulkanScreenQuad::Late),
+                                           PassStage::Deferred, PassStage::Deferred, nullptr,
+                                           [=] { screenQuad->endRenderCommandBufferCreation(VulkanScreenQuad::Normal); });
+            }
+        } else
+        {
+            if (_renderGraph->isPassActive(CommandsType::ScreenQuadPass))
+            {
+                screenQuad->reallocateCommandBuffers(VulkanScreenQuad::Normal);
+                screenQuad->startRenderCommandBufferCreation(VulkanScreenQuad::Normal, subpassContents);
+                _commandsRecorder->addPass(CommandsType::ScreenQuadPass, BUFFER_INDEX_SCREEN_QUAD,
+                                           screenQuad->getRecordInfo(VulkanScreenQuad::Normal),
+                                           PassStage::Start, PassStage::Instanced, skybox.get(),
+                                           [=] { screenQuad->endRenderCommandBufferCreation(VulkanScreenQuad::Normal); });
+            }
+
+            if (_renderGraph->isPassActive(CommandsType::ScreenQuadMRTPass))
+            {
+                screenQuad->reallocateCommandBuffers(VulkanScreenQuad::MRT);
+                screenQuad->startRenderCommandBufferCreation(VulkanScreenQuad::MRT, subpassContents);
+                _commandsRecorder->addPass(CommandsType::ScreenQuadMRTPass, BUFFER_INDEX_SCREEN_QUAD_MRT,
+                                           screenQuad->getRecordInfo(VulkanScreenQuad::MRT),
+                                           PassStage::Start, PassStage::Instanced, nullptr,
+                                           [=] { screenQuad->endRenderCommandBufferCreation(VulkanScreenQuad::MRT); });
+            }
+
+            if (_renderGraph->isPassActive(CommandsType::ScreenQuadLatePass))
+            {
+                screenQuad->reallocateCommandBuffers(VulkanScreenQuad::Late);
+                screenQuad->startRenderCommandBufferCreation(VulkanScreenQuad::Late, subpassContents);
+                _commandsRecorder->addPass(CommandsType::ScreenQuadLatePass, BUFFER_INDEX_SCREEN_QUAD_LATE,
+                                           screenQuad->getRecordInfo(VulkanScreenQuad::Late),
+                                           PassStage::Deferred, PassStage::Deferred, nullptr,
+                                           [=] { screenQuad->endRenderCommandBufferCreation(VulkanScreenQuad::Late); });
+            }
+        }
 
-        // Draw GUI
-        _overlayManager->applyDrawingCommands(currentFrame, currentImage);
+        // Post effects and main pass only draw screen quads and GUI, so they are recorded on main thread,
+        // while scene passes are recorded by workers
+        mainThreadCommands = [this, currentFrame, currentImage]
+        {
+            setPassType(CommandsType::PostEffectPasses);
+            _postEffectManager->createCommands(*_renderGraph, currentFrame, currentImage);
+
+            setPassType(CommandsType::MainPass);
+            _vulkanInstance->startRenderCommandBufferCreation();
+            auto screenQuadMaterial = _materialManager->getMaterial("ScreenQuad")->getVulkanMaterial();
+            auto index = screenQuadMaterial->getInstanceForEntity(nullptr);
+            screenQuadMaterial->applyDrawingCommands(currentFrame, currentImage, index);
+            auto commandBuffer = _vulkanInstance->getCommandBuffer(currentFrame);
+            vkCmdDraw(commandBuffer, 6, 1, 0, 0);
+
+            // Draw GUI
+            _overlayManager->applyDrawingCommands(currentFrame, currentImage);
+            _vulkanInstance->endRenderCommandBufferCreation();
+        };
     } else
     {
-        if (skybox)
-            skybox->applyDrawingCommands(currentFrame, currentImage);
-        createNodeDrawCommands(_sceneManager->getRootNode(), currentFrame, currentImage);
+        _vulkanInstance->startRenderCommandBufferCreation(subpassContents);
+        _commandsRecorder->addPass(CommandsType::MainPass, currentFrame, _vulkanInstance->getRecordInfo(),
+                                   PassStage::Start, PassStage::Deferred, skybox.get(),
+                                   [this] { _vulkanInstance->endRenderCommandBufferCreation(); });
     }
-    _vulkanInstance->endRenderCommandBufferCreation();
+    _commandsRecorder->record(mainThreadCommands);
+    setPassType(CommandsType::MainPass);
 
+    /////// Update animation
 
-    ////// Fill uniform data (from camera and lights)
+    // Skeletal entities bones are evaluated on worker threads before uniforms update, which only reads them
+    auto animationStartTime = std::chrono::high_resolution_clock::now();
+    _animationUpdater->begin();
+    for (const auto& entityItem : _renderList->getEntityList())
+        entityItem.entity->prepareAnimation(*_animationUpdater);
+    _animationUpdater->update();
+    _frameStats->animationTime = std::chrono::duration<float, std::chrono::milliseconds::period>(
+            std::chrono::high_resolution_clock::now() - animationStartTime).count();
 
-    auto mainCamera = _sceneManager->getMainCamera();
-    if (!mainCamera)
-        throw VulkanException("Camera not set");
+    /////// Update uniforms
 
-    // TODO: Init this once
-    UniformDataList uniformDataList(PassCount);
+    auto uniformsStartAllocations = getAllocationCount();
+    if (skybox)
+        skybox->updateUniforms(uniformDataList);
+    _renderList->updateUniforms(uniformDataList);
+    _overlayManager->updateUniforms(uniformDataList);
+    auto* passUniforms = _vulkanInstance->getPassUniforms();
+    for (auto i = 0u; i < PassCount; i++)
+        passUniforms->update(static_cast<CommandsType>(i), *uniformDataList[i]);
+    passUniforms->updateLights(*uniformDataList[toInt(CommandsType::MainPass)]);
+    _frameStats->uniformUpdateAllocations = getAllocationCount() - uniformsStartAllocations;
 
-    for (auto i = 0; i < PassCount; i++)
+    _postEffectManager->updateUniforms(uniformDataList);
+
+    ///////  Submit command buffers to queue
+    auto submitStartTime = std::chrono::high_resolution_clock::now();
+    // resources uploaded since last frame should be available for frame passes
+    _vulkanInstance->getUploadManager()->flush();
+    _renderGraph->submit();
+    _frameStats->submitTime = std::chrono::duration<float, std::chrono::milliseconds::period>(
+            std::chrono::high_resolution_clock::now() - submitStartTime).count();
+    _frameStats->queueSubmits = _renderGraph->getQueueSubmitCount();
+    _frameStats->submitBatches = _renderGraph->getSubmitBatchCount();
+    _frameStats->computeGpuTime = _vulkanInstance->getComputeGpuTime();
+    _frameStats->computeOverlapTime = _vulkanInstance->getComputeOverlapTime();
+
+    _vulkanInstance->renderCommands();
+
+    _frameStats->frameId = _frameId;
+    _frameStats->recordingThreads = _commandsRecorder->getThreadCount();
+    _frameStats->renderGraphDependencies = _renderGraph->getDependencyCount();
+    _frameStats->renderGraphCulledPasses = _renderGraph->getCulledPassCount();
+    _frameStats->renderGraphBarriers = _renderGraph->getBarrierCount();
+    _frameStats->renderGraphLayoutTransitions = _renderGraph->getLayoutTransitionCount();
+    _frameStats->renderGraphAliasedImages = _renderGraph->getAliasedImageCount();
+    updateAttachmentTraffic();
+    _frameStats->heapAllocations = getAllocationCount() - frameStartAllocations;
+    VmaStats vmaStats {};
+    vmaCalculateStats(_vulkanInstance->getAllocator(), &vmaStats);
+    _frameStats->vmaAllocationCount = vmaStats.total.allocationCount;
+    _frameStats->meshVertexBindings = _vulkanInstance->getGeometryArena()->resetBindingCount();
+    _frameStats->cpuTime = std::chrono::duration<float, std::chrono::milliseconds::period>(
+            std::chrono::high_resolution_clock::now() - frameStartTime).count();
+    *_lastFrameStats = *_frameStats;
+    *_frameStats = {};
+
+    for (auto& frameBenchmark : _frameBenchmarks)
+        frameBenchmark->update(*_lastFrameStats);
+}
+
+void Engine::declareRenderGraph()
+{
+    auto* lightManager = _sceneManager->getLightManager();
+    auto currentFrame = _vulkanInstance->getCurrentFrameIndex();
+
+    _renderGraph->beginDeclaration();
+
+    // particles and GPU culled instances
+    _renderGraph->addPass(CommandsType::ComputeParticlesPass, 0, BUFFER_INDEX_COMPUTE_PARTICLES);
+    _renderGraph->addWrite(RenderResource::ComputeBuffers);
+
+    if (isShadowMappingEnabled())
     {
-        uniformDataList[i] = std::make_shared<UniformData>();
+        if (lightManager->getDirectionLight() && lightManager->getDirectLightShadowMap())
+        {
+            _renderGraph->addPass(CommandsType::ShadowPassDirectLight, 0, BUFFER_INDEX_SHADOWMAP_SUN + currentFrame);
+            _renderGraph->addWrite(RenderResource::ShadowMapDirect);
+        }
+        if (lightManager->getPointLightShadowMap())
+        {
+            _renderGraph->addPass(CommandsType::ShadowPassPointLights, 0, BUFFER_INDEX_SHADOWMAP_POINT + currentFrame);
+            _renderGraph->addWrite(RenderResource::ShadowMapPoint);
+        }
     }
-    auto& mainUniform = uniformDataList[toInt(CommandsType::MainPass)];
-
-    mainUniform->clipPlane = glm::vec4(0.0, 1.0, 0.0, 100);
-    mainUniform->time = getTime();
-    mainUniform->deltaTime = getDeltaTime();
-    mainUniform->imageSize = glm::ivec4(getRenderWindowSize(), 0, 0);
-    _sceneManager->getMainCamera()->fillUniformData(*mainUniform);
 
-    for (auto i = 1; i < PassCount; i++)
+    if (_sceneManager->getWater())
     {
-        *uniformDataList[i] = *mainUniform;
+        _renderGraph->addPass(CommandsType::ReflectionPass, 0, BUFFER_INDEX_WATER_REFLECTION);
+        _renderGraph->addRead(RenderResource::ComputeBuffers);
+        _renderGraph->addTextureReads(_renderList->getPassTextureMask(CommandsType::ReflectionPass));
+        _renderGraph->addWrite(RenderResource::Reflection);
+
+        _renderGraph->addPass(CommandsType::RefractionPass, 0, BUFFER_INDEX_WATER_REFRACTION);
+        _renderGraph->addRead(RenderResource::ComputeBuffers);
+        _renderGraph->addTextureReads(_renderList->getPassTextureMask(CommandsType::RefractionPass));
+        _renderGraph->addWrite(RenderResource::Refraction);
     }
 
-    _sceneManager->getLightManager()->getDirectionLight()->updateViewMatrix(_sceneManager->getMainCamera()->getPosition(),
-                                                                            _sceneManager->getMainCamera()->getDirection());
-    _sceneManager->getLightManager()->fillUniformData(*uniformDataList[toInt(CommandsType::ShadowPassDirectLight)], LightType::SunLight);
-    _sceneManager->getLightManager()->fillUniformData(*uniformDataList[toInt(CommandsType::ShadowPassPointLights)], LightType::ShadowPointLight);
-    for (auto i = 0u; i < PassCount; i++)
+    if (auto* screenQuad = _vulkanInstance->getScreenQuad())
     {
-        if (i == toInt(CommandsType::ShadowPassDirectLight) || i == toInt(CommandsType::ShadowPassPointLights))
-            continue;
-        _sceneManager->getLightManager()->fillUniformData(*uniformDataList[i]);
+        if (screenQuad->isMerged())
+        {
+            // stages are subpasses without input attachments, so they can't sample what previous stages have drawn
+            auto textureMask = _renderList->getPassTextureMask(CommandsType::ScreenQuadPass)
+                               | _renderList->getPassTextureMask(CommandsType::ScreenQuadMRTPass)
+                               | _renderList->getPassTextureMask(CommandsType::ScreenQuadLatePass);
+            if (textureMask & (1u << static_cast<uint32_t>(TextureType::ScreenQuad)
+                               | 1u << static_cast<uint32_t>(TextureType::ScreenQuadSecond)
+                               | 1u << static_cast<uint32_t>(TextureType::ScreenQuadDepth)))
+            {
+                throw VulkanException("Merged screen quad passes can't sample screen quad textures");
+            }
+
+            _renderGraph->addPass(CommandsType::ScreenQuadPass, 0, BUFFER_INDEX_SCREEN_QUAD);
+            _renderGraph->addRead(RenderResource::ComputeBuffers);
+            _renderGraph->addTextureReads(textureMask);
+            _renderGraph->addWrite(RenderResource::ScreenQuad);
+            _renderGraph->addWrite(RenderResource::ScreenQuadSecond);
+        } else
+        {
+            _renderGraph->addPass(CommandsType::ScreenQuadPass, 0, BUFFER_INDEX_SCREEN_QUAD);
+            _renderGraph->addRead(RenderResource::ComputeBuffers);
+            _renderGraph->addTextureReads(_renderList->getPassTextureMask(CommandsType::ScreenQuadPass));
+            _renderGraph->addWrite(RenderResource::ScreenQuad);
+
+            _renderGraph->addPass(CommandsType::ScreenQuadMRTPass, 0, BUFFER_INDEX_SCREEN_QUAD_MRT);
+            _renderGraph->addTextureReads(_renderList->getPassTextureMask(CommandsType::ScreenQuadMRTPass));
+            _renderGraph->addWrite(RenderResource::ScreenQuad);
+            _renderGraph->addWrite(RenderResource::ScreenQuadSecond);
+
+            _renderGraph->addPass(CommandsType::ScreenQuadLatePass, 0, BUFFER_INDEX_SCREEN_QUAD_LATE);
+            _renderGraph->addRead(RenderResource::ComputeBuffers);
+            _renderGraph->addTextureReads(_renderList->getPassTextureMask(CommandsType::ScreenQuadLatePass));
+            _renderGraph->addWrite(RenderResource::ScreenQuad);
+        }
+
+        _postEffectManager->declarePasses(*_renderGraph);
+
+        // main pass only draws screen quad with the last effect output and GUI
+        auto effectCount = _postEffectManager->getEffectCount();
+        _renderGraph->addPass(CommandsType::MainPass, 0, currentFrame);
+        if (effectCount > 0)
+            _renderGraph->addRead(RenderResource::PostEffect, effectCount);
+        else
+            _renderGraph->addRead(RenderResource::ScreenQuad);
+        _renderGraph->addWrite(RenderResource::Swapchain);
+    } else
+    {
+        _renderGraph->addPass(CommandsType::MainPass, 0, currentFrame);
+        _renderGraph->addRead(RenderResource::ComputeBuffers);
+        _renderGraph->addTextureReads(_renderList->getPassTextureMask(CommandsType::MainPass));
+        _renderGraph->addWrite(RenderResource::Swapchain);
     }
 
-    if (auto water = _sceneManager->getWater())
+    _renderGraph->endDeclaration();
+}
+
+void Engine::cullRenderList(const UniformDataList& uniformDataList)
+{
+    auto createVolume = [](const std::vector<glm::mat4>& viewProjectionList)
     {
-        water->getVulkanWater()->fillUniformData(*uniformDataList[toInt(CommandsType::ReflectionPass)],
-                                                 VulkanWater::PassType::Reflection);
-        water->getVulkanWater()->fillUniformData(*uniformDataList[toInt(CommandsType::RefractionPass)],
-                                                 VulkanWater::PassType::Refraction);
+        CullingVolume cullingVolume;
+        cullingVolume.reserve(viewProjectionList.size());
+        for (auto& viewProjection : viewProjectionList)
+            cullingVolume.emplace_back(viewProjection);
+        return cullingVolume;
+    };
+
+    auto& mainUniform = uniformDataList[toInt(CommandsType::MainPass)];
+    CullingVolume mainVolume { Frustum(mainUniform->projection * mainUniform->view) };
+    for (auto passType : { CommandsType::MainPass,
+                           CommandsType::ScreenQuadPass,
+                           CommandsType::ScreenQuadMRTPass,
+                           CommandsType::ScreenQuadLatePass,
+                           CommandsType::ScreenQuadDepthPass,
+                           CommandsType::RefractionPass })
+    {
+        _renderList->cull(passType, mainVolume);
     }
 
-    /////// Update uniforms
+    if (isWaterEnabled())
+    {
+        auto& reflectionUniform = uniformDataList[toInt(CommandsType::ReflectionPass)];
+        _renderList->cull(CommandsType::ReflectionPass,
+                          { Frustum(reflectionUniform->projection * reflectionUniform->view) });
+    }
 
-    if (skybox)
-        skybox->updateUniforms(uniformDataList);
-    updateNode(_sceneManager->getRootNode(), uniformDataList);
-    _overlayManager->updateUniforms(uniformDataList);
+    // shadow passes use light cascades and point lights cube faces as view sources
+    _renderList->cull(CommandsType::ShadowPassDirectLight,
+                      createVolume(uniformDataList[toInt(CommandsType::ShadowPassDirectLight)]->viewProjectionList));
+    _renderList->cull(CommandsType::ShadowPassPointLights,
+                      createVolume(uniformDataList[toInt(CommandsType::ShadowPassPointLights)]->viewProjectionList));
+}
 
-    ///////  Submit command buffers to queue
-    //if (particleSystemManager)
+void Engine::createFrameBenchmarks()
+{
+    const auto& settings = getEngineSettings();
+    if (settings.benchmarkRecording)
     {
-        // TODO: Use special compute queue instead of graphics queue for compute shader (they can be different)
-        _vulkanInstance->submitCommands(CommandsType::ComputeParticlesPass, BUFFER_INDEX_COMPUTE_PARTICLES);
+        _frameBenchmarks.push_back(std::make_unique<FrameBenchmark>(
+                getCount(BenchmarkThreadCounts),
+                [this](uint32_t step)
+                {
+                    setRecordingThreadCount(step < getCount(BenchmarkThreadCounts)
+                                            ? BenchmarkThreadCounts[step]
+                                            : getRecordingThreadCount(getEngineSettings().recordingThreads));
+                },
+                [](uint32_t step, const FrameStats& sum, uint32_t frameCount)
+                {
+                    std::cout << "Recording benchmark: " << BenchmarkThreadCounts[step] << " thread(s), frame CPU time "
+                              << sum.cpuTime / frameCount << " ms" << std::endl;
+                }));
     }
-    if (isShadowMappingEnabled())
+
+    if (settings.benchmarkQueueSubmits)
     {
-        if (_sceneManager->getLightManager()->getDirectLightShadowMap())
-        {
-            _vulkanInstance->submitCommands(
-                    CommandsType::ShadowPassDirectLight,
-                    BUFFER_INDEX_SHADOWMAP_SUN + _vulkanInstance->getCurrentFrameIndex());
-        }
+        _frameBenchmarks.push_back(std::make_unique<FrameBenchmark>(
+                getCount(BenchmarkSubmitBatching),
+                [this](uint32_t step)
+                {
+                    _renderGraph->setSubmitBatching(step < getCount(BenchmarkSubmitBatching)
+                                                    ? BenchmarkSubmitBatching[step]
+                                                    : getEngineSettings().batchQueueSubmits);
+                },
+                [](uint32_t step, const FrameStats& sum, uint32_t frameCount)
+                {
+                    std::cout << "Submit benchmark: batching " << (BenchmarkSubmitBatching[step] ? "on" : "off")
+                              << ", " << sum.queueSubmits / frameCount << " queue submits, "
+                              << sum.submitBatches / frameCount << " batches, submit CPU time "
+                              << sum.submitTime / frameCount << " ms, frame CPU time "
+                              << sum.cpuTime / frameCount << " ms" << std::endl;
+                }));
+    }
 
-        if (_sceneManager->getLightManager()->getPointLightShadowMap())
-        {
-            _vulkanInstance->submitCommands(
-                    CommandsType::ShadowPassPointLights,
-                    BUFFER_INDEX_SHADOWMAP_POINT + _vulkanInstance->getCurrentFrameIndex());
-        }
+    if (settings.profileAsyncCompute)
+    {
+        _frameBenchmarks.push_back(std::make_unique<FrameBenchmark>(
+                [this](uint32_t /*step*/, const FrameStats& sum, uint32_t frameCount)
+                {
+                    std::cout << "Compute profile: "
+                              << (_vulkanInstance->isAsyncCompute() ? "async compute queue" : "graphics queue")
+                              << ", compute GPU time " << sum.computeGpuTime / frameCount
+                              << " ms, overlapped with graphics " << sum.computeOverlapTime / frameCount << " ms"
+                              << std::endl;
+                }));
     }
-    if (_sceneManager->getWater())
+
+    if (settings.reportAnimation)
     {
-        _vulkanInstance->submitCommands(CommandsType::ReflectionPass, BUFFER_INDEX_WATER_REFLECTION);
-        _vulkanInstance->submitCommands(CommandsType::RefractionPass, BUFFER_INDEX_WATER_REFRACTION);
+        _frameBenchmarks.push_back(std::make_unique<FrameBenchmark>(
+                [this](uint32_t /*step*/, const FrameStats& sum, uint32_t frameCount)
+                {
+                    auto hitRate = sum.animatedEntityCount > 0
+                            ? 100.0f * (sum.animatedEntityCount - sum.animationPoseEvaluations) / sum.animatedEntityCount
+                            : 0.0f;
+                    std::cout << "Animation report: " << static_cast<float>(sum.animatedEntityCount) / frameCount
+                              << " skeletal entities, " << static_cast<float>(sum.animationPoseEvaluations) / frameCount
+                              << " poses evaluated, pose cache hit rate " << hitRate << "%, animation phase time "
+                              << sum.animationTime / frameCount << " ms on " << _animationUpdater->getThreadCount()
+                              << " thread(s)" << std::endl;
+                }));
     }
+}
+
+void Engine::createInstanceCulling()
+{
+    auto shader = _shaderManager->getShader("instanceCullingComputeShader");
+    if (!shader)
+        throw VulkanException("Instance culling compute shader isn't loaded");
+
+    _instanceCulling = std::make_unique<VulkanInstanceCulling>(
+            _vulkanInstance.get(),
+            shader->getVulkanShaderInfo(),
+            getEngineSettings().maxGpuCulledBatches);
+}
 
-    if (_vulkanInstance->getScreenQuad())
+void Engine::updateAttachmentTraffic()
+{
+    auto traffic = _vulkanInstance->getAttachmentTraffic();
+    auto* screenQuad = _vulkanInstance->getScreenQuad();
+    if (screenQuad)
     {
-        //_vulkanInstance->submitCommands(CommandsType::ScreenQuadDepthPass, BUFFER_INDEX_SCREEN_QUAD_DEPTH);
-        _vulkanInstance->submitCommands(CommandsType::ScreenQuadPass, BUFFER_INDEX_SCREEN_QUAD);
-        _vulkanInstance->submitCommands(CommandsType::ScreenQuadMRTPass, BUFFER_INDEX_SCREEN_QUAD_MRT);
-        _vulkanInstance->submitCommands(CommandsType::ScreenQuadLatePass, BUFFER_INDEX_SCREEN_QUAD_LATE);
-        _postEffectManager->submitCommands(uniformDataList);
+        traffic += screenQuad->getAttachmentTraffic(screenQuad->isMerged());
+        traffic += _postEffectManager->getAttachmentTraffic(*_renderGraph);
     }
-    _vulkanInstance->submitCommands(CommandsType::MainPass, _vulkanInstance->getCurrentFrameIndex());
+    _frameStats->attachmentLoadBytes = traffic.loadBytes;
+    _frameStats->attachmentStoreBytes = traffic.storeBytes;
 
-    _vulkanInstance->renderCommands();
+    if (getEngineSettings().reportAttachmentTraffic && _frameId == 1 && screenQuad)
+    {
+        auto separate = screenQuad->getAttachmentTraffic(false);
+        auto merged = screenQuad->getAttachmentTraffic(true);
+        std::cout << "Attachment traffic per frame: " << traffic.loadBytes / 1024 << " KB loaded, "
+                  << traffic.storeBytes / 1024 << " KB stored" << std::endl;
+        std::cout << "Screen quad passes: separate " << (separate.loadBytes + separate.storeBytes) / 1024
+                  << " KB, merged " << (merged.loadBytes + merged.storeBytes) / 1024 << " KB" << std::endl;
+    }
 }
 
 float Engine::getTime()
@@ -555,7 +864,36 @@ void Engine::updateTime()
 
 CommandsType Engine::getPassType() const
 {
-    return _commandsType;
+    return currentPassType;
+}
+
+void Engine::setPassType(CommandsType commandsType)
+{
+    currentPassType = commandsType;
+}
+
+void Engine::setRecordingThreadCount(uint32_t threadCount)
+{
+    if (_commandsRecorder && _commandsRecorder->getThreadCount() == threadCount)
+        return;
+
+    _vulkanInstance->setRecordingThreadCount(threadCount);
+    _commandsRecorder = std::make_unique<CommandsRecorder>(threadCount);
+}
+
+const FrameStats& Engine::getFrameStats() const
+{
+    return *_lastFrameStats;
+}
+
+FrameStats& Engine::getCurrentFrameStats()
+{
+    return *_frameStats;
+}
+
+uint64_t Engine::getFrameId() const
+{
+    return _frameId;
 }
 
 bool Engine::isShadowMappingEnabled() const
@@ -590,4 +928,14 @@ bool Engine::isFirstRun() const
     return _isFirstRun;
 }
 
+uint32_t Engine::getAnimationPhaseBuckets() const
+{
+    return _animationPhaseBuckets;
+}
+
+void Engine::setAnimationPhaseBuckets(uint32_t phaseBuckets)
+{
+    _animationPhaseBuckets = phaseBuckets;
+}
+
 } // namespace SVE
\ No newline at end of file
@@ -24,6 +24,14 @@ class PostEffectManager;
 class FontManager;
 class OverlayManager;
 class PipelineCacheManager;
+class RenderList;
+class CommandsRecorder;
+class AnimationUpdater;
+class VulkanInstanceCulling;
+class RenderGraph;
+struct FrameStats;
+struct ResourceUsage;
+class FrameBenchmark;
 
 enum class CommandsType : uint8_t
 {
@@ -43,11 +51,18 @@ enum class CommandsType : uint8_t
 
 static const uint8_t PassCount = 9;
 
+inline PassMask toPassMask(CommandsType commandsType)
+{
+    return static_cast<PassMask>(1u << static_cast<uint8_t>(commandsType));
+}
+
 class Engine
 {
 public:
     static Engine* createInstance(SDL_Window* window, const std::string& settingsPath, std::shared_ptr<FileSystem> fileSystem, glm::ivec2 frameBufferResolution = {0, 0});
-    static Engine* createInstance(SDL_Window* window, EngineSettings settings, std::shared_ptr<FileSystem> fileSystem);
+    static Engine* createInstance(SDL_Window* window, EngineSettings settings, std::shared_ptr<FileSystem> fileSystem, glm::ivec2 frameBufferResolution = {0, 0});
+    // Settings from configuration file, can be modified before engine creation (e.g. by tools)
+    static EngineSettings loadSettings(const std::string& settingsPath, const std::shared_ptr<FileSystem>& fileSystem);
     static void destroyInstance(); // debug only
     static Engine* getInstance();
     ~Engine();
@@ -63,10 +78,16 @@ public:
     FontManager* getFontManager();
     OverlayManager* getOverlayManager();
     PipelineCacheManager* getPipelineCacheManager();
+    RenderList* getRenderList();
+    // nullptr if GPU culling is disabled
+    VulkanInstanceCulling* getInstanceCulling();
 
     void resizeWindow();
     glm::ivec2 getRenderWindowSize();
     void finishRendering();
+    // Returns memory of deleted entities to shared pools, should be called when scene is cleared (e.g. level end)
+    void releaseFreeResources();
+    ResourceUsage getResourceUsage();
 
     void onPause();
     void onResume();
@@ -77,8 +98,20 @@ public:
 
     bool isFirstRun() const;
     void setIsFirstRun(bool value);
+    // Animation time of skeletal entities is snapped to this number of phases per clip (0 - off), so more
+    // entities share evaluated poses. Initialized from animationPhaseBuckets setting.
+    uint32_t getAnimationPhaseBuckets() const;
+    void setAnimationPhaseBuckets(uint32_t phaseBuckets);
 
+    // Pass type is stored per thread, as passes can be recorded in parallel
     CommandsType getPassType() const;
+    void setPassType(CommandsType commandsType);
+    void setRecordingThreadCount(uint32_t threadCount);
+    // Stats of the last rendered frame
+    const FrameStats& getFrameStats() const;
+    // Stats of the frame currently collected
+    FrameStats& getCurrentFrameStats();
+    uint64_t getFrameId() const;
     float getTime();
     float getDeltaTime();
 
@@ -91,10 +124,14 @@ private:
 
     void updateTime();
     void renderFrameImpl();
+    void cullRenderList(const UniformDataList& uniformDataList);
+    void createFrameBenchmarks();
+    void createInstanceCulling();
+    void declareRenderGraph();
+    void updateAttachmentTraffic();
 private:
     static Engine* _engineInstance;
     std::unique_ptr<VulkanInstance> _vulkanInstance;
-    CommandsType _commandsType = CommandsType::MainPass;
     std::unique_ptr<MaterialManager> _materialManager;
     std::unique_ptr<SceneManager> _sceneManager;
     std::unique_ptr<MeshManager> _meshManager;
@@ -105,6 +142,11 @@ private:
     std::unique_ptr<FontManager> _fontManager;
     std::unique_ptr<OverlayManager> _overlayManager;
     std::unique_ptr<PipelineCacheManager> _pipelineCacheManager;
+    std::unique_ptr<RenderList> _renderList;
+    std::unique_ptr<CommandsRecorder> _commandsRecorder;
+    std::unique_ptr<AnimationUpdater> _animationUpdater;
+    std::unique_ptr<VulkanInstanceCulling> _instanceCulling;
+    std::unique_ptr<RenderGraph> _renderGraph;
 
     std::chrono::high_resolution_clock::time_point _startTime = std::chrono::high_resolution_clock::now();
     std::chrono::high_resolution_clock::time_point _currentTime = std::chrono::high_resolution_clock::now();
@@ -112,6 +154,13 @@ private:
     float _duration;
     float _deltaTime;
     uint64_t _frameId = 0;
+    std::unique_ptr<FrameStats> _frameStats;
+    std::unique_ptr<FrameStats> _lastFrameStats;
+    UniformDataList _uniformDataList;
+
+    // benchmarks and reports enabled in settings
+    std::vector<std::unique_ptr<FrameBenchmark>> _frameBenchmarks;
+    uint32_t _animationPhaseBuckets = 0;
 
     bool _isFirstRun = false;
 };
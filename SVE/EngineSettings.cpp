@@ -9,5 +9,6 @@ namespace SVE
 
 const int EngineSettings::BEST_GPU_AVAILABLE = -1;
 const int EngineSettings::BEST_MSAA_AVAILABLE = -1;
+const int EngineSettings::BEST_THREADS_AVAILABLE = -1;
 
 } // namespace SVE
\ No newline at end of file
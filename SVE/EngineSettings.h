@@ -29,9 +29,78 @@ struct EngineSettings
     bool initWater = false;
     bool useCascadeShadowMap = false;
     bool particlesEnabled = true;
+    bool useFrustumCulling = true;
+    // threads used to record command buffers, 1 - record everything on main thread
+    int recordingThreads = BEST_THREADS_AVAILABLE;
+    // measure frame CPU time with different recording threads count and print results
+    bool benchmarkRecording = false;
+    // size of uniform arena block (per swapchain image), new blocks are added when it's full
+    uint32_t uniformArenaBlockSize = 4 * 1024 * 1024;
+    // GPU-local block for vertices and indices of meshes, bigger meshes get their own block
+    uint32_t geometryArenaBlockSize = 16 * 1024 * 1024;
+    // print material instances, descriptor pools, geometry and VMA usage when free resources are released (level end)
+    bool reportFreeResources = false;
+    // max instanced entities per frame, their model matrices are stored in shared transform buffer
+    uint32_t maxInstanceTransforms = 20000;
+    // cull instance batches with compute shader and draw them with indirect draw calls (one multi draw call
+    // per material bucket if multiDrawIndirect is supported). SceneRunner gpu-culling compares it with CPU
+    // culling, but it hasn't been run on a device yet, so GPU culling is unverified
+    bool useGpuCulling = false;
+    uint32_t maxGpuCulledBatches = 1024;
+    // compare GPU culling results with CPU culling and print mismatches (slow, debug only)
+    bool validateGpuCulling = false;
+    // global texture array for shaders with useBindlessTextures (needs VK_EXT_descriptor_indexing,
+    // materials fall back to shader bindlessFallback if it's not supported)
+    bool useBindlessTextures = false;
+    uint32_t maxBindlessTextures = 4096;
+    // print render graph passes, dependencies and submit batches when it's recompiled
+    bool dumpRenderGraph = false;
+    // render screen quad Normal, MRT and Late stages as subpasses of a single render pass
+    bool mergeScreenQuadPasses = true;
+    // print estimated attachment load/store bytes per frame for separate and merged screen quad passes
+    bool reportAttachmentTraffic = false;
+    // send all frame passes with single vkQueueSubmit, otherwise each pass is submitted separately
+    bool batchQueueSubmits = true;
+    // measure submit CPU time with batched and separate queue submits and print results
+    bool benchmarkQueueSubmits = false;
+    // run particles and GPU culling compute on separate compute queue family (if GPU has one), so it overlaps
+    // with graphics passes which don't use compute results
+    bool useAsyncCompute = true;
+    // write GPU timestamps around compute and graphics work, print compute time and its overlap with graphics
+    bool profileAsyncCompute = false;
+    // copy uploaded buffers and textures on separate transfer queue family (if GPU has one)
+    bool useTransferQueue = true;
+    // persistently mapped staging memory for uploads, larger uploads get their own staging buffer
+    uint32_t uploadRingSize = 32 * 1024 * 1024;
+    // print uploaded bytes and time from first upload to GPU completion, when all pending uploads are finished
+    bool reportUploads = false;
+    // store mesh normals, colors, texture coordinates and skin data in 8/16 bit vertex formats
+    bool useCompactVertices = true;
+    // print geometry size of each created mesh compared to full float layout
+    bool reportMeshMemory = false;
+    // print vertex cache statistics of meshes optimized on load (generated and imported ones, baked meshes are
+    // optimized by MeshBaker)
+    bool reportMeshOptimization = false;
+    // load meshes from .smesh files made by MeshBaker (BakeMeshes build target) when they exist and are up to date,
+    // instead of importing source files
+    bool useBakedMeshes = true;
+    // print load time of each mesh file
+    bool reportMeshLoading = false;
+    // entities of the same skeletal mesh playing the same clip at the same time share evaluated pose,
+    // clip time is quantized to animationTimeStep seconds
+    bool shareAnimationPoses = true;
+    float animationTimeStep = 0.004f;
+    // snap animation time to this number of phases per clip, so entities with time offsets share poses too
+    // (lower animation quality, 0 - off)
+    uint32_t animationPhaseBuckets = 0;
+    // threads evaluating skeletal animation poses, 1 - evaluate on main thread
+    int animationThreads = BEST_THREADS_AVAILABLE;
+    // print skeletal entities count, pose cache hit rate and bones update CPU time periodically
+    bool reportAnimation = false;
 
     static const int BEST_GPU_AVAILABLE;
     static const int BEST_MSAA_AVAILABLE;
+    static const int BEST_THREADS_AVAILABLE;
 };
 
 } // namespace SVE
\ No newline at end of file
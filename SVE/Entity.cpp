@@ -6,6 +6,7 @@
 #include "Entity.h"
 #include "SceneNode.h"
 #include "Engine.h"
+#include "ShaderSettings.h"
 
 namespace SVE
 {
@@ -73,6 +74,21 @@ void Entity::setCustomData(glm::mat4 data)
     _customMat4 = data;
 }
 
+PassMask Entity::getPassMask() const
+{
+    return AllPassesMask;
+}
+
+const BoundingBox* Entity::getBoundingBox() const
+{
+    return nullptr;
+}
+
+uint32_t Entity::getExternalTextureMask() const
+{
+    return 0;
+}
+
 bool Entity::isComputeEntity() const
 {
     return false;
@@ -88,7 +104,53 @@ MaterialInfo* Entity::getMaterialInfo()
     return nullptr;
 }
 
-void Entity::updateInstanceBuffers()
+bool InstanceBatchKey::operator==(const InstanceBatchKey& other) const
+{
+    return mesh == other.mesh && isSameBucket(other);
+}
+
+bool InstanceBatchKey::isSameBucket(const InstanceBatchKey& other) const
+{
+    if (material != other.material || passMask != other.passMask || geometryBlock != other.geometryBlock
+        || indexSize != other.indexSize)
+        return false;
+    if (materialInfo == other.materialInfo)
+        return true;
+
+    return materialInfo && other.materialInfo
+           && materialInfo->ambient == other.materialInfo->ambient
+           && materialInfo->diffuse == other.materialInfo->diffuse
+           && materialInfo->specular == other.materialInfo->specular
+           && materialInfo->shininess == other.materialInfo->shininess
+           && materialInfo->ignoreShadow == other.materialInfo->ignoreShadow;
+}
+
+InstanceBatchKey Entity::getInstanceBatchKey() const
+{
+    return { this, nullptr };
+}
+
+void Entity::setInstanceBatch(uint32_t batchIndex, uint32_t firstInstance, uint32_t instanceCount)
+{
+    // do nothing
+}
+
+void Entity::setCulledInstanceBatch(uint32_t batchIndex, uint32_t firstInstance) const
+{
+    // do nothing
+}
+
+void Entity::setCulledInstanceBucket(uint32_t firstBatch, uint32_t batchCount)
+{
+    // do nothing
+}
+
+void Entity::prepareAnimation(AnimationUpdater& animationUpdater)
+{
+    // do nothing
+}
+
+void Entity::skipUniformsUpdate() const
 {
     // do nothing
 }
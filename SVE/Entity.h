@@ -12,9 +12,32 @@ namespace SVE
 struct UniformData;
 class SceneNode;
 struct MaterialInfo;
+struct BoundingBox;
+class AnimationUpdater;
 enum class CommandsType : uint8_t;
 
 using UniformDataList = std::vector<std::shared_ptr<UniformData>>;
+// Bit per CommandsType value
+using PassMask = uint16_t;
+static const PassMask AllPassesMask = 0xFFFF;
+
+// Instance rendering entities with equal keys are drawn with a single instanced draw call
+struct InstanceBatchKey
+{
+    const void* mesh = nullptr;
+    const void* material = nullptr;
+    // batch is drawn with material instance of one of its entities, so their material info should be equal
+    const MaterialInfo* materialInfo = nullptr;
+    // filled by render list, entities of the batch are drawn in the same passes
+    PassMask passMask = 0;
+    // batches of different meshes from the same geometry block can be drawn by one multi draw indirect call
+    uint32_t geometryBlock = 0;
+    uint32_t indexSize = 0;
+
+    bool operator==(const InstanceBatchKey& other) const;
+    // Batches can be drawn together (everything except mesh is equal)
+    bool isSameBucket(const InstanceBatchKey& other) const;
+};
 
 // Base class for entities that can be attached to scene nodes
 class Entity : public std::enable_shared_from_this<Entity>
@@ -44,13 +67,33 @@ public:
 
     virtual bool isComputeEntity() const;
     virtual bool isInstanceRendering() const;
+    virtual InstanceBatchKey getInstanceBatchKey() const;
+    // Set before recording for every entity of the batch, any of them can draw all batch instances
+    // (render list keeps one of them per pass)
+    virtual void setInstanceBatch(uint32_t batchIndex, uint32_t firstInstance, uint32_t instanceCount);
+    // Called for one entity of every batch culled on GPU, sets up its indirect draw
+    virtual void setCulledInstanceBatch(uint32_t batchIndex, uint32_t firstInstance) const;
+    // Called for every entity of the batch. Adjacent GPU culled batches sharing material and geometry block
+    // form a bucket, which is drawn from its first batch by one multi draw call in culled passes.
+    // Batch count is 0 if the batch isn't culled on GPU.
+    virtual void setCulledInstanceBucket(uint32_t firstBatch, uint32_t batchCount);
+    // Passes this entity produces draw commands for (checked once per frame on scene extraction)
+    virtual PassMask getPassMask() const;
+    // Local space bounds used for culling, nullptr if entity shouldn't be culled
+    virtual const BoundingBox* getBoundingBox() const;
+    // Bit per TextureType of render target textures sampled when drawing (used to order and cull passes)
+    virtual uint32_t getExternalTextureMask() const;
 
     virtual void setMaterial(const std::string& materialName);
     virtual void setMaterialInfo(const MaterialInfo& materialInfo);
     virtual MaterialInfo* getMaterialInfo();
 
-    virtual void updateUniforms(UniformDataList uniformDataList) const = 0;
-    virtual void updateInstanceBuffers();
+    // Called before uniforms update on main thread in scene order, skeletal entities add their bones evaluation
+    // to animation phase, which results are read in updateUniforms
+    virtual void prepareAnimation(AnimationUpdater& animationUpdater);
+    virtual void updateUniforms(const UniformDataList& uniformDataList) const = 0;
+    // Called instead of updateUniforms when entity isn't drawn this frame (e.g. its batch is drawn by another entity)
+    virtual void skipUniformsUpdate() const;
     virtual void applyDrawingCommands(uint32_t bufferIndex, uint32_t imageIndex) const = 0;
 
     virtual void subscribeToAttachment(const std::string& name);
@@ -24,6 +24,32 @@ public:
 using FSEntityList = std::vector<std::shared_ptr<FileSystemEntity>>;
 using FSEntityPtr = std::shared_ptr<FileSystemEntity>;
 
+// Read-only file data, valid while the object is alive
+class FileContent
+{
+public:
+    virtual ~FileContent() = default;
+
+    virtual const char* getData() const = 0;
+    virtual size_t getSize() const = 0;
+};
+
+using FileContentPtr = std::shared_ptr<FileContent>;
+
+class LoadedFileContent : public FileContent
+{
+public:
+    explicit LoadedFileContent(std::string content)
+        : _content(std::move(content))
+    {}
+
+    const char* getData() const override { return _content.data(); }
+    size_t getSize() const override { return _content.size(); }
+
+private:
+    std::string _content;
+};
+
 class FileSystem
 {
 public:
@@ -33,6 +59,11 @@ public:
     virtual FSEntityPtr getContainingDirectory(FSEntityPtr file) const = 0;
     virtual FSEntityList getFileList(FSEntityPtr dir) const = 0;
     virtual std::string getFileContent(FSEntityPtr file) const = 0;
+    // Maps file to memory, file systems without mapping support load its content
+    virtual FileContentPtr mapFileContent(FSEntityPtr file) const
+    {
+        return std::make_shared<LoadedFileContent>(getFileContent(file));
+    }
     virtual std::string getSavePath() const = 0;
 
     virtual FSEntityPtr getEntity(const std::string& localPath, bool isDirectory = false) const = 0;
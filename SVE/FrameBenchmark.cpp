@@ -0,0 +1,108 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+
+#include "FrameBenchmark.h"
+
+namespace SVE
+{
+
+namespace
+{
+
+const uint32_t WarmupFrames = 30;
+const uint32_t MeasuredFrames = 300;
+
+// frameId, recordingThreads and vmaAllocationCount aren't summed, the last frame values are kept
+void addFrameStats(FrameStats& sum, const FrameStats& frameStats)
+{
+    sum.frameId = frameStats.frameId;
+    sum.cpuTime += frameStats.cpuTime;
+    sum.recordingThreads = frameStats.recordingThreads;
+    sum.worldTransformUpdates += frameStats.worldTransformUpdates;
+    sum.instancedEntityCount += frameStats.instancedEntityCount;
+    sum.instanceBatchCount += frameStats.instanceBatchCount;
+    sum.skippedInstanceCount += frameStats.skippedInstanceCount;
+    sum.gpuCulledBatchCount += frameStats.gpuCulledBatchCount;
+    sum.gpuCulledBucketCount += frameStats.gpuCulledBucketCount;
+    sum.gpuCullingMismatches += frameStats.gpuCullingMismatches;
+    sum.gpuCullingValidatedBatches += frameStats.gpuCullingValidatedBatches;
+    sum.uniformBytesWritten += frameStats.uniformBytesWritten;
+    sum.vmaAllocationCount = frameStats.vmaAllocationCount;
+    sum.meshVertexBindings += frameStats.meshVertexBindings;
+    sum.heapAllocations += frameStats.heapAllocations;
+    sum.uniformUpdateAllocations += frameStats.uniformUpdateAllocations;
+    sum.renderGraphDependencies += frameStats.renderGraphDependencies;
+    sum.renderGraphCulledPasses += frameStats.renderGraphCulledPasses;
+    sum.renderGraphBarriers += frameStats.renderGraphBarriers;
+    sum.renderGraphLayoutTransitions += frameStats.renderGraphLayoutTransitions;
+    sum.renderGraphAliasedImages += frameStats.renderGraphAliasedImages;
+    sum.attachmentLoadBytes += frameStats.attachmentLoadBytes;
+    sum.attachmentStoreBytes += frameStats.attachmentStoreBytes;
+    sum.queueSubmits += frameStats.queueSubmits;
+    sum.submitBatches += frameStats.submitBatches;
+    sum.submitTime += frameStats.submitTime;
+    sum.computeGpuTime += frameStats.computeGpuTime;
+    sum.computeOverlapTime += frameStats.computeOverlapTime;
+    sum.animatedEntityCount += frameStats.animatedEntityCount;
+    sum.animationPoseEvaluations += frameStats.animationPoseEvaluations;
+    sum.animationTime += frameStats.animationTime;
+    for (auto i = 0u; i < PassCount; i++)
+    {
+        sum.drawCount[i] += frameStats.drawCount[i];
+        sum.culledDrawCount[i] += frameStats.culledDrawCount[i];
+    }
+}
+
+} // anon namespace
+
+FrameBenchmark::FrameBenchmark(uint32_t stepCount, StepFunc stepFunc, ReportFunc reportFunc)
+    : _stepCount(stepCount)
+    , _stepFunc(std::move(stepFunc))
+    , _reportFunc(std::move(reportFunc))
+{
+}
+
+FrameBenchmark::FrameBenchmark(ReportFunc reportFunc)
+    : FrameBenchmark(0, nullptr, std::move(reportFunc))
+{
+}
+
+void FrameBenchmark::update(const FrameStats& frameStats)
+{
+    if (isFinished())
+        return;
+
+    if (_frame == 0 && _stepFunc)
+        _stepFunc(_step);
+
+    ++_frame;
+    if (_frame <= WarmupFrames)
+        return;
+
+    addFrameStats(_sum, frameStats);
+    if (_frame < WarmupFrames + MeasuredFrames)
+        return;
+
+    _reportFunc(_step, _sum, MeasuredFrames);
+    _sum = {};
+
+    if (_stepCount == 0)
+    {
+        // periodic report doesn't need warmup again
+        _frame = WarmupFrames;
+        return;
+    }
+
+    _frame = 0;
+    ++_step;
+    if (_step == _stepCount && _stepFunc)
+        _stepFunc(_step);
+}
+
+bool FrameBenchmark::isFinished() const
+{
+    return _stepCount > 0 && _step >= _stepCount;
+}
+
+} // namespace SVE
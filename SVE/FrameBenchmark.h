@@ -0,0 +1,38 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include "FrameStats.h"
+#include <functional>
+
+namespace SVE
+{
+
+// Sums stats of rendered frames after warmup and reports them. Benchmark can go through several steps (e.g.
+// recording threads count), each step is measured separately. Benchmark without steps reports periodically.
+class FrameBenchmark
+{
+public:
+    // Called before step is measured, and with step count when all steps are finished
+    using StepFunc = std::function<void(uint32_t step)>;
+    // Counters and times in sum are added up over frameCount frames
+    using ReportFunc = std::function<void(uint32_t step, const FrameStats& sum, uint32_t frameCount)>;
+
+    FrameBenchmark(uint32_t stepCount, StepFunc stepFunc, ReportFunc reportFunc);
+    explicit FrameBenchmark(ReportFunc reportFunc);
+
+    void update(const FrameStats& frameStats);
+    // All steps are measured (benchmark without steps is never finished)
+    bool isFinished() const;
+
+private:
+    uint32_t _stepCount;
+    StepFunc _stepFunc;
+    ReportFunc _reportFunc;
+
+    uint32_t _step = 0;
+    uint32_t _frame = 0;
+    FrameStats _sum;
+};
+
+} // namespace SVE
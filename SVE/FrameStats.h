@@ -0,0 +1,85 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include "Engine.h"
+
+namespace SVE
+{
+
+// Per-frame counters, collected during frame and available after it's rendered
+struct FrameStats
+{
+    uint64_t frameId = 0;
+    // milliseconds spent on CPU to prepare and submit frame (without waiting for swapchain image)
+    float cpuTime = 0;
+    uint32_t recordingThreads = 0;
+
+    uint32_t worldTransformUpdates = 0;
+    // instanced entities and draw calls they are batched to
+    uint32_t instancedEntityCount = 0;
+    uint32_t instanceBatchCount = 0;
+    // instances which didn't fit into transform buffer (maxInstanceTransforms) and weren't drawn
+    uint32_t skippedInstanceCount = 0;
+    // batches culled on GPU and indirect draw calls they are drawn with in every culled pass
+    uint32_t gpuCulledBatchCount = 0;
+    uint32_t gpuCulledBucketCount = 0;
+    // batches with different GPU and CPU culling results and all compared batches, counted only if
+    // validateGpuCulling is set
+    uint32_t gpuCullingMismatches = 0;
+    uint32_t gpuCullingValidatedBatches = 0;
+
+    // bytes copied to uniform arena by materials
+    uint64_t uniformBytesWritten = 0;
+    // live VMA allocations at the end of frame
+    uint32_t vmaAllocationCount = 0;
+    // vertex buffers bound by mesh draws (vertex stream and skin stream)
+    uint32_t meshVertexBindings = 0;
+    // heap allocations, counted only if engine is built with SVE_COUNT_ALLOCATIONS
+    uint64_t heapAllocations = 0;
+    uint64_t uniformUpdateAllocations = 0;
+
+    // resource dependencies between passes and passes skipped by render graph
+    uint32_t renderGraphDependencies = 0;
+    uint32_t renderGraphCulledPasses = 0;
+    // barriers and layout transitions derived by render graph (not recorded yet, see RenderGraph),
+    // and transient images which could share memory with other ones
+    uint32_t renderGraphBarriers = 0;
+    uint32_t renderGraphLayoutTransitions = 0;
+    uint32_t renderGraphAliasedImages = 0;
+    // estimated render pass attachments loads and stores from main memory
+    uint64_t attachmentLoadBytes = 0;
+    uint64_t attachmentStoreBytes = 0;
+
+    // vkQueueSubmit calls, batches of passes chained by semaphores, and milliseconds spent submitting
+    uint32_t queueSubmits = 0;
+    uint32_t submitBatches = 0;
+    float submitTime = 0;
+    // GPU milliseconds of compute work and its part overlapped with graphics work, measured only if
+    // profileAsyncCompute is set (values are from the frame which used the same frame in flight slot before)
+    float computeGpuTime = 0;
+    float computeOverlapTime = 0;
+
+    // skeletal entities updated, poses evaluated for them (others reused poses cached in the same frame)
+    // and milliseconds spent in animation phase
+    uint32_t animatedEntityCount = 0;
+    uint32_t animationPoseEvaluations = 0;
+    float animationTime = 0;
+
+    // per CommandsType
+    uint32_t drawCount[PassCount] = {};
+    uint32_t culledDrawCount[PassCount] = {};
+};
+
+// Engine resources alive, they shouldn't grow between levels when free resources are released
+struct ResourceUsage
+{
+    uint32_t materialInstances = 0;
+    uint32_t descriptorPools = 0;
+    uint32_t geometrySlots = 0;
+    uint32_t geometryBlocks = 0;
+    uint32_t vmaAllocations = 0;
+    uint64_t vmaUsedBytes = 0;
+};
+
+} // namespace SVE
@@ -0,0 +1,73 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#include "Frustum.h"
+
+namespace SVE
+{
+
+Frustum::Frustum(const glm::mat4& viewProjection)
+{
+    auto row0 = glm::vec4(viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0]);
+    auto row1 = glm::vec4(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1]);
+    auto row2 = glm::vec4(viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2]);
+    auto row3 = glm::vec4(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+
+    _planes[0] = row3 + row0; // left
+    _planes[1] = row3 - row0; // right
+    _planes[2] = row3 + row1; // bottom
+    _planes[3] = row3 - row1; // top
+    _planes[4] = row2;        // near
+    _planes[5] = row3 - row2; // far
+}
+
+bool Frustum::isVisible(const BoundingBox& boundingBox) const
+{
+    for (const auto& plane : _planes)
+    {
+        // check box corner, which is the farthest along the plane normal
+        glm::vec3 corner(
+                plane.x >= 0 ? boundingBox.max.x : boundingBox.min.x,
+                plane.y >= 0 ? boundingBox.max.y : boundingBox.min.y,
+                plane.z >= 0 ? boundingBox.max.z : boundingBox.min.z);
+        if (glm::dot(glm::vec3(plane), corner) + plane.w < 0)
+            return false;
+    }
+
+    return true;
+}
+
+const glm::vec4* Frustum::getPlanes() const
+{
+    return _planes;
+}
+
+bool isVisible(const CullingVolume& cullingVolume, const BoundingBox& boundingBox)
+{
+    for (const auto& frustum : cullingVolume)
+    {
+        if (frustum.isVisible(boundingBox))
+            return true;
+    }
+
+    return false;
+}
+
+BoundingBox transformBoundingBox(const BoundingBox& boundingBox, const glm::mat4& transform)
+{
+    // Arvo's method: transformed extents are sums of min/max of each matrix column contribution
+    BoundingBox result;
+    result.min = glm::vec3(transform[3]);
+    result.max = result.min;
+    for (auto i = 0; i < 3; i++)
+    {
+        auto a = glm::vec3(transform[i]) * boundingBox.min[i];
+        auto b = glm::vec3(transform[i]) * boundingBox.max[i];
+        result.min += glm::min(a, b);
+        result.max += glm::max(a, b);
+    }
+
+    return result;
+}
+
+} // namespace SVE
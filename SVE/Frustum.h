@@ -0,0 +1,32 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include "Libs.h"
+#include "MeshDefs.h"
+#include <vector>
+
+namespace SVE
+{
+
+class Frustum
+{
+public:
+    // Planes are extracted from view-projection matrix (with depth range [0, 1])
+    explicit Frustum(const glm::mat4& viewProjection);
+
+    bool isVisible(const BoundingBox& boundingBox) const;
+    // left, right, bottom, top, near, far (not normalized)
+    const glm::vec4* getPlanes() const;
+
+private:
+    glm::vec4 _planes[6];
+};
+
+// Culling volume is visible if any of its frustums is visible (cascades, point light cube faces)
+using CullingVolume = std::vector<Frustum>;
+
+bool isVisible(const CullingVolume& cullingVolume, const BoundingBox& boundingBox);
+BoundingBox transformBoundingBox(const BoundingBox& boundingBox, const glm::mat4& transform);
+
+} // namespace SVE
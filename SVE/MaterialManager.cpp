@@ -4,6 +4,7 @@
 
 #include "MaterialManager.h"
 #include "VulkanException.h"
+#include "VulkanMaterial.h"
 namespace SVE
 {
 
@@ -24,6 +25,28 @@ Material* SVE::MaterialManager::getMaterial(const std::string& name, bool emptyA
     return materialIter->second.get();
 }
 
+Material* MaterialManager::getInstancedMaterial(Material* material)
+{
+    auto* vulkanMaterial = material->getVulkanMaterial();
+    if (vulkanMaterial->isInstanced())
+        return material;
+
+    auto vertexShaderName = vulkanMaterial->getInstancedVertexShaderName();
+    if (vertexShaderName.empty())
+        return nullptr;
+
+    auto name = material->getName() + "Instanced";
+    if (auto* instancedMaterial = getMaterial(name, true))
+        return instancedMaterial->getVulkanMaterial()->isInstanced() ? instancedMaterial : nullptr;
+
+    auto materialSettings = vulkanMaterial->getSettings();
+    materialSettings.name = name;
+    materialSettings.vertexShaderName = vertexShaderName;
+    auto instancedMaterial = std::make_shared<Material>(materialSettings);
+    registerMaterial(instancedMaterial);
+    return instancedMaterial.get();
+}
+
 void MaterialManager::resetPipelines()
 {
     for (auto& material : _materialMap)
@@ -40,5 +63,23 @@ void MaterialManager::resetDescriptors()
     }
 }
 
+void MaterialManager::releaseFreeInstances()
+{
+    for (auto& material : _materialMap)
+    {
+        material.second->getVulkanMaterial()->releaseFreeInstances();
+    }
+}
+
+uint32_t MaterialManager::getUsedInstanceCount() const
+{
+    uint32_t count = 0;
+    for (auto& material : _materialMap)
+    {
+        count += material.second->getVulkanMaterial()->getUsedInstanceCount();
+    }
+    return count;
+}
+
 
 } // namespace SVE
\ No newline at end of file
@@ -14,9 +14,14 @@ class MaterialManager
 public:
     void registerMaterial(std::shared_ptr<Material> material);
     Material* getMaterial(const std::string& name, bool emptyAllowed = false) const;
+    // Material with instanced variant of vertex shader (registered as <name>Instanced on first use, unless material
+    // with this name is loaded), or nullptr if material can't be drawn instanced. Instanced material is returned as is.
+    Material* getInstancedMaterial(Material* material);
 
     void resetPipelines();
     void resetDescriptors();
+    void releaseFreeInstances();
+    uint32_t getUsedInstanceCount() const;
 
 private:
     std::unordered_map<std::string, std::shared_ptr<Material>> _materialMap;
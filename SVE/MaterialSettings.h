@@ -91,9 +91,7 @@ struct MaterialSettings
     bool useMultisampling = true;
     bool useAlphaBlending = false;
     bool useMRT = false;
-    bool useInstancing = false;
     bool ignoreShadow = true;
-    uint32_t instanceMaxCount = 0;
     BlendFactor srcBlendFactor = BlendFactor::SrcAlpha;
     BlendFactor dstBlendFactor = BlendFactor::OneMinusSrcAlpha;
     MaterialCullFace cullFace = MaterialCullFace::FrontFace;
@@ -2,6 +2,12 @@
 // Copyright (c) 2018-2019, Igor Barinov
 // Licensed under the MIT License
 #include "Mesh.h"
+#include "MeshBaker.h"
+#include "MeshOptimizer.h"
+#include "SkeletalAnimation.h"
+#include "AnimationPoseCache.h"
+#include "AnimationUpdater.h"
+#include "FrameStats.h"
 #include "VulkanMesh.h"
 #include "VulkanException.h"
 #include "ShaderSettings.h"
@@ -10,9 +16,9 @@
 
 #include <stack>
 #include <set>
-#include <assimp/Importer.hpp>
-#include <assimp/scene.h>
-#include <assimp/postprocess.h>
+#include <iostream>
+#include <chrono>
+#include <algorithm>
 
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtc/matrix_transform.hpp>
@@ -36,139 +42,88 @@ std::string fixAssimpBoneName(std::string nodeName)
     return nodeName;
 }
 
+// Welds vertices and reorders triangles and vertices for vertex cache and overdraw
+MeshSettings optimizeMeshSettings(MeshSettings meshSettings)
+{
+    if (meshSettings.isOptimized)
+        return meshSettings;
+
+    auto stats = optimizeMesh(meshSettings);
+    meshSettings.isOptimized = true;
+    if (Engine::getInstance()->getEngineSettings().reportMeshOptimization)
+    {
+        std::cout << "Mesh " << meshSettings.name << " optimized: vertices " << stats.originalVertexCount << " -> "
+                  << stats.vertexCount << ", ACMR " << stats.originalAcmr << " -> " << stats.acmr
+                  << ", ATVR " << stats.originalAtvr << " -> " << stats.atvr << std::endl;
+    }
+    return meshSettings;
+}
+
 } // anon namespace
 
 Mesh::Mesh(MeshSettings meshSettings)
     : _name(meshSettings.name)
     , _materialName(meshSettings.materialName)
     , _isAnimated(meshSettings.boneNum > 0 && meshSettings.animation->animations != nullptr)
-    , _vulkanMesh(std::make_unique<VulkanMesh>(std::move(meshSettings)))
+    , _boundingBox(calculateBoundingBox(meshSettings))
+    , _vulkanMesh(std::make_unique<VulkanMesh>(optimizeMeshSettings(std::move(meshSettings))))
 {
-
+    if (_isAnimated)
+        createAnimation();
 }
 
 Mesh::Mesh(MeshLoadSettings meshLoadSettings)
     : _name(meshLoadSettings.name)
 {
-    MeshSettings meshSettings {};
+    auto startTime = std::chrono::high_resolution_clock::now();
+    auto* resourceManager = Engine::getInstance()->getResourceManager();
+    const auto& engineSettings = Engine::getInstance()->getEngineSettings();
 
-    //Assimp::Importer importer;
-    meshSettings.animation = std::make_shared<AnimationSettings>();
-    meshSettings.animationSpeed = meshLoadSettings.animationSpeed;
-    auto& importer = meshSettings.animation->importer;
-
-    std::map<std::string, uint32_t> boneMap;
-
-    auto fileContent = Engine::getInstance()->getResourceManager()->loadFileContent(meshLoadSettings.filename);
-    const aiScene* scene = importer.ReadFileFromMemory(
-            fileContent.data(), fileContent.size(),
-            aiProcess_CalcTangentSpace       |
-            aiProcess_Triangulate            |
-            aiProcess_JoinIdenticalVertices  |
-            aiProcess_TransformUVCoords      |
-            aiProcess_LimitBoneWeights       |
-            aiProcess_OptimizeMeshes         |
-            aiProcess_SortByPType            |
-            aiProcess_OptimizeGraph);
-
-    // If the import failed, report it
-    if(!scene)
+    // source is hashed to check that baked mesh is up to date, mapping avoids copying it
+    MeshSettings meshSettings {};
+    auto sourceContent = resourceManager->mapFileContent(meshLoadSettings.filename);
+    auto bakedFilename = getBakedMeshFilename(meshLoadSettings.filename);
+    auto isBaked = engineSettings.useBakedMeshes && resourceManager->isFileExist(bakedFilename);
+    if (isBaked)
     {
-        throw VulkanException( importer.GetErrorString());
+        auto content = resourceManager->mapFileContent(bakedFilename);
+        auto sourceHash = getMeshSourceHash(sourceContent->getData(), sourceContent->getSize());
+        isBaked = loadBakedMesh(content->getData(), content->getSize(), meshLoadSettings, sourceHash, meshSettings);
+        if (!isBaked)
+            std::cout << "Baked mesh " << bakedFilename << " is outdated, importing " << meshLoadSettings.filename << std::endl;
     }
-
-    meshSettings.name = meshLoadSettings.name;
-    aiString materialName;
-    scene->mMaterials[0]->Get(AI_MATKEY_NAME, materialName);
-
-    meshSettings.materialName = materialName.C_Str();
-    _materialName = meshSettings.materialName;
-
-    // TODO: Support multiple meshes (only 1 currently will work)
-    for (auto i = 0u; i < scene->mNumMeshes; i++)
+    if (!isBaked)
     {
-        const auto* mesh = scene->mMeshes[i];
-        meshSettings.vertexPosData.reserve(mesh->mNumVertices);
-        meshSettings.vertexColorData.reserve(mesh->mNumVertices);
-        meshSettings.vertexTexData.reserve(mesh->mNumVertices);
-        meshSettings.vertexNormalData.reserve(mesh->mNumVertices);
-        meshSettings.vertexBinormalData.reserve(mesh->mNumVertices);
-        meshSettings.vertexTangentData.reserve(mesh->mNumVertices);
-        for (auto v = 0u; v < mesh->mNumVertices; v++)
-        {
-            if (meshLoadSettings.switchYZ)
-            {
-                meshSettings.vertexPosData.emplace_back(mesh->mVertices[v].x, mesh->mVertices[v].z, mesh->mVertices[v].y);
-                meshSettings.vertexPosData.back() *= meshLoadSettings.scale;
-                meshSettings.vertexColorData.emplace_back(1.0f, 1.0f, 1.0f);
-                meshSettings.vertexTexData.emplace_back(mesh->mTextureCoords[0][v].x, 1.0f - mesh->mTextureCoords[0][v].y);
-                meshSettings.vertexNormalData.emplace_back(mesh->mNormals[v].x, mesh->mNormals[v].z, mesh->mNormals[v].y);
-                meshSettings.vertexBinormalData.emplace_back(mesh->mBitangents[v].x, mesh->mBitangents[v].z, mesh->mBitangents[v].y);
-                meshSettings.vertexTangentData.emplace_back(mesh->mTangents[v].x, mesh->mTangents[v].z, mesh->mTangents[v].y);
-            } else {
-                meshSettings.vertexPosData.emplace_back(mesh->mVertices[v].x, mesh->mVertices[v].y, mesh->mVertices[v].z);
-                meshSettings.vertexPosData.back() *= meshLoadSettings.scale;
-                meshSettings.vertexColorData.emplace_back(1.0f, 1.0f, 1.0f);
-                meshSettings.vertexTexData.emplace_back(mesh->mTextureCoords[0][v].x, 1.0f - mesh->mTextureCoords[0][v].y);
-                meshSettings.vertexNormalData.emplace_back(mesh->mNormals[v].x, mesh->mNormals[v].y, mesh->mNormals[v].z);
-                meshSettings.vertexBinormalData.emplace_back(mesh->mBitangents[v].x, mesh->mBitangents[v].y, mesh->mBitangents[v].z);
-                meshSettings.vertexTangentData.emplace_back(mesh->mTangents[v].x, mesh->mTangents[v].y, mesh->mTangents[v].z);
-            }
-        }
-        meshSettings.indexData.reserve(meshSettings.indexData.size() + mesh->mNumFaces * 3);
-        for (auto f = 0u; f < mesh->mNumFaces; f++)
-        {
-            for (auto index = 0u; index < mesh->mFaces[f].mNumIndices; index++)
-            {
-                meshSettings.indexData.push_back(mesh->mFaces[f].mIndices[index]);
-            }
-        }
-
-        if (mesh->mNumBones > 0)
-        {
-            meshSettings.boneNum = mesh->mNumBones;
-            meshSettings.vertexBoneIndexData.resize(mesh->mNumVertices);
-            meshSettings.vertexBoneWeightData.resize(mesh->mNumVertices);
-            meshSettings.animation->boneOffset.resize(mesh->mNumBones);
-
-            for (auto r = 0u; r < mesh->mNumBones; r++)
-            {
-                auto* boneInfo = mesh->mBones[r];
-                boneMap[boneInfo->mName.C_Str()] = r;
-                meshSettings.animation->boneOffset[r] = boneInfo->mOffsetMatrix;
-                for (auto w = 0u; w < boneInfo->mNumWeights; w++)
-                {
-                    auto weight = boneInfo->mWeights[w];
-
-                    auto vID = weight.mVertexId;
-                    for (auto bi = 0u; bi < 4; bi++)
-                    {
-                        if (meshSettings.vertexBoneWeightData[vID][bi] < 0.01f)
-                        {
-                            meshSettings.vertexBoneIndexData[vID][bi] = r;
-                            meshSettings.vertexBoneWeightData[vID][bi] = weight.mWeight;
-                            break;
-                        }
-                    }
-                }
-            }
-        }
+        meshSettings = importMesh(meshLoadSettings, std::string(sourceContent->getData(), sourceContent->getSize()));
     }
 
-
-    _isAnimated = false;
-    if (scene->mNumAnimations > 0)
+    // materials from mesh description override imported ones, empty name keeps imported material
+    for (auto i = 0u; i < meshLoadSettings.submeshMaterials.size(); i++)
     {
-        meshSettings.animation->animations = scene->mAnimations;
-        meshSettings.animation->rootNode = scene->mRootNode;
-        meshSettings.animation->globalInverse = scene->mRootNode->mTransformation;
-        meshSettings.animation->globalInverse.Inverse();
-        meshSettings.animation->boneMap = boneMap;
-        _isAnimated = true;
+        const auto& materialName = meshLoadSettings.submeshMaterials[i];
+        if (materialName.empty())
+            continue;
+        if (i == 0)
+            meshSettings.materialName = materialName;
+        if (i < meshSettings.submeshes.size())
+            meshSettings.submeshes[i].materialName = materialName;
     }
+    auto submeshCount = std::max<size_t>(meshSettings.submeshes.size(), 1);
 
+    _materialName = meshSettings.materialName;
+    _isAnimated = meshSettings.animation->animations != nullptr;
+    _boundingBox = calculateBoundingBox(meshSettings);
+    _vulkanMesh = std::make_unique<VulkanMesh>(optimizeMeshSettings(std::move(meshSettings)));
+    if (_isAnimated)
+        createAnimation();
 
-    _vulkanMesh = std::make_unique<VulkanMesh>(std::move(meshSettings));
+    if (engineSettings.reportMeshLoading)
+    {
+        auto duration = std::chrono::duration<float, std::chrono::milliseconds::period>(
+                std::chrono::high_resolution_clock::now() - startTime).count();
+        std::cout << "Mesh " << _name << " loaded from " << (isBaked ? bakedFilename : meshLoadSettings.filename)
+                  << " in " << duration << " ms, " << submeshCount << " submesh(es)" << std::endl;
+    }
 }
 
 Mesh::~Mesh() = default;
@@ -188,15 +143,83 @@ VulkanMesh* Mesh::getVulkanMesh()
     return _vulkanMesh.get();
 }
 
-void Mesh::updateMesh(MeshSettings meshSettings)
+const BoundingBox* Mesh::getBoundingBox() const
 {
-    _vulkanMesh->updateMesh(std::move(meshSettings));
+    return &_boundingBox;
 }
 
-void Mesh::updateUniformDataBones(UniformData& data, float time, BonesAttachments& bonesAttachments)
+void Mesh::updateMesh(MeshSettings meshSettings)
 {
+    _boundingBox = calculateBoundingBox(meshSettings);
+    _vulkanMesh->updateMesh(optimizeMeshSettings(std::move(meshSettings)));
     if (_isAnimated)
-        data.bones = getAnimationTransforms(_vulkanMesh->getMeshSettings(), 0, time, bonesAttachments);
+        createAnimation();
+}
+
+void Mesh::prepareBones(float time,
+                        AnimationPose& pose,
+                        AnimationInstance& animationInstance,
+                        std::vector<glm::mat4>& bones,
+                        AnimationUpdater& animationUpdater)
+{
+    if (!_isAnimated)
+        return;
+
+    auto* engine = Engine::getInstance();
+    const auto& engineSettings = engine->getEngineSettings();
+    pose.frameId = engine->getFrameId();
+    pose.clip = 0;
+    pose.cachedPose = AnimationPose::NoCachedPose;
+
+    auto isEvaluated = true;
+    if (engineSettings.shareAnimationPoses)
+    {
+        pose.clipTime = _poseCache->getClipTime(
+                pose.clip, time, engineSettings.animationTimeStep, engine->getAnimationPhaseBuckets());
+        pose.cachedPose = _poseCache->addPose(pose.clip, pose.clipTime, pose.frameId, isEvaluated);
+        if (isEvaluated)
+            animationUpdater.addEvaluation(_poseCache.get(), pose.cachedPose);
+    }
+    else
+    {
+        pose.clipTime = _skeletalAnimation->getClipTime(pose.clip, time);
+    }
+
+    if (pose.cachedPose == AnimationPose::NoCachedPose)
+    {
+        isEvaluated = true;
+        animationUpdater.addEvaluation(_skeletalAnimation.get(), pose.clip, pose.clipTime, &animationInstance, &bones);
+    }
+
+    auto& frameStats = engine->getCurrentFrameStats();
+    ++frameStats.animatedEntityCount;
+    if (isEvaluated)
+        ++frameStats.animationPoseEvaluations;
+}
+
+const std::vector<glm::mat4>* Mesh::getBones(const AnimationPose& pose,
+                                             const AnimationInstance& animationInstance,
+                                             const std::vector<glm::mat4>& bones,
+                                             BonesAttachments& bonesAttachments) const
+{
+    if (!_isAnimated)
+        return nullptr;
+
+    if (pose.cachedPose != AnimationPose::NoCachedPose)
+    {
+        _poseCache->updateAttachments(pose.cachedPose, bonesAttachments);
+        return &_poseCache->getBones(pose.cachedPose);
+    }
+
+    if (!bonesAttachments.empty())
+        _skeletalAnimation->updateAttachments(animationInstance, bonesAttachments);
+    return &bones;
+}
+
+void Mesh::createAnimation()
+{
+    _skeletalAnimation = std::make_unique<SkeletalAnimation>(_vulkanMesh->getMeshSettings());
+    _poseCache = std::make_unique<AnimationPoseCache>(*_skeletalAnimation);
 }
 
 } // namespace SVE
\ No newline at end of file
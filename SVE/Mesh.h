@@ -8,7 +8,11 @@
 namespace SVE
 {
 class VulkanMesh;
-class UniformData;
+class SkeletalAnimation;
+class AnimationPoseCache;
+class AnimationUpdater;
+struct AnimationInstance;
+struct AnimationPose;
 
 class Mesh
 {
@@ -20,19 +24,39 @@ public:
     const std::string& getName() const;
     const std::string& getDefaultMaterialName() const;
     VulkanMesh* getVulkanMesh();
+    // Bounds in mesh space, for animated meshes they are padded bind pose bounds
+    const BoundingBox* getBoundingBox() const;
 
     void updateMesh(MeshSettings meshSettings);
 
     // TODO: this should be moved to something like Animation class
-    void updateUniformDataBones(UniformData& data, float time, BonesAttachments& bonesAttachments);
+    // Animation phase: selects entity pose for the time and adds its evaluation to updater, unless it's
+    // evaluated for another entity in this frame (own instance and bones are used if pose isn't shared)
+    void prepareBones(float time,
+                      AnimationPose& pose,
+                      AnimationInstance& animationInstance,
+                      std::vector<glm::mat4>& bones,
+                      AnimationUpdater& animationUpdater);
+    // Bones of the pose evaluated in animation phase (nullptr if mesh isn't animated), attachments are
+    // updated from the same pose
+    const std::vector<glm::mat4>* getBones(const AnimationPose& pose,
+                                           const AnimationInstance& animationInstance,
+                                           const std::vector<glm::mat4>& bones,
+                                           BonesAttachments& bonesAttachments) const;
+
+private:
+    void createAnimation();
 
 private:
     std::string _name;
     std::string _materialName;
 
     bool _isAnimated;
+    BoundingBox _boundingBox;
 
     std::unique_ptr<VulkanMesh> _vulkanMesh;
+    std::unique_ptr<SkeletalAnimation> _skeletalAnimation;
+    std::unique_ptr<AnimationPoseCache> _poseCache;
 };
 
 } // namespace SVE
\ No newline at end of file
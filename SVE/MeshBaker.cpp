@@ -0,0 +1,533 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#include "MeshBaker.h"
+#include "VulkanException.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <numeric>
+#include <type_traits>
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+
+namespace SVE
+{
+
+namespace
+{
+
+const char BakedMeshMagic[4] = { 'S', 'V', 'E', 'M' };
+// increase when format changes, meshes baked with other version are imported from source files
+const uint32_t BakedMeshVersion = 3;
+const char BakedMeshExtension[] = ".smesh";
+
+class BakedMeshWriter
+{
+public:
+    template <typename T>
+    void write(const T& value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Only plain data can be baked");
+        _data.append(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    void writeVector(const std::vector<T>& data)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Only plain data can be baked");
+        write(static_cast<uint32_t>(data.size()));
+        _data.append(reinterpret_cast<const char*>(data.data()), data.size() * sizeof(T));
+    }
+
+    void writeString(const std::string& value)
+    {
+        write(static_cast<uint32_t>(value.size()));
+        _data.append(value);
+    }
+
+    std::string& getData()
+    {
+        return _data;
+    }
+
+private:
+    std::string _data;
+};
+
+class BakedMeshReader
+{
+public:
+    BakedMeshReader(const char* data, size_t size)
+        : _data(data)
+        , _size(size)
+    {
+    }
+
+    template <typename T>
+    T read()
+    {
+        T value;
+        readBytes(&value, sizeof(T));
+        return value;
+    }
+
+    // Reads array size, checking that array with elements of at least elementSize fits into remaining data
+    uint32_t readCount(size_t elementSize)
+    {
+        auto count = read<uint32_t>();
+        if (count > (_size - _offset) / elementSize)
+            throw VulkanException("Baked mesh data is corrupted");
+        return count;
+    }
+
+    template <typename T>
+    std::vector<T> readVector()
+    {
+        std::vector<T> result(readCount(sizeof(T)));
+        readBytes(result.data(), result.size() * sizeof(T));
+        return result;
+    }
+
+    std::string readString()
+    {
+        auto size = readCount(1);
+        std::string result(_data + _offset, size);
+        _offset += size;
+        return result;
+    }
+
+private:
+    void readBytes(void* destination, size_t size)
+    {
+        if (size > _size - _offset)
+            throw VulkanException("Baked mesh data is corrupted");
+        memcpy(destination, _data + _offset, size);
+        _offset += size;
+    }
+
+private:
+    const char* _data;
+    size_t _size;
+    size_t _offset = 0;
+};
+
+// Keys are written field by field, as their layout depends on assimp version
+void writeKeys(BakedMeshWriter& writer, const aiVectorKey* keys, uint32_t count)
+{
+    writer.write(count);
+    for (auto i = 0u; i < count; i++)
+    {
+        writer.write(keys[i].mTime);
+        writer.write(keys[i].mValue.x);
+        writer.write(keys[i].mValue.y);
+        writer.write(keys[i].mValue.z);
+    }
+}
+
+void writeKeys(BakedMeshWriter& writer, const aiQuatKey* keys, uint32_t count)
+{
+    writer.write(count);
+    for (auto i = 0u; i < count; i++)
+    {
+        writer.write(keys[i].mTime);
+        writer.write(keys[i].mValue.w);
+        writer.write(keys[i].mValue.x);
+        writer.write(keys[i].mValue.y);
+        writer.write(keys[i].mValue.z);
+    }
+}
+
+aiVectorKey* readKeys(BakedMeshReader& reader, uint32_t& count)
+{
+    count = reader.readCount(sizeof(double) + sizeof(float) * 3);
+    std::unique_ptr<aiVectorKey[]> keys(new aiVectorKey[count]);
+    for (auto i = 0u; i < count; i++)
+    {
+        keys[i].mTime = reader.read<double>();
+        keys[i].mValue.x = reader.read<float>();
+        keys[i].mValue.y = reader.read<float>();
+        keys[i].mValue.z = reader.read<float>();
+    }
+    return keys.release();
+}
+
+aiQuatKey* readQuatKeys(BakedMeshReader& reader, uint32_t& count)
+{
+    count = reader.readCount(sizeof(double) + sizeof(float) * 4);
+    std::unique_ptr<aiQuatKey[]> keys(new aiQuatKey[count]);
+    for (auto i = 0u; i < count; i++)
+    {
+        keys[i].mTime = reader.read<double>();
+        keys[i].mValue.w = reader.read<float>();
+        keys[i].mValue.x = reader.read<float>();
+        keys[i].mValue.y = reader.read<float>();
+        keys[i].mValue.z = reader.read<float>();
+    }
+    return keys.release();
+}
+
+void writeNode(BakedMeshWriter& writer, const aiNode* node)
+{
+    writer.writeString(node->mName.C_Str());
+    writer.write(node->mTransformation);
+    writer.write(node->mNumChildren);
+    for (auto i = 0u; i < node->mNumChildren; i++)
+        writeNode(writer, node->mChildren[i]);
+}
+
+aiNode* readNode(BakedMeshReader& reader, aiNode* parent)
+{
+    std::unique_ptr<aiNode> node(new aiNode(reader.readString()));
+    node->mParent = parent;
+    node->mTransformation = reader.read<aiMatrix4x4>();
+
+    // node destructor deletes children, so array is filled with nulls in case reading fails
+    auto childCount = reader.readCount(sizeof(uint32_t) * 2 + sizeof(aiMatrix4x4));
+    if (childCount > 0)
+    {
+        node->mChildren = new aiNode*[childCount]();
+        node->mNumChildren = childCount;
+        for (auto i = 0u; i < childCount; i++)
+            node->mChildren[i] = readNode(reader, node.get());
+    }
+
+    return node.release();
+}
+
+void writeAnimation(BakedMeshWriter& writer, const aiAnimation* animation)
+{
+    writer.writeString(animation->mName.C_Str());
+    writer.write(animation->mDuration);
+    writer.write(animation->mTicksPerSecond);
+    writer.write(animation->mNumChannels);
+    for (auto i = 0u; i < animation->mNumChannels; i++)
+    {
+        const auto* channel = animation->mChannels[i];
+        writer.writeString(channel->mNodeName.C_Str());
+        writeKeys(writer, channel->mPositionKeys, channel->mNumPositionKeys);
+        writeKeys(writer, channel->mRotationKeys, channel->mNumRotationKeys);
+        writeKeys(writer, channel->mScalingKeys, channel->mNumScalingKeys);
+    }
+}
+
+std::unique_ptr<aiAnimation> readAnimation(BakedMeshReader& reader)
+{
+    auto animation = std::make_unique<aiAnimation>();
+    animation->mName = aiString(reader.readString());
+    animation->mDuration = reader.read<double>();
+    animation->mTicksPerSecond = reader.read<double>();
+
+    auto channelCount = reader.readCount(sizeof(uint32_t) * 4);
+    if (channelCount > 0)
+    {
+        animation->mChannels = new aiNodeAnim*[channelCount]();
+        animation->mNumChannels = channelCount;
+        for (auto i = 0u; i < channelCount; i++)
+        {
+            auto* channel = new aiNodeAnim();
+            animation->mChannels[i] = channel;
+            channel->mNodeName = aiString(reader.readString());
+            channel->mPositionKeys = readKeys(reader, channel->mNumPositionKeys);
+            channel->mRotationKeys = readQuatKeys(reader, channel->mNumRotationKeys);
+            channel->mScalingKeys = readKeys(reader, channel->mNumScalingKeys);
+        }
+    }
+
+    return animation;
+}
+
+} // anon namespace
+
+MeshSettings importMesh(const MeshLoadSettings& meshLoadSettings, const std::string& fileContent)
+{
+    MeshSettings meshSettings {};
+
+    meshSettings.animation = std::make_shared<AnimationSettings>();
+    meshSettings.animationSpeed = meshLoadSettings.animationSpeed;
+    meshSettings.animationBoundsMargin = meshLoadSettings.animationBoundsMargin;
+    auto& importer = meshSettings.animation->importer;
+
+    std::map<std::string, uint32_t> boneMap;
+
+    const aiScene* scene = importer.ReadFileFromMemory(
+            fileContent.data(), fileContent.size(),
+            aiProcess_CalcTangentSpace       |
+            aiProcess_Triangulate            |
+            aiProcess_JoinIdenticalVertices  |
+            aiProcess_TransformUVCoords      |
+            aiProcess_LimitBoneWeights       |
+            aiProcess_OptimizeMeshes         |
+            aiProcess_SortByPType            |
+            aiProcess_OptimizeGraph);
+
+    // If the import failed, report it
+    if(!scene)
+    {
+        throw VulkanException( importer.GetErrorString());
+    }
+
+    meshSettings.name = meshLoadSettings.name;
+
+    // meshes with the same material are placed one after another, so each material is drawn as single submesh
+    std::vector<uint32_t> meshOrder(scene->mNumMeshes);
+    std::iota(meshOrder.begin(), meshOrder.end(), 0);
+    std::stable_sort(meshOrder.begin(), meshOrder.end(), [scene](uint32_t a, uint32_t b)
+    {
+        return scene->mMeshes[a]->mMaterialIndex < scene->mMeshes[b]->mMaterialIndex;
+    });
+
+    for (auto i : meshOrder)
+    {
+        const auto* mesh = scene->mMeshes[i];
+        auto vertexBase = static_cast<uint32_t>(meshSettings.vertexPosData.size());
+        auto vertexCount = vertexBase + mesh->mNumVertices;
+        meshSettings.vertexPosData.reserve(vertexCount);
+        meshSettings.vertexColorData.reserve(vertexCount);
+        meshSettings.vertexTexData.reserve(vertexCount);
+        meshSettings.vertexNormalData.reserve(vertexCount);
+        meshSettings.vertexBinormalData.reserve(vertexCount);
+        meshSettings.vertexTangentData.reserve(vertexCount);
+        for (auto v = 0u; v < mesh->mNumVertices; v++)
+        {
+            if (meshLoadSettings.switchYZ)
+            {
+                meshSettings.vertexPosData.emplace_back(mesh->mVertices[v].x, mesh->mVertices[v].z, mesh->mVertices[v].y);
+                meshSettings.vertexPosData.back() *= meshLoadSettings.scale;
+                meshSettings.vertexColorData.emplace_back(1.0f, 1.0f, 1.0f);
+                meshSettings.vertexTexData.emplace_back(mesh->mTextureCoords[0][v].x, 1.0f - mesh->mTextureCoords[0][v].y);
+                meshSettings.vertexNormalData.emplace_back(mesh->mNormals[v].x, mesh->mNormals[v].z, mesh->mNormals[v].y);
+                meshSettings.vertexBinormalData.emplace_back(mesh->mBitangents[v].x, mesh->mBitangents[v].z, mesh->mBitangents[v].y);
+                meshSettings.vertexTangentData.emplace_back(mesh->mTangents[v].x, mesh->mTangents[v].z, mesh->mTangents[v].y);
+            } else {
+                meshSettings.vertexPosData.emplace_back(mesh->mVertices[v].x, mesh->mVertices[v].y, mesh->mVertices[v].z);
+                meshSettings.vertexPosData.back() *= meshLoadSettings.scale;
+                meshSettings.vertexColorData.emplace_back(1.0f, 1.0f, 1.0f);
+                meshSettings.vertexTexData.emplace_back(mesh->mTextureCoords[0][v].x, 1.0f - mesh->mTextureCoords[0][v].y);
+                meshSettings.vertexNormalData.emplace_back(mesh->mNormals[v].x, mesh->mNormals[v].y, mesh->mNormals[v].z);
+                meshSettings.vertexBinormalData.emplace_back(mesh->mBitangents[v].x, mesh->mBitangents[v].y, mesh->mBitangents[v].z);
+                meshSettings.vertexTangentData.emplace_back(mesh->mTangents[v].x, mesh->mTangents[v].y, mesh->mTangents[v].z);
+            }
+        }
+
+        auto firstIndex = static_cast<uint32_t>(meshSettings.indexData.size());
+        meshSettings.indexData.reserve(meshSettings.indexData.size() + mesh->mNumFaces * 3);
+        for (auto f = 0u; f < mesh->mNumFaces; f++)
+        {
+            for (auto index = 0u; index < mesh->mFaces[f].mNumIndices; index++)
+            {
+                meshSettings.indexData.push_back(vertexBase + mesh->mFaces[f].mIndices[index]);
+            }
+        }
+
+        aiString materialName;
+        scene->mMaterials[mesh->mMaterialIndex]->Get(AI_MATKEY_NAME, materialName);
+        if (meshSettings.submeshes.empty() || meshSettings.submeshes.back().materialName != materialName.C_Str())
+            meshSettings.submeshes.push_back({ firstIndex, 0, materialName.C_Str() });
+        meshSettings.submeshes.back().indexCount += static_cast<uint32_t>(meshSettings.indexData.size()) - firstIndex;
+
+        // bones of all meshes are in single list, meshes without bones have zero weights
+        if (mesh->mNumBones > 0 || !meshSettings.vertexBoneIndexData.empty())
+        {
+            meshSettings.vertexBoneIndexData.resize(vertexCount);
+            meshSettings.vertexBoneWeightData.resize(vertexCount);
+        }
+
+        for (auto r = 0u; r < mesh->mNumBones; r++)
+        {
+            auto* boneInfo = mesh->mBones[r];
+            auto bone = boneMap.emplace(boneInfo->mName.C_Str(), static_cast<uint32_t>(boneMap.size())).first->second;
+            if (bone >= meshSettings.animation->boneOffset.size())
+                meshSettings.animation->boneOffset.resize(bone + 1);
+            meshSettings.animation->boneOffset[bone] = boneInfo->mOffsetMatrix;
+            for (auto w = 0u; w < boneInfo->mNumWeights; w++)
+            {
+                auto weight = boneInfo->mWeights[w];
+
+                auto vID = vertexBase + weight.mVertexId;
+                for (auto bi = 0u; bi < 4; bi++)
+                {
+                    if (meshSettings.vertexBoneWeightData[vID][bi] < 0.01f)
+                    {
+                        meshSettings.vertexBoneIndexData[vID][bi] = bone;
+                        meshSettings.vertexBoneWeightData[vID][bi] = weight.mWeight;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+    meshSettings.boneNum = static_cast<uint32_t>(boneMap.size());
+
+    if (meshSettings.submeshes.size() > 1)
+    {
+        meshSettings.materialName = meshSettings.submeshes.front().materialName;
+    }
+    else
+    {
+        aiString materialName;
+        scene->mMaterials[0]->Get(AI_MATKEY_NAME, materialName);
+        meshSettings.materialName = materialName.C_Str();
+        meshSettings.submeshes.clear();
+    }
+
+    if (scene->mNumAnimations > 0)
+    {
+        meshSettings.animation->animations = scene->mAnimations;
+        meshSettings.animation->animationCount = scene->mNumAnimations;
+        meshSettings.animation->rootNode = scene->mRootNode;
+        meshSettings.animation->globalInverse = scene->mRootNode->mTransformation;
+        meshSettings.animation->globalInverse.Inverse();
+        meshSettings.animation->boneMap = boneMap;
+    }
+
+    return meshSettings;
+}
+
+std::string getBakedMeshFilename(const std::string& filename)
+{
+    auto extensionPos = filename.find_last_of('.');
+    auto directoryPos = filename.find_last_of("/\\");
+    if (extensionPos == std::string::npos || (directoryPos != std::string::npos && extensionPos < directoryPos))
+        return filename + BakedMeshExtension;
+
+    return filename.substr(0, extensionPos) + BakedMeshExtension;
+}
+
+uint64_t getMeshSourceHash(const char* data, size_t size)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (size_t i = 0; i < size; i++)
+        hash = (hash ^ static_cast<uint8_t>(data[i])) * 1099511628211ull;
+    return hash;
+}
+
+std::string bakeMesh(const MeshSettings& meshSettings, const MeshLoadSettings& meshLoadSettings, uint64_t sourceHash)
+{
+    BakedMeshWriter writer;
+    writer.write(BakedMeshMagic);
+    writer.write(BakedMeshVersion);
+    writer.write(sourceHash);
+    writer.write(static_cast<uint32_t>(meshLoadSettings.switchYZ));
+    writer.write(meshLoadSettings.scale);
+
+    writer.writeString(meshSettings.materialName);
+    writer.write(static_cast<uint32_t>(meshSettings.isOptimized));
+    writer.writeVector(meshSettings.vertexPosData);
+    writer.writeVector(meshSettings.vertexColorData);
+    writer.writeVector(meshSettings.vertexTexData);
+    writer.writeVector(meshSettings.vertexNormalData);
+    writer.writeVector(meshSettings.vertexBinormalData);
+    writer.writeVector(meshSettings.vertexTangentData);
+    writer.writeVector(meshSettings.indexData);
+    writer.write(meshSettings.boneNum);
+    writer.writeVector(meshSettings.vertexBoneIndexData);
+    writer.writeVector(meshSettings.vertexBoneWeightData);
+    writer.write(static_cast<uint32_t>(meshSettings.submeshes.size()));
+    for (const auto& submesh : meshSettings.submeshes)
+    {
+        writer.write(submesh.firstIndex);
+        writer.write(submesh.indexCount);
+        writer.writeString(submesh.materialName);
+    }
+
+    const auto& animation = meshSettings.animation;
+    auto animationCount = animation && animation->animations ? animation->animationCount : 0;
+    writer.write(animationCount);
+    if (animationCount > 0)
+    {
+        writeNode(writer, animation->rootNode);
+        writer.writeVector(animation->boneOffset);
+        writer.write(animation->globalInverse);
+        writer.write(static_cast<uint32_t>(animation->boneMap.size()));
+        for (const auto& bone : animation->boneMap)
+        {
+            writer.writeString(bone.first);
+            writer.write(bone.second);
+        }
+        for (auto i = 0u; i < animationCount; i++)
+            writeAnimation(writer, animation->animations[i]);
+    }
+
+    return std::move(writer.getData());
+}
+
+bool loadBakedMesh(const char* data, size_t size, const MeshLoadSettings& meshLoadSettings, uint64_t sourceHash,
+                   MeshSettings& meshSettings)
+{
+    BakedMeshReader reader(data, size);
+    char magic[4];
+    for (auto& symbol : magic)
+        symbol = reader.read<char>();
+    if (memcmp(magic, BakedMeshMagic, sizeof(magic)) != 0)
+        throw VulkanException("Incorrect baked mesh format");
+
+    if (reader.read<uint32_t>() != BakedMeshVersion || reader.read<uint64_t>() != sourceHash)
+        return false;
+    auto isSwitchYZ = reader.read<uint32_t>() != 0;
+    auto scale = reader.read<glm::vec3>();
+    if (isSwitchYZ != meshLoadSettings.switchYZ || scale != meshLoadSettings.scale)
+        return false;
+
+    meshSettings = {};
+    meshSettings.name = meshLoadSettings.name;
+    meshSettings.animationSpeed = meshLoadSettings.animationSpeed;
+    meshSettings.animationBoundsMargin = meshLoadSettings.animationBoundsMargin;
+    meshSettings.materialName = reader.readString();
+    meshSettings.isOptimized = reader.read<uint32_t>() != 0;
+    meshSettings.vertexPosData = reader.readVector<glm::vec3>();
+    meshSettings.vertexColorData = reader.readVector<glm::vec3>();
+    meshSettings.vertexTexData = reader.readVector<glm::vec2>();
+    meshSettings.vertexNormalData = reader.readVector<glm::vec3>();
+    meshSettings.vertexBinormalData = reader.readVector<glm::vec3>();
+    meshSettings.vertexTangentData = reader.readVector<glm::vec3>();
+    meshSettings.indexData = reader.readVector<uint32_t>();
+    meshSettings.boneNum = reader.read<uint32_t>();
+    meshSettings.vertexBoneIndexData = reader.readVector<glm::ivec4>();
+    meshSettings.vertexBoneWeightData = reader.readVector<glm::vec4>();
+    auto submeshCount = reader.readCount(sizeof(uint32_t) * 3);
+    for (auto i = 0u; i < submeshCount; i++)
+    {
+        SubmeshSettings submesh;
+        submesh.firstIndex = reader.read<uint32_t>();
+        submesh.indexCount = reader.read<uint32_t>();
+        submesh.materialName = reader.readString();
+        if (submesh.firstIndex > meshSettings.indexData.size()
+            || submesh.indexCount > meshSettings.indexData.size() - submesh.firstIndex)
+        {
+            throw VulkanException("Baked mesh data is corrupted");
+        }
+        meshSettings.submeshes.push_back(std::move(submesh));
+    }
+
+    meshSettings.animation = std::make_shared<AnimationSettings>();
+    auto& animation = *meshSettings.animation;
+    auto animationCount = reader.readCount(sizeof(uint32_t));
+    if (animationCount > 0)
+    {
+        animation.bakedRootNode.reset(readNode(reader, nullptr));
+        animation.rootNode = animation.bakedRootNode.get();
+        animation.boneOffset = reader.readVector<aiMatrix4x4>();
+        animation.globalInverse = reader.read<aiMatrix4x4>();
+        auto boneCount = reader.readCount(sizeof(uint32_t) * 2);
+        for (auto i = 0u; i < boneCount; i++)
+        {
+            auto name = reader.readString();
+            animation.boneMap[name] = reader.read<uint32_t>();
+        }
+
+        for (auto i = 0u; i < animationCount; i++)
+        {
+            animation.bakedAnimations.push_back(readAnimation(reader));
+            animation.bakedAnimationList.push_back(animation.bakedAnimations.back().get());
+        }
+        animation.animations = animation.bakedAnimationList.data();
+        animation.animationCount = animationCount;
+    }
+
+    return true;
+}
+
+} // namespace SVE
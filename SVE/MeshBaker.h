@@ -0,0 +1,25 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include "MeshSettings.h"
+
+namespace SVE
+{
+
+// Imports mesh file with assimp (used by baker and when there is no baked mesh)
+MeshSettings importMesh(const MeshLoadSettings& meshLoadSettings, const std::string& fileContent);
+
+// Baked mesh contains MeshSettings vertex arrays with load settings (axis switch and scale) already applied,
+// skeleton and animations. It's stored next to source file with .smesh extension.
+// Arrays are copied from baked data to MeshSettings on load, as VulkanMesh packs them into its own vertex layout.
+std::string getBakedMeshFilename(const std::string& filename);
+// FNV-1a of source file content, mesh baked from other content is outdated
+uint64_t getMeshSourceHash(const char* data, size_t size);
+std::string bakeMesh(const MeshSettings& meshSettings, const MeshLoadSettings& meshLoadSettings, uint64_t sourceHash);
+// Returns false if baked mesh has other version, was baked with other load settings or from other source content,
+// throws if data is corrupted
+bool loadBakedMesh(const char* data, size_t size, const MeshLoadSettings& meshLoadSettings, uint64_t sourceHash,
+                   MeshSettings& meshSettings);
+
+} // namespace SVE
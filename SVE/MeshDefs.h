@@ -1,12 +1,20 @@
 // SVE (Simple Vulkan Engine) Library
 // Copyright (c) 2018-2019, Igor Barinov
 // Licensed under the MIT License
+#pragma once
 #include <unordered_map>
 #include <glm/detail/type_mat.hpp>
+#include <glm/glm.hpp>
 
 namespace SVE
 {
 
 using BonesAttachments = std::unordered_map<std::string, glm::mat4>;
 
+struct BoundingBox
+{
+    glm::vec3 min = glm::vec3(0);
+    glm::vec3 max = glm::vec3(0);
+};
+
 } // namespace SVE
\ No newline at end of file
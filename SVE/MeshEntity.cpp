@@ -8,7 +8,9 @@
 #include "MaterialManager.h"
 #include "VulkanMesh.h"
 #include "VulkanMaterial.h"
+#include "VulkanInstanceCulling.h"
 #include "ShaderSettings.h"
+#include "VulkanException.h"
 #include "Utils.h"
 
 namespace SVE
@@ -27,8 +29,16 @@ MeshEntity::MeshEntity(Mesh* mesh)
                       glm::vec4(1.0f, 1.0f, 1.0f, 1.0f), 16,
                       (_material ? (uint32_t)_material->getVulkanMaterial()->getSettings().ignoreShadow : 0) }
 {
+    const auto& submeshes = mesh->getVulkanMesh()->getMeshSettings().submeshes;
+    for (auto i = 1u; i < submeshes.size(); i++)
+    {
+        auto* material = Engine::getInstance()->getMaterialManager()->getMaterial(submeshes[i].materialName, true);
+        _submeshMaterials.push_back({ material ? material : _material });
+    }
+
     if (_material)
     {
+        _material = selectMaterial(_material);
         setupMaterial();
     }
 }
@@ -39,6 +49,11 @@ MeshEntity::~MeshEntity()
     {
         _material->getVulkanMaterial()->deleteInstancesForEntity(this);
     }
+    for (const auto& submeshMaterial : _submeshMaterials)
+    {
+        if (submeshMaterial.material)
+            submeshMaterial.material->getVulkanMaterial()->deleteInstancesForEntity(this);
+    }
     if (_shadowMaterial)
     {
         _shadowMaterial->getVulkanMaterial()->deleteInstancesForEntity(this);
@@ -51,11 +66,34 @@ MeshEntity::~MeshEntity()
 
 void MeshEntity::setMaterial(const std::string& materialName)
 {
-    _material = Engine::getInstance()->getMaterialManager()->getMaterial(materialName);
+    // instances of previous material are returned for reuse
+    if (_material)
+        _material->getVulkanMaterial()->deleteInstancesForEntity(this);
+    _material = selectMaterial(Engine::getInstance()->getMaterialManager()->getMaterial(materialName));
     _materialInfo.ignoreShadow = static_cast<uint32_t>(_material->getVulkanMaterial()->getSettings().ignoreShadow);
+    // drawn alone until render list assigns instance batch
+    setInstanceBatch(0, 0, 1);
     setupMaterial();
 }
 
+void MeshEntity::setSubmeshMaterial(uint32_t submesh, const std::string& materialName)
+{
+    if (submesh == 0)
+    {
+        setMaterial(materialName);
+        return;
+    }
+    if (submesh > _submeshMaterials.size())
+        throw VulkanException("Incorrect submesh index");
+
+    auto& submeshMaterial = _submeshMaterials[submesh - 1];
+    if (submeshMaterial.material)
+        submeshMaterial.material->getVulkanMaterial()->deleteInstancesForEntity(this);
+    submeshMaterial.material = Engine::getInstance()->getMaterialManager()->getMaterial(materialName);
+    if (_material)
+        setupMaterial();
+}
+
 void MeshEntity::setCastShadows(bool castShadows)
 {
     _castShadows = castShadows;
@@ -66,67 +104,101 @@ void MeshEntity::setIsReflected(bool isReflected)
     _isReflected = isReflected;
 }
 
-void MeshEntity::updateUniforms(UniformDataList uniformDataList) const
+void MeshEntity::prepareAnimation(AnimationUpdater& animationUpdater)
 {
-    for (auto& uniformData : uniformDataList)
-    {
-        // TODO: Load material info data from resources
-        uniformData->materialInfo = _materialInfo;
-    }
+    if (_animationState == AnimationState::Play && !_isTimePaused)
+        _animationTime += Engine::getInstance()->getDeltaTime();
+
+    _mesh->prepareBones(_animationTime, _animationPose, _animationInstance, _bones, animationUpdater);
+}
 
-    UniformData newData = *uniformDataList[toInt(CommandsType::MainPass)];
+void MeshEntity::skipUniformsUpdate() const
+{
+    // time still runs, so it's correct when entity is drawn again
+    if (!_isTimePaused)
+        _time += Engine::getInstance()->getDeltaTime();
+}
 
+void MeshEntity::updateUniforms(const UniformDataList& uniformDataList) const
+{
     if (!_isTimePaused)
         _time += Engine::getInstance()->getDeltaTime();
-    newData.time = _time;
-    newData.customFloat = _customFloat;
-    newData.customVec4 = _customVec4;
-    newData.customMat4 = _customMat4;
 
-    if (_animationState == AnimationState::Play && !_isTimePaused)
-        _animationTime += Engine::getInstance()->getDeltaTime();
-    _mesh->updateUniformDataBones(newData, _animationTime, _attachments);
-    _material->getVulkanMaterial()->setUniformData(_materialIndex, newData);
+    // Only per-entity values are stored here, everything else is taken from shared per-pass data
+    // TODO: Load material info data from resources
+    _entityUniformData.materialInfo = _materialInfo;
+    _entityUniformData.time = _time;
+    _entityUniformData.customFloat = _customFloat;
+    _entityUniformData.customVec4 = _customVec4;
+    _entityUniformData.customMat4 = _customMat4;
+    _entityUniformData.bones = _mesh->getBones(_animationPose, _animationInstance, _bones, _attachments);
+
+    _material->getVulkanMaterial()->setUniformData(
+            _materialIndex, *uniformDataList[toInt(CommandsType::MainPass)], &_entityUniformData);
 
     if (_shadowMaterial)
     {
-        UniformData newShadowData = *uniformDataList[toInt(CommandsType::ShadowPassDirectLight)];
-        newShadowData.bones = newData.bones;
         _shadowMaterial->getVulkanMaterial()->setUniformData(
                 _shadowIndex,
-                newShadowData);
+                *uniformDataList[toInt(CommandsType::ShadowPassDirectLight)],
+                &_entityUniformData);
 
         if (_renderToDepth)
         {
-            UniformData depthData = *uniformDataList[toInt(CommandsType::ScreenQuadDepthPass)];
-            depthData.bones = newData.bones;
             _shadowMaterial->getVulkanMaterial()->setUniformData(
                     _depthIndex,
-                    depthData);
+                    *uniformDataList[toInt(CommandsType::ScreenQuadDepthPass)],
+                    &_entityUniformData);
         }
     }
     if (_pointLightShadowMaterial)
     {
-        UniformData newShadowData = *uniformDataList[toInt(CommandsType::ShadowPassPointLights)];
-        newShadowData.bones = newData.bones;
         _pointLightShadowMaterial->getVulkanMaterial()->setUniformData(
                 _pointLightShadowMaterial->getVulkanMaterial()->getInstanceForEntity(this),
-                newShadowData);
+                *uniformDataList[toInt(CommandsType::ShadowPassPointLights)],
+                &_entityUniformData);
     }
     if (Engine::getInstance()->isWaterEnabled())
     {
-        UniformData newReflectionData = *uniformDataList[toInt(CommandsType::ReflectionPass)];
-        newReflectionData.bones = newData.bones;
-        _material->getVulkanMaterial()->setUniformData(_reflectionMaterialIndex, newReflectionData);
+        _material->getVulkanMaterial()->setUniformData(
+                _reflectionMaterialIndex, *uniformDataList[toInt(CommandsType::ReflectionPass)], &_entityUniformData);
+        _material->getVulkanMaterial()->setUniformData(
+                _refractionMaterialIndex, *uniformDataList[toInt(CommandsType::RefractionPass)], &_entityUniformData);
+    }
 
-        UniformData newRefractionData = *uniformDataList[toInt(CommandsType::RefractionPass)];
-        newRefractionData.bones = newData.bones;
-        _material->getVulkanMaterial()->setUniformData(_refractionMaterialIndex, newRefractionData);
+    for (const auto& submeshMaterial : _submeshMaterials)
+    {
+        auto* vulkanMaterial = submeshMaterial.material->getVulkanMaterial();
+        vulkanMaterial->setUniformData(
+                submeshMaterial.materialIndex, *uniformDataList[toInt(CommandsType::MainPass)], &_entityUniformData);
+        if (Engine::getInstance()->isWaterEnabled())
+        {
+            vulkanMaterial->setUniformData(
+                    submeshMaterial.reflectionMaterialIndex,
+                    *uniformDataList[toInt(CommandsType::ReflectionPass)],
+                    &_entityUniformData);
+            vulkanMaterial->setUniformData(
+                    submeshMaterial.refractionMaterialIndex,
+                    *uniformDataList[toInt(CommandsType::RefractionPass)],
+                    &_entityUniformData);
+        }
     }
 }
 
 void MeshEntity::applyDrawingCommands(uint32_t bufferIndex, uint32_t imageIndex) const
 {
+    // batch placed beyond transform buffer capacity has no instances to draw
+    if (_instanceCount == 0)
+        return;
+
+    auto passType = Engine::getInstance()->getPassType();
+    if (!_submeshMaterials.empty() && passType != CommandsType::ShadowPassDirectLight
+        && passType != CommandsType::ShadowPassPointLights && passType != CommandsType::ScreenQuadDepthPass)
+    {
+        applySubmeshDrawingCommands(bufferIndex, imageIndex, passType);
+        return;
+    }
+
     if (Engine::getInstance()->getPassType() == CommandsType::ReflectionPass)
     {
         if (!_isReflected)
@@ -178,14 +250,51 @@ void MeshEntity::applyDrawingCommands(uint32_t bufferIndex, uint32_t imageIndex)
         _material->getVulkanMaterial()->applyDrawingCommands(bufferIndex, imageIndex, _materialIndex);
     }
 
-    if (!isInstanceRendering() ||
-        !_material->getVulkanMaterial()->isInstancesRendered() || _material->getVulkanMaterial()->isMainInstance(_materialIndex))
+    // batches culled on GPU are drawn with instance count written by culling compute shader,
+    // whole bucket of them with one call
+    auto* instanceCulling = Engine::getInstance()->getInstanceCulling();
+    if (instanceCulling && _culledBucketSize > 0
+        && VulkanInstanceCulling::isCulledPass(Engine::getInstance()->getPassType()))
     {
-        _mesh->getVulkanMesh()->applyDrawingCommands(bufferIndex, _material->getVulkanMaterial()->getInstanceCount());
-        _material->getVulkanMaterial()->setInstancedRendered();
-        _material->getVulkanMaterial()->setMainInstance(_materialIndex);
-        if (_shadowMaterial)
-            _shadowMaterial->getVulkanMaterial()->setMainInstance(_materialIndex);
+        _mesh->getVulkanMesh()->applyIndirectDrawingCommands(
+                bufferIndex,
+                instanceCulling->getIndirectBuffer(),
+                instanceCulling->getIndirectOffset(imageIndex, _culledBucketFirst),
+                _culledBucketSize);
+    }
+    else
+    {
+        _mesh->getVulkanMesh()->applyDrawingCommands(bufferIndex, _instanceCount, _firstInstance);
+    }
+}
+
+void MeshEntity::applySubmeshDrawingCommands(uint32_t bufferIndex, uint32_t imageIndex, CommandsType passType) const
+{
+    bool isWaterPass = passType == CommandsType::ReflectionPass || passType == CommandsType::RefractionPass;
+    if (isWaterPass && !_isReflected)
+        return;
+
+    // geometry is bound once, every submesh only binds its material and draws own index range
+    auto* vulkanMesh = _mesh->getVulkanMesh();
+    bool isMRTPass = passType == CommandsType::ScreenQuadMRTPass;
+    bool isGeometryBound = false;
+    for (auto submesh = 0u; submesh <= _submeshMaterials.size(); submesh++)
+    {
+        SubmeshMaterial submeshMaterial { _material, _materialIndex, _reflectionMaterialIndex, _refractionMaterialIndex };
+        if (submesh > 0)
+            submeshMaterial = _submeshMaterials[submesh - 1];
+        if (!isWaterPass && isMRTPass != submeshMaterial.material->isMRT())
+            continue;
+
+        auto materialIndex = submeshMaterial.materialIndex;
+        if (passType == CommandsType::ReflectionPass)
+            materialIndex = submeshMaterial.reflectionMaterialIndex;
+        else if (passType == CommandsType::RefractionPass)
+            materialIndex = submeshMaterial.refractionMaterialIndex;
+
+        submeshMaterial.material->getVulkanMaterial()->applyDrawingCommands(bufferIndex, imageIndex, materialIndex);
+        vulkanMesh->applySubmeshDrawingCommands(bufferIndex, submesh, isGeometryBound);
+        isGeometryBound = true;
     }
 }
 
@@ -199,22 +308,46 @@ void MeshEntity::setupMaterial()
         _refractionMaterialIndex = _material->getVulkanMaterial()->getInstanceForEntity(this, 2);
     }
 
+    for (auto& submeshMaterial : _submeshMaterials)
+    {
+        // submeshes are drawn with separate index ranges, so instanced indirect draws can't be used
+        if (submeshMaterial.material->getVulkanMaterial()->isInstanced() || _material->getVulkanMaterial()->isInstanced())
+            throw VulkanException("Instanced materials are not supported for meshes with several submeshes");
+
+        submeshMaterial.materialIndex = submeshMaterial.material->getVulkanMaterial()->getInstanceForEntity(this);
+        if (Engine::getInstance()->isWaterEnabled())
+        {
+            submeshMaterial.reflectionMaterialIndex =
+                    submeshMaterial.material->getVulkanMaterial()->getInstanceForEntity(this, 1);
+            submeshMaterial.refractionMaterialIndex =
+                    submeshMaterial.material->getVulkanMaterial()->getInstanceForEntity(this, 2);
+        }
+    }
+
     if (Engine::getInstance()->isShadowMappingEnabled())
     {
+        auto* materialManager = Engine::getInstance()->getMaterialManager();
+        auto* previousShadowMaterial = _shadowMaterial;
         // TODO: Get shadow materials (or their names) from shadowmap class or special function in MatManager
         if (_material->getVulkanMaterial()->isSkeletal())
         {
-            _shadowMaterial = Engine::getInstance()->getMaterialManager()->getMaterial("SimpleSkeletalDepth");
+            _shadowMaterial = materialManager->getMaterial("SimpleSkeletalDepth");
             // TODO: Add configuration to enable/disable point lights shadows
             //_pointLightShadowMaterial = Engine::getInstance()->getMaterialManager()->getMaterial("FullSkeletalDepth");
         }
         else
         {
-            _shadowMaterial = Engine::getInstance()->getMaterialManager()->getMaterial(
-                    _material->getVulkanMaterial()->getSettings().useInstancing ? "SimpleDepthInstanced" : "SimpleDepth");
+            _shadowMaterial = materialManager->getMaterial("SimpleDepth");
+            if (isInstanceRendering())
+                _shadowMaterial = materialManager->getInstancedMaterial(_shadowMaterial);
+            if (!_shadowMaterial)
+                throw VulkanException("Shadow material can't be drawn instanced");
             //_pointLightShadowMaterial = Engine::getInstance()->getMaterialManager()->getMaterial("FullDepth");
         }
 
+        if (previousShadowMaterial && previousShadowMaterial != _shadowMaterial)
+            previousShadowMaterial->getVulkanMaterial()->deleteInstancesForEntity(this);
+
         _shadowIndex = _shadowMaterial->getVulkanMaterial()->getInstanceForEntity(this, 0);
         _depthIndex = _shadowMaterial->getVulkanMaterial()->getInstanceForEntity(this, 1);
     }
@@ -232,16 +365,91 @@ MaterialInfo* MeshEntity::getMaterialInfo()
 
 bool MeshEntity::isInstanceRendering() const
 {
-    return _material->getVulkanMaterial()->getSettings().useInstancing;
+    return _material->getVulkanMaterial()->isInstanced();
 }
 
-void MeshEntity::updateInstanceBuffers()
+PassMask MeshEntity::getPassMask() const
 {
-    _material->getVulkanMaterial()->updateInstancedData();
-    if (_shadowMaterial)
+    PassMask passMask = 0;
+    if (_isReflected)
+        passMask |= toPassMask(CommandsType::ReflectionPass) | toPassMask(CommandsType::RefractionPass);
+    if (_castShadows && _shadowMaterial)
+        passMask |= toPassMask(CommandsType::ShadowPassDirectLight);
+    if (_castShadows && _pointLightShadowMaterial)
+        passMask |= toPassMask(CommandsType::ShadowPassPointLights);
+    if (_renderToDepth && _shadowMaterial)
+        passMask |= toPassMask(CommandsType::ScreenQuadDepthPass);
+
+    auto addMaterialPasses = [&passMask](const Material* material)
     {
-        _shadowMaterial->getVulkanMaterial()->updateInstancedData();
-    }
+        if (material->isMRT())
+            passMask |= toPassMask(CommandsType::ScreenQuadMRTPass);
+        else
+            passMask |= toPassMask(CommandsType::MainPass)
+                        | toPassMask(CommandsType::ScreenQuadPass)
+                        | toPassMask(CommandsType::ScreenQuadLatePass);
+    };
+    addMaterialPasses(_material);
+    for (const auto& submeshMaterial : _submeshMaterials)
+        addMaterialPasses(submeshMaterial.material);
+
+    return passMask;
+}
+
+const BoundingBox* MeshEntity::getBoundingBox() const
+{
+    return _mesh->getBoundingBox();
+}
+
+uint32_t MeshEntity::getExternalTextureMask() const
+{
+    auto textureMask = _material->getVulkanMaterial()->getExternalTextureMask();
+    for (const auto& submeshMaterial : _submeshMaterials)
+        textureMask |= submeshMaterial.material->getVulkanMaterial()->getExternalTextureMask();
+    return textureMask;
+}
+
+InstanceBatchKey MeshEntity::getInstanceBatchKey() const
+{
+    auto* vulkanMesh = _mesh->getVulkanMesh();
+    InstanceBatchKey key { _mesh, _material, &_materialInfo };
+    key.geometryBlock = vulkanMesh->getGeometryBlock();
+    key.indexSize = vulkanMesh->getIndexType() == VK_INDEX_TYPE_UINT16 ? sizeof(uint16_t) : sizeof(uint32_t);
+    return key;
+}
+
+void MeshEntity::setInstanceBatch(uint32_t batchIndex, uint32_t firstInstance, uint32_t instanceCount)
+{
+    _firstInstance = firstInstance;
+    _instanceCount = instanceCount;
+}
+
+void MeshEntity::setCulledInstanceBatch(uint32_t batchIndex, uint32_t firstInstance) const
+{
+    auto* vulkanMesh = _mesh->getVulkanMesh();
+    Engine::getInstance()->getInstanceCulling()->setBatch(
+            batchIndex,
+            firstInstance,
+            vulkanMesh->getMeshSettings().indexData.size(),
+            vulkanMesh->getFirstIndex(),
+            vulkanMesh->getVertexOffset(),
+            _mesh->getBoundingBox());
+}
+
+void MeshEntity::setCulledInstanceBucket(uint32_t firstBatch, uint32_t batchCount)
+{
+    _culledBucketFirst = firstBatch;
+    _culledBucketSize = batchCount;
+}
+
+Material* MeshEntity::selectMaterial(Material* material) const
+{
+    // submeshes are drawn with their own index ranges, so entities with them aren't batched
+    if (!_submeshMaterials.empty())
+        return material;
+
+    auto* instancedMaterial = Engine::getInstance()->getMaterialManager()->getInstancedMaterial(material);
+    return instancedMaterial ? instancedMaterial : material;
 }
 
 void MeshEntity::setAnimationState(AnimationState animationState)
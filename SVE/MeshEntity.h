@@ -5,6 +5,7 @@
 #include "Entity.h"
 #include "ShaderSettings.h"
 #include "MeshDefs.h"
+#include "AnimationPoseCache.h"
 #include <memory>
 
 namespace SVE
@@ -26,6 +27,8 @@ public:
     ~MeshEntity();
 
     void setMaterial(const std::string& materialName) override;
+    // Material of submesh (submesh 0 uses entity material)
+    void setSubmeshMaterial(uint32_t submesh, const std::string& materialName);
     void setMaterialInfo(const MaterialInfo& materialInfo) override;
     MaterialInfo* getMaterialInfo() override;
     void setCastShadows(bool castShadows);
@@ -33,11 +36,19 @@ public:
     // TODO: add IsRefracted method
     void setIsReflected(bool isReflected);
 
-    void updateUniforms(UniformDataList uniformDataList) const override;
-    void updateInstanceBuffers() override;
+    void prepareAnimation(AnimationUpdater& animationUpdater) override;
+    void updateUniforms(const UniformDataList& uniformDataList) const override;
+    void skipUniformsUpdate() const override;
     void applyDrawingCommands(uint32_t bufferIndex, uint32_t imageIndex) const override;
 
     bool isInstanceRendering() const override;
+    InstanceBatchKey getInstanceBatchKey() const override;
+    void setInstanceBatch(uint32_t batchIndex, uint32_t firstInstance, uint32_t instanceCount) override;
+    void setCulledInstanceBatch(uint32_t batchIndex, uint32_t firstInstance) const override;
+    void setCulledInstanceBucket(uint32_t firstBatch, uint32_t batchCount) override;
+    PassMask getPassMask() const override;
+    const BoundingBox* getBoundingBox() const override;
+    uint32_t getExternalTextureMask() const override;
 
     void setAnimationState(AnimationState animationState);
     void resetTime(float time = 0.0f, bool resetAnimation = false);
@@ -47,7 +58,18 @@ public:
     glm::mat4 getAttachment(const std::string& name) override;
 
 private:
+    struct SubmeshMaterial
+    {
+        Material* material = nullptr;
+        uint32_t materialIndex = 0;
+        uint32_t reflectionMaterialIndex = 0;
+        uint32_t refractionMaterialIndex = 0;
+    };
+
+    // Instanced variant of material if entity can be batched with others of the same mesh and material
+    Material* selectMaterial(Material* material) const;
     void setupMaterial();
+    void applySubmeshDrawingCommands(uint32_t bufferIndex, uint32_t imageIndex, CommandsType passType) const;
 
 private:
     Mesh* _mesh = nullptr;
@@ -59,20 +81,31 @@ private:
     uint32_t _materialIndex = 0;
     uint32_t _reflectionMaterialIndex = 0;
     uint32_t _refractionMaterialIndex = 0;
+    // materials of submeshes after the first one
+    std::vector<SubmeshMaterial> _submeshMaterials;
 
     Material* _shadowMaterial = nullptr;
     uint32_t _shadowIndex = 0;
     uint32_t _depthIndex = 0;
+    uint32_t _firstInstance = 0;
+    uint32_t _instanceCount = 1;
+    uint32_t _culledBucketFirst = 0;
+    uint32_t _culledBucketSize = 0;
     Material* _pointLightShadowMaterial = nullptr;
     //std::unique_ptr<Material> _bloomMaterial;
     //std::vector<uint32_t> _shadowMaterialIndexes;
 
     // TODO: Move to animation class
     AnimationState _animationState = AnimationState::Play;
-    mutable float _animationTime = 0.0f;
+    float _animationTime = 0.0f;
     mutable float _time = 0.0f;
 
     mutable BonesAttachments _attachments;
+    // bones palette written in animation phase (if pose isn't shared) and read by uniforms update
+    AnimationInstance _animationInstance;
+    AnimationPose _animationPose;
+    std::vector<glm::mat4> _bones;
+    mutable EntityUniformData _entityUniformData;
 };
 
 } // namespace SVE
\ No newline at end of file
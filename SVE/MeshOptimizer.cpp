@@ -0,0 +1,394 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#include "MeshOptimizer.h"
+#include <algorithm>
+#include <unordered_set>
+
+namespace SVE
+{
+
+namespace
+{
+
+const uint32_t NoVertex = ~0u;
+// hard clusters are split where ACMR of the part is close to ACMR of the whole cluster
+const float SoftBoundaryThreshold = 1.05f;
+
+template <typename T>
+T getAttribute(const std::vector<T>& data, uint32_t index)
+{
+    return index < data.size() ? data[index] : T(0);
+}
+
+template <typename T>
+bool isEqualAttribute(const std::vector<T>& data, uint32_t a, uint32_t b)
+{
+    return getAttribute(data, a) == getAttribute(data, b);
+}
+
+template <typename T>
+void remapAttribute(std::vector<T>& data, const std::vector<uint32_t>& remap, uint32_t vertexCount)
+{
+    if (data.empty())
+        return;
+
+    std::vector<T> remappedData(vertexCount);
+    for (auto i = 0u; i < remap.size(); i++)
+    {
+        if (remap[i] != NoVertex)
+            remappedData[remap[i]] = getAttribute(data, i);
+    }
+    data.swap(remappedData);
+}
+
+void hashCombine(size_t& seed, float value)
+{
+    seed ^= std::hash<float>()(value) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+// FIFO cache simulation, vertex is in cache if it was one of the last cacheSize misses
+uint32_t countCacheMisses(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize)
+{
+    std::vector<uint32_t> cacheTime(vertexCount, 0);
+    uint32_t time = cacheSize + 1;
+    uint32_t misses = 0;
+    for (auto index : indices)
+    {
+        if (time - cacheTime[index] > cacheSize)
+        {
+            cacheTime[index] = time++;
+            misses++;
+        }
+    }
+
+    return misses;
+}
+
+// Returns index of the first vertex with the same attributes for each vertex
+std::vector<uint32_t> findIdenticalVertices(const MeshSettings& meshSettings)
+{
+    auto hash = [&meshSettings](uint32_t vertex)
+    {
+        size_t seed = 0;
+        const auto& position = meshSettings.vertexPosData[vertex];
+        hashCombine(seed, position.x);
+        hashCombine(seed, position.y);
+        hashCombine(seed, position.z);
+        return seed;
+    };
+    auto isEqual = [&meshSettings](uint32_t a, uint32_t b)
+    {
+        return meshSettings.vertexPosData[a] == meshSettings.vertexPosData[b]
+               && isEqualAttribute(meshSettings.vertexColorData, a, b)
+               && isEqualAttribute(meshSettings.vertexTexData, a, b)
+               && isEqualAttribute(meshSettings.vertexNormalData, a, b)
+               && isEqualAttribute(meshSettings.vertexBinormalData, a, b)
+               && isEqualAttribute(meshSettings.vertexTangentData, a, b)
+               && isEqualAttribute(meshSettings.vertexBoneIndexData, a, b)
+               && isEqualAttribute(meshSettings.vertexBoneWeightData, a, b);
+    };
+
+    auto vertexCount = static_cast<uint32_t>(meshSettings.vertexPosData.size());
+    std::unordered_set<uint32_t, decltype(hash), decltype(isEqual)> uniqueVertices(vertexCount, hash, isEqual);
+    std::vector<uint32_t> remap(vertexCount);
+    for (auto vertex = 0u; vertex < vertexCount; vertex++)
+        remap[vertex] = *uniqueVertices.insert(vertex).first;
+
+    return remap;
+}
+
+// Tipsify (Sander, Nehab, Barczak 2007): emits all triangles around fanning vertex, then selects next fanning
+// vertex among vertices of emitted triangles, which will still be in cache. Hard cluster boundaries are
+// placed where no such vertex exists.
+std::vector<uint32_t> tipsify(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize,
+                              std::vector<uint32_t>& clusters)
+{
+    std::vector<uint32_t> liveTriangles(vertexCount, 0);
+    for (auto index : indices)
+        liveTriangles[index]++;
+
+    // triangles using each vertex
+    std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+    for (auto vertex = 0u; vertex < vertexCount; vertex++)
+        adjacencyOffsets[vertex + 1] = adjacencyOffsets[vertex] + liveTriangles[vertex];
+    std::vector<uint32_t> adjacency(indices.size());
+    std::vector<uint32_t> fillOffsets(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+    for (auto i = 0u; i < indices.size(); i++)
+        adjacency[fillOffsets[indices[i]]++] = i / 3;
+
+    std::vector<uint32_t> cacheTime(vertexCount, 0);
+    std::vector<bool> isEmitted(indices.size() / 3, false);
+    std::vector<uint32_t> deadEnd;
+    std::vector<uint32_t> candidates;
+    std::vector<uint32_t> result;
+    result.reserve(indices.size());
+    uint32_t time = cacheSize + 1;
+    uint32_t cursor = 0;
+
+    clusters.push_back(0);
+    auto fanningVertex = indices.front();
+    while (fanningVertex != NoVertex)
+    {
+        candidates.clear();
+        for (auto i = adjacencyOffsets[fanningVertex]; i < adjacencyOffsets[fanningVertex + 1]; i++)
+        {
+            auto triangle = adjacency[i];
+            if (isEmitted[triangle])
+                continue;
+
+            for (auto k = 0u; k < 3; k++)
+            {
+                auto vertex = indices[triangle * 3 + k];
+                result.push_back(vertex);
+                deadEnd.push_back(vertex);
+                candidates.push_back(vertex);
+                liveTriangles[vertex]--;
+                if (time - cacheTime[vertex] > cacheSize)
+                    cacheTime[vertex] = time++;
+            }
+            isEmitted[triangle] = true;
+        }
+
+        // prefer the oldest vertex in cache, which will stay there after its triangles are emitted
+        fanningVertex = NoVertex;
+        uint32_t bestPriority = 0;
+        for (auto vertex : candidates)
+        {
+            if (liveTriangles[vertex] == 0)
+                continue;
+
+            uint32_t priority = 0;
+            if (time - cacheTime[vertex] + 2 * liveTriangles[vertex] <= cacheSize)
+                priority = time - cacheTime[vertex];
+            if (fanningVertex == NoVertex || priority > bestPriority)
+            {
+                fanningVertex = vertex;
+                bestPriority = priority;
+            }
+        }
+
+        if (fanningVertex == NoVertex)
+        {
+            // dead end: continue from recently used vertex or from next vertex in input order
+            while (!deadEnd.empty() && fanningVertex == NoVertex)
+            {
+                if (liveTriangles[deadEnd.back()] > 0)
+                    fanningVertex = deadEnd.back();
+                deadEnd.pop_back();
+            }
+            for (; cursor < vertexCount && fanningVertex == NoVertex; cursor++)
+            {
+                if (liveTriangles[cursor] > 0)
+                    fanningVertex = cursor;
+            }
+
+            if (fanningVertex != NoVertex)
+                clusters.push_back(static_cast<uint32_t>(result.size() / 3));
+        }
+    }
+
+    return result;
+}
+
+// Splits hard clusters at soft boundaries and sorts clusters so that ones facing away from mesh center
+// (which are likely to occlude others) are drawn first (Sander, Nehab, Barczak 2007)
+void optimizeOverdraw(const MeshSettings& meshSettings, std::vector<uint32_t>& indices,
+                      std::vector<uint32_t> hardClusters, uint32_t vertexCount, uint32_t cacheSize)
+{
+    auto triangleCount = static_cast<uint32_t>(indices.size() / 3);
+    hardClusters.push_back(triangleCount);
+
+    std::vector<uint32_t> cacheTime(vertexCount, 0);
+    uint32_t time = cacheSize + 1;
+    auto countTriangleMisses = [&](uint32_t triangle)
+    {
+        uint32_t misses = 0;
+        for (auto k = 0u; k < 3; k++)
+        {
+            auto vertex = indices[triangle * 3 + k];
+            if (time - cacheTime[vertex] > cacheSize)
+            {
+                cacheTime[vertex] = time++;
+                misses++;
+            }
+        }
+        return misses;
+    };
+    auto flushCache = [&]() { time += cacheSize + 1; };
+
+    std::vector<uint32_t> clusters;
+    for (auto c = 0u; c + 1 < hardClusters.size(); c++)
+    {
+        auto begin = hardClusters[c];
+        auto end = hardClusters[c + 1];
+
+        flushCache();
+        uint32_t clusterMisses = 0;
+        for (auto triangle = begin; triangle < end; triangle++)
+            clusterMisses += countTriangleMisses(triangle);
+        auto clusterAcmr = static_cast<float>(clusterMisses) / (end - begin);
+
+        flushCache();
+        clusters.push_back(begin);
+        uint32_t misses = 0;
+        auto start = begin;
+        for (auto triangle = begin; triangle < end; triangle++)
+        {
+            misses += countTriangleMisses(triangle);
+            if (triangle + 1 < end && misses <= clusterAcmr * SoftBoundaryThreshold * (triangle + 1 - start))
+            {
+                clusters.push_back(triangle + 1);
+                start = triangle + 1;
+                misses = 0;
+                flushCache();
+            }
+        }
+    }
+    clusters.push_back(triangleCount);
+
+    struct Cluster
+    {
+        uint32_t begin;
+        uint32_t end;
+        glm::vec3 center;
+        glm::vec3 normal;
+        float area;
+        float sortKey;
+    };
+
+    std::vector<Cluster> clusterList;
+    clusterList.reserve(clusters.size() - 1);
+    glm::vec3 meshCenter(0);
+    float meshArea = 0;
+    for (auto c = 0u; c + 1 < clusters.size(); c++)
+    {
+        Cluster cluster { clusters[c], clusters[c + 1], glm::vec3(0), glm::vec3(0), 0.0f, 0.0f };
+        for (auto triangle = cluster.begin; triangle < cluster.end; triangle++)
+        {
+            const auto& p0 = meshSettings.vertexPosData[indices[triangle * 3]];
+            const auto& p1 = meshSettings.vertexPosData[indices[triangle * 3 + 1]];
+            const auto& p2 = meshSettings.vertexPosData[indices[triangle * 3 + 2]];
+            auto normal = glm::cross(p1 - p0, p2 - p0);
+            auto area = glm::length(normal);
+            cluster.center += (p0 + p1 + p2) * (area / 3.0f);
+            cluster.normal += normal;
+            cluster.area += area;
+        }
+        meshCenter += cluster.center;
+        meshArea += cluster.area;
+        clusterList.push_back(cluster);
+    }
+    if (meshArea > 0)
+        meshCenter /= meshArea;
+
+    for (auto& cluster : clusterList)
+    {
+        if (cluster.area > 0)
+            cluster.center /= cluster.area;
+        auto normalLength = glm::length(cluster.normal);
+        if (normalLength > 0)
+            cluster.normal /= normalLength;
+        cluster.sortKey = glm::dot(cluster.center - meshCenter, cluster.normal);
+    }
+
+    std::stable_sort(clusterList.begin(), clusterList.end(), [](const Cluster& a, const Cluster& b)
+    {
+        return a.sortKey > b.sortKey;
+    });
+
+    std::vector<uint32_t> sortedIndices;
+    sortedIndices.reserve(indices.size());
+    for (const auto& cluster : clusterList)
+        sortedIndices.insert(sortedIndices.end(), indices.begin() + cluster.begin * 3, indices.begin() + cluster.end * 3);
+    indices.swap(sortedIndices);
+}
+
+// Renumbers vertices in order of first use in index buffer, unused vertices are removed
+uint32_t reorderVertices(MeshSettings& meshSettings)
+{
+    std::vector<uint32_t> remap(meshSettings.vertexPosData.size(), NoVertex);
+    uint32_t vertexCount = 0;
+    for (auto& index : meshSettings.indexData)
+    {
+        if (remap[index] == NoVertex)
+            remap[index] = vertexCount++;
+        index = remap[index];
+    }
+
+    remapAttribute(meshSettings.vertexPosData, remap, vertexCount);
+    remapAttribute(meshSettings.vertexColorData, remap, vertexCount);
+    remapAttribute(meshSettings.vertexTexData, remap, vertexCount);
+    remapAttribute(meshSettings.vertexNormalData, remap, vertexCount);
+    remapAttribute(meshSettings.vertexBinormalData, remap, vertexCount);
+    remapAttribute(meshSettings.vertexTangentData, remap, vertexCount);
+    remapAttribute(meshSettings.vertexBoneIndexData, remap, vertexCount);
+    remapAttribute(meshSettings.vertexBoneWeightData, remap, vertexCount);
+
+    return vertexCount;
+}
+
+} // anon namespace
+
+MeshOptimizationStats optimizeMesh(MeshSettings& meshSettings, uint32_t cacheSize)
+{
+    MeshOptimizationStats stats;
+    auto vertexCount = static_cast<uint32_t>(meshSettings.vertexPosData.size());
+    auto& indices = meshSettings.indexData;
+    stats.originalVertexCount = stats.vertexCount = vertexCount;
+
+    if (indices.empty() || indices.size() % 3 != 0
+        || *std::max_element(indices.begin(), indices.end()) >= vertexCount)
+    {
+        return stats;
+    }
+    for (const auto& submesh : meshSettings.submeshes)
+    {
+        if (submesh.firstIndex % 3 != 0 || submesh.indexCount % 3 != 0
+            || submesh.firstIndex + submesh.indexCount > indices.size())
+        {
+            return stats;
+        }
+    }
+
+    auto triangleCount = static_cast<float>(indices.size() / 3);
+    auto originalMisses = countCacheMisses(indices, vertexCount, cacheSize);
+    stats.originalAcmr = originalMisses / triangleCount;
+    stats.originalAtvr = static_cast<float>(originalMisses) / vertexCount;
+
+    auto identicalVertices = findIdenticalVertices(meshSettings);
+    for (auto& index : indices)
+        index = identicalVertices[index];
+
+    // triangles are reordered inside submeshes, so their index ranges stay the same
+    auto optimizeTriangles = [&](uint32_t firstIndex, uint32_t indexCount)
+    {
+        if (indexCount == 0)
+            return;
+
+        std::vector<uint32_t> rangeIndices(indices.begin() + firstIndex, indices.begin() + firstIndex + indexCount);
+        std::vector<uint32_t> hardClusters;
+        rangeIndices = tipsify(rangeIndices, vertexCount, cacheSize, hardClusters);
+        optimizeOverdraw(meshSettings, rangeIndices, std::move(hardClusters), vertexCount, cacheSize);
+        std::copy(rangeIndices.begin(), rangeIndices.end(), indices.begin() + firstIndex);
+    };
+
+    if (meshSettings.submeshes.empty())
+    {
+        optimizeTriangles(0, static_cast<uint32_t>(indices.size()));
+    }
+    else
+    {
+        for (const auto& submesh : meshSettings.submeshes)
+            optimizeTriangles(submesh.firstIndex, submesh.indexCount);
+    }
+    stats.vertexCount = reorderVertices(meshSettings);
+
+    auto misses = countCacheMisses(indices, stats.vertexCount, cacheSize);
+    stats.acmr = misses / triangleCount;
+    stats.atvr = static_cast<float>(misses) / stats.vertexCount;
+
+    return stats;
+}
+
+} // namespace SVE
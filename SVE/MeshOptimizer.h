@@ -0,0 +1,27 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include "MeshSettings.h"
+
+namespace SVE
+{
+
+// Post-transform vertex cache statistics before and after optimization.
+// ACMR - cache misses per triangle, ATVR - cache misses per vertex (1.0 is the best possible).
+struct MeshOptimizationStats
+{
+    uint32_t originalVertexCount = 0;
+    uint32_t vertexCount = 0;
+    float originalAcmr = 0.0f;
+    float acmr = 0.0f;
+    float originalAtvr = 0.0f;
+    float atvr = 0.0f;
+};
+
+// Welds identical vertices, reorders triangles for vertex cache (Tipsify) and overdraw (clusters sorted
+// by view-independent occlusion measure), then reorders vertices in order of their first use.
+// Triangles are reordered inside submeshes. Triangle lists only, meshes with other index count are left as is.
+MeshOptimizationStats optimizeMesh(MeshSettings& meshSettings, uint32_t cacheSize = 16);
+
+} // namespace SVE
@@ -207,7 +207,8 @@ void iterateBones(
 } // anon namespace
 
 
-std::vector<glm::mat4> getAnimationTransforms(const MeshSettings& meshSettings, uint32_t animationId, float time, BonesAttachments& bonesAttachments)
+void getAnimationTransforms(const MeshSettings& meshSettings, uint32_t animationId, float time, BonesAttachments& bonesAttachments,
+                            std::vector<glm::mat4>& boneData)
 {
     // TODO: Only for looped anims
     time *= meshSettings.animationSpeed;
@@ -220,9 +221,31 @@ std::vector<glm::mat4> getAnimationTransforms(const MeshSettings& meshSettings,
         }
     }
 
-    std::vector<glm::mat4> result(meshSettings.boneNum, glm::mat4(1));
-    iterateBones(result, time, meshSettings.animation, animationId, meshSettings.animation->rootNode, aiMatrix4x4(), bonesAttachments);
+    boneData.assign(meshSettings.boneNum, glm::mat4(1));
+    iterateBones(boneData, time, meshSettings.animation, animationId, meshSettings.animation->rootNode, aiMatrix4x4(), bonesAttachments);
+}
+
+BoundingBox calculateBoundingBox(const MeshSettings& meshSettings)
+{
+    BoundingBox boundingBox;
+    if (meshSettings.vertexPosData.empty())
+        return boundingBox;
+
+    boundingBox.min = boundingBox.max = meshSettings.vertexPosData.front();
+    for (const auto& pos : meshSettings.vertexPosData)
+    {
+        boundingBox.min = glm::min(boundingBox.min, pos);
+        boundingBox.max = glm::max(boundingBox.max, pos);
+    }
+
+    // bones can move vertices out of bind pose bounds
+    if (meshSettings.boneNum > 0 && meshSettings.animation && meshSettings.animation->animations)
+    {
+        auto margin = (boundingBox.max - boundingBox.min) * meshSettings.animationBoundsMargin;
+        boundingBox.min -= margin;
+        boundingBox.max += margin;
+    }
 
-    return result;
+    return boundingBox;
 }
 } // namespace SVE
\ No newline at end of file
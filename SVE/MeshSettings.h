@@ -20,11 +20,17 @@ namespace SVE
 struct AnimationSettings
 {
     Assimp::Importer importer;
-    aiAnimation** animations;
-    aiNode* rootNode;
+    aiAnimation** animations = nullptr;
+    uint32_t animationCount = 0;
+    aiNode* rootNode = nullptr;
     std::vector<aiMatrix4x4> boneOffset;
     aiMatrix4x4 globalInverse;
     std::map<std::string, uint32_t> boneMap;
+
+    // node tree and animations of baked meshes (imported ones are owned by importer)
+    std::unique_ptr<aiNode> bakedRootNode;
+    std::vector<std::unique_ptr<aiAnimation>> bakedAnimations;
+    std::vector<aiAnimation*> bakedAnimationList;
 };
 
 struct MeshLoadSettings
@@ -34,6 +40,18 @@ struct MeshLoadSettings
     bool switchYZ = false;
     glm::vec3 scale = {1.0f, 1.0f, 1.0f};
     float animationSpeed = 1.0f;
+    // animated mesh is culled with bind pose bounds padded by this part of their size on each side
+    float animationBoundsMargin = 0.25f;
+    // replace materials of submeshes from mesh file, empty names keep imported material
+    std::vector<std::string> submeshMaterials;
+};
+
+// Index range of mesh drawn with its own material
+struct SubmeshSettings
+{
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    std::string materialName;
 };
 
 struct MeshSettings
@@ -52,10 +70,20 @@ struct MeshSettings
     std::vector<glm::vec4> vertexBoneWeightData;
     std::shared_ptr<AnimationSettings> animation;
     float animationSpeed = 1.0f;
+    // see MeshLoadSettings
+    float animationBoundsMargin = 0.25f;
 
     std::string materialName;
+    // index ranges of materials (the first one is materialName), empty if whole mesh uses single material
+    std::vector<SubmeshSettings> submeshes;
+    // baked meshes are optimized by baker
+    bool isOptimized = false;
 };
 
-std::vector<glm::mat4> getAnimationTransforms(const MeshSettings& meshSettings, uint32_t animationId, float time, BonesAttachments& bonesAttachments);
+// Evaluates animation by walking assimp node tree (meshes use SkeletalAnimation, this is kept as reference)
+void getAnimationTransforms(const MeshSettings& meshSettings, uint32_t animationId, float time, BonesAttachments& bonesAttachments,
+                            std::vector<glm::mat4>& boneData);
+// Bind pose bounds, animated meshes have them padded by animationBoundsMargin
+BoundingBox calculateBoundingBox(const MeshSettings& meshSettings);
 
 } // namespace SVE
\ No newline at end of file
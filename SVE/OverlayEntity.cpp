@@ -43,7 +43,7 @@ void OverlayEntity::setText(TextInfo textInfo)
     initText();
 }
 
-void OverlayEntity::updateUniforms(UniformDataList uniformDataList) const
+void OverlayEntity::updateUniforms(const UniformDataList& uniformDataList) const
 {
     auto& uniformData = *uniformDataList[toInt(CommandsType::MainPass)];
 
@@ -66,10 +66,7 @@ void OverlayEntity::updateUniforms(UniformDataList uniformDataList) const
         uniformData.textInfo.maxGlyphHeight = _overlayInfo.textInfo.font->maxGlyphHeight;
         uniformData.textInfo.scale = _overlayInfo.textInfo.scale;
         uniformData.textInfo.color = _overlayInfo.textInfo.color;
-        uniformData.glyphList.clear();
-        uniformData.glyphList.reserve(300);
-        std::copy(_overlayInfo.textInfo.font->symbols, _overlayInfo.textInfo.font->symbols + 300, std::back_inserter(uniformData.glyphList));
-        uniformData.glyphList.resize(300);
+        uniformData.glyphList.assign(_overlayInfo.textInfo.font->symbols, _overlayInfo.textInfo.font->symbols + 300);
         uniformData.textSymbolList = _overlayInfo.textInfo.symbols;
         uniformData.textSymbolList.resize(100);
 
@@ -77,6 +74,13 @@ void OverlayEntity::updateUniforms(UniformDataList uniformDataList) const
     }
 }
 
+PassMask OverlayEntity::getPassMask() const
+{
+    return toPassMask(CommandsType::MainPass)
+           | toPassMask(CommandsType::ScreenQuadPass)
+           | toPassMask(CommandsType::ScreenQuadLatePass);
+}
+
 void OverlayEntity::applyDrawingCommands(uint32_t bufferIndex, uint32_t imageIndex) const
 {
     if (!_isVisible)
@@ -25,8 +25,9 @@ public:
     void setVisible(bool visible);
     bool isVisible() const;
 
-    void updateUniforms(UniformDataList uniformDataList) const override;
+    void updateUniforms(const UniformDataList& uniformDataList) const override;
     void applyDrawingCommands(uint32_t bufferIndex, uint32_t imageIndex) const override;
+    PassMask getPassMask() const override;
 
 private:
     void initText();
@@ -44,7 +44,7 @@ void OverlayManager::changeOverlayOrder(const std::string& name, uint32_t newOrd
     _overlayZMap[newOrder].push_back(overlay);
 }
 
-void OverlayManager::updateUniforms(UniformDataList uniformDataList) const
+void OverlayManager::updateUniforms(const UniformDataList& uniformDataList) const
 {
     for (auto& overlay : _overlayList)
     {
@@ -16,7 +16,7 @@ public:
     void removeOverlay(const std::string& name);
     void changeOverlayOrder(const std::string& name, uint32_t newOrder);
 
-    void updateUniforms(UniformDataList uniformDataList) const;
+    void updateUniforms(const UniformDataList& uniformDataList) const;
     void applyDrawingCommands(uint32_t bufferIndex, uint32_t imageIndex) const;
 
 private:
@@ -29,7 +29,10 @@ ParticleSystemEntity::ParticleSystemEntity(const std::string &name)
 
 }
 
-ParticleSystemEntity::~ParticleSystemEntity() = default;
+ParticleSystemEntity::~ParticleSystemEntity()
+{
+    _material->getVulkanMaterial()->deleteInstancesForEntity(this);
+}
 
 void ParticleSystemEntity::applyComputeCommands(uint32_t bufferIndex, uint32_t imageIndex) const
 {
@@ -39,7 +42,7 @@ void ParticleSystemEntity::applyComputeCommands(uint32_t bufferIndex, uint32_t i
     _vulkanComputeEntity->applyComputeCommands();
 }
 
-void ParticleSystemEntity::updateUniforms(UniformDataList uniformDataList) const
+void ParticleSystemEntity::updateUniforms(const UniformDataList& uniformDataList) const
 {
     auto& data = *uniformDataList[toInt(CommandsType::MainPass)];
     data.materialInfo = _materialInfo;
@@ -57,6 +60,18 @@ void ParticleSystemEntity::updateUniforms(UniformDataList uniformDataList) const
     _vulkanComputeEntity->setUniformData(data);
 }
 
+PassMask ParticleSystemEntity::getPassMask() const
+{
+    return toPassMask(CommandsType::MainPass)
+           | toPassMask(CommandsType::ScreenQuadPass)
+           | toPassMask(CommandsType::ScreenQuadLatePass);
+}
+
+uint32_t ParticleSystemEntity::getExternalTextureMask() const
+{
+    return _material->getVulkanMaterial()->getExternalTextureMask();
+}
+
 void ParticleSystemEntity::applyDrawingCommands(uint32_t bufferIndex, uint32_t imageIndex) const
 {
     if (Engine::getInstance()->getPassType() == CommandsType::MainPass || Engine::getInstance()->getPassType() == CommandsType::ScreenQuadPass
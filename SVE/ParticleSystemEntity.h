@@ -21,7 +21,9 @@ public:
 
     void applyComputeCommands(uint32_t bufferIndex, uint32_t imageIndex) const override;
     void applyDrawingCommands(uint32_t bufferIndex, uint32_t imageIndex) const override;
-    void updateUniforms(UniformDataList uniformDataList) const override;
+    PassMask getPassMask() const override;
+    uint32_t getExternalTextureMask() const override;
+    void updateUniforms(const UniformDataList& uniformDataList) const override;
 
     void setMaterialInfo(const MaterialInfo& materialInfo) override;
     MaterialInfo* getMaterialInfo() override;
@@ -12,6 +12,7 @@
 #include "MaterialManager.h"
 #include "VulkanInstance.h"
 #include "VulkanMaterial.h"
+#include "RenderGraph.h"
 #include "Utils.h"
 
 namespace SVE
@@ -46,10 +47,46 @@ uint32_t PostEffectManager::getEffectIndex(const std::string& name)
     return iter == _effectMap.end() ? 0 : iter->second;
 }
 
-void PostEffectManager::createCommands(uint32_t currentFrame, uint32_t currentImage)
+uint32_t PostEffectManager::getEffectCount() const
+{
+    return static_cast<uint32_t>(_effectList.size());
+}
+
+void PostEffectManager::declarePasses(RenderGraph& renderGraph) const
+{
+    for (auto& postEffect : _effectList)
+    {
+        renderGraph.addPass(CommandsType::PostEffectPasses, postEffect.index, BUFFER_INDEX_SCREEN_QUAD + postEffect.index);
+        for (auto& texture : postEffect.material->getVulkanMaterial()->getSettings().textures)
+        {
+            if (texture.textureType == TextureType::LastEffect)
+            {
+                if (postEffect.index > 1)
+                    renderGraph.addRead(RenderResource::PostEffect, postEffect.index - 1);
+                else
+                    renderGraph.addRead(RenderResource::ScreenQuad);
+            }
+            else if (texture.textureType == TextureType::ScreenQuad && !texture.textureSubtype.empty())
+            {
+                auto iter = _effectMap.find(texture.textureSubtype);
+                renderGraph.addTextureRead(texture.textureType, iter == _effectMap.end() ? 0 : iter->second);
+            }
+            else
+            {
+                renderGraph.addTextureRead(texture.textureType);
+            }
+        }
+        renderGraph.addWrite(RenderResource::PostEffect, postEffect.index);
+    }
+}
+
+void PostEffectManager::createCommands(const RenderGraph& renderGraph, uint32_t currentFrame, uint32_t currentImage)
 {
     for (auto& postEffect : _effectList)
     {
+        if (!renderGraph.isPassActive(CommandsType::PostEffectPasses, postEffect.index))
+            continue;
+
         auto bufferIndex = BUFFER_INDEX_SCREEN_QUAD + postEffect.index;
         auto commandBuffer =  postEffect.vulkanPostEffect->reallocateCommandBuffers();
 
@@ -61,16 +98,26 @@ void PostEffectManager::createCommands(uint32_t currentFrame, uint32_t currentIm
     }
 }
 
-void PostEffectManager::submitCommands(UniformDataList uniformDataList)
+void PostEffectManager::updateUniforms(const UniformDataList& uniformDataList)
 {
-    auto* vulkanInstance = Engine::getInstance()->getVulkanInstance();
+    // each effect gets size of the previous effect image
     auto* uniformData = uniformDataList[toInt(CommandsType::ScreenQuadPass)].get();
     for (auto& postEffect : _effectList)
     {
         postEffect.material->getVulkanMaterial()->setUniformData(postEffect.materialIndex, *uniformData);
-        vulkanInstance->submitCommands(CommandsType::ScreenQuadPass, BUFFER_INDEX_SCREEN_QUAD + postEffect.index);
         uniformData->imageSize = glm::ivec4(postEffect.width, postEffect.height, 0, 0);
     }
 }
 
+VulkanUtils::AttachmentTraffic PostEffectManager::getAttachmentTraffic(const RenderGraph& renderGraph) const
+{
+    VulkanUtils::AttachmentTraffic traffic;
+    for (auto& postEffect : _effectList)
+    {
+        if (renderGraph.isPassActive(CommandsType::PostEffectPasses, postEffect.index))
+            traffic += postEffect.vulkanPostEffect->getAttachmentTraffic();
+    }
+    return traffic;
+}
+
 } // namespace SVE
\ No newline at end of file
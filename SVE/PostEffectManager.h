@@ -4,12 +4,14 @@
 #pragma once
 
 #include "Entity.h"
+#include "VulkanUtils.h"
 
 namespace SVE
 {
 
 class Material;
 class VulkanPostEffect;
+class RenderGraph;
 
 struct PostEffect
 {
@@ -32,9 +34,15 @@ public:
 
     void addPostEffect(const std::string& materialName, std::string effectName, int width = -1, int height = -1);
     uint32_t getEffectIndex(const std::string& name);
-
-    void createCommands(uint32_t currentFrame, uint32_t currentImage);
-    void submitCommands(UniformDataList uniformDataList);
+    uint32_t getEffectCount() const;
+
+    // Adds effect passes to render graph, effects are applied in order of adding
+    void declarePasses(RenderGraph& renderGraph) const;
+    // Commands are created only for passes which aren't culled by render graph
+    void createCommands(const RenderGraph& renderGraph, uint32_t currentFrame, uint32_t currentImage);
+    void updateUniforms(const UniformDataList& uniformDataList);
+    // Estimate for effects which aren't culled by render graph
+    VulkanUtils::AttachmentTraffic getAttachmentTraffic(const RenderGraph& renderGraph) const;
 
 private:
     std::vector<PostEffect> _effectList;
@@ -0,0 +1,737 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#include "RenderGraph.h"
+#include "VulkanException.h"
+#include "MaterialSettings.h"
+#include "Utils.h"
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+
+namespace SVE
+{
+namespace
+{
+
+const char* getPassName(CommandsType commandsType)
+{
+    switch (commandsType)
+    {
+        case CommandsType::MainPass: return "Main";
+        case CommandsType::ShadowPassDirectLight: return "ShadowDirectLight";
+        case CommandsType::ShadowPassPointLights: return "ShadowPointLights";
+        case CommandsType::ReflectionPass: return "Reflection";
+        case CommandsType::RefractionPass: return "Refraction";
+        case CommandsType::ScreenQuadPass: return "ScreenQuad";
+        case CommandsType::ScreenQuadMRTPass: return "ScreenQuadMRT";
+        case CommandsType::ScreenQuadLatePass: return "ScreenQuadLate";
+        case CommandsType::ScreenQuadDepthPass: return "ScreenQuadDepth";
+        case CommandsType::ComputeParticlesPass: return "Compute";
+        case CommandsType::PostEffectPasses: return "PostEffect";
+    }
+    return "Unknown";
+}
+
+const char* getResourceName(RenderResource type)
+{
+    switch (type)
+    {
+        case RenderResource::ComputeBuffers: return "ComputeBuffers";
+        case RenderResource::ShadowMapDirect: return "ShadowMapDirect";
+        case RenderResource::ShadowMapPoint: return "ShadowMapPoint";
+        case RenderResource::Reflection: return "Reflection";
+        case RenderResource::Refraction: return "Refraction";
+        case RenderResource::ScreenQuad: return "ScreenQuad";
+        case RenderResource::ScreenQuadSecond: return "ScreenQuadSecond";
+        case RenderResource::ScreenQuadDepth: return "ScreenQuadDepth";
+        case RenderResource::PostEffect: return "PostEffect";
+        case RenderResource::Swapchain: return "Swapchain";
+    }
+    return "Unknown";
+}
+
+std::string getResourceName(const RenderResourceId& resource)
+{
+    std::string name = getResourceName(resource.type);
+    if (resource.type == RenderResource::PostEffect)
+        name += std::to_string(resource.index);
+    return name;
+}
+
+template <typename T>
+std::string getPassName(const T& pass)
+{
+    std::string name = getPassName(pass.commandsType);
+    if (pass.commandsType == CommandsType::PostEffectPasses)
+        name += std::to_string(pass.index);
+    return name;
+}
+
+const char* getLayoutName(VkImageLayout layout)
+{
+    switch (layout)
+    {
+        case VK_IMAGE_LAYOUT_UNDEFINED: return "Undefined";
+        case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL: return "ColorAttachment";
+        case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL: return "DepthAttachment";
+        case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL: return "ShaderRead";
+        default: return "Other";
+    }
+}
+
+bool isImageResource(RenderResource type)
+{
+    return type != RenderResource::ComputeBuffers;
+}
+
+bool isDepthResource(RenderResource type)
+{
+    return type == RenderResource::ShadowMapDirect || type == RenderResource::ScreenQuadDepth;
+}
+
+bool hasResource(const std::vector<RenderResourceId>& resourceList, const RenderResourceId& resource)
+{
+    return std::find(resourceList.begin(), resourceList.end(), resource) != resourceList.end();
+}
+
+} // anon namespace
+
+RenderGraph::RenderGraph(VulkanInstance* vulkanInstance)
+    : _vulkanInstance(vulkanInstance)
+{
+}
+
+void RenderGraph::beginDeclaration()
+{
+    _passCount = 0;
+}
+
+void RenderGraph::addPass(CommandsType commandsType, uint32_t index, BufferIndex bufferIndex)
+{
+    if (_passCount == _passList.size())
+        _passList.emplace_back();
+
+    auto& pass = _passList[_passCount++];
+    pass.commandsType = commandsType;
+    pass.index = index;
+    pass.bufferIndex = bufferIndex;
+    pass.readList.clear();
+    pass.writeList.clear();
+}
+
+void RenderGraph::addRead(RenderResource type, uint32_t index)
+{
+    auto& readList = _passList[_passCount - 1].readList;
+    RenderResourceId resource { type, index };
+    if (std::find(readList.begin(), readList.end(), resource) == readList.end())
+        readList.push_back(resource);
+}
+
+void RenderGraph::addWrite(RenderResource type, uint32_t index)
+{
+    _passList[_passCount - 1].writeList.push_back({ type, index });
+}
+
+void RenderGraph::addTextureRead(TextureType textureType, uint32_t subtype)
+{
+    switch (textureType)
+    {
+        case TextureType::ShadowMapDirect: addRead(RenderResource::ShadowMapDirect); break;
+        case TextureType::ShadowMapPoint: addRead(RenderResource::ShadowMapPoint); break;
+        case TextureType::Reflection: addRead(RenderResource::Reflection); break;
+        case TextureType::Refraction: addRead(RenderResource::Refraction); break;
+        case TextureType::ScreenQuad:
+            if (subtype > 0)
+                addRead(RenderResource::PostEffect, subtype);
+            else
+                addRead(RenderResource::ScreenQuad);
+            break;
+        case TextureType::ScreenQuadSecond: addRead(RenderResource::ScreenQuadSecond); break;
+        case TextureType::ScreenQuadDepth: addRead(RenderResource::ScreenQuadDepth); break;
+        case TextureType::ImageFile:
+        case TextureType::LastEffect:
+            break;
+    }
+}
+
+void RenderGraph::addTextureReads(uint32_t textureMask)
+{
+    for (auto type = 0u; textureMask >> type; type++)
+    {
+        if (textureMask & (1u << type))
+            addTextureRead(static_cast<TextureType>(type));
+    }
+}
+
+void RenderGraph::endDeclaration()
+{
+    if (_isCompiled && !isDeclarationChanged())
+    {
+        // buffer indices can change every frame (e.g. per frame shadow map buffers)
+        for (auto i = 0u; i < _passCount; i++)
+            _compiledPassList[i].bufferIndex = _passList[i].bufferIndex;
+        return;
+    }
+
+    _compiledPassList.assign(_passList.begin(), _passList.begin() + _passCount);
+    compile();
+
+    if (_vulkanInstance->getEngineSettings().dumpRenderGraph)
+        std::cout << dump();
+}
+
+bool RenderGraph::isPassActive(CommandsType commandsType, uint32_t index) const
+{
+    for (auto i = 0u; i < _compiledPassList.size(); i++)
+    {
+        const auto& pass = _compiledPassList[i];
+        if (pass.commandsType == commandsType && pass.index == index)
+            return _isActive[i];
+    }
+    return false;
+}
+
+uint32_t RenderGraph::getActivePassCount() const
+{
+    return static_cast<uint32_t>(_submitOrder.size());
+}
+
+uint32_t RenderGraph::getCulledPassCount() const
+{
+    return static_cast<uint32_t>(_compiledPassList.size() - _submitOrder.size());
+}
+
+uint32_t RenderGraph::getDependencyCount() const
+{
+    return _dependencyCount;
+}
+
+uint32_t RenderGraph::getBarrierCount() const
+{
+    return static_cast<uint32_t>(_barrierList.size());
+}
+
+uint32_t RenderGraph::getLayoutTransitionCount() const
+{
+    return _layoutTransitionCount;
+}
+
+uint32_t RenderGraph::getAliasedImageCount() const
+{
+    return static_cast<uint32_t>(_aliasList.size()) - _aliasSlotCount;
+}
+
+void RenderGraph::setSubmitBatching(bool isBatching)
+{
+    _isSubmitBatching = isBatching;
+}
+
+void RenderGraph::submit() const
+{
+    if (_computePass >= 0)
+        _vulkanInstance->submitComputeCommands(_compiledPassList[_computePass].bufferIndex);
+
+    if (!_isSubmitBatching)
+    {
+        for (auto i = 0u; i < _graphicsPassList.size(); i++)
+        {
+            const auto& pass = _compiledPassList[_graphicsPassList[i]];
+            _vulkanInstance->submitCommands(pass.bufferIndex, i + 1 == _graphicsPassList.size(), i == _computeWaitPosition);
+        }
+        return;
+    }
+
+    _submitBufferList.clear();
+    for (auto passIndex : _graphicsPassList)
+        _submitBufferList.push_back(_compiledPassList[passIndex].bufferIndex);
+    _vulkanInstance->submitCommands(_submitBufferList, _batchSizeList, _computeWaitBatch);
+}
+
+uint32_t RenderGraph::getQueueSubmitCount() const
+{
+    if (_submitOrder.empty())
+        return 0;
+    // async compute adds compute queue submit
+    auto computeSubmits = _computePass >= 0 ? 1u : 0u;
+    return computeSubmits + (_isSubmitBatching ? 1 : static_cast<uint32_t>(_graphicsPassList.size()));
+}
+
+uint32_t RenderGraph::getSubmitBatchCount() const
+{
+    return _isSubmitBatching ? static_cast<uint32_t>(_batchSizeList.size()) : static_cast<uint32_t>(_graphicsPassList.size());
+}
+
+std::string RenderGraph::dump() const
+{
+    std::stringstream stream;
+    stream << "Render graph: " << getActivePassCount() << " passes, " << getCulledPassCount() << " culled, "
+           << _dependencyCount << " dependencies, " << _batchSizeList.size() << " submit batches, "
+           << _barrierList.size() << " barriers (" << _layoutTransitionCount << " layout transitions), "
+           << getAliasedImageCount() << " aliased images" << std::endl;
+    if (_computePass >= 0)
+        stream << "  async compute: " << getPassName(_compiledPassList[_computePass]) << ", waited by batch "
+               << _computeWaitBatch << std::endl;
+
+    auto printResources = [&stream](const char* title, const std::vector<RenderResourceId>& resourceList)
+    {
+        if (resourceList.empty())
+            return;
+        stream << " " << title;
+        for (const auto& resource : resourceList)
+            stream << " " << getResourceName(resource);
+    };
+
+    for (auto passIndex : _submitOrder)
+    {
+        const auto& pass = _compiledPassList[passIndex];
+        stream << "  " << getPassName(pass) << ":";
+        printResources("reads", pass.readList);
+        printResources("writes", pass.writeList);
+        stream << std::endl;
+    }
+    for (auto i = 0u; i < _compiledPassList.size(); i++)
+    {
+        if (!_isActive[i])
+            stream << "  culled " << getPassName(_compiledPassList[i]) << std::endl;
+    }
+
+    for (const auto& dependency : _dependencyList)
+    {
+        if (!_isActive[dependency.from] || !_isActive[dependency.to] || dependency.isWriteAfterRead)
+            continue;
+
+        stream << "  dependency " << getResourceName(dependency.resource) << ": "
+               << getPassName(_compiledPassList[dependency.from]) << " -> " << getPassName(_compiledPassList[dependency.to])
+               << (isComputeQueuePass(dependency.from) ? " (compute queue)" : "") << std::endl;
+    }
+
+    for (const auto& barrier : _barrierList)
+    {
+        stream << "  barrier " << getResourceName(barrier.resource) << ": ";
+        if (barrier.from == barrier.to)
+            stream << "first use";
+        else
+            stream << getPassName(_compiledPassList[barrier.from]);
+        stream << " -> " << getPassName(_compiledPassList[barrier.to]);
+        if (isImageResource(barrier.resource.type))
+            stream << ", " << getLayoutName(barrier.srcState.layout) << " -> " << getLayoutName(barrier.dstState.layout);
+        stream << std::endl;
+    }
+
+    for (auto slot = 0u; slot < _aliasSlotCount; slot++)
+    {
+        stream << "  alias slot " << slot << ":";
+        for (const auto& alias : _aliasList)
+        {
+            if (alias.second == slot)
+                stream << " " << getResourceName(alias.first);
+        }
+        stream << std::endl;
+    }
+
+    return stream.str();
+}
+
+bool RenderGraph::isDeclarationChanged() const
+{
+    if (_compiledPassList.size() != _passCount)
+        return true;
+
+    for (auto i = 0u; i < _passCount; i++)
+    {
+        const auto& pass = _passList[i];
+        const auto& compiledPass = _compiledPassList[i];
+        if (pass.commandsType != compiledPass.commandsType || pass.index != compiledPass.index
+            || pass.readList != compiledPass.readList || pass.writeList != compiledPass.writeList)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void RenderGraph::compile()
+{
+    buildDependencies();
+    cullPasses();
+    sortPasses();
+    buildBatches();
+    buildBarriers();
+    buildAliases();
+
+    _dependencyCount = 0;
+    for (const auto& dependency : _dependencyList)
+    {
+        if (_isActive[dependency.from] && _isActive[dependency.to] && !dependency.isWriteAfterRead)
+            ++_dependencyCount;
+    }
+    _isCompiled = true;
+}
+
+int RenderGraph::findWriter(const RenderResourceId& resource, uint32_t passIndex, bool before) const
+{
+    // last writer declared before the pass, or first one declared after it
+    if (before)
+    {
+        for (auto i = static_cast<int>(passIndex) - 1; i >= 0; i--)
+        {
+            const auto& writeList = _compiledPassList[i].writeList;
+            if (std::find(writeList.begin(), writeList.end(), resource) != writeList.end())
+                return i;
+        }
+    }
+    else
+    {
+        for (auto i = passIndex + 1; i < _compiledPassList.size(); i++)
+        {
+            const auto& writeList = _compiledPassList[i].writeList;
+            if (std::find(writeList.begin(), writeList.end(), resource) != writeList.end())
+                return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+void RenderGraph::buildDependencies()
+{
+    _dependencyList.clear();
+    for (auto i = 0u; i < _compiledPassList.size(); i++)
+    {
+        const auto& pass = _compiledPassList[i];
+        for (const auto& resource : pass.readList)
+        {
+            // resources without writers aren't produced this frame (e.g. disabled shadows)
+            auto writer = findWriter(resource, i, true);
+            if (writer < 0)
+                writer = findWriter(resource, i, false);
+            if (writer >= 0)
+                _dependencyList.push_back({ static_cast<uint32_t>(writer), i, resource, false });
+        }
+
+        for (const auto& resource : pass.writeList)
+        {
+            auto writer = findWriter(resource, i, true);
+            if (writer < 0)
+                continue;
+
+            // previous writer content is kept (passes load attachments), and its readers should finish first
+            _dependencyList.push_back({ static_cast<uint32_t>(writer), i, resource, false });
+            for (auto reader = static_cast<uint32_t>(writer) + 1; reader < i; reader++)
+            {
+                const auto& readList = _compiledPassList[reader].readList;
+                if (std::find(readList.begin(), readList.end(), resource) != readList.end())
+                    _dependencyList.push_back({ reader, i, resource, true });
+            }
+        }
+    }
+}
+
+void RenderGraph::cullPasses()
+{
+    // passes writing to swapchain and all their producers are kept
+    _isActive.assign(_compiledPassList.size(), false);
+    for (auto i = 0u; i < _compiledPassList.size(); i++)
+    {
+        const auto& writeList = _compiledPassList[i].writeList;
+        _isActive[i] = std::find_if(writeList.begin(), writeList.end(), [](const RenderResourceId& resource)
+        {
+            return resource.type == RenderResource::Swapchain;
+        }) != writeList.end();
+    }
+
+    bool isChanged = true;
+    while (isChanged)
+    {
+        isChanged = false;
+        for (const auto& dependency : _dependencyList)
+        {
+            if (!dependency.isWriteAfterRead && _isActive[dependency.to] && !_isActive[dependency.from])
+            {
+                _isActive[dependency.from] = true;
+                isChanged = true;
+            }
+        }
+    }
+}
+
+void RenderGraph::sortPasses()
+{
+    // topological order, declaration order is kept for independent passes
+    std::vector<uint32_t> dependencyCount(_compiledPassList.size(), 0);
+    for (const auto& dependency : _dependencyList)
+    {
+        if (_isActive[dependency.from] && _isActive[dependency.to])
+            ++dependencyCount[dependency.to];
+    }
+
+    _submitOrder.clear();
+    std::vector<bool> isAdded(_compiledPassList.size(), false);
+    auto activeCount = static_cast<size_t>(std::count(_isActive.begin(), _isActive.end(), true));
+    while (_submitOrder.size() < activeCount)
+    {
+        auto next = 0u;
+        while (next < _compiledPassList.size() && (!_isActive[next] || isAdded[next] || dependencyCount[next] > 0))
+            ++next;
+        if (next == _compiledPassList.size())
+            throw VulkanException("Render graph has cyclic dependencies");
+
+        isAdded[next] = true;
+        _submitOrder.push_back(next);
+        for (const auto& dependency : _dependencyList)
+        {
+            if (dependency.from == next && _isActive[dependency.to])
+                --dependencyCount[dependency.to];
+        }
+    }
+}
+
+void RenderGraph::buildBatches()
+{
+    std::vector<uint32_t> position(_compiledPassList.size(), 0);
+    for (auto i = 0u; i < _submitOrder.size(); i++)
+        position[_submitOrder[i]] = i;
+
+    // pass starts new batch if it depends on any pass of the current one
+    _graphicsPassList.clear();
+    _batchSizeList.clear();
+    _computePass = -1;
+    _computeWaitBatch = VulkanInstance::NoComputeWait;
+    _computeWaitPosition = VulkanInstance::NoComputeWait;
+    uint32_t batchStart = 0;
+    for (auto i = 0u; i < _submitOrder.size(); i++)
+    {
+        auto passIndex = _submitOrder[i];
+        if (isComputeQueuePass(passIndex))
+        {
+            _computePass = static_cast<int>(passIndex);
+            continue;
+        }
+
+        auto isDependent = std::any_of(_dependencyList.begin(), _dependencyList.end(),
+                                       [&](const Dependency& dependency)
+        {
+            return dependency.to == passIndex && _isActive[dependency.from] && !isComputeQueuePass(dependency.from)
+                   && position[dependency.from] >= batchStart;
+        });
+        if (isDependent || _batchSizeList.empty())
+        {
+            batchStart = i;
+            _batchSizeList.push_back(0);
+        }
+
+        auto isComputeDependent = _computePass >= 0
+                                  && std::any_of(_dependencyList.begin(), _dependencyList.end(),
+                                                 [&](const Dependency& dependency)
+        {
+            return dependency.to == passIndex && dependency.from == static_cast<uint32_t>(_computePass);
+        });
+        if (isComputeDependent && _computeWaitPosition == VulkanInstance::NoComputeWait)
+        {
+            _computeWaitBatch = static_cast<uint32_t>(_batchSizeList.size() - 1);
+            _computeWaitPosition = static_cast<uint32_t>(_graphicsPassList.size());
+        }
+
+        _graphicsPassList.push_back(passIndex);
+        ++_batchSizeList.back();
+    }
+
+    // compute buffers are released to graphics queue anyway, so the frame should acquire them
+    if (_computePass >= 0 && _computeWaitPosition == VulkanInstance::NoComputeWait && !_graphicsPassList.empty())
+    {
+        _computeWaitBatch = static_cast<uint32_t>(_batchSizeList.size() - 1);
+        _computeWaitPosition = static_cast<uint32_t>(_graphicsPassList.size() - 1);
+    }
+}
+
+void RenderGraph::buildBarriers()
+{
+    std::vector<uint32_t> position(_compiledPassList.size(), 0);
+    for (auto i = 0u; i < _submitOrder.size(); i++)
+        position[_submitOrder[i]] = i;
+
+    // dependencies of consumer on the same resource are merged into one barrier
+    _barrierList.clear();
+    for (const auto& dependency : _dependencyList)
+    {
+        if (!_isActive[dependency.from] || !_isActive[dependency.to])
+            continue;
+
+        auto srcState = getResourceState(dependency.resource.type, !dependency.isWriteAfterRead);
+        // reads don't have to be made available, writer only waits for them to finish
+        if (dependency.isWriteAfterRead)
+            srcState.accessMask = 0;
+        auto dstState = getResourceState(dependency.resource.type,
+                                         hasResource(_compiledPassList[dependency.to].writeList, dependency.resource));
+
+        auto barrier = std::find_if(_barrierList.begin(), _barrierList.end(), [&dependency](const Barrier& candidate)
+        {
+            return candidate.to == dependency.to && candidate.resource == dependency.resource;
+        });
+        if (barrier == _barrierList.end())
+        {
+            _barrierList.push_back({ dependency.from, dependency.to, dependency.resource, srcState, dstState });
+            continue;
+        }
+
+        barrier->srcState.stageMask |= srcState.stageMask;
+        barrier->srcState.accessMask |= srcState.accessMask;
+        if (position[dependency.from] > position[barrier->from])
+            barrier->from = dependency.from;
+    }
+
+    // images written without producer start from undefined layout, their previous content isn't needed
+    for (auto passIndex : _submitOrder)
+    {
+        for (const auto& resource : _compiledPassList[passIndex].writeList)
+        {
+            if (!isImageResource(resource.type))
+                continue;
+
+            auto hasProducer = std::any_of(_barrierList.begin(), _barrierList.end(), [&](const Barrier& barrier)
+            {
+                return barrier.to == passIndex && barrier.resource == resource;
+            });
+            if (!hasProducer)
+            {
+                ResourceState srcState { VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, 0, VK_IMAGE_LAYOUT_UNDEFINED };
+                _barrierList.push_back({ passIndex, passIndex, resource, srcState, getResourceState(resource.type, true) });
+            }
+        }
+    }
+
+    // image layout before barrier is the one required by the previous pass using it (e.g. another reader)
+    std::stable_sort(_barrierList.begin(), _barrierList.end(), [&position](const Barrier& left, const Barrier& right)
+    {
+        return position[left.to] < position[right.to];
+    });
+    std::vector<std::pair<RenderResourceId, VkImageLayout>> layoutList;
+    _layoutTransitionCount = 0;
+    for (auto& barrier : _barrierList)
+    {
+        if (!isImageResource(barrier.resource.type))
+            continue;
+
+        auto layout = std::find_if(layoutList.begin(), layoutList.end(),
+                                   [&barrier](const std::pair<RenderResourceId, VkImageLayout>& candidate)
+        {
+            return candidate.first == barrier.resource;
+        });
+        if (layout == layoutList.end())
+        {
+            layoutList.emplace_back(barrier.resource, barrier.dstState.layout);
+        }
+        else
+        {
+            barrier.srcState.layout = layout->second;
+            layout->second = barrier.dstState.layout;
+        }
+
+        if (barrier.srcState.layout != barrier.dstState.layout)
+            ++_layoutTransitionCount;
+    }
+}
+
+void RenderGraph::buildAliases()
+{
+    // lifetime of transient image is the range of submit batches using it, passes of one batch can overlap on GPU
+    struct Lifetime
+    {
+        RenderResourceId resource;
+        uint32_t first;
+        uint32_t last;
+    };
+    std::vector<Lifetime> lifetimeList;
+    auto batch = 0u;
+    auto batchPassCount = 0u;
+    for (auto passIndex : _graphicsPassList)
+    {
+        if (batchPassCount == _batchSizeList[batch])
+        {
+            ++batch;
+            batchPassCount = 0;
+        }
+        ++batchPassCount;
+
+        const auto& pass = _compiledPassList[passIndex];
+        for (const auto* resourceList : { &pass.readList, &pass.writeList })
+        {
+            for (const auto& resource : *resourceList)
+            {
+                if (!isImageResource(resource.type) || resource.type == RenderResource::Swapchain)
+                    continue;
+
+                auto lifetime = std::find_if(lifetimeList.begin(), lifetimeList.end(), [&resource](const Lifetime& candidate)
+                {
+                    return candidate.resource == resource;
+                });
+                if (lifetime == lifetimeList.end())
+                    lifetimeList.push_back({ resource, batch, batch });
+                else
+                    lifetime->last = batch;
+            }
+        }
+    }
+
+    // image reuses slot of the same kind which was last used before image is first written
+    struct Slot
+    {
+        bool isDepth;
+        uint32_t last;
+    };
+    std::vector<Slot> slotList;
+    _aliasList.clear();
+    for (const auto& lifetime : lifetimeList)
+    {
+        auto isDepth = isDepthResource(lifetime.resource.type);
+        auto slot = std::find_if(slotList.begin(), slotList.end(), [&](const Slot& candidate)
+        {
+            return candidate.isDepth == isDepth && candidate.last < lifetime.first;
+        });
+        if (slot == slotList.end())
+        {
+            slotList.push_back({ isDepth, lifetime.last });
+            slot = slotList.end() - 1;
+        }
+        else
+        {
+            slot->last = lifetime.last;
+        }
+        _aliasList.emplace_back(lifetime.resource, static_cast<uint32_t>(slot - slotList.begin()));
+    }
+    _aliasSlotCount = static_cast<uint32_t>(slotList.size());
+}
+
+// Attachments are loaded by passes which write them, so writes include attachment reads.
+// Images are sampled in fragment shaders, compute buffers are read as vertex and indirect command data.
+RenderGraph::ResourceState RenderGraph::getResourceState(RenderResource type, bool isWrite)
+{
+    if (!isImageResource(type))
+    {
+        if (isWrite)
+            return { VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT, VK_IMAGE_LAYOUT_UNDEFINED };
+        return { VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+                 VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_SHADER_READ_BIT,
+                 VK_IMAGE_LAYOUT_UNDEFINED };
+    }
+
+    if (!isWrite)
+        return { VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+
+    if (isDepthResource(type))
+        return { VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+                 VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                 VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL };
+
+    return { VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+             VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+             VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL };
+}
+
+bool RenderGraph::isComputeQueuePass(uint32_t passIndex) const
+{
+    return _vulkanInstance->isAsyncCompute()
+           && _compiledPassList[passIndex].commandsType == CommandsType::ComputeParticlesPass;
+}
+
+} // namespace SVE
@@ -0,0 +1,168 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include <vector>
+#include <string>
+#include "Engine.h"
+#include "VulkanInstance.h"
+
+namespace SVE
+{
+enum class TextureType : uint8_t;
+
+enum class RenderResource : uint8_t
+{
+    ComputeBuffers, // particles and GPU culled instances
+    ShadowMapDirect,
+    ShadowMapPoint,
+    Reflection,
+    Refraction,
+    ScreenQuad,
+    ScreenQuadSecond,
+    ScreenQuadDepth,
+    PostEffect,     // indexed by effect index
+    Swapchain
+};
+
+struct RenderResourceId
+{
+    RenderResource type;
+    uint32_t index;
+
+    bool operator==(const RenderResourceId& other) const
+    {
+        return type == other.type && index == other.index;
+    }
+};
+
+// Frame passes with resources they read and write.
+// Passes are declared every frame before recording, graph is compiled only when declaration changes.
+// Compiled graph has passes needed for swapchain output in submission order (unused passes are culled),
+// dependencies between them, and barriers derived from the dependencies: stages, accesses and image layouts
+// of producer and consumer, one barrier per consumer and resource. Transient images with lifetimes that
+// don't overlap are grouped into alias slots by attachment kind (color or depth).
+// TODO: Derived barriers and alias slots are only reported (dump and frame stats). Feature render passes still
+// do layout transitions themselves (final layouts and external subpass dependencies) and own image memory,
+// recording graph barriers instead and binding aliased images to shared memory is not done yet.
+class RenderGraph
+{
+public:
+    explicit RenderGraph(VulkanInstance* vulkanInstance);
+
+    void beginDeclaration();
+    // Reads and writes of the pass are added with following calls
+    void addPass(CommandsType commandsType, uint32_t index, BufferIndex bufferIndex);
+    void addRead(RenderResource type, uint32_t index = 0);
+    void addWrite(RenderResource type, uint32_t index = 0);
+    // Resource sampled as material texture (LastEffect should be resolved by caller)
+    void addTextureRead(TextureType textureType, uint32_t subtype = 0);
+    // Bit per TextureType
+    void addTextureReads(uint32_t textureMask);
+    void endDeclaration();
+
+    // Culled passes shouldn't be recorded
+    bool isPassActive(CommandsType commandsType, uint32_t index = 0) const;
+    uint32_t getActivePassCount() const;
+    uint32_t getCulledPassCount() const;
+    // Dependencies between active passes (one per produced resource use)
+    uint32_t getDependencyCount() const;
+    // Barriers needed by active passes, including first use transitions from undefined layout
+    uint32_t getBarrierCount() const;
+    uint32_t getLayoutTransitionCount() const;
+    // Transient images which could share memory with image used earlier in the frame
+    uint32_t getAliasedImageCount() const;
+
+    // Passes without dependencies between them are grouped into batches, each batch waits for the previous one.
+    // Batched submit sends all batches with single queue submit, otherwise each pass is submitted separately.
+    // With async compute, compute pass is submitted to compute queue first, and the first graphics batch
+    // using its results waits for it.
+    void setSubmitBatching(bool isBatching);
+    // Submits active passes in compiled order, last one finishes the frame
+    void submit() const;
+    uint32_t getQueueSubmitCount() const;
+    uint32_t getSubmitBatchCount() const;
+
+    std::string dump() const;
+
+private:
+    struct Pass
+    {
+        CommandsType commandsType;
+        uint32_t index;
+        BufferIndex bufferIndex;
+        std::vector<RenderResourceId> readList;
+        std::vector<RenderResourceId> writeList;
+    };
+
+    struct Dependency
+    {
+        uint32_t from;
+        uint32_t to;
+        RenderResourceId resource;
+        // write after read only orders passes, producer of other dependencies is needed by consumer
+        bool isWriteAfterRead;
+    };
+
+    // Stages, accesses and layout of resource use by pass
+    struct ResourceState
+    {
+        VkPipelineStageFlags stageMask;
+        VkAccessFlags accessMask;
+        VkImageLayout layout;
+    };
+
+    // Producer equal to consumer means first use of the resource in frame
+    struct Barrier
+    {
+        uint32_t from;
+        uint32_t to;
+        RenderResourceId resource;
+        ResourceState srcState;
+        ResourceState dstState;
+    };
+
+    bool isDeclarationChanged() const;
+    void compile();
+    void buildDependencies();
+    void cullPasses();
+    void sortPasses();
+    void buildBatches();
+    void buildBarriers();
+    void buildAliases();
+    static ResourceState getResourceState(RenderResource type, bool isWrite);
+    bool isComputeQueuePass(uint32_t passIndex) const;
+    int findWriter(const RenderResourceId& resource, uint32_t passIndex, bool before) const;
+
+private:
+    VulkanInstance* _vulkanInstance;
+
+    // declared passes, storage is reused between frames
+    std::vector<Pass> _passList;
+    uint32_t _passCount = 0;
+
+    // last compiled declaration
+    std::vector<Pass> _compiledPassList;
+    std::vector<Dependency> _dependencyList;
+    std::vector<Barrier> _barrierList;
+    // alias slot per transient image, images of the same slot can share memory
+    std::vector<std::pair<RenderResourceId, uint32_t>> _aliasList;
+    uint32_t _aliasSlotCount = 0;
+    std::vector<bool> _isActive;
+    std::vector<uint32_t> _submitOrder;
+    // passes submitted to graphics queue, in submit order
+    std::vector<uint32_t> _graphicsPassList;
+    // passes count per batch, in submit order
+    std::vector<uint32_t> _batchSizeList;
+    // pass submitted to async compute queue (-1 if there is none), graphics batch and pass waiting for it
+    int _computePass = -1;
+    uint32_t _computeWaitBatch = VulkanInstance::NoComputeWait;
+    uint32_t _computeWaitPosition = VulkanInstance::NoComputeWait;
+    mutable std::vector<BufferIndex> _submitBufferList;
+    bool _isSubmitBatching = true;
+    uint32_t _dependencyCount = 0;
+    uint32_t _layoutTransitionCount = 0;
+    bool _isCompiled = false;
+};
+
+} // namespace SVE
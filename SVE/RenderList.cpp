@@ -0,0 +1,441 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#include "RenderList.h"
+#include "SceneNode.h"
+#include "ComputeEntity.h"
+#include "ShaderSettings.h"
+#include "FrameStats.h"
+#include "VulkanInstance.h"
+#include "VulkanTransformBuffer.h"
+#include "VulkanInstanceCulling.h"
+#include "Utils.h"
+#include <algorithm>
+
+namespace SVE
+{
+
+namespace
+{
+
+const uint32_t NoInstanceIndex = UINT32_MAX;
+const uint32_t NoBatchIndex = UINT32_MAX;
+
+} // anon namespace
+
+void RenderList::extract(const std::shared_ptr<SceneNode>& rootNode, uint64_t frameId)
+{
+    clear();
+    extractNode(rootNode.get(), -1, false, frameId);
+
+    // entities of nodes attached to bones are culled with bounds of the entity they follow, as their transform
+    // is known only after animation (attachments should stay within its padded bounds)
+    for (auto& entityItem : _entityList)
+    {
+        const auto& nodeItem = _nodeList[entityItem.nodeIndex];
+        if (!nodeItem.isDynamic || !entityItem.entity->getBoundingBox())
+            continue;
+
+        auto* attachmentNode = &nodeItem;
+        while (!attachmentNode->node->hasEntityAttachment())
+            attachmentNode = &_nodeList[attachmentNode->parentIndex];
+        auto* targetEntity = attachmentNode->node->getEntityAttachment();
+        auto targetItem = std::find_if(_entityList.begin(), _entityList.end(), [targetEntity](const EntityItem& item)
+        {
+            return item.entity == targetEntity;
+        });
+        if (targetItem != _entityList.end() && targetItem->isCullable)
+        {
+            entityItem.isCullable = true;
+            entityItem.worldBounds = targetItem->worldBounds;
+        }
+    }
+}
+
+void RenderList::clear()
+{
+    // keep capacity, so no allocations happen after first frames
+    _nodeList.clear();
+    _entityList.clear();
+    _computeList.clear();
+    _instanceBatches.clear();
+    _groupedBatchIndices.clear();
+    _groupedBatches.clear();
+    for (auto& passList : _passLists)
+    {
+        for (auto& stageList : passList)
+            stageList.clear();
+    }
+}
+
+void RenderList::extractNode(SceneNode* node, int32_t parentIndex, bool isParentDynamic, uint64_t frameId)
+{
+    node->setCurrentFrame(frameId);
+
+    auto nodeIndex = static_cast<int32_t>(_nodeList.size());
+    NodeItem nodeItem {};
+    nodeItem.node = node;
+    nodeItem.parentIndex = parentIndex;
+    nodeItem.entityStart = static_cast<uint32_t>(_entityList.size());
+    nodeItem.isDynamic = isParentDynamic || node->hasEntityAttachment();
+    if (!nodeItem.isDynamic)
+        nodeItem.world = node->getTotalTransformation();
+
+    for (auto& entity : node->getAttachedEntities())
+    {
+        EntityItem entityItem {};
+        entityItem.entity = entity.get();
+        entityItem.nodeIndex = static_cast<uint32_t>(nodeIndex);
+        entityItem.passMask = entity->getPassMask();
+        if (!entity->isRenderToDepth())
+            entityItem.passMask &= ~toPassMask(CommandsType::ScreenQuadDepthPass);
+
+        entityItem.isInstanced = entity->isInstanceRendering();
+        entityItem.batchIndex = NoBatchIndex;
+        entityItem.instanceIndex = NoInstanceIndex;
+        if (entity->isRenderLast())
+            entityItem.stage = PassStage::Deferred;
+        else if (entityItem.isInstanced)
+            entityItem.stage = PassStage::Instanced;
+        else
+            entityItem.stage = PassStage::Start;
+
+        // attached nodes don't have world transform yet, their entities are resolved after extraction
+        auto* boundingBox = entity->getBoundingBox();
+        entityItem.isCullable = boundingBox && !nodeItem.isDynamic;
+        if (entityItem.isCullable)
+            entityItem.worldBounds = transformBoundingBox(*boundingBox, nodeItem.world);
+
+        auto entityIndex = static_cast<uint32_t>(_entityList.size());
+        for (auto pass = 0u; pass < PassCount; pass++)
+        {
+            if (entityItem.passMask & (1u << pass))
+                _passLists[pass][toInt(entityItem.stage)].push_back(entityIndex);
+        }
+
+        if (entity->isComputeEntity())
+            _computeList.push_back(static_cast<ComputeEntity*>(entity.get()));
+
+        _entityList.push_back(entityItem);
+    }
+    nodeItem.entityCount = static_cast<uint32_t>(_entityList.size()) - nodeItem.entityStart;
+    _nodeList.push_back(nodeItem);
+
+    for (auto& child : node->getChildren())
+    {
+        extractNode(child.get(), nodeIndex, nodeItem.isDynamic, frameId);
+    }
+}
+
+void RenderList::cull(CommandsType passType, const CullingVolume& cullingVolume)
+{
+    uint32_t culledCount = 0;
+    for (auto& stageList : _passLists[toInt(passType)])
+    {
+        auto newEnd = std::remove_if(stageList.begin(), stageList.end(), [&](uint32_t entityIndex)
+        {
+            const auto& entityItem = _entityList[entityIndex];
+            return entityItem.isCullable && !isVisible(cullingVolume, entityItem.worldBounds);
+        });
+        culledCount += static_cast<uint32_t>(stageList.end() - newEnd);
+        stageList.erase(newEnd, stageList.end());
+    }
+
+    Engine::getInstance()->getCurrentFrameStats().culledDrawCount[toInt(passType)] += culledCount;
+}
+
+void RenderList::updateInstanceBatches()
+{
+    _instanceBatches.clear();
+
+    // instanced entities which are culled in all passes don't get instances
+    for (auto& passList : _passLists)
+    {
+        for (auto& stageList : passList)
+        {
+            for (auto entityIndex : stageList)
+            {
+                auto& entityItem = _entityList[entityIndex];
+                if (!entityItem.isInstanced || entityItem.batchIndex != NoBatchIndex)
+                    continue;
+
+                auto key = entityItem.entity->getInstanceBatchKey();
+                key.passMask = entityItem.passMask;
+                auto isShared = _useInstanceBatching && entityItem.stage == PassStage::Instanced;
+                entityItem.batchIndex = isShared ? getInstanceBatch(key) : static_cast<uint32_t>(_instanceBatches.size());
+                if (entityItem.batchIndex == _instanceBatches.size())
+                    _instanceBatches.push_back({ key, isShared, 0, 0, 0, 0, 0, 0 });
+                ++_instanceBatches[entityItem.batchIndex].instanceCount;
+            }
+        }
+    }
+
+    auto* vulkanInstance = Engine::getInstance()->getVulkanInstance();
+    auto* instanceCulling = Engine::getInstance()->getInstanceCulling();
+    auto useBuckets = instanceCulling && vulkanInstance->isMultiDrawIndirectSupported();
+    if (useBuckets)
+        groupInstanceBuckets();
+
+    // batches are placed one after another, so each one is a single range of transform buffer
+    auto capacity = vulkanInstance->getTransformBuffer()->getCapacity();
+    uint32_t firstInstance = 0;
+    for (auto& batch : _instanceBatches)
+    {
+        batch.firstInstance = firstInstance;
+        firstInstance += batch.instanceCount;
+    }
+
+    // batches after max count of GPU culling or not fitting into transform buffer are drawn without culling
+    auto culledBatchCount = instanceCulling
+            ? std::min(static_cast<uint32_t>(_instanceBatches.size()), instanceCulling->getMaxBatchCount())
+            : 0u;
+    while (culledBatchCount > 0 && _instanceBatches[culledBatchCount - 1].firstInstance
+                                   + _instanceBatches[culledBatchCount - 1].instanceCount > capacity)
+        --culledBatchCount;
+    _culledBatchCount = culledBatchCount;
+
+    // adjacent culled batches of one bucket are drawn from the first of them
+    uint32_t culledBucketCount = 0;
+    for (auto i = 0u; i < _instanceBatches.size(); i++)
+    {
+        auto& batch = _instanceBatches[i];
+        batch.bucketFirst = i;
+        batch.bucketSize = i < culledBatchCount ? 1 : 0;
+        if (useBuckets && i > 0 && i < culledBatchCount)
+        {
+            const auto& previousBatch = _instanceBatches[i - 1];
+            if (batch.isShared && previousBatch.isShared && batch.key.isSameBucket(previousBatch.key))
+            {
+                batch.bucketFirst = previousBatch.bucketFirst;
+                batch.bucketSize = 0;
+                ++_instanceBatches[batch.bucketFirst].bucketSize;
+            }
+        }
+        if (batch.bucketSize > 0)
+            ++culledBucketCount;
+    }
+    _culledInstanceCount = culledBatchCount < _instanceBatches.size()
+            ? _instanceBatches[culledBatchCount].firstInstance
+            : firstInstance;
+
+    uint32_t instancedEntityCount = 0;
+    for (auto& entityItem : _entityList)
+    {
+        if (entityItem.batchIndex == NoBatchIndex)
+            continue;
+
+        auto batchIndex = entityItem.batchIndex;
+        auto& batch = _instanceBatches[batchIndex];
+        auto drawnCount = std::min(batch.instanceCount, capacity - std::min(batch.firstInstance, capacity));
+        entityItem.entity->setInstanceBatch(batchIndex, batch.firstInstance, drawnCount);
+        entityItem.entity->setCulledInstanceBucket(batch.bucketFirst, _instanceBatches[batch.bucketFirst].bucketSize);
+        if (batch.assignedCount == 0 && batchIndex < culledBatchCount)
+            entityItem.entity->setCulledInstanceBatch(batchIndex, batch.firstInstance);
+
+        entityItem.instanceIndex = batch.firstInstance + batch.assignedCount;
+        ++batch.assignedCount;
+        if (entityItem.instanceIndex >= capacity)
+            entityItem.instanceIndex = NoInstanceIndex;
+        else if (batchIndex < culledBatchCount)
+            instanceCulling->setInstanceBatch(entityItem.instanceIndex, batchIndex);
+        ++instancedEntityCount;
+    }
+
+    // every entity of the batch draws all its instances (and in culled passes all instances of its bucket),
+    // so only the first one is kept in pass lists
+    for (auto pass = 0u; pass < PassCount; pass++)
+    {
+        auto passBit = static_cast<PassMask>(1u << pass);
+        auto isCulledPass = instanceCulling && VulkanInstanceCulling::isCulledPass(static_cast<CommandsType>(pass));
+        auto& stageList = _passLists[pass][toInt(PassStage::Instanced)];
+        auto newEnd = std::remove_if(stageList.begin(), stageList.end(), [&](uint32_t entityIndex)
+        {
+            auto batchIndex = _entityList[entityIndex].batchIndex;
+            if (isCulledPass && batchIndex < culledBatchCount)
+                batchIndex = _instanceBatches[batchIndex].bucketFirst;
+            auto& batch = _instanceBatches[batchIndex];
+            if (batch.drawnPasses & passBit)
+                return true;
+            batch.drawnPasses |= passBit;
+            return false;
+        });
+        stageList.erase(newEnd, stageList.end());
+        for (auto entityIndex : stageList)
+            _entityList[entityIndex].isBatchLeader = true;
+    }
+
+    auto& frameStats = Engine::getInstance()->getCurrentFrameStats();
+    frameStats.instancedEntityCount = instancedEntityCount;
+    frameStats.instanceBatchCount = static_cast<uint32_t>(_instanceBatches.size());
+    frameStats.skippedInstanceCount = firstInstance > capacity ? firstInstance - capacity : 0;
+    frameStats.gpuCulledBatchCount = culledBatchCount;
+    frameStats.gpuCulledBucketCount = culledBucketCount;
+}
+
+void RenderList::applyInstanceCullingCommands(uint32_t bufferIndex, const glm::mat4& viewProjection) const
+{
+    if (auto* instanceCulling = Engine::getInstance()->getInstanceCulling())
+    {
+        instanceCulling->applyComputeCommands(
+                Engine::getInstance()->getVulkanInstance()->getCommandBuffer(bufferIndex),
+                viewProjection,
+                _culledInstanceCount,
+                _culledBatchCount);
+    }
+}
+
+void RenderList::setInstanceBatching(bool enabled)
+{
+    _useInstanceBatching = enabled;
+}
+
+uint32_t RenderList::getInstanceBatch(const InstanceBatchKey& key)
+{
+    // there are few dozens of batches per scene, so linear search is enough
+    for (auto i = 0u; i < _instanceBatches.size(); i++)
+    {
+        if (_instanceBatches[i].isShared && _instanceBatches[i].key == key)
+            return i;
+    }
+    return static_cast<uint32_t>(_instanceBatches.size());
+}
+
+void RenderList::groupInstanceBuckets()
+{
+    // shared batches of the same bucket are moved next to the first one, others keep their order
+    auto& newIndices = _groupedBatchIndices;
+    auto& groupedBatches = _groupedBatches;
+    newIndices.assign(_instanceBatches.size(), NoBatchIndex);
+    groupedBatches.clear();
+    for (auto i = 0u; i < _instanceBatches.size(); i++)
+    {
+        if (newIndices[i] != NoBatchIndex)
+            continue;
+
+        newIndices[i] = static_cast<uint32_t>(groupedBatches.size());
+        groupedBatches.push_back(_instanceBatches[i]);
+        if (!_instanceBatches[i].isShared)
+            continue;
+
+        for (auto j = i + 1; j < _instanceBatches.size(); j++)
+        {
+            if (newIndices[j] == NoBatchIndex && _instanceBatches[j].isShared
+                && _instanceBatches[j].key.isSameBucket(_instanceBatches[i].key))
+            {
+                newIndices[j] = static_cast<uint32_t>(groupedBatches.size());
+                groupedBatches.push_back(_instanceBatches[j]);
+            }
+        }
+    }
+
+    _instanceBatches.swap(groupedBatches);
+    for (auto& entityItem : _entityList)
+    {
+        if (entityItem.batchIndex != NoBatchIndex)
+            entityItem.batchIndex = newIndices[entityItem.batchIndex];
+    }
+}
+
+void RenderList::applyDrawingCommands(CommandsType passType, PassStage stage, uint32_t first, uint32_t count,
+                                      uint32_t bufferIndex, uint32_t imageIndex) const
+{
+    const auto& stageList = _passLists[toInt(passType)][toInt(stage)];
+    for (auto i = first; i < first + count; i++)
+    {
+        _entityList[stageList[i]].entity->applyDrawingCommands(bufferIndex, imageIndex);
+    }
+}
+
+void RenderList::applyDrawingCommands(CommandsType passType, PassStage stage, uint32_t bufferIndex, uint32_t imageIndex) const
+{
+    auto count = static_cast<uint32_t>(getDrawCount(passType, stage));
+    Engine::getInstance()->getCurrentFrameStats().drawCount[toInt(passType)] += count;
+    applyDrawingCommands(passType, stage, 0, count, bufferIndex, imageIndex);
+}
+
+void RenderList::applyDrawingCommands(CommandsType passType, uint32_t bufferIndex, uint32_t imageIndex) const
+{
+    applyDrawingCommands(passType, PassStage::Start, bufferIndex, imageIndex);
+    applyDrawingCommands(passType, PassStage::Instanced, bufferIndex, imageIndex);
+    applyDrawingCommands(passType, PassStage::Deferred, bufferIndex, imageIndex);
+}
+
+void RenderList::applyComputeCommands(uint32_t bufferIndex, uint32_t imageIndex) const
+{
+    for (auto* computeEntity : _computeList)
+    {
+        computeEntity->applyComputeCommands(bufferIndex, imageIndex);
+    }
+}
+
+void RenderList::updateUniforms(UniformDataList& uniformDataList)
+{
+    auto oldModel = uniformDataList[0]->model;
+    auto* vulkanInstance = Engine::getInstance()->getVulkanInstance();
+    auto* instanceTransforms = vulkanInstance->getTransformBuffer()->getMappedData(vulkanInstance->getCurrentImageIndex());
+    for (auto& nodeItem : _nodeList)
+    {
+        // Attachment transformation is updated by parent entities uniforms update, so it's evaluated here in scene order
+        if (nodeItem.isDynamic)
+        {
+            nodeItem.node->markTransformationDirty();
+            nodeItem.world = nodeItem.node->getTotalTransformation();
+        }
+
+        if (nodeItem.entityCount == 0)
+            continue;
+
+        for (auto& uniformData : uniformDataList)
+            uniformData->model = oldModel * nodeItem.world;
+
+        for (auto i = nodeItem.entityStart; i < nodeItem.entityStart + nodeItem.entityCount; i++)
+        {
+            const auto& entityItem = _entityList[i];
+            if (entityItem.instanceIndex != NoInstanceIndex)
+                instanceTransforms[entityItem.instanceIndex] = oldModel * nodeItem.world;
+            if (entityItem.stage == PassStage::Instanced && !entityItem.isBatchLeader)
+                entityItem.entity->skipUniformsUpdate();
+            else
+                entityItem.entity->updateUniforms(uniformDataList);
+        }
+    }
+
+    for (auto& uniformData : uniformDataList)
+        uniformData->model = oldModel;
+}
+
+const std::vector<RenderList::NodeItem>& RenderList::getNodeList() const
+{
+    return _nodeList;
+}
+
+const std::vector<RenderList::EntityItem>& RenderList::getEntityList() const
+{
+    return _entityList;
+}
+
+size_t RenderList::getDrawCount(CommandsType passType) const
+{
+    size_t count = 0;
+    for (auto& stageList : _passLists[toInt(passType)])
+        count += stageList.size();
+    return count;
+}
+
+size_t RenderList::getDrawCount(CommandsType passType, PassStage stage) const
+{
+    return _passLists[toInt(passType)][toInt(stage)].size();
+}
+
+uint32_t RenderList::getPassTextureMask(CommandsType passType) const
+{
+    uint32_t textureMask = 0;
+    for (auto& stageList : _passLists[toInt(passType)])
+    {
+        for (auto index : stageList)
+            textureMask |= _entityList[index].entity->getExternalTextureMask();
+    }
+    return textureMask;
+}
+
+} // namespace SVE
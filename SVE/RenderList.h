@@ -0,0 +1,121 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include <memory>
+#include <vector>
+#include "Libs.h"
+#include "Engine.h"
+#include "Frustum.h"
+
+namespace SVE
+{
+class SceneNode;
+class ComputeEntity;
+
+enum class PassStage : uint8_t
+{
+    Start,
+    Instanced,
+    Deferred
+};
+
+static const uint8_t PassStageCount = 3;
+
+// Flat snapshot of the scene graph, extracted once per frame.
+// Passes record their commands from per-pass lists instead of walking the scene tree.
+class RenderList
+{
+public:
+    struct NodeItem
+    {
+        SceneNode* node;
+        int32_t parentIndex;
+        uint32_t entityStart;
+        uint32_t entityCount;
+        // node transformation depends on entity attachment (bones), so it's re-evaluated on uniforms update
+        bool isDynamic;
+        glm::mat4 world;
+    };
+
+    struct EntityItem
+    {
+        Entity* entity;
+        uint32_t nodeIndex;
+        PassMask passMask;
+        PassStage stage;
+        bool isCullable;
+        BoundingBox worldBounds;
+        // instanced entities get batch and index in transform buffer, unless they are culled in all passes
+        bool isInstanced;
+        uint32_t batchIndex;
+        uint32_t instanceIndex;
+        // instanced entity is kept in pass lists and draws its batch, uniforms of other batch entities aren't used
+        bool isBatchLeader;
+    };
+
+    void extract(const std::shared_ptr<SceneNode>& rootNode, uint64_t frameId);
+    void clear();
+    // Removes entities outside of culling volume from pass lists
+    void cull(CommandsType passType, const CullingVolume& cullingVolume);
+
+    // Groups instanced entities by batch key, assigns their transform buffer indices and keeps one entity per batch
+    // in pass lists (only these entities update their uniforms). Should be called after culling and before recording, transforms are written on uniforms update.
+    void updateInstanceBatches();
+    // Records GPU culling of instance batches (if it's enabled) against main camera frustum
+    void applyInstanceCullingCommands(uint32_t bufferIndex, const glm::mat4& viewProjection) const;
+    // If disabled, every instanced entity is drawn with its own draw call
+    void setInstanceBatching(bool enabled);
+
+    // Draws part of stage list, doesn't modify any shared state, so chunks can be recorded in parallel
+    void applyDrawingCommands(CommandsType passType, PassStage stage, uint32_t first, uint32_t count,
+                              uint32_t bufferIndex, uint32_t imageIndex) const;
+    void applyDrawingCommands(CommandsType passType, PassStage stage, uint32_t bufferIndex, uint32_t imageIndex) const;
+    void applyDrawingCommands(CommandsType passType, uint32_t bufferIndex, uint32_t imageIndex) const;
+    void applyComputeCommands(uint32_t bufferIndex, uint32_t imageIndex) const;
+    void updateUniforms(UniformDataList& uniformDataList);
+
+    const std::vector<NodeItem>& getNodeList() const;
+    const std::vector<EntityItem>& getEntityList() const;
+    size_t getDrawCount(CommandsType passType) const;
+    size_t getDrawCount(CommandsType passType, PassStage stage) const;
+    // Render target textures sampled by entities drawn in pass (bit per TextureType)
+    uint32_t getPassTextureMask(CommandsType passType) const;
+
+private:
+    void extractNode(SceneNode* node, int32_t parentIndex, bool isParentDynamic, uint64_t frameId);
+    uint32_t getInstanceBatch(const InstanceBatchKey& key);
+    void groupInstanceBuckets();
+
+private:
+    struct InstanceBatch
+    {
+        InstanceBatchKey key;
+        // entities drawn after others (or all entities if batching is disabled) get batches of their own
+        bool isShared;
+        uint32_t firstInstance;
+        uint32_t instanceCount;
+        uint32_t assignedCount;
+        // passes in which an entity of the batch is kept for drawing
+        PassMask drawnPasses;
+        // GPU culled batches are drawn by bucket (see InstanceBatchKey::isSameBucket), batch count is
+        // set in its first batch and is 0 for batches which aren't culled
+        uint32_t bucketFirst;
+        uint32_t bucketSize;
+    };
+
+    std::vector<NodeItem> _nodeList;
+    std::vector<EntityItem> _entityList;
+    std::vector<ComputeEntity*> _computeList;
+    // indices into _entityList, in scene order
+    std::vector<uint32_t> _passLists[PassCount][PassStageCount];
+    std::vector<InstanceBatch> _instanceBatches;
+    // groupInstanceBuckets temporaries, kept to reuse their capacity
+    std::vector<uint32_t> _groupedBatchIndices;
+    std::vector<InstanceBatch> _groupedBatches;
+    bool _useInstanceBatching = true;
+    uint32_t _culledBatchCount = 0;
+    uint32_t _culledInstanceCount = 0;
+};
+
+} // namespace SVE
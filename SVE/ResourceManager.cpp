@@ -82,6 +82,48 @@ EngineSettings loadEngine(const std::string& data)
     setOptional(engineSettings.useScreenQuad = document["useScreenQuad"].GetBool());
     setOptional(engineSettings.useCascadeShadowMap = document["useCascadeShadowMap"].GetBool());
     setOptional(engineSettings.particlesEnabled = document["particlesEnabled"].GetBool());
+    setOptional(engineSettings.useFrustumCulling = document["useFrustumCulling"].GetBool());
+    setOptional(engineSettings.recordingThreads =
+            document["recordingThreads"].IsString()
+                ? (document["recordingThreads"].GetString() == std::string("best")
+                       ? EngineSettings::BEST_THREADS_AVAILABLE
+                       : throw VulkanException("Incorrect recording threads count"))
+                : document["recordingThreads"].GetInt());
+    setOptional(engineSettings.benchmarkRecording = document["benchmarkRecording"].GetBool());
+    setOptional(engineSettings.uniformArenaBlockSize = document["uniformArenaBlockSize"].GetUint());
+    setOptional(engineSettings.geometryArenaBlockSize = document["geometryArenaBlockSize"].GetUint());
+    setOptional(engineSettings.reportFreeResources = document["reportFreeResources"].GetBool());
+    setOptional(engineSettings.maxInstanceTransforms = document["maxInstanceTransforms"].GetUint());
+    setOptional(engineSettings.useGpuCulling = document["useGpuCulling"].GetBool());
+    setOptional(engineSettings.maxGpuCulledBatches = document["maxGpuCulledBatches"].GetUint());
+    setOptional(engineSettings.validateGpuCulling = document["validateGpuCulling"].GetBool());
+    setOptional(engineSettings.useBindlessTextures = document["useBindlessTextures"].GetBool());
+    setOptional(engineSettings.maxBindlessTextures = document["maxBindlessTextures"].GetUint());
+    setOptional(engineSettings.dumpRenderGraph = document["dumpRenderGraph"].GetBool());
+    setOptional(engineSettings.mergeScreenQuadPasses = document["mergeScreenQuadPasses"].GetBool());
+    setOptional(engineSettings.reportAttachmentTraffic = document["reportAttachmentTraffic"].GetBool());
+    setOptional(engineSettings.batchQueueSubmits = document["batchQueueSubmits"].GetBool());
+    setOptional(engineSettings.benchmarkQueueSubmits = document["benchmarkQueueSubmits"].GetBool());
+    setOptional(engineSettings.useAsyncCompute = document["useAsyncCompute"].GetBool());
+    setOptional(engineSettings.profileAsyncCompute = document["profileAsyncCompute"].GetBool());
+    setOptional(engineSettings.useTransferQueue = document["useTransferQueue"].GetBool());
+    setOptional(engineSettings.uploadRingSize = document["uploadRingSize"].GetUint());
+    setOptional(engineSettings.reportUploads = document["reportUploads"].GetBool());
+    setOptional(engineSettings.useCompactVertices = document["useCompactVertices"].GetBool());
+    setOptional(engineSettings.reportMeshMemory = document["reportMeshMemory"].GetBool());
+    setOptional(engineSettings.reportMeshOptimization = document["reportMeshOptimization"].GetBool());
+    setOptional(engineSettings.useBakedMeshes = document["useBakedMeshes"].GetBool());
+    setOptional(engineSettings.reportMeshLoading = document["reportMeshLoading"].GetBool());
+    setOptional(engineSettings.shareAnimationPoses = document["shareAnimationPoses"].GetBool());
+    setOptional(engineSettings.animationTimeStep = document["animationTimeStep"].GetFloat());
+    setOptional(engineSettings.animationPhaseBuckets = document["animationPhaseBuckets"].GetUint());
+    setOptional(engineSettings.animationThreads =
+            document["animationThreads"].IsString()
+                ? (document["animationThreads"].GetString() == std::string("best")
+                       ? EngineSettings::BEST_THREADS_AVAILABLE
+                       : throw VulkanException("Incorrect animation threads count"))
+                : document["animationThreads"].GetInt());
+    setOptional(engineSettings.reportAnimation = document["reportAnimation"].GetBool());
 
     return engineSettings;
 }
@@ -228,6 +270,9 @@ ShaderSettings loadShader(FSEntityPtr directory, const std::string& data)
     setOptional(shaderSettings.vertexInfo = getVertexInfo(document));
     setOptional(shaderSettings.maxGlyphCount = document["maxGlyphCount"].GetUint());
     setOptional(shaderSettings.samplerNamesList = getStringList(document, "samplerNamesList"));
+    setOptional(shaderSettings.useBindlessTextures = document["useBindlessTextures"].GetBool());
+    setOptional(shaderSettings.bindlessFallback = document["bindlessFallback"].GetString());
+    setOptional(shaderSettings.instancedVariant = document["instancedVariant"].GetString());
     shaderSettings.filename = directory->resolveFilePath(document["filename"].GetString());
     shaderSettings.shaderType = shaderTypeMap.at(document["shaderType"].GetString());
     setOptional(shaderSettings.entryPoint = document["entryPoint"].GetString());
@@ -426,9 +471,7 @@ MaterialSettings loadMaterial(FSEntityPtr directory, const std::string& data)
     setOptional(materialSettings.useMultisampling = document["useMultisampling"].GetBool());
     setOptional(materialSettings.useAlphaBlending = document["useAlphaBlending"].GetBool());
     setOptional(materialSettings.useMRT = document["useMRT"].GetBool());
-    setOptional(materialSettings.useInstancing = document["useInstancing"].GetBool());
     setOptional(materialSettings.ignoreShadow = document["ignoreShadow"].GetBool());
-    setOptional(materialSettings.instanceMaxCount = document["instanceMaxCount"].GetUint());
     setOptional(materialSettings.srcBlendFactor = blendFactor.at(document["srcBlendFactor"].GetString()));
     setOptional(materialSettings.dstBlendFactor = blendFactor.at(document["dstBlendFactor"].GetString()));
     setOptional(materialSettings.isCubemap = document["isCubemap"].GetBool());
@@ -442,6 +485,16 @@ MaterialSettings loadMaterial(FSEntityPtr directory, const std::string& data)
     return materialSettings;
 }
 
+std::vector<std::string> getSubmeshMaterials(rj::Document& document)
+{
+    std::vector<std::string> materialList;
+    auto list = document["submeshMaterials"].GetArray();
+    for (auto& item : list)
+        materialList.emplace_back(item.GetString());
+
+    return materialList;
+}
+
 MeshLoadSettings loadMesh(FSEntityPtr directory, const std::string& data)
 {
     rj::Document document;
@@ -454,6 +507,8 @@ MeshLoadSettings loadMesh(FSEntityPtr directory, const std::string& data)
     setOptional(meshLoadSettings.switchYZ = document["switchYZ"].GetBool());
     setOptional(meshLoadSettings.scale = loadVector<3>(document, "scale"));
     setOptional(meshLoadSettings.animationSpeed = document["animationSpeed"].GetFloat());
+    setOptional(meshLoadSettings.animationBoundsMargin = document["animationBoundsMargin"].GetFloat());
+    setOptional(meshLoadSettings.submeshMaterials = getSubmeshMaterials(document));
 
     return meshLoadSettings;
 }
@@ -618,6 +673,16 @@ std::string ResourceManager::loadFileContent(const std::string& file) const
     return _fileSystem->getFileContent(_fileSystem->getEntity(file));
 }
 
+FileContentPtr ResourceManager::mapFileContent(const std::string& file) const
+{
+    return _fileSystem->mapFileContent(_fileSystem->getEntity(file));
+}
+
+bool ResourceManager::isFileExist(const std::string& file) const
+{
+    return _fileSystem->getEntity(file)->exist();
+}
+
 void ResourceManager::loadDirectory(const std::string& directory, LoadData& loadData, const std::shared_ptr<FileSystem>& fileSystem)
 {
     auto dir = fileSystem->getEntity(directory, true);
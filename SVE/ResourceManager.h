@@ -43,6 +43,8 @@ public:
     static LoadData getLoadDataFromFolder(const std::string& folder, bool isFolder, const std::shared_ptr<FileSystem>& fileSystem);
     const std::vector<std::string> getFolderList() const;
     std::string loadFileContent(const std::string& file) const;
+    FileContentPtr mapFileContent(const std::string& file) const;
+    bool isFileExist(const std::string& file) const;
     std::string getSavePath() const;
     std::shared_ptr<FileSystem> getFileSystem() const;
 
@@ -4,6 +4,7 @@
 #include "SceneNode.h"
 #include "SceneManager.h"
 #include "Engine.h"
+#include "FrameStats.h"
 #include <algorithm>
 
 namespace SVE
@@ -36,6 +37,7 @@ void SceneNode::setParent(std::shared_ptr<SceneNode> parent)
         }
     }
     _parent = std::move(parent);
+    markTransformationDirty();
 }
 
 std::shared_ptr<SceneNode> SceneNode::getParent() const
@@ -87,6 +89,7 @@ void SceneNode::detachSceneNode(std::shared_ptr<SceneNode> sceneNode)
     {
         _sceneNodeList.remove(sceneNode);
         sceneNode->_parent.reset();
+        sceneNode->markTransformationDirty();
     }
 }
 
@@ -106,19 +109,36 @@ glm::mat4 SceneNode::getNodeTransformation() const
 void SceneNode::setNodeTransformation(glm::mat4 transform)
 {
     _transformation = std::move(transform);
+    markTransformationDirty();
 }
 
-glm::mat4 SceneNode::getTotalTransformation() const
+const glm::mat4& SceneNode::getTotalTransformation() const
 {
-    glm::mat4 totalTransform = glm::mat4(1);
-    auto node = shared_from_this();
-    while (node)
+    if (_isTotalTransformationDirty)
     {
-        totalTransform *= node->getNodeTransformation();
-        node = node->getParent();
+        auto parent = _parent.lock();
+        _totalTransformation = parent
+                ? parent->getTotalTransformation() * getNodeTransformation()
+                : getNodeTransformation();
+        _isTotalTransformationDirty = false;
+
+        ++Engine::getInstance()->getCurrentFrameStats().worldTransformUpdates;
     }
 
-    return totalTransform;
+    return _totalTransformation;
+}
+
+void SceneNode::markTransformationDirty()
+{
+    // children of dirty node are always dirty too
+    if (_isTotalTransformationDirty)
+        return;
+
+    _isTotalTransformationDirty = true;
+    for (auto& child : _sceneNodeList)
+    {
+        child->markTransformationDirty();
+    }
 }
 
 void SceneNode::setCurrentFrame(uint64_t frame)
@@ -141,6 +161,17 @@ void SceneNode::setEntityAttachment(std::shared_ptr<Entity> entity, const std::s
     _attachment = std::move(entity);
     _attachment->subscribeToAttachment(attachmentName);
     _attachmentName = attachmentName;
+    markTransformationDirty();
+}
+
+bool SceneNode::hasEntityAttachment() const
+{
+    return _attachment != nullptr;
+}
+
+Entity* SceneNode::getEntityAttachment() const
+{
+    return _attachment.get();
 }
 
 } // namespace SVE
\ No newline at end of file
@@ -26,6 +26,8 @@ public:
     std::shared_ptr<SceneNode> getParent() const;
 
     void setEntityAttachment(std::shared_ptr<Entity> entity, const std::string& attachmentName);
+    bool hasEntityAttachment() const;
+    Entity* getEntityAttachment() const;
 
     void attachEntity(std::shared_ptr<Entity> entity);
     void detachEntity(std::shared_ptr<Entity> entity);
@@ -40,7 +42,9 @@ public:
     glm::mat4 getNodeTransformation() const;
     virtual void setNodeTransformation(glm::mat4 transform);
 
-    glm::mat4 getTotalTransformation() const;
+    // World transformation, cached until this node or one of its parents is changed
+    const glm::mat4& getTotalTransformation() const;
+    void markTransformationDirty();
 
 private:
     std::string _name;
@@ -55,6 +59,8 @@ private:
     bool _entitiesHidden = false;
 
     glm::mat4 _transformation = glm::mat4(1);
+    mutable glm::mat4 _totalTransformation = glm::mat4(1);
+    mutable bool _isTotalTransformationDirty = true;
 };
 
 } // namespace SVE
\ No newline at end of file
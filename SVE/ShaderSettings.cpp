@@ -5,10 +5,33 @@
 #include "ShaderSettings.h"
 #include "ParticleSystemSettings.h"
 #include "VulkanException.h"
+#include <algorithm>
+#include <cstring>
 
 namespace SVE
 {
 
+namespace
+{
+
+template <typename T>
+size_t writeValue(const T& value, char* destination, size_t maxSize)
+{
+    auto size = std::min(sizeof(T), maxSize);
+    memcpy(destination, &value, size);
+    return size;
+}
+
+template <typename T>
+size_t writeList(const std::vector<T>& list, char* destination, size_t maxSize)
+{
+    auto size = std::min(sizeof(T) * list.size(), maxSize);
+    memcpy(destination, list.data(), size);
+    return size;
+}
+
+} // anon namespace
+
 const std::map<UniformType, size_t>& getUniformSizeMap()
 {
     static const std::map<UniformType, size_t> uniformSizeMap {
@@ -61,23 +84,44 @@ const std::map<BufferType, size_t>& getStorageBufferSizeMap()
     return bufferSizeMap;
 }
 
-std::vector<char> getStorageDataByType(const StorageData& data, BufferType type)
+size_t computeUniformLayout(const ShaderSettings& shaderSettings, std::vector<UniformLayoutEntry>& uniformLayout)
 {
     const auto& sizeMap = getUniformSizeMap();
-    switch (type)
+    auto getMaxCount = [&shaderSettings](UniformType uniformType) -> uint32_t
     {
-        case BufferType::AtomicCounter:
-        {
-            return std::vector<char>();
-        }
-        case BufferType::ModelMatrixList:
-        {
-            const char* byteData = reinterpret_cast<const char*>(data.modelList.data());
-            return std::vector<char>(byteData, byteData + sizeof(glm::mat4) * data.modelList.size());
+        switch (uniformType)
+        {
+            case UniformType::BoneMatrices: return shaderSettings.maxBonesSize;
+            case UniformType::LightPoint: return shaderSettings.maxShadowPointLightSize;
+            case UniformType::LightPointSimple: return shaderSettings.maxPointLightSize;
+            case UniformType::LightLine: return shaderSettings.maxLineLightSize;
+            case UniformType::LightPointViewProjectionList: return shaderSettings.maxLightSize;
+            case UniformType::LightDirectViewProjectionList: return shaderSettings.maxCascadeLightSize;
+            case UniformType::ViewProjectionMatrixList: return shaderSettings.maxViewProjectionMatrices;
+            case UniformType::GlyphInfoList: return shaderSettings.maxGlyphCount;
+            case UniformType::TextSymbolList: return shaderSettings.maxTextSize;
+            default: return 1;
         }
+    };
+
+    size_t uniformsSize = 0;
+    uniformLayout.clear();
+    for (const auto& info : shaderSettings.uniformList)
+    {
+        auto sizeIter = sizeMap.find(info.uniformType);
+        if (sizeIter == sizeMap.end())
+            continue;
+
+        UniformLayoutEntry entry {};
+        entry.uniformType = info.uniformType;
+        entry.offset = static_cast<uint32_t>(uniformsSize);
+        entry.size = static_cast<uint32_t>(sizeIter->second * getMaxCount(info.uniformType));
+        uniformLayout.push_back(entry);
+
+        uniformsSize += entry.size;
     }
 
-    throw VulkanException("Unsupported uniform type");
+    return uniformsSize;
 }
 
 std::vector<char> getUniformDataByType(const UniformData& data, UniformType type)
@@ -270,22 +314,161 @@ std::vector<char> getUniformDataByType(const UniformData& data, UniformType type
     throw VulkanException("Unsupported uniform type");
 }
 
-void updateStorageDataByUniforms(const UniformData& data, StorageData& storageData, BufferType type)
+size_t writeUniformData(const UniformData& data, const EntityUniformData* entityData, UniformType type,
+                        char* destination, size_t maxSize)
 {
-    switch (type)
+    if (entityData)
     {
-        case BufferType::AtomicCounter:
-        {
-            return;
+        switch (type)
+        {
+            case UniformType::MaterialInfo:
+                return writeValue(entityData->materialInfo, destination, maxSize);
+            case UniformType::Time:
+                return writeValue(entityData->time, destination, maxSize);
+            case UniformType::CustomFloat:
+                return writeValue(entityData->customFloat, destination, maxSize);
+            case UniformType::CustomVec4:
+                return writeValue(entityData->customVec4, destination, maxSize);
+            case UniformType::CustomMat4:
+                return writeValue(entityData->customMat4, destination, maxSize);
+            case UniformType::BoneMatrices:
+                if (entityData->bones)
+                    return writeList(*entityData->bones, destination, maxSize);
+                break;
+            default:
+                break;
         }
-        case BufferType::ModelMatrixList:
+    }
+
+    switch (type)
+    {
+        case UniformType::ModelMatrix:
+            return writeValue(data.model, destination, maxSize);
+        case UniformType::ViewMatrix:
+            return writeValue(data.view, destination, maxSize);
+        case UniformType::ProjectionMatrix:
+            return writeValue(data.projection, destination, maxSize);
+        case UniformType::InverseModelMatrix:
+            return writeValue(glm::inverse(data.model), destination, maxSize);
+        case UniformType::ModelViewProjectionMatrix:
+            return writeValue(data.projection * data.view * data.model, destination, maxSize);
+        case UniformType::ViewProjectionMatrix:
+            return writeValue(data.projection * data.view, destination, maxSize);
+        case UniformType::ViewProjectionMatrixList:
+            return writeList(data.viewProjectionList, destination, maxSize);
+        case UniformType::ViewProjectionMatrixSize:
         {
-            storageData.modelList.push_back(data.model);
-            return;
+            uint32_t vpListSize[4] = { static_cast<uint32_t>(data.viewProjectionList.size()) };
+            return writeValue(vpListSize, destination, maxSize);
         }
+        case UniformType::CameraPosition:
+            return writeValue(data.cameraPos, destination, maxSize);
+        case UniformType::MaterialInfo:
+            return writeValue(data.materialInfo, destination, maxSize);
+        case UniformType::LightInfo:
+            return writeValue(data.lightInfo, destination, maxSize);
+        case UniformType::LightDirectional:
+            return writeValue(data.dirLight, destination, maxSize);
+        case UniformType::LightPoint:
+            return writeList(data.shadowPointLightList, destination, maxSize);
+        case UniformType::LightPointSimple:
+            return writeList(data.pointLightList, destination, maxSize);
+        case UniformType::LightLine:
+            return writeList(data.lineLightList, destination, maxSize);
+        case UniformType::LightSpot:
+            return writeValue(data.spotLight, destination, maxSize);
+        case UniformType::LightPointViewProjectionList:
+            return writeList(data.lightPointViewProjectionList, destination, maxSize);
+        case UniformType::LightDirectViewProjectionList:
+            return writeList(data.lightDirectViewProjectionList, destination, maxSize);
+        case UniformType::LightDirectViewProjection:
+            return data.lightDirectViewProjectionList.empty()
+                   ? 0
+                   : writeValue(data.lightDirectViewProjectionList.front(), destination, maxSize);
+        case UniformType::BoneMatrices:
+            return writeList(data.bones, destination, maxSize);
+        case UniformType::ClipPlane:
+            return writeValue(data.clipPlane, destination, maxSize);
+        case UniformType::ParticleEmitter:
+            return writeValue(data.particleEmitter, destination, maxSize);
+        case UniformType::ParticleAffector:
+            return writeValue(data.particleAffector, destination, maxSize);
+        case UniformType::ParticleCount:
+            return writeValue(data.particleCount, destination, maxSize);
+        case UniformType::SpritesheetSize:
+            return writeValue(data.spritesheetSize, destination, maxSize);
+        case UniformType::ImageSize:
+            return writeValue(data.imageSize, destination, maxSize);
+        case UniformType::TextInfo:
+            return writeValue(data.textInfo, destination, maxSize);
+        case UniformType::GlyphInfoList:
+            return writeList(data.glyphList, destination, maxSize);
+        case UniformType::TextSymbolList:
+            return writeList(data.textSymbolList, destination, maxSize);
+        case UniformType::OverlayInfo:
+            return writeValue(data.overlayInfo, destination, maxSize);
+        case UniformType::CustomFloat:
+            return writeValue(data.customFloat, destination, maxSize);
+        case UniformType::CustomVec4:
+            return writeValue(data.customVec4, destination, maxSize);
+        case UniformType::CustomMat4:
+            return writeValue(data.customMat4, destination, maxSize);
+        case UniformType::Time:
+            return writeValue(data.time, destination, maxSize);
+        case UniformType::DeltaTime:
+            return writeValue(data.deltaTime, destination, maxSize);
     }
 
-    throw VulkanException("Unsupported SSBO type");
+    throw VulkanException("Unsupported uniform type");
+}
+
+void resetUniformData(UniformData& data)
+{
+    UniformData resetData {};
+    // move cleared lists to reset data, so their memory is reused
+    auto keepList = [](auto& list, auto& resetList)
+    {
+        list.clear();
+        std::swap(list, resetList);
+    };
+    keepList(data.viewProjectionList, resetData.viewProjectionList);
+    keepList(data.lightDirectViewProjectionList, resetData.lightDirectViewProjectionList);
+    keepList(data.lightPointViewProjectionList, resetData.lightPointViewProjectionList);
+    keepList(data.shadowPointLightList, resetData.shadowPointLightList);
+    keepList(data.pointLightList, resetData.pointLightList);
+    keepList(data.lineLightList, resetData.lineLightList);
+    keepList(data.bones, resetData.bones);
+    keepList(data.glyphList, resetData.glyphList);
+    keepList(data.textSymbolList, resetData.textSymbolList);
+
+    data = std::move(resetData);
+}
+
+void fillPassUniformData(const UniformData& data, PassUniformData& passData)
+{
+    passData.view = data.view;
+    passData.projection = data.projection;
+    passData.viewProjection = data.projection * data.view;
+    passData.lightDirectViewProjection = data.lightDirectViewProjectionList.empty()
+            ? glm::mat4(1)
+            : data.lightDirectViewProjectionList.front();
+    passData.cameraPos = data.cameraPos;
+    passData.clipPlane = data.clipPlane;
+    passData.time = data.time;
+    passData.deltaTime = data.deltaTime;
+}
+
+void fillFrameUniformData(const UniformData& data, FrameUniformData& frameData)
+{
+    frameData.dirLight = data.dirLight;
+    frameData.spotLight = data.spotLight;
+    std::copy_n(data.lineLightList.begin(),
+                std::min<size_t>(data.lineLightList.size(), FrameUniformData::MaxLineLights),
+                frameData.lineLight);
+    std::copy_n(data.pointLightList.begin(),
+                std::min<size_t>(data.pointLightList.size(), FrameUniformData::MaxPointLights),
+                frameData.pointLight);
+    frameData.lightInfo = data.lightInfo;
 }
 
-} // namespace SVE
\ No newline at end of file
+} // namespace SVE
@@ -78,11 +78,6 @@ struct MaterialInfo
     float _padding[2];
 };
 
-struct StorageData
-{
-    std::vector<glm::mat4> modelList;
-};
-
 struct UniformData
 {
     glm::mat4 model;
@@ -120,6 +115,44 @@ struct UniformData
     glm::mat4 customMat4;
 };
 
+// Uniforms which differ per entity, written over shared per-pass data
+struct EntityUniformData
+{
+    MaterialInfo materialInfo {};
+    float time = 0;
+    float customFloat = 0;
+    glm::vec4 customVec4 {};
+    glm::mat4 customMat4 {};
+    const std::vector<glm::mat4>* bones = nullptr; // per-pass bones are used if not set
+};
+
+// Data shared by all draws in a pass, bound once per pass (std140 layout of passData.glsl)
+struct PassUniformData
+{
+    glm::mat4 view;
+    glm::mat4 projection;
+    glm::mat4 viewProjection;
+    glm::mat4 lightDirectViewProjection;
+    glm::vec4 cameraPos;
+    glm::vec4 clipPlane;
+    float time;
+    float deltaTime;
+    float _padding[2];
+};
+
+// Lights are the same in all passes, so they are written once per frame and bound with pass data
+struct FrameUniformData
+{
+    static constexpr uint32_t MaxLineLights = 15;
+    static constexpr uint32_t MaxPointLights = 20;
+
+    DirLight dirLight;
+    SpotLight spotLight;
+    LineLight lineLight[MaxLineLights];
+    PointLight pointLight[MaxPointLights];
+    LightInfo lightInfo;
+};
+
 struct UniformInfo
 {
     UniformType uniformType;
@@ -144,6 +177,7 @@ struct VertexInfo
     uint8_t positionSize = 3;
     uint8_t colorSize = 3;
     uint8_t customCount = 0;
+    // mesh vertex streams (interleaved vertex and skin bindings), otherwise all attributes are packed to single binding
     bool separateBinding = true;
 };
 
@@ -155,6 +189,13 @@ struct ShaderSettings
     VertexInfo vertexInfo;
     std::vector<UniformInfo> uniformList;
     std::vector<std::string> samplerNamesList;
+    // samplers are taken from global texture table (set 4) by indices in push constants
+    bool useBindlessTextures = false;
+    // shader used instead of this one if texture table isn't supported
+    std::string bindlessFallback;
+    // vertex shader which reads model matrices from transform buffer (ModelMatrixList) instead of uniforms,
+    // materials with this shader get instanced variant, so their entities are batched
+    std::string instancedVariant;
     std::vector<BufferType> bufferList; // currently only supported in compute shaders
     uint32_t maxBonesSize = 0;
     uint32_t maxShadowPointLightSize = 4;
@@ -169,10 +210,26 @@ struct ShaderSettings
     std::string entryPoint = "main";
 };
 
+// Uniform placement in shader uniform block, computed once per shader
+struct UniformLayoutEntry
+{
+    UniformType uniformType;
+    uint32_t offset;
+    uint32_t size; // reserved size, lists reserve space for max elements count
+};
+
 const std::map<UniformType, size_t>& getUniformSizeMap();
 const std::map<BufferType, size_t>& getStorageBufferSizeMap();
 std::vector<char> getUniformDataByType(const UniformData& data, UniformType type);
-std::vector<char> getStorageDataByType(const StorageData& data, BufferType type);
-void updateStorageDataByUniforms(const UniformData& data, StorageData& storageData, BufferType type);
+// Places shader uniforms one after another, returns uniform block size
+size_t computeUniformLayout(const ShaderSettings& shaderSettings, std::vector<UniformLayoutEntry>& uniformLayout);
+// Copies uniform directly to destination (not more than maxSize bytes), returns bytes count written.
+// Entity data (if set) replaces per-pass values of per-entity uniforms.
+size_t writeUniformData(const UniformData& data, const EntityUniformData* entityData, UniformType type,
+                        char* destination, size_t maxSize);
+// Resets data to default values, but keeps lists memory for reuse
+void resetUniformData(UniformData& data);
+void fillPassUniformData(const UniformData& data, PassUniformData& passData);
+void fillFrameUniformData(const UniformData& data, FrameUniformData& frameData);
 
 } // namespace SVE
\ No newline at end of file
@@ -0,0 +1,253 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+
+#include "SkeletalAnimation.h"
+#include <cmath>
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+namespace SVE
+{
+
+namespace
+{
+
+glm::mat4 toGlm(const aiMatrix4x4& matrix)
+{
+    return glm::transpose(glm::make_mat4(&matrix.a1));
+}
+
+glm::vec3 toGlm(const aiVector3D& vector)
+{
+    return glm::vec3(vector.x, vector.y, vector.z);
+}
+
+glm::quat toGlm(const aiQuaternion& quaternion)
+{
+    return glm::quat(quaternion.w, quaternion.x, quaternion.y, quaternion.z);
+}
+
+template <typename Key, typename Value>
+void convertKeys(const Key* keys, uint32_t keyCount, std::vector<float>& times, std::vector<Value>& values)
+{
+    times.resize(keyCount);
+    values.resize(keyCount);
+    for (auto i = 0u; i < keyCount; i++)
+    {
+        times[i] = static_cast<float>(keys[i].mTime);
+        values[i] = toGlm(keys[i].mValue);
+    }
+}
+
+// Finds interval [key, key + 1] containing time, search is started from key found for previous frame
+uint32_t findKey(const std::vector<float>& times, float time, uint32_t& key)
+{
+    if (key + 1 >= times.size() || time < times[key])
+        key = 0;
+    while (key + 2 < times.size() && time >= times[key + 1])
+        key++;
+    return key;
+}
+
+float getInterpolationFactor(const std::vector<float>& times, float time, uint32_t key)
+{
+    auto length = times[key + 1] - times[key];
+    if (length <= 0.0f)
+        return 0.0f;
+    return glm::clamp((time - times[key]) / length, 0.0f, 1.0f);
+}
+
+glm::vec3 sampleVector(const std::vector<float>& times,
+                       const std::vector<glm::vec3>& values,
+                       float time,
+                       uint32_t& key,
+                       const glm::vec3& defaultValue)
+{
+    if (values.size() < 2)
+        return values.empty() ? defaultValue : values.front();
+
+    auto index = findKey(times, time, key);
+    return glm::mix(values[index], values[index + 1], getInterpolationFactor(times, time, index));
+}
+
+glm::quat sampleRotation(const std::vector<float>& times, const std::vector<glm::quat>& values, float time, uint32_t& key)
+{
+    if (values.size() < 2)
+        return values.empty() ? glm::quat() : values.front();
+
+    auto index = findKey(times, time, key);
+    return glm::normalize(glm::slerp(values[index], values[index + 1], getInterpolationFactor(times, time, index)));
+}
+
+glm::mat4 sampleTrack(const AnimationTrack& track, float time, uint32_t* keys)
+{
+    auto position = sampleVector(track.positionTimes, track.positions, time, keys[0], glm::vec3(0));
+    auto rotation = sampleRotation(track.rotationTimes, track.rotations, time, keys[1]);
+    auto scale = sampleVector(track.scaleTimes, track.scales, time, keys[2], glm::vec3(1));
+
+    // translation * rotation * scale
+    glm::mat4 transform = glm::mat4_cast(rotation);
+    transform[0] *= scale.x;
+    transform[1] *= scale.y;
+    transform[2] *= scale.z;
+    transform[3] = glm::vec4(position, 1.0f);
+    return transform;
+}
+
+} // anon namespace
+
+SkeletalAnimation::SkeletalAnimation(const MeshSettings& meshSettings)
+    : _globalInverse(toGlm(meshSettings.animation->globalInverse))
+    , _boneCount(meshSettings.boneNum)
+    , _animationSpeed(meshSettings.animationSpeed)
+{
+    const auto& animationSettings = *meshSettings.animation;
+    for (const auto& boneOffset : animationSettings.boneOffset)
+        _boneOffsets.push_back(toGlm(boneOffset));
+
+    addJoint(animationSettings.rootNode, -1, animationSettings);
+
+    for (auto clipIndex = 0u; clipIndex < animationSettings.animationCount; clipIndex++)
+    {
+        const auto* animation = animationSettings.animations[clipIndex];
+
+        AnimationClip clip;
+        clip.duration = static_cast<float>(animation->mDuration);
+        clip.jointTracks.assign(_joints.size(), -1);
+        for (auto i = 0u; i < animation->mNumChannels; i++)
+        {
+            const auto* channel = animation->mChannels[i];
+            auto jointIter = _jointMap.find(channel->mNodeName.C_Str());
+            // only the first channel of joint is used
+            if (jointIter == _jointMap.end() || clip.jointTracks[jointIter->second] >= 0)
+                continue;
+
+            AnimationTrack track;
+            convertKeys(channel->mPositionKeys, channel->mNumPositionKeys, track.positionTimes, track.positions);
+            convertKeys(channel->mRotationKeys, channel->mNumRotationKeys, track.rotationTimes, track.rotations);
+            convertKeys(channel->mScalingKeys, channel->mNumScalingKeys, track.scaleTimes, track.scales);
+
+            clip.jointTracks[jointIter->second] = static_cast<int32_t>(clip.tracks.size());
+            clip.tracks.push_back(std::move(track));
+        }
+        _clips.push_back(std::move(clip));
+    }
+}
+
+void SkeletalAnimation::addJoint(const aiNode* node, int32_t parent, const AnimationSettings& animationSettings)
+{
+    std::string nodeName = node->mName.C_Str();
+    auto jointIndex = static_cast<uint32_t>(_joints.size());
+
+    Joint joint;
+    joint.parent = parent;
+    joint.transform = toGlm(node->mTransformation);
+
+    auto boneIter = animationSettings.boneMap.find(nodeName);
+    if (boneIter != animationSettings.boneMap.end() && boneIter->second < _boneCount
+        && boneIter->second < _boneOffsets.size())
+    {
+        joint.boneIndex = static_cast<int32_t>(boneIter->second);
+    }
+
+    // attachment is scaled as the bone found by going up the tree
+    std::string name = nodeName;
+    const auto* curNode = node;
+    while (!name.empty() && animationSettings.boneMap.find(name) == animationSettings.boneMap.end())
+    {
+        curNode = curNode->mParent;
+        name = curNode && curNode->mParent ? curNode->mParent->mName.C_Str() : "";
+    }
+    joint.attachmentScale = glm::mat4(1);
+    if (!name.empty() && animationSettings.boneMap.at(name) < animationSettings.boneOffset.size())
+    {
+        aiVector3D scale, rotation, position;
+        animationSettings.boneOffset[animationSettings.boneMap.at(name)].Decompose(scale, rotation, position);
+        joint.attachmentScale = glm::scale(glm::mat4(1), toGlm(scale));
+    }
+
+    _joints.push_back(joint);
+    _jointMap.emplace(nodeName, jointIndex);
+
+    for (auto i = 0u; i < node->mNumChildren; i++)
+        addJoint(node->mChildren[i], static_cast<int32_t>(jointIndex), animationSettings);
+}
+
+uint32_t SkeletalAnimation::getClipCount() const
+{
+    return static_cast<uint32_t>(_clips.size());
+}
+
+float SkeletalAnimation::getClipDuration(uint32_t clip) const
+{
+    return _clips[clip].duration;
+}
+
+float SkeletalAnimation::getAnimationSpeed() const
+{
+    return _animationSpeed;
+}
+
+float SkeletalAnimation::getClipTime(uint32_t clip, float time) const
+{
+    // TODO: Only for looped anims
+    time *= _animationSpeed;
+    if (_clips[clip].duration > 0.0f)
+        time = std::fmod(time, _clips[clip].duration);
+    return time;
+}
+
+void SkeletalAnimation::evaluate(uint32_t clip,
+                                 float time,
+                                 AnimationInstance& instance,
+                                 BonesAttachments& bonesAttachments,
+                                 std::vector<glm::mat4>& boneData) const
+{
+    evaluatePose(clip, getClipTime(clip, time), instance, boneData);
+    updateAttachments(instance, bonesAttachments);
+}
+
+void SkeletalAnimation::evaluatePose(uint32_t clip,
+                                     float clipTime,
+                                     AnimationInstance& instance,
+                                     std::vector<glm::mat4>& boneData) const
+{
+    const auto& animationClip = _clips[clip];
+    if (instance.clip != clip || instance.keys.size() != animationClip.tracks.size() * 3)
+    {
+        instance.clip = clip;
+        instance.keys.assign(animationClip.tracks.size() * 3, 0);
+    }
+    instance.jointTransforms.resize(_joints.size());
+    boneData.assign(_boneCount, glm::mat4(1));
+
+    // global inverse is applied to the root, so it's already included in all joint transforms
+    for (auto i = 0u; i < _joints.size(); i++)
+    {
+        const auto& joint = _joints[i];
+        const auto& parentTransform = joint.parent < 0 ? _globalInverse : instance.jointTransforms[joint.parent];
+
+        auto trackIndex = animationClip.jointTracks[i];
+        if (trackIndex < 0)
+            instance.jointTransforms[i] = parentTransform * joint.transform;
+        else
+            instance.jointTransforms[i] = parentTransform * sampleTrack(
+                    animationClip.tracks[trackIndex], clipTime, &instance.keys[trackIndex * 3]);
+
+        if (joint.boneIndex >= 0)
+            boneData[joint.boneIndex] = instance.jointTransforms[i] * _boneOffsets[joint.boneIndex];
+    }
+}
+
+void SkeletalAnimation::updateAttachments(const AnimationInstance& instance, BonesAttachments& bonesAttachments) const
+{
+    for (auto& attachment : bonesAttachments)
+    {
+        auto jointIter = _jointMap.find(attachment.first);
+        if (jointIter != _jointMap.end())
+            attachment.second = instance.jointTransforms[jointIter->second] * _joints[jointIter->second].attachmentScale;
+    }
+}
+
+} // namespace SVE
@@ -0,0 +1,82 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include "MeshSettings.h"
+#include <glm/gtc/quaternion.hpp>
+
+namespace SVE
+{
+
+// Keys of one animated joint, every channel has its own key times
+struct AnimationTrack
+{
+    std::vector<float> positionTimes;
+    std::vector<glm::vec3> positions;
+    std::vector<float> rotationTimes;
+    std::vector<glm::quat> rotations;
+    std::vector<float> scaleTimes;
+    std::vector<glm::vec3> scales;
+};
+
+struct AnimationClip
+{
+    float duration = 0.0f;
+    // track of every joint, -1 if joint isn't animated in this clip
+    std::vector<int32_t> jointTracks;
+    std::vector<AnimationTrack> tracks;
+};
+
+// Per-entity evaluation state: last used key of every channel (time usually moves forward, so next
+// key is found in a step or two) and joint transforms of the last evaluated pose
+struct AnimationInstance
+{
+    uint32_t clip = UINT32_MAX;
+    std::vector<uint32_t> keys;
+    std::vector<glm::mat4> jointTransforms;
+};
+
+// Animations of skeletal mesh converted at load time from assimp node tree: joints are stored in flat array
+// with parents before children, channels are resolved to joints, all math is done in glm.
+class SkeletalAnimation
+{
+public:
+    explicit SkeletalAnimation(const MeshSettings& meshSettings);
+
+    uint32_t getClipCount() const;
+    float getClipDuration(uint32_t clip) const;
+    float getAnimationSpeed() const;
+    // Time in clip (animation speed applied and looped)
+    float getClipTime(uint32_t clip, float time) const;
+
+    void evaluate(uint32_t clip,
+                  float time,
+                  AnimationInstance& instance,
+                  BonesAttachments& bonesAttachments,
+                  std::vector<glm::mat4>& boneData) const;
+    void evaluatePose(uint32_t clip, float clipTime, AnimationInstance& instance, std::vector<glm::mat4>& boneData) const;
+    void updateAttachments(const AnimationInstance& instance, BonesAttachments& bonesAttachments) const;
+
+private:
+    struct Joint
+    {
+        int32_t parent = -1;
+        int32_t boneIndex = -1;
+        glm::mat4 transform;
+        // applied to attachments of this joint (scale of the nearest bone)
+        glm::mat4 attachmentScale;
+    };
+
+    void addJoint(const aiNode* node, int32_t parent, const AnimationSettings& animationSettings);
+
+private:
+    std::vector<Joint> _joints;
+    std::unordered_map<std::string, uint32_t> _jointMap;
+    std::vector<glm::mat4> _boneOffsets;
+    glm::mat4 _globalInverse;
+    uint32_t _boneCount;
+    float _animationSpeed;
+    std::vector<AnimationClip> _clips;
+};
+
+} // namespace SVE
@@ -80,7 +80,11 @@ Skybox::Skybox(const std::string& materialName)
         setupMaterial();
 }
 
-Skybox::~Skybox() = default;
+Skybox::~Skybox()
+{
+    if (_material)
+        _material->getVulkanMaterial()->deleteInstancesForEntity(this);
+}
 
 void Skybox::applyDrawingCommands(uint32_t bufferIndex, uint32_t imageIndex) const
 {
@@ -104,7 +108,7 @@ void Skybox::applyDrawingCommands(uint32_t bufferIndex, uint32_t imageIndex) con
     _mesh->getVulkanMesh()->applyDrawingCommands(bufferIndex);
 }
 
-void Skybox::updateUniforms(UniformDataList uniformDataList) const
+void Skybox::updateUniforms(const UniformDataList& uniformDataList) const
 {
     _material->getVulkanMaterial()->setUniformData(_materialIndex, *uniformDataList[toInt(CommandsType::MainPass)]);
 
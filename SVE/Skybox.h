@@ -19,7 +19,7 @@ public:
     ~Skybox() override;
 
     void applyDrawingCommands(uint32_t bufferIndex, uint32_t imageIndex) const override;
-    void updateUniforms(UniformDataList uniformDataList) const override;
+    void updateUniforms(const UniformDataList& uniformDataList) const override;
 
 private:
     void setupMaterial();
@@ -34,7 +34,7 @@ void TextEntity::setText(TextInfo textInfo)
     _textInfo = std::move(textInfo);
 }
 
-void TextEntity::updateUniforms(UniformDataList uniformDataList) const
+void TextEntity::updateUniforms(const UniformDataList& uniformDataList) const
 {
     auto& uniformData = *uniformDataList[toInt(CommandsType::MainPass)];
     uniformData.textInfo.symbolCount = _textInfo.symbolCount;
@@ -44,15 +44,20 @@ void TextEntity::updateUniforms(UniformDataList uniformDataList) const
     uniformData.textInfo.maxGlyphHeight = _textInfo.font->maxGlyphHeight;
     uniformData.textInfo.scale = _textInfo.scale;
     uniformData.textInfo.color = _textInfo.color;
-    uniformData.glyphList.reserve(300);
-    std::copy(_textInfo.font->symbols, _textInfo.font->symbols + 300, std::back_inserter(uniformData.glyphList));
-    uniformData.glyphList.resize(300);
-    uniformData.textSymbolList.reserve(_textInfo.symbolCount);
+    // shared lists are reassigned in place, so their memory is reused
+    uniformData.glyphList.assign(_textInfo.font->symbols, _textInfo.font->symbols + 300);
     uniformData.textSymbolList = _textInfo.symbols;
 
     _material->getVulkanMaterial()->setUniformData(_materialIndex, *uniformDataList[toInt(CommandsType::MainPass)]);
 }
 
+PassMask TextEntity::getPassMask() const
+{
+    return toPassMask(CommandsType::MainPass)
+           | toPassMask(CommandsType::ScreenQuadPass)
+           | toPassMask(CommandsType::ScreenQuadLatePass);
+}
+
 void TextEntity::applyDrawingCommands(uint32_t bufferIndex, uint32_t imageIndex) const
 {
     if (Engine::getInstance()->getPassType() == CommandsType::MainPass
@@ -19,8 +19,9 @@ public:
     TextInfo& getText();
     void setText(TextInfo textInfo);
 
-    void updateUniforms(UniformDataList uniformDataList) const override;
+    void updateUniforms(const UniformDataList& uniformDataList) const override;
     void applyDrawingCommands(uint32_t bufferIndex, uint32_t imageIndex) const override;
+    PassMask getPassMask() const override;
 
 private:
     TextInfo _textInfo;
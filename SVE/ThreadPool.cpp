@@ -0,0 +1,112 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#include "ThreadPool.h"
+
+namespace SVE
+{
+
+ThreadPool::ThreadPool(uint32_t threadCount)
+{
+    for (auto i = 1u; i < threadCount; i++)
+    {
+        _workers.emplace_back(&ThreadPool::workerLoop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _isStopping = true;
+    }
+    _startCondition.notify_all();
+
+    for (auto& worker : _workers)
+    {
+        worker.join();
+    }
+}
+
+uint32_t ThreadPool::getThreadCount() const
+{
+    return static_cast<uint32_t>(_workers.size()) + 1;
+}
+
+void ThreadPool::start(uint32_t jobCount, Job job)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _job = std::move(job);
+        _jobCount = jobCount;
+        _nextJob = 0;
+        _activeWorkers = static_cast<uint32_t>(_workers.size());
+        _exception = nullptr;
+        ++_generation;
+    }
+    _startCondition.notify_all();
+}
+
+void ThreadPool::wait()
+{
+    processJobs(0);
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _finishCondition.wait(lock, [this] { return _activeWorkers == 0; });
+    _job = nullptr;
+
+    if (_exception)
+        std::rethrow_exception(_exception);
+}
+
+void ThreadPool::run(uint32_t jobCount, Job job)
+{
+    start(jobCount, std::move(job));
+    wait();
+}
+
+void ThreadPool::workerLoop(uint32_t threadIndex)
+{
+    uint64_t generation = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _startCondition.wait(lock, [&] { return _isStopping || _generation != generation; });
+            if (_isStopping)
+                return;
+            generation = _generation;
+        }
+
+        processJobs(threadIndex);
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            --_activeWorkers;
+        }
+        _finishCondition.notify_one();
+    }
+}
+
+void ThreadPool::processJobs(uint32_t threadIndex)
+{
+    while (true)
+    {
+        auto jobIndex = _nextJob.fetch_add(1);
+        if (jobIndex >= _jobCount)
+            break;
+
+        try
+        {
+            _job(jobIndex, threadIndex);
+        }
+        catch (...)
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (!_exception)
+                _exception = std::current_exception();
+        }
+    }
+}
+
+} // namespace SVE
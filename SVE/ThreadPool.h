@@ -0,0 +1,53 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <exception>
+
+namespace SVE
+{
+
+// Fixed set of worker threads, processing indexed jobs. Calling thread is used as thread 0.
+class ThreadPool
+{
+public:
+    using Job = std::function<void(uint32_t jobIndex, uint32_t threadIndex)>;
+
+    explicit ThreadPool(uint32_t threadCount);
+    ~ThreadPool();
+
+    uint32_t getThreadCount() const;
+
+    // Starts processing jobs on worker threads, doesn't block
+    void start(uint32_t jobCount, Job job);
+    // Processes remaining jobs on calling thread and waits until all are finished
+    void wait();
+    void run(uint32_t jobCount, Job job);
+
+private:
+    void workerLoop(uint32_t threadIndex);
+    void processJobs(uint32_t threadIndex);
+
+private:
+    std::vector<std::thread> _workers;
+
+    std::mutex _mutex;
+    std::condition_variable _startCondition;
+    std::condition_variable _finishCondition;
+
+    Job _job;
+    uint32_t _jobCount = 0;
+    std::atomic<uint32_t> _nextJob { 0 };
+    uint32_t _activeWorkers = 0;
+    uint64_t _generation = 0;
+    bool _isStopping = false;
+    std::exception_ptr _exception;
+};
+
+} // namespace SVE
@@ -3,18 +3,33 @@
 // Licensed under the MIT License
 #pragma once
 #include <cstdint>
+#include "VulkanHeaders.h"
 
 namespace SVE
 {
 
+// Render pass state, which should be inherited (or set again) by secondary command buffers
+struct RenderPassRecordInfo
+{
+    VkRenderPass renderPass = VK_NULL_HANDLE;
+    VkFramebuffer framebuffer = VK_NULL_HANDLE;
+    uint32_t subpass = 0;
+    VkExtent2D extent = {};
+    bool useDepthBias = false;
+    float depthBiasConstant = 0.0f;
+    float depthBiasSlope = 0.0f;
+};
+
 class VulkanCommandsManager
 {
 public:
     virtual ~VulkanCommandsManager() {}
 
     virtual void reallocateCommandBuffers() = 0;
-    virtual uint32_t startRenderCommandBufferCreation(uint32_t bufferNumber, uint32_t imageIndex) = 0;
+    virtual uint32_t startRenderCommandBufferCreation(uint32_t bufferNumber, uint32_t imageIndex,
+                                                      VkSubpassContents subpassContents = VK_SUBPASS_CONTENTS_INLINE) = 0;
     virtual void endRenderCommandBufferCreation(uint32_t bufferIndex) = 0;
+    virtual RenderPassRecordInfo getRecordInfo(uint32_t imageIndex) const = 0;
 };
 
 } // namespace SVE
@@ -55,14 +55,11 @@ void VulkanComputeEntity::setUniformData(const UniformData &uniformData) const
     if (uniformSize == 0)
         return;
 
-    const auto& shaderSettings = _computeShader->getShaderSettings();
     char* data = nullptr;
     vmaMapMemory(_vulkanInstance->getAllocator(),  _uniformBuffersMemory[imageIndex], (void**)&data);
-    for (const auto& r : shaderSettings.uniformList)
+    for (const auto& entry : _computeShader->getUniformLayout())
     {
-        auto uniformBytes = getUniformDataByType(uniformData, r.uniformType);
-        memcpy(data, uniformBytes.data(), uniformBytes.size());
-        data += uniformBytes.size();
+        writeUniformData(uniformData, nullptr, entry.uniformType, data + entry.offset, entry.size);
     }
     vmaUnmapMemory(_vulkanInstance->getAllocator(), _uniformBuffersMemory[imageIndex]);
 }
@@ -157,7 +154,9 @@ void VulkanComputeEntity::createBufferResources()
 {
     VkBufferUsageFlags flags = VK_BUFFER_USAGE_STORAGE_TEXEL_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
 
-    _vulkanUtils.createOptimizedBuffer(_computeSettings.data.data(), _computeSettings.data.size(), _buffer, _bufferMemory, flags);
+    // buffer is written by async compute and read by graphics queue
+    _vulkanUtils.createOptimizedBuffer(_computeSettings.data.data(), _computeSettings.data.size(), _buffer, _bufferMemory, flags,
+                                       true);
 
     VkBufferViewCreateInfo bufferViewCreateInfo{};
     bufferViewCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_VIEW_CREATE_INFO;
@@ -351,7 +350,9 @@ void VulkanComputeEntity::deleteDescriptorSets()
 
 void VulkanComputeEntity::finishComputeStep()
 {
-    auto commandBuffer = Engine::getInstance()->getVulkanInstance()->getCommandBuffer(BUFFER_INDEX_COMPUTE_PARTICLES);
+    auto* vulkanInstance = Engine::getInstance()->getVulkanInstance();
+    auto commandBuffer = vulkanInstance->getCommandBuffer(BUFFER_INDEX_COMPUTE_PARTICLES);
+    vulkanInstance->endComputeCommands(commandBuffer);
 
     // finish recording
     if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
@@ -363,7 +364,8 @@ void VulkanComputeEntity::finishComputeStep()
 
 void VulkanComputeEntity::startComputeStep()
 {
-    auto commandBuffer = Engine::getInstance()->getVulkanInstance()->createCommandBuffer(BUFFER_INDEX_COMPUTE_PARTICLES);
+    auto* vulkanInstance = Engine::getInstance()->getVulkanInstance();
+    auto commandBuffer = vulkanInstance->createCommandBuffer(BUFFER_INDEX_COMPUTE_PARTICLES);
 
     VkCommandBufferBeginInfo beginInfo{};
     beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
@@ -374,6 +376,7 @@ void VulkanComputeEntity::startComputeStep()
     {
         throw VulkanException("Failed to begin recording Vulkan command buffer");
     }
+    vulkanInstance->beginComputeCommands(commandBuffer);
 }
 
 } // namespace SVE
\ No newline at end of file
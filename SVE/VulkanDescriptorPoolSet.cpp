@@ -0,0 +1,156 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#include "VulkanDescriptorPoolSet.h"
+#include "VulkanException.h"
+#include <algorithm>
+
+namespace SVE
+{
+
+namespace
+{
+
+const uint32_t PoolSetCount = 1024;
+
+uint32_t& getDescriptorCount(std::vector<VkDescriptorPoolSize>& descriptorCounts, VkDescriptorType type)
+{
+    for (auto& descriptorCount : descriptorCounts)
+    {
+        if (descriptorCount.type == type)
+            return descriptorCount.descriptorCount;
+    }
+    descriptorCounts.push_back({ type, 0 });
+    return descriptorCounts.back().descriptorCount;
+}
+
+bool hasSpace(std::vector<VkDescriptorPoolSize>& freeDescriptors, const std::vector<VkDescriptorPoolSize>& descriptorCounts)
+{
+    return std::all_of(descriptorCounts.begin(), descriptorCounts.end(), [&](const VkDescriptorPoolSize& descriptorCount)
+    {
+        return getDescriptorCount(freeDescriptors, descriptorCount.type) >= descriptorCount.descriptorCount;
+    });
+}
+
+} // anon namespace
+
+VulkanDescriptorPoolSet::VulkanDescriptorPoolSet(VkDevice device)
+    : _device(device)
+{
+}
+
+VulkanDescriptorPoolSet::~VulkanDescriptorPoolSet()
+{
+    for (auto& pool : _pools)
+    {
+        vkDestroyDescriptorPool(_device, pool.pool, nullptr);
+    }
+}
+
+void VulkanDescriptorPoolSet::addDescriptorCounts(std::vector<VkDescriptorPoolSize>& descriptorCounts,
+                                                  const std::vector<VkDescriptorPoolSize>& setDescriptorCounts,
+                                                  uint32_t setCount)
+{
+    for (const auto& descriptorCount : setDescriptorCounts)
+        getDescriptorCount(descriptorCounts, descriptorCount.type) += descriptorCount.descriptorCount * setCount;
+}
+
+VkDescriptorPool VulkanDescriptorPoolSet::allocate(const std::vector<VkDescriptorSetLayout>& layouts,
+                                                   const std::vector<VkDescriptorPoolSize>& descriptorCounts,
+                                                   std::vector<VkDescriptorSet>& descriptorSets)
+{
+    descriptorSets.resize(layouts.size());
+    if (layouts.empty())
+        return VK_NULL_HANDLE;
+
+    VkDescriptorSetAllocateInfo allocInfo {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorSetCount = static_cast<uint32_t>(layouts.size());
+    allocInfo.pSetLayouts = layouts.data();
+
+    auto reserve = [&](Pool& pool)
+    {
+        pool.freeSetCount -= allocInfo.descriptorSetCount;
+        for (const auto& descriptorCount : descriptorCounts)
+            getDescriptorCount(pool.freeDescriptors, descriptorCount.type) -= descriptorCount.descriptorCount;
+        return pool.pool;
+    };
+
+    // newest pool is the most likely to have free space
+    for (auto iter = _pools.rbegin(); iter != _pools.rend(); ++iter)
+    {
+        if (iter->freeSetCount < allocInfo.descriptorSetCount || !hasSpace(iter->freeDescriptors, descriptorCounts))
+            continue;
+
+        // pool with enough free descriptors can still be fragmented (VK_ERROR_FRAGMENTED_POOL)
+        allocInfo.descriptorPool = iter->pool;
+        if (vkAllocateDescriptorSets(_device, &allocInfo, descriptorSets.data()) == VK_SUCCESS)
+            return reserve(*iter);
+    }
+
+    auto& pool = createPool(allocInfo.descriptorSetCount, descriptorCounts);
+    allocInfo.descriptorPool = pool.pool;
+    auto result = vkAllocateDescriptorSets(_device, &allocInfo, descriptorSets.data());
+    if (result != VK_SUCCESS)
+        throw VulkanException("Can't allocate Vulkan descriptor sets", result);
+
+    return reserve(pool);
+}
+
+void VulkanDescriptorPoolSet::free(VkDescriptorPool pool, const std::vector<VkDescriptorSet>& descriptorSets,
+                                   const std::vector<VkDescriptorPoolSize>& descriptorCounts)
+{
+    if (pool == VK_NULL_HANDLE || descriptorSets.empty())
+        return;
+
+    vkFreeDescriptorSets(_device, pool, static_cast<uint32_t>(descriptorSets.size()), descriptorSets.data());
+
+    auto iter = std::find_if(_pools.begin(), _pools.end(), [pool](const Pool& item) { return item.pool == pool; });
+    if (iter == _pools.end())
+        throw VulkanException("Descriptor sets are freed to unknown pool");
+
+    iter->freeSetCount += static_cast<uint32_t>(descriptorSets.size());
+    for (const auto& descriptorCount : descriptorCounts)
+        getDescriptorCount(iter->freeDescriptors, descriptorCount.type) += descriptorCount.descriptorCount;
+}
+
+uint32_t VulkanDescriptorPoolSet::getPoolCount() const
+{
+    return static_cast<uint32_t>(_pools.size());
+}
+
+VulkanDescriptorPoolSet::Pool& VulkanDescriptorPoolSet::createPool(uint32_t minSetCount,
+                                                                   const std::vector<VkDescriptorPoolSize>& minDescriptorCounts)
+{
+    // every set has a few descriptors at most, so sizes are proportional to sets count
+    auto setCount = std::max(PoolSetCount, minSetCount);
+    std::vector<VkDescriptorPoolSize> poolSizes = {
+            { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, setCount },
+            { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, setCount * 4 },
+            { VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, setCount / 4 }
+    };
+    for (const auto& descriptorCount : minDescriptorCounts)
+    {
+        auto& poolCount = getDescriptorCount(poolSizes, descriptorCount.type);
+        poolCount = std::max(poolCount, descriptorCount.descriptorCount);
+    }
+
+    VkDescriptorPoolCreateInfo poolInfo = {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT;
+    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes = poolSizes.data();
+    poolInfo.maxSets = setCount;
+
+    Pool pool;
+    auto result = vkCreateDescriptorPool(_device, &poolInfo, nullptr, &pool.pool);
+    if (result != VK_SUCCESS)
+        throw VulkanException("Can't create Vulkan descriptor pool", result);
+
+    pool.freeSetCount = setCount;
+    pool.freeDescriptors = std::move(poolSizes);
+    _pools.push_back(std::move(pool));
+    return _pools.back();
+}
+
+} // namespace SVE
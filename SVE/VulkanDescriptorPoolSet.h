@@ -0,0 +1,52 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include "VulkanHeaders.h"
+#include <vector>
+
+namespace SVE
+{
+
+// Descriptor pools shared by all materials. Free sets and descriptors of each pool are tracked, so sets are
+// allocated only from pools which have space for them (Vulkan 1.0 doesn't define allocation from exhausted pool),
+// new pool is added when current ones don't have enough. Sets are returned to their pool when freed,
+// so pools are reused between levels.
+class VulkanDescriptorPoolSet
+{
+public:
+    explicit VulkanDescriptorPoolSet(VkDevice device);
+    ~VulkanDescriptorPoolSet();
+
+    // Adds descriptors of setCount sets with setDescriptorCounts to descriptorCounts
+    static void addDescriptorCounts(std::vector<VkDescriptorPoolSize>& descriptorCounts,
+                                    const std::vector<VkDescriptorPoolSize>& setDescriptorCounts, uint32_t setCount);
+
+    // Allocates all sets from a single pool, returns that pool (needed to free sets).
+    // descriptorCounts are descriptors of all layouts by type.
+    VkDescriptorPool allocate(const std::vector<VkDescriptorSetLayout>& layouts,
+                              const std::vector<VkDescriptorPoolSize>& descriptorCounts,
+                              std::vector<VkDescriptorSet>& descriptorSets);
+    // descriptorCounts should be the same as on allocation
+    void free(VkDescriptorPool pool, const std::vector<VkDescriptorSet>& descriptorSets,
+              const std::vector<VkDescriptorPoolSize>& descriptorCounts);
+
+    uint32_t getPoolCount() const;
+
+private:
+    struct Pool
+    {
+        VkDescriptorPool pool = VK_NULL_HANDLE;
+        uint32_t freeSetCount = 0;
+        // free descriptors by type
+        std::vector<VkDescriptorPoolSize> freeDescriptors;
+    };
+
+    Pool& createPool(uint32_t minSetCount, const std::vector<VkDescriptorPoolSize>& minDescriptorCounts);
+
+private:
+    VkDevice _device;
+    std::vector<Pool> _pools;
+};
+
+} // namespace SVE
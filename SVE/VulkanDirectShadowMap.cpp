@@ -45,7 +45,8 @@ void VulkanDirectShadowMap::reallocateCommandBuffers()
     }
 }
 
-uint32_t VulkanDirectShadowMap::startRenderCommandBufferCreation(uint32_t bufferNumber, uint32_t imageIndex)
+uint32_t VulkanDirectShadowMap::startRenderCommandBufferCreation(uint32_t bufferNumber, uint32_t imageIndex,
+                                                                 VkSubpassContents subpassContents)
 {
     VkCommandBufferBeginInfo beginInfo{};
     beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
@@ -72,7 +73,11 @@ uint32_t VulkanDirectShadowMap::startRenderCommandBufferCreation(uint32_t buffer
     renderPassBeginInfo.clearValueCount = 2;
     renderPassBeginInfo.pClearValues = clearValues.data();
 
-    vkCmdBeginRenderPass(_commandBuffers[bufferNumber], &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+    vkCmdBeginRenderPass(_commandBuffers[bufferNumber], &renderPassBeginInfo, subpassContents);
+
+    // dynamic state isn't allowed in primary buffer, secondary buffers set it from record info
+    if (subpassContents == VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS)
+        return BUFFER_INDEX_SHADOWMAP_SUN + bufferNumber;
 
     // TODO: Add depth bias constants to configuration
     vkCmdSetDepthBias(
@@ -112,6 +117,19 @@ void VulkanDirectShadowMap::endRenderCommandBufferCreation(uint32_t bufferIndex)
     }
 }
 
+RenderPassRecordInfo VulkanDirectShadowMap::getRecordInfo(uint32_t imageIndex) const
+{
+    RenderPassRecordInfo recordInfo;
+    recordInfo.renderPass = _renderPass;
+    recordInfo.framebuffer = _framebuffers[imageIndex];
+    recordInfo.extent = { _shadowMapSize, _shadowMapSize };
+    recordInfo.useDepthBias = true;
+    recordInfo.depthBiasConstant = 1.25f;
+    recordInfo.depthBiasSlope = 1.75f;
+
+    return recordInfo;
+}
+
 VkSampler VulkanDirectShadowMap::getSampler(uint32_t index) const
 {
     return _shadowSampler[index];
@@ -21,8 +21,10 @@ public:
     ~VulkanDirectShadowMap() override;
 
     void reallocateCommandBuffers() override;
-    uint32_t startRenderCommandBufferCreation(uint32_t bufferNumber, uint32_t imageIndex) override;
+    uint32_t startRenderCommandBufferCreation(uint32_t bufferNumber, uint32_t imageIndex,
+                                              VkSubpassContents subpassContents = VK_SUBPASS_CONTENTS_INLINE) override;
     void endRenderCommandBufferCreation(uint32_t bufferIndex) override;
+    RenderPassRecordInfo getRecordInfo(uint32_t imageIndex) const override;
 
     VkSampler getSampler(uint32_t index) const;
 
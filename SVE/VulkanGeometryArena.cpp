@@ -0,0 +1,153 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#include "VulkanGeometryArena.h"
+#include "VulkanInstance.h"
+#include "VulkanException.h"
+#include <algorithm>
+#include <iterator>
+
+namespace SVE
+{
+
+namespace
+{
+
+// enough for vertex attributes and 32 bit indices
+const VkDeviceSize GeometryAlignment = 16;
+
+VkDeviceSize alignSize(VkDeviceSize size, VkDeviceSize alignment)
+{
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+} // anon namespace
+
+VulkanGeometryArena::VulkanGeometryArena(VulkanInstance* vulkanInstance, VkDeviceSize blockSize)
+    : _vulkanInstance(vulkanInstance)
+    , _alignment(GeometryAlignment)
+    , _blockSize(alignSize(blockSize, GeometryAlignment))
+{
+    createBlock(_blockSize);
+}
+
+VulkanGeometryArena::~VulkanGeometryArena()
+{
+    deleteBlocks();
+}
+
+GeometrySlot VulkanGeometryArena::allocate(VkDeviceSize size)
+{
+    size = alignSize(size, _alignment);
+
+    for (auto block = 0u; ; block++)
+    {
+        if (block == _blocks.size())
+        {
+            // meshes bigger than block get their own block
+            createBlock(std::max(size, _blockSize));
+        }
+
+        auto& freeRanges = _blocks[block].freeRanges;
+        for (auto iter = freeRanges.begin(); iter != freeRanges.end(); ++iter)
+        {
+            if (iter->second < size)
+                continue;
+
+            GeometrySlot slot;
+            slot.block = block;
+            slot.offset = iter->first;
+            slot.size = size;
+
+            auto rangeSize = iter->second;
+            freeRanges.erase(iter);
+            if (rangeSize > size)
+                freeRanges.emplace(slot.offset + size, rangeSize - size);
+
+            _slotCount++;
+            return slot;
+        }
+    }
+}
+
+void VulkanGeometryArena::free(const GeometrySlot& slot)
+{
+    if (slot.size == 0)
+        return;
+
+    _slotCount--;
+    auto& freeRanges = _blocks[slot.block].freeRanges;
+    auto iter = freeRanges.emplace(slot.offset, slot.size).first;
+
+    // merge with neighbour ranges
+    auto next = std::next(iter);
+    if (next != freeRanges.end() && iter->first + iter->second == next->first)
+    {
+        iter->second += next->second;
+        freeRanges.erase(next);
+    }
+    if (iter != freeRanges.begin())
+    {
+        auto prev = std::prev(iter);
+        if (prev->first + prev->second == iter->first)
+        {
+            prev->second += iter->second;
+            freeRanges.erase(iter);
+        }
+    }
+}
+
+VkDeviceSize VulkanGeometryArena::getAlignment() const
+{
+    return _alignment;
+}
+
+uint32_t VulkanGeometryArena::getBlockCount() const
+{
+    return static_cast<uint32_t>(_blocks.size());
+}
+
+uint32_t VulkanGeometryArena::getSlotCount() const
+{
+    return _slotCount;
+}
+
+VkBuffer VulkanGeometryArena::getBuffer(uint32_t block) const
+{
+    return _blocks[block].buffer;
+}
+
+void VulkanGeometryArena::addBindings(uint32_t count)
+{
+    _bindingCount.fetch_add(count, std::memory_order_relaxed);
+}
+
+uint32_t VulkanGeometryArena::resetBindingCount()
+{
+    return _bindingCount.exchange(0, std::memory_order_relaxed);
+}
+
+void VulkanGeometryArena::createBlock(VkDeviceSize size)
+{
+    Block block;
+    _vulkanInstance->getVulkanUtils().createBuffer(
+            size,
+            VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+            VMA_MEMORY_USAGE_GPU_ONLY,
+            block.buffer,
+            block.allocation,
+            false,
+            true);
+    block.freeRanges.emplace(0, size);
+
+    _blocks.push_back(std::move(block));
+}
+
+void VulkanGeometryArena::deleteBlocks()
+{
+    for (auto& block : _blocks)
+        vmaDestroyBuffer(_vulkanInstance->getAllocator(), block.buffer, block.allocation);
+    _blocks.clear();
+}
+
+} // namespace SVE
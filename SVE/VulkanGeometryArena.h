@@ -0,0 +1,66 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include "VulkanHeaders.h"
+#include <vulkan/vk_mem_alloc.h>
+#include <vector>
+#include <map>
+#include <atomic>
+
+namespace SVE
+{
+class VulkanInstance;
+
+// Location of mesh geometry (vertex streams and indices) in the arena
+struct GeometrySlot
+{
+    uint32_t block = 0;
+    VkDeviceSize offset = 0;
+    VkDeviceSize size = 0;
+};
+
+// GPU-local vertex and index memory, shared by all meshes.
+// Each block is a single buffer, which can be used both as vertex and index buffer. Meshes are suballocated
+// in blocks, so creating mesh doesn't create any Vulkan objects. Blocks are shared with transfer queue,
+// so meshes can be uploaded while other meshes from the same block are drawn.
+class VulkanGeometryArena
+{
+public:
+    VulkanGeometryArena(VulkanInstance* vulkanInstance, VkDeviceSize blockSize);
+    ~VulkanGeometryArena();
+
+    GeometrySlot allocate(VkDeviceSize size);
+    void free(const GeometrySlot& slot);
+
+    VkDeviceSize getAlignment() const;
+    uint32_t getBlockCount() const;
+    uint32_t getSlotCount() const;
+    VkBuffer getBuffer(uint32_t block) const;
+
+    // Vertex buffers bound by meshes since last reset (can be called from recording threads)
+    void addBindings(uint32_t count);
+    uint32_t resetBindingCount();
+
+private:
+    void createBlock(VkDeviceSize size);
+    void deleteBlocks();
+
+private:
+    struct Block
+    {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VmaAllocation allocation = VK_NULL_HANDLE;
+        // free ranges, offset -> size
+        std::map<VkDeviceSize, VkDeviceSize> freeRanges;
+    };
+
+    VulkanInstance* _vulkanInstance;
+    VkDeviceSize _alignment;
+    VkDeviceSize _blockSize;
+    std::vector<Block> _blocks;
+    uint32_t _slotCount = 0;
+    std::atomic<uint32_t> _bindingCount { 0 };
+};
+
+} // namespace SVE
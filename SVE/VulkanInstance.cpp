@@ -12,6 +12,13 @@
 #include "VulkanScreenQuad.h"
 #include "VulkanSamplerHolder.h"
 #include "VulkanPassInfo.h"
+#include "VulkanUniformArena.h"
+#include "VulkanPassUniforms.h"
+#include "VulkanDescriptorPoolSet.h"
+#include "VulkanTransformBuffer.h"
+#include "VulkanTextureTable.h"
+#include "VulkanUploadManager.h"
+#include "VulkanGeometryArena.h"
 
 namespace SVE
 {
@@ -120,6 +127,53 @@ static VKAPI_ATTR VkBool32 VKAPI_CALL debugCallback(
     return VK_FALSE;
 }
 
+bool isInstanceExtensionSupported(const char* extensionName)
+{
+    uint32_t extensionCount;
+    vkEnumerateInstanceExtensionProperties(nullptr, &extensionCount, nullptr);
+    std::vector<VkExtensionProperties> extensionList(extensionCount);
+    vkEnumerateInstanceExtensionProperties(nullptr, &extensionCount, extensionList.data());
+
+    return std::any_of(extensionList.begin(), extensionList.end(), [extensionName](const VkExtensionProperties& props)
+    {
+        return strcmp(props.extensionName, extensionName) == 0;
+    });
+}
+
+bool isDeviceExtensionSupported(VkPhysicalDevice gpu, const char* extensionName)
+{
+    uint32_t extensionCount;
+    vkEnumerateDeviceExtensionProperties(gpu, nullptr, &extensionCount, nullptr);
+    std::vector<VkExtensionProperties> extensionList(extensionCount);
+    vkEnumerateDeviceExtensionProperties(gpu, nullptr, &extensionCount, extensionList.data());
+
+    return std::any_of(extensionList.begin(), extensionList.end(), [extensionName](const VkExtensionProperties& props)
+    {
+        return strcmp(props.extensionName, extensionName) == 0;
+    });
+}
+
+// secondary command buffer currently recorded on this thread
+thread_local BufferIndex recordingBufferIndex = 0;
+thread_local VkCommandBuffer recordingCommandBuffer = VK_NULL_HANDLE;
+
+// frame timestamps in query pool
+enum : uint32_t
+{
+    ComputeBeginTimestamp = 0,
+    ComputeEndTimestamp,
+    GraphicsBeginTimestamp,
+    GraphicsEndTimestamp,
+    TimestampsPerFrame
+};
+
+// graphics stages reading compute results (indirect draw commands, particles vertices and culled transforms)
+const VkPipelineStageFlags ComputeWaitStages = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT
+                                               | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT
+                                               | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT;
+// previous submit, graphics done semaphore of previous frame and compute submit
+const uint32_t SubmitWaitCount = 3;
+
 } // anon namespace
 
 VulkanInstance::VulkanInstance(SDL_Window* window, EngineSettings settings)
@@ -144,12 +198,31 @@ VulkanInstance::VulkanInstance(SDL_Window* window, EngineSettings settings)
     createDepthBuffer();
     createFramebuffers();
     createSyncPrimitives();
+    createTimestampQueryPool();
+
+    _uploadManager = std::make_unique<VulkanUploadManager>(this, _engineSettings.uploadRingSize);
+    _geometryArena = std::make_unique<VulkanGeometryArena>(this, _engineSettings.geometryArenaBlockSize);
+    _descriptorPoolSet = std::make_unique<VulkanDescriptorPoolSet>(_device);
+    _uniformArena = std::make_unique<VulkanUniformArena>(this, _engineSettings.uniformArenaBlockSize, getSwapchainSize());
+    // pass layout takes push constant range from texture table
+    if (_bindlessTexturesSupported)
+        _textureTable = std::make_unique<VulkanTextureTable>(this, _engineSettings.maxBindlessTextures);
+    _passUniforms = std::make_unique<VulkanPassUniforms>(this);
+    _transformBuffer = std::make_unique<VulkanTransformBuffer>(this, _engineSettings.maxInstanceTransforms, getSwapchainSize());
 }
 
 VulkanInstance::~VulkanInstance()
 {
     _screenQuad.reset();
-
+    _transformBuffer.reset();
+    _passUniforms.reset();
+    _textureTable.reset();
+    _uniformArena.reset();
+    _descriptorPoolSet.reset();
+    _uploadManager.reset();
+    _geometryArena.reset();
+
+    deleteTimestampQueryPool();
     deleteSyncPrimitives();
     deleteFramebuffers();
     deleteDepthBuffer();
@@ -245,6 +318,11 @@ VkRenderPass VulkanInstance::getRenderPass() const
     return _renderPass;
 }
 
+VulkanUtils::AttachmentTraffic VulkanInstance::getAttachmentTraffic() const
+{
+    return _attachmentTraffic;
+}
+
 VkExtent2D VulkanInstance::getExtent() const
 {
     return _extent;
@@ -312,9 +390,12 @@ VkCommandBuffer VulkanInstance::createCommandBuffer(BufferIndex bufferIndex)
         return existingBufferIter->second;
     }
 
+    // compute commands are submitted to compute queue, so they are allocated from its family pool
+    auto isComputeBuffer = _isAsyncCompute && bufferIndex == BUFFER_INDEX_COMPUTE_PARTICLES;
+
     VkCommandBufferAllocateInfo commandBufferAllocateInfo{};
     commandBufferAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    commandBufferAllocateInfo.commandPool = _commandPools[_currentPool];
+    commandBufferAllocateInfo.commandPool = isComputeBuffer ? _computeCommandPools[_currentPool] : _commandPools[_currentPool];
     commandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
     commandBufferAllocateInfo.commandBufferCount = 1;
 
@@ -331,6 +412,11 @@ VkCommandBuffer VulkanInstance::createCommandBuffer(BufferIndex bufferIndex)
 
 VkCommandBuffer VulkanInstance::getCommandBuffer(BufferIndex index) const
 {
+    if (recordingCommandBuffer != VK_NULL_HANDLE && recordingBufferIndex == index)
+    {
+        return recordingCommandBuffer;
+    }
+
     if (index < _commandBuffers.size())
     {
         return _commandBuffers[index];
@@ -360,8 +446,12 @@ void VulkanInstance::waitAvailableFramebuffer()
                     VK_TRUE,
                     std::numeric_limits<uint64_t>::max());
     vkResetFences(_device, 1, &_inFlightFences[_currentFrame]);
+    readTimestamps();
 
     _currentWaitSemaphore = _imageAvailableSemaphores[_currentFrame];
+    _submitIndex = 0;
+    _isFrameSubmitStarted = false;
+    _computeSemaphore = VK_NULL_HANDLE;
 
     if (result == VK_ERROR_OUT_OF_DATE_KHR)
     {
@@ -373,46 +463,158 @@ void VulkanInstance::waitAvailableFramebuffer()
     }
 }
 
-void VulkanInstance::submitCommands(CommandsType commandsType, BufferIndex bufferIndex) const
+VkSemaphore VulkanInstance::getSubmitSemaphore() const
 {
-    static VkPipelineStageFlags waitStages[] = { VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT };
+    // submits are chained, each one waits for the previous one
+    auto& frameSemaphores = _submitSemaphores[_currentFrame];
+    if (_submitIndex == frameSemaphores.size())
+    {
+        VkSemaphoreCreateInfo semaphoreCreateInfo{};
+        semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-    static const std::map<CommandsType, const std::vector<VkSemaphore>&> semaphoresMap = {
-            { CommandsType::ComputeParticlesPass, _computeParticlesReadySemaphore },
-            { CommandsType::ShadowPassDirectLight, _shadowMapDirectReadySemaphores },
-            { CommandsType::ShadowPassPointLights, _shadowMapPointReadySemaphores },
-            { CommandsType::ReflectionPass, _waterReflectionReadySemaphores },
-            { CommandsType::RefractionPass, _waterRefractionReadySemaphores },
-            { CommandsType::ScreenQuadPass, _screenQuadReadySemaphores },
-            { CommandsType::ScreenQuadMRTPass, _screenQuadMrtReadySemaphores },
-            { CommandsType::ScreenQuadLatePass, _screenQuadLateReadySemaphores },
-            { CommandsType::ScreenQuadDepthPass, _screenQuadDepthReadySemaphores },
-            { CommandsType::MainPass, _renderFinishedSemaphores }
-    };
+        VkSemaphore newSemaphore;
+        if (vkCreateSemaphore(_device, &semaphoreCreateInfo, nullptr, &newSemaphore) != VK_SUCCESS)
+        {
+            throw std::runtime_error("Failed to create Vulkan semaphore");
+        }
+        frameSemaphores.push_back(newSemaphore);
+    }
+
+    return frameSemaphores[_submitIndex++];
+}
+
+void VulkanInstance::submitCommands(BufferIndex bufferIndex, bool isFrameEnd, bool isComputeWait) const
+{
+    uint32_t batchSize = 1;
+    submitBatches(&bufferIndex, &batchSize, 1, isComputeWait ? 0 : NoComputeWait, isFrameEnd);
+}
+
+void VulkanInstance::submitCommands(const std::vector<BufferIndex>& bufferIndexList,
+                                    const std::vector<uint32_t>& batchSizeList,
+                                    uint32_t computeWaitBatch) const
+{
+    submitBatches(bufferIndexList.data(), batchSizeList.data(), static_cast<uint32_t>(batchSizeList.size()),
+                  computeWaitBatch, true);
+}
+
+void VulkanInstance::submitBatches(const BufferIndex* bufferIndexList, const uint32_t* batchSizeList, uint32_t batchCount,
+                                   uint32_t computeWaitBatch, bool isFrameEnd) const
+{
+    auto isProfiling = _timestampQueryPool != VK_NULL_HANDLE;
+    auto bufferCount = 0u;
+    for (auto batch = 0u; batch < batchCount; batch++)
+        bufferCount += batchSizeList[batch];
+
+    // pointers to these lists are kept in submit infos, so they shouldn't grow while infos are filled
+    // (batches can have timestamp buffers in addition to pass buffers, last batch can signal graphics done semaphore)
+    _submitInfoList.resize(batchCount);
+    _submitCommandBuffers.resize(bufferCount + 2);
+    _submitWaitSemaphores.resize(batchCount * SubmitWaitCount);
+    _submitWaitStages.resize(batchCount * SubmitWaitCount);
+    _submitSignalSemaphores.resize(batchCount + 1);
+
+    uint32_t firstBuffer = 0;
+    uint32_t commandBufferCount = 0;
+    for (auto batch = 0u; batch < batchCount; batch++)
+    {
+        auto& submitInfo = _submitInfoList[batch];
+        submitInfo = {};
+        submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        auto* waitSemaphores = &_submitWaitSemaphores[batch * SubmitWaitCount];
+        auto* waitStages = &_submitWaitStages[batch * SubmitWaitCount];
+        submitInfo.pWaitSemaphores = waitSemaphores;
+        submitInfo.pWaitDstStageMask = waitStages;
+        auto batchFirstBuffer = commandBufferCount;
+        submitInfo.pCommandBuffers = &_submitCommandBuffers[batchFirstBuffer];
+
+        waitSemaphores[0] = _currentWaitSemaphore;
+        waitStages[0] = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+        submitInfo.waitSemaphoreCount = 1;
+
+        // semaphore signaled by previous frame should be waited before it's signaled again
+        if (_isGraphicsDoneSignaled)
+        {
+            waitSemaphores[submitInfo.waitSemaphoreCount] = _graphicsDoneSemaphore;
+            waitStages[submitInfo.waitSemaphoreCount++] = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+            _isGraphicsDoneSignaled = false;
+        }
+
+        if (isProfiling && !_isFrameSubmitStarted)
+            _submitCommandBuffers[commandBufferCount++] = getCommandBuffer(BUFFER_INDEX_TIMESTAMP_BEGIN);
+        _isFrameSubmitStarted = true;
+
+        if (batch == computeWaitBatch && _computeSemaphore != VK_NULL_HANDLE)
+        {
+            waitSemaphores[submitInfo.waitSemaphoreCount] = _computeSemaphore;
+            waitStages[submitInfo.waitSemaphoreCount++] = ComputeWaitStages;
+            _computeSemaphore = VK_NULL_HANDLE;
+        }
+
+        for (auto i = firstBuffer; i < firstBuffer + batchSizeList[batch]; i++)
+        {
+            // compute pass is submitted to graphics queue if async compute isn't used
+            if (bufferIndexList[i] == BUFFER_INDEX_COMPUTE_PARTICLES)
+                _isComputeTimestampWritten[_currentFrame] = isProfiling;
+            _submitCommandBuffers[commandBufferCount++] = getCommandBuffer(bufferIndexList[i]);
+        }
+        firstBuffer += batchSizeList[batch];
+
+        if (isProfiling && isFrameEnd && batch + 1 == batchCount)
+            _submitCommandBuffers[commandBufferCount++] = getCommandBuffer(BUFFER_INDEX_TIMESTAMP_END);
+
+        submitInfo.commandBufferCount = commandBufferCount - batchFirstBuffer;
+        _submitSignalSemaphores[batch] = getSubmitSemaphore();
+        submitInfo.signalSemaphoreCount = 1;
+        submitInfo.pSignalSemaphores = &_submitSignalSemaphores[batch];
+        if (_isAsyncCompute && isFrameEnd && batch + 1 == batchCount)
+        {
+            _submitSignalSemaphores[batch + 1] = _graphicsDoneSemaphore;
+            submitInfo.signalSemaphoreCount = 2;
+            _isGraphicsDoneSignaled = true;
+        }
+
+        _currentWaitSemaphore = _submitSignalSemaphores[batch];
+    }
+
+    auto result = vkQueueSubmit(
+            _queue,
+            batchCount, _submitInfoList.data(),
+            isFrameEnd ? _inFlightFences[_currentFrame] : VK_NULL_HANDLE);
+
+    if (result != VK_SUCCESS)
+    {
+        throw VulkanException("Can't submit Vulkan command buffers to queue", result);
+    }
+}
+
+void VulkanInstance::submitComputeCommands(BufferIndex bufferIndex) const
+{
+    VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
 
     auto commandBuffer = getCommandBuffer(bufferIndex);
-    auto semaphore = semaphoresMap.at(commandsType)[_currentFrame];
+    _computeSemaphore = getSubmitSemaphore();
     VkSubmitInfo submitInfo{};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.waitSemaphoreCount = 1;
-    submitInfo.pWaitSemaphores = &_currentWaitSemaphore;
-    submitInfo.pWaitDstStageMask = waitStages;
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &commandBuffer;
     submitInfo.signalSemaphoreCount = 1;
-    submitInfo.pSignalSemaphores = &semaphore;
-
-    auto result = vkQueueSubmit(
-            _queue,
-            1, &submitInfo,
-            commandsType == CommandsType::MainPass ? _inFlightFences[_currentFrame] : VK_NULL_HANDLE);
+    submitInfo.pSignalSemaphores = &_computeSemaphore;
+    // previous frame passes could still read compute buffers
+    if (_isGraphicsDoneSignaled)
+    {
+        submitInfo.waitSemaphoreCount = 1;
+        submitInfo.pWaitSemaphores = &_graphicsDoneSemaphore;
+        submitInfo.pWaitDstStageMask = &waitStage;
+        _isGraphicsDoneSignaled = false;
+    }
 
+    auto result = vkQueueSubmit(_computeQueue, 1, &submitInfo, VK_NULL_HANDLE);
     if (result != VK_SUCCESS)
     {
-        throw VulkanException("Can't submit Vulkan command buffers to queue (shadow pass)");
+        throw VulkanException("Can't submit Vulkan command buffers to compute queue", result);
     }
 
-    _currentWaitSemaphore = semaphore;
+    _isComputeTimestampWritten[_currentFrame] = _timestampQueryPool != VK_NULL_HANDLE;
 }
 
 void VulkanInstance::renderCommands() const
@@ -458,20 +660,52 @@ void VulkanInstance::reallocateCommandBuffers()
     {
         throw VulkanException("Can't reset Vulkan Command Pool");
     }
+    if (_isAsyncCompute
+        && vkResetCommandPool(_device, _computeCommandPools[_currentPool], VK_COMMAND_POOL_RESET_RELEASE_RESOURCES_BIT) != VK_SUCCESS)
+    {
+        throw VulkanException("Can't reset Vulkan Command Pool");
+    }
     _externalBufferMap.clear();
 
     for (auto i = 0u; i < MAX_FRAMES_IN_FLIGHT; i ++)
         _commandBuffers[i] = createCommandBuffer(i);
+
+    if (_timestampQueryPool != VK_NULL_HANDLE)
+    {
+        auto firstQuery = _currentFrame * TimestampsPerFrame;
+        recordFrameCommands(BUFFER_INDEX_TIMESTAMP_BEGIN, [this, firstQuery](VkCommandBuffer commandBuffer)
+        {
+            vkCmdResetQueryPool(commandBuffer, _timestampQueryPool, firstQuery + GraphicsBeginTimestamp, 2);
+            vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, _timestampQueryPool,
+                                firstQuery + GraphicsBeginTimestamp);
+        });
+        recordFrameCommands(BUFFER_INDEX_TIMESTAMP_END, [this, firstQuery](VkCommandBuffer commandBuffer)
+        {
+            vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, _timestampQueryPool,
+                                firstQuery + GraphicsEndTimestamp);
+        });
+    }
+
+    if (!_threadCommandPools.empty())
+    {
+        for (auto& threadPool : _threadCommandPools[_currentPool])
+        {
+            if (vkResetCommandPool(_device, threadPool.commandPool, 0) != VK_SUCCESS)
+            {
+                throw VulkanException("Can't reset Vulkan Command Pool");
+            }
+            threadPool.usedCount = 0;
+        }
+    }
 }
 
-void VulkanInstance::startRenderCommandBufferCreation()
+void VulkanInstance::startRenderCommandBufferCreation(VkSubpassContents subpassContents)
 {
     VkCommandBufferBeginInfo beginInfo{};
     beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
     beginInfo.flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
     beginInfo.pInheritanceInfo = nullptr;
 
-    // TODO: Instead of single command buffer recreation for every object, secondary buffers can be used.
     // Start recording
     if (vkBeginCommandBuffer(_commandBuffers[_currentFrame], &beginInfo) != VK_SUCCESS)
     {
@@ -492,7 +726,11 @@ void VulkanInstance::startRenderCommandBufferCreation()
     renderPassBeginInfo.clearValueCount = clearValues.size();
     renderPassBeginInfo.pClearValues = clearValues.data();
 
-    vkCmdBeginRenderPass(_commandBuffers[_currentFrame], &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+    vkCmdBeginRenderPass(_commandBuffers[_currentFrame], &renderPassBeginInfo, subpassContents);
+
+    // dynamic state isn't allowed in primary buffer, secondary buffers set it from record info
+    if (subpassContents == VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS)
+        return;
 
     VkViewport viewport;
     viewport.x = 0.0f;
@@ -522,6 +760,196 @@ void VulkanInstance::endRenderCommandBufferCreation()
     }
 }
 
+RenderPassRecordInfo VulkanInstance::getRecordInfo() const
+{
+    RenderPassRecordInfo recordInfo;
+    recordInfo.renderPass = _renderPass;
+    recordInfo.framebuffer = _swapchainFramebuffers[_currentImageIndex];
+    recordInfo.extent = _extent;
+
+    return recordInfo;
+}
+
+void VulkanInstance::setRecordingThreadCount(uint32_t threadCount)
+{
+    if (threadCount == _recordingThreadCount)
+        return;
+
+    finishRendering();
+    deleteThreadCommandPools();
+    _recordingThreadCount = threadCount;
+    createThreadCommandPools();
+}
+
+uint32_t VulkanInstance::getRecordingThreadCount() const
+{
+    return _recordingThreadCount;
+}
+
+VkCommandBuffer VulkanInstance::beginSecondaryCommandBuffer(BufferIndex bufferIndex,
+                                                            const RenderPassRecordInfo& recordInfo,
+                                                            uint32_t threadIndex)
+{
+    // only recording thread accesses its pool, so no synchronization is needed
+    auto& threadPool = _threadCommandPools[_currentPool][threadIndex];
+    if (threadPool.usedCount == threadPool.secondaryBuffers.size())
+    {
+        VkCommandBufferAllocateInfo commandBufferAllocateInfo{};
+        commandBufferAllocateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        commandBufferAllocateInfo.commandPool = threadPool.commandPool;
+        commandBufferAllocateInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        commandBufferAllocateInfo.commandBufferCount = 1;
+
+        VkCommandBuffer buffer = VK_NULL_HANDLE;
+        if (vkAllocateCommandBuffers(_device, &commandBufferAllocateInfo, &buffer) != VK_SUCCESS)
+        {
+            throw VulkanException("Can't create Vulkan Command Buffers");
+        }
+        threadPool.secondaryBuffers.push_back(buffer);
+    }
+    auto commandBuffer = threadPool.secondaryBuffers[threadPool.usedCount++];
+
+    VkCommandBufferInheritanceInfo inheritanceInfo{};
+    inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    inheritanceInfo.renderPass = recordInfo.renderPass;
+    inheritanceInfo.subpass = recordInfo.subpass;
+    inheritanceInfo.framebuffer = recordInfo.framebuffer;
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    beginInfo.pInheritanceInfo = &inheritanceInfo;
+
+    if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+    {
+        throw VulkanException("Failed to begin recording Vulkan command buffer");
+    }
+
+    // dynamic state isn't inherited from primary buffer
+    if (recordInfo.useDepthBias)
+    {
+        vkCmdSetDepthBias(commandBuffer, recordInfo.depthBiasConstant, 0.0f, recordInfo.depthBiasSlope);
+    }
+
+    VkViewport viewport;
+    viewport.x = 0.0f;
+    viewport.y = 0.0f;
+    viewport.width = (float) recordInfo.extent.width;
+    viewport.height = (float) recordInfo.extent.height;
+    viewport.minDepth = 0.0f;
+    viewport.maxDepth = 1.0f;
+
+    vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+
+    VkRect2D scissor{};
+    scissor.offset = {0, 0};
+    scissor.extent = recordInfo.extent;
+
+    vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+    recordingBufferIndex = bufferIndex;
+    recordingCommandBuffer = commandBuffer;
+
+    return commandBuffer;
+}
+
+void VulkanInstance::endSecondaryCommandBuffer(VkCommandBuffer commandBuffer)
+{
+    recordingCommandBuffer = VK_NULL_HANDLE;
+
+    if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+    {
+        throw VulkanException("Failed to record Vulkan command buffer");
+    }
+}
+
+bool VulkanInstance::isMultiDrawIndirectSupported() const
+{
+    return _multiDrawIndirectSupported;
+}
+
+bool VulkanInstance::isAsyncCompute() const
+{
+    return _isAsyncCompute;
+}
+
+uint32_t VulkanInstance::getGraphicsQueueFamily() const
+{
+    return _queueIndex;
+}
+
+uint32_t VulkanInstance::getComputeQueueFamily() const
+{
+    return _computeQueueIndex;
+}
+
+bool VulkanInstance::isTransferQueue() const
+{
+    return _isTransferQueue;
+}
+
+uint32_t VulkanInstance::getTransferQueueFamily() const
+{
+    return _transferQueueIndex;
+}
+
+VkQueue VulkanInstance::getTransferQueue() const
+{
+    return _transferQueue;
+}
+
+void VulkanInstance::beginComputeCommands(VkCommandBuffer commandBuffer) const
+{
+    if (_timestampQueryPool != VK_NULL_HANDLE)
+    {
+        auto firstQuery = _currentFrame * TimestampsPerFrame;
+        vkCmdResetQueryPool(commandBuffer, _timestampQueryPool, firstQuery + ComputeBeginTimestamp, 2);
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, _timestampQueryPool,
+                            firstQuery + ComputeBeginTimestamp);
+    }
+}
+
+void VulkanInstance::endComputeCommands(VkCommandBuffer commandBuffer)
+{
+    if (_timestampQueryPool != VK_NULL_HANDLE)
+    {
+        vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, _timestampQueryPool,
+                            _currentFrame * TimestampsPerFrame + ComputeEndTimestamp);
+    }
+
+}
+
+float VulkanInstance::getComputeGpuTime() const
+{
+    return _computeGpuTime;
+}
+
+float VulkanInstance::getComputeOverlapTime() const
+{
+    return _computeOverlapTime;
+}
+
+void VulkanInstance::recordFrameCommands(BufferIndex bufferIndex, const std::function<void(VkCommandBuffer)>& commands)
+{
+    auto commandBuffer = createCommandBuffer(bufferIndex);
+
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+    {
+        throw VulkanException("Failed to begin recording Vulkan command buffer");
+    }
+
+    commands(commandBuffer);
+
+    if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+    {
+        throw VulkanException("Failed to record Vulkan command buffer");
+    }
+}
+
 void VulkanInstance::initScreenQuad(glm::ivec2 resolution)
 {
     _screenQuad = std::make_unique<VulkanScreenQuad>(resolution);
@@ -537,6 +965,41 @@ VulkanSamplerHolder* VulkanInstance::getSamplerHolder()
     return _samplerHolder.get();
 }
 
+VulkanUniformArena* VulkanInstance::getUniformArena()
+{
+    return _uniformArena.get();
+}
+
+VulkanPassUniforms* VulkanInstance::getPassUniforms()
+{
+    return _passUniforms.get();
+}
+
+VulkanDescriptorPoolSet* VulkanInstance::getDescriptorPoolSet()
+{
+    return _descriptorPoolSet.get();
+}
+
+VulkanTransformBuffer* VulkanInstance::getTransformBuffer()
+{
+    return _transformBuffer.get();
+}
+
+VulkanUploadManager* VulkanInstance::getUploadManager() const
+{
+    return _uploadManager.get();
+}
+
+VulkanGeometryArena* VulkanInstance::getGeometryArena()
+{
+    return _geometryArena.get();
+}
+
+VulkanTextureTable* VulkanInstance::getTextureTable()
+{
+    return _textureTable.get();
+}
+
 VulkanPassInfo* VulkanInstance::getPassInfo()
 {
     return _passInfo.get();
@@ -567,6 +1030,13 @@ void VulkanInstance::createInstance()
         extensions.push_back(VK_EXT_DEBUG_REPORT_EXTENSION_NAME);
         extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
     }
+    // needed to query descriptor indexing features
+    if (_engineSettings.useBindlessTextures
+        && isInstanceExtensionSupported(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME))
+    {
+        extensions.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+        _physicalDeviceProperties2Enabled = true;
+    }
 
     instanceInfo.enabledExtensionCount = static_cast<uint32_t>(extensions.size());
     instanceInfo.ppEnabledExtensionNames = extensions.data();
@@ -630,14 +1100,79 @@ void VulkanInstance::createDevice()
         {
             throw VulkanException("GPU doesn't support graphics output");
         }
+
+        // family without graphics support is usually a separate hardware queue, which runs in parallel with graphics
+        const auto computeQueueIter = std::find_if(queueFamilyProps.begin(), queueFamilyProps.end(),
+                                                   [](const VkQueueFamilyProperties &prop)
+                                                   {
+                                                       return (prop.queueFlags & VK_QUEUE_COMPUTE_BIT)
+                                                              && !(prop.queueFlags & VK_QUEUE_GRAPHICS_BIT);
+                                                   });
+
+        _computeQueueIndex = _queueIndex;
+        if (_engineSettings.useAsyncCompute)
+        {
+            if (computeQueueIter != queueFamilyProps.end())
+            {
+                _computeQueueIndex = static_cast<uint32_t>(std::distance(queueFamilyProps.begin(), computeQueueIter));
+                _isAsyncCompute = true;
+                std::cout << "Async compute enabled (queue family " << _computeQueueIndex << ")" << std::endl;
+            }
+            else
+            {
+                std::cout << "GPU has no separate compute queue family, compute runs on graphics queue" << std::endl;
+            }
+        }
+
+        // dedicated transfer family is usually a DMA engine, which copies data without blocking other queues
+        const auto transferQueueIter = std::find_if(queueFamilyProps.begin(), queueFamilyProps.end(),
+                                                    [](const VkQueueFamilyProperties &prop)
+                                                    {
+                                                        return (prop.queueFlags & VK_QUEUE_TRANSFER_BIT)
+                                                               && !(prop.queueFlags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT));
+                                                    });
+
+        _transferQueueIndex = _queueIndex;
+        if (_engineSettings.useTransferQueue)
+        {
+            if (transferQueueIter != queueFamilyProps.end())
+            {
+                _transferQueueIndex = static_cast<uint32_t>(std::distance(queueFamilyProps.begin(), transferQueueIter));
+                _isTransferQueue = true;
+                std::cout << "Transfer queue enabled (queue family " << _transferQueueIndex << ")" << std::endl;
+            }
+            else
+            {
+                std::cout << "GPU has no separate transfer queue family, uploads run on graphics queue" << std::endl;
+            }
+        }
+
+        if (_engineSettings.profileAsyncCompute)
+        {
+            auto validBits = std::min(queueFamilyProps[_queueIndex].timestampValidBits,
+                                      queueFamilyProps[_computeQueueIndex].timestampValidBits);
+            if (validBits == 0)
+                std::cout << "GPU doesn't support timestamps, compute profiling disabled" << std::endl;
+            else
+                _timestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+        }
     }
 
     float priorities[] = {1.0f};
-    VkDeviceQueueCreateInfo deviceQueueCreateInfo{};
-    deviceQueueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
-    deviceQueueCreateInfo.queueCount = 1;
-    deviceQueueCreateInfo.queueFamilyIndex = _queueIndex;
-    deviceQueueCreateInfo.pQueuePriorities = priorities;
+    std::vector<uint32_t> queueFamilyList = { _queueIndex };
+    if (_isAsyncCompute)
+        queueFamilyList.push_back(_computeQueueIndex);
+    if (_isTransferQueue)
+        queueFamilyList.push_back(_transferQueueIndex);
+    std::vector<VkDeviceQueueCreateInfo> queueCreateInfoList(queueFamilyList.size());
+    for (auto i = 0u; i < queueCreateInfoList.size(); i++)
+    {
+        auto& deviceQueueCreateInfo = queueCreateInfoList[i];
+        deviceQueueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+        deviceQueueCreateInfo.queueCount = 1;
+        deviceQueueCreateInfo.queueFamilyIndex = queueFamilyList[i];
+        deviceQueueCreateInfo.pQueuePriorities = priorities;
+    }
 
     // TODO: Add device extension support check (mb when displaying list of supported GPUs)
     std::vector<const char *> extensions = {
@@ -655,11 +1190,35 @@ void VulkanInstance::createDevice()
     deviceFeatures.geometryShader = VK_TRUE;
     deviceFeatures.imageCubeArray = VK_TRUE;
 
+    VkPhysicalDeviceFeatures supportedFeatures {};
+    vkGetPhysicalDeviceFeatures(_gpu, &supportedFeatures);
+    _multiDrawIndirectSupported = supportedFeatures.multiDrawIndirect == VK_TRUE;
+    deviceFeatures.multiDrawIndirect = supportedFeatures.multiDrawIndirect;
+
+    VkPhysicalDeviceDescriptorIndexingFeaturesEXT indexingFeatures {};
+    indexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+    if (_engineSettings.useBindlessTextures)
+    {
+        checkBindlessTexturesSupport(indexingFeatures);
+        if (_bindlessTexturesSupported)
+        {
+            extensions.push_back(VK_KHR_MAINTENANCE3_EXTENSION_NAME);
+            extensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+            std::cout << "Bindless textures enabled (" << _engineSettings.maxBindlessTextures << " textures)" << std::endl;
+        }
+        else
+        {
+            std::cout << "Bindless textures not supported, using fallback shaders" << std::endl;
+        }
+    }
+
     VkDeviceCreateInfo deviceCreateInfo{};
     deviceCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    if (_bindlessTexturesSupported)
+        deviceCreateInfo.pNext = &indexingFeatures;
     deviceCreateInfo.pEnabledFeatures = &deviceFeatures;
-    deviceCreateInfo.queueCreateInfoCount = 1;
-    deviceCreateInfo.pQueueCreateInfos = &deviceQueueCreateInfo;
+    deviceCreateInfo.queueCreateInfoCount = queueCreateInfoList.size();
+    deviceCreateInfo.pQueueCreateInfos = queueCreateInfoList.data();
     deviceCreateInfo.enabledExtensionCount = extensions.size();
     deviceCreateInfo.ppEnabledExtensionNames = extensions.data();
 
@@ -677,6 +1236,63 @@ void VulkanInstance::createDevice()
     }
 
     vkGetDeviceQueue(_device, _queueIndex, 0, &_queue);
+    vkGetDeviceQueue(_device, _computeQueueIndex, 0, &_computeQueue);
+    vkGetDeviceQueue(_device, _transferQueueIndex, 0, &_transferQueue);
+}
+
+void VulkanInstance::checkBindlessTexturesSupport(VkPhysicalDeviceDescriptorIndexingFeaturesEXT& indexingFeatures)
+{
+    _bindlessTexturesSupported = false;
+
+    // texture table is bound after all material sets
+    if (!_physicalDeviceProperties2Enabled
+        || _gpuProps.limits.maxBoundDescriptorSets <= VulkanTextureTable::TableSet
+        || !isDeviceExtensionSupported(_gpu, VK_KHR_MAINTENANCE3_EXTENSION_NAME)
+        || !isDeviceExtensionSupported(_gpu, VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME))
+    {
+        return;
+    }
+
+    auto getFeatures2 = (PFN_vkGetPhysicalDeviceFeatures2KHR) vkGetInstanceProcAddr(_instance, "vkGetPhysicalDeviceFeatures2KHR");
+    auto getProperties2 = (PFN_vkGetPhysicalDeviceProperties2KHR) vkGetInstanceProcAddr(_instance, "vkGetPhysicalDeviceProperties2KHR");
+    if (getFeatures2 == nullptr || getProperties2 == nullptr)
+        return;
+
+    VkPhysicalDeviceDescriptorIndexingFeaturesEXT supportedFeatures {};
+    supportedFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+    VkPhysicalDeviceFeatures2KHR features2 {};
+    features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+    features2.pNext = &supportedFeatures;
+    getFeatures2(_gpu, &features2);
+
+    if (!supportedFeatures.runtimeDescriptorArray
+        || !supportedFeatures.descriptorBindingPartiallyBound
+        || !supportedFeatures.descriptorBindingSampledImageUpdateAfterBind)
+    {
+        return;
+    }
+
+    VkPhysicalDeviceDescriptorIndexingPropertiesEXT indexingProperties {};
+    indexingProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT;
+    VkPhysicalDeviceProperties2KHR properties2 {};
+    properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2_KHR;
+    properties2.pNext = &indexingProperties;
+    getProperties2(_gpu, &properties2);
+
+    _engineSettings.maxBindlessTextures = std::min({
+            _engineSettings.maxBindlessTextures,
+            indexingProperties.maxDescriptorSetUpdateAfterBindSampledImages,
+            indexingProperties.maxDescriptorSetUpdateAfterBindSamplers,
+            indexingProperties.maxPerStageDescriptorUpdateAfterBindSampledImages,
+            indexingProperties.maxPerStageDescriptorUpdateAfterBindSamplers});
+    if (_engineSettings.maxBindlessTextures == 0)
+        return;
+
+    indexingFeatures.runtimeDescriptorArray = VK_TRUE;
+    indexingFeatures.descriptorBindingPartiallyBound = VK_TRUE;
+    indexingFeatures.descriptorBindingSampledImageUpdateAfterBind = VK_TRUE;
+    indexingFeatures.shaderSampledImageArrayNonUniformIndexing = supportedFeatures.shaderSampledImageArrayNonUniformIndexing;
+    _bindlessTexturesSupported = true;
 }
 
 void VulkanInstance::deleteDevice()
@@ -902,7 +1518,8 @@ void VulkanInstance::createRenderPass()
     colorAttachment.format = _surfaceFormat.format;
     colorAttachment.samples = _msaaSamples; // for multisampling
     colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR; // clear every frame
-    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE; // should be STORE for rendering
+    // multisampled image is only resolved to swapchain image
+    colorAttachment.storeOp = _msaaSamples == VK_SAMPLE_COUNT_1_BIT ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
     colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
     colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
@@ -962,6 +1579,7 @@ void VulkanInstance::createRenderPass()
     std::vector<VkAttachmentDescription> attachments = {colorAttachment, depthAttachment, colorAttachmentResolve};
     if (_msaaSamples == VK_SAMPLE_COUNT_1_BIT)
         attachments.resize(2);
+    _attachmentTraffic = VulkanUtils::getAttachmentTraffic(attachments, _extent);
 
     VkRenderPassCreateInfo renderPassCreateInfo{};
     renderPassCreateInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
@@ -1007,18 +1625,79 @@ void VulkanInstance::createCommandPool()
         }
     }
 
+    if (_isAsyncCompute)
+    {
+        _computeCommandPools.resize(_swapchainImages.size());
+        for (auto& commandPool : _computeCommandPools)
+        {
+            VkCommandPoolCreateInfo poolCreateInfo{};
+            poolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            poolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+            poolCreateInfo.queueFamilyIndex = _computeQueueIndex;
+
+            if (vkCreateCommandPool(_device, &poolCreateInfo, nullptr, &commandPool) != VK_SUCCESS)
+            {
+                throw VulkanException("Can't create Vulkan Command Pool");
+            }
+        }
+    }
+
     _commandBuffers.resize(getInFlightSize());
+    createThreadCommandPools();
 }
 
 void VulkanInstance::deleteCommandPool()
 {
+    deleteThreadCommandPools();
     for (auto commandPool : _commandPools)
     {
         vkDestroyCommandPool(_device, commandPool, nullptr);
     }
+    for (auto commandPool : _computeCommandPools)
+    {
+        vkDestroyCommandPool(_device, commandPool, nullptr);
+    }
+    _computeCommandPools.clear();
     _poolBufferMap.clear();
 }
 
+void VulkanInstance::createThreadCommandPools()
+{
+    // single-threaded recording uses primary buffers only
+    if (_recordingThreadCount <= 1)
+        return;
+
+    _threadCommandPools.resize(_commandPools.size());
+    for (auto& threadPools : _threadCommandPools)
+    {
+        threadPools.resize(_recordingThreadCount);
+        for (auto& threadPool : threadPools)
+        {
+            VkCommandPoolCreateInfo poolCreateInfo{};
+            poolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+            poolCreateInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+            poolCreateInfo.queueFamilyIndex = _queueIndex;
+
+            if (vkCreateCommandPool(_device, &poolCreateInfo, nullptr, &threadPool.commandPool) != VK_SUCCESS)
+            {
+                throw VulkanException("Can't create Vulkan Command Pool");
+            }
+        }
+    }
+}
+
+void VulkanInstance::deleteThreadCommandPools()
+{
+    for (auto& threadPools : _threadCommandPools)
+    {
+        for (auto& threadPool : threadPools)
+        {
+            vkDestroyCommandPool(_device, threadPool.commandPool, nullptr);
+        }
+    }
+    _threadCommandPools.clear();
+}
+
 void VulkanInstance::createMSAABuffer()
 {
     VkFormat colorFormat = _surfaceFormat.format;
@@ -1068,7 +1747,7 @@ void VulkanInstance::createDepthBuffer()
             _msaaSamples,
             depthFormat,
             VK_IMAGE_TILING_OPTIMAL,
-            VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+            VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
             _depthImage,
             _depthImageMemory);
@@ -1133,16 +1812,7 @@ void VulkanInstance::createSyncPrimitives()
     _inFlightFences.resize(MAX_FRAMES_IN_FLIGHT);
 
     _imageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-    _renderFinishedSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-    _shadowMapDirectReadySemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-    _shadowMapPointReadySemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-    _waterReflectionReadySemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-    _waterRefractionReadySemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-    _screenQuadReadySemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-    _screenQuadMrtReadySemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-    _screenQuadLateReadySemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-    _screenQuadDepthReadySemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-    _computeParticlesReadySemaphore.resize(MAX_FRAMES_IN_FLIGHT);
+    _submitSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
 
     VkSemaphoreCreateInfo semaphoreCreateInfo{};
     semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
@@ -1153,46 +1823,10 @@ void VulkanInstance::createSyncPrimitives()
         {
             throw std::runtime_error("Failed to create Vulkan semaphore");
         }
-        if (vkCreateSemaphore(_device, &semaphoreCreateInfo, nullptr, &_renderFinishedSemaphores[i]) != VK_SUCCESS)
-        {
-            throw std::runtime_error("Failed to create Vulkan semaphore");
-        }
-        if (vkCreateSemaphore(_device, &semaphoreCreateInfo, nullptr, &_shadowMapDirectReadySemaphores[i]) != VK_SUCCESS)
-        {
-            throw std::runtime_error("Failed to create Vulkan semaphore");
-        }
-        if (vkCreateSemaphore(_device, &semaphoreCreateInfo, nullptr, &_shadowMapPointReadySemaphores[i]) != VK_SUCCESS)
-        {
-            throw std::runtime_error("Failed to create Vulkan semaphore");
-        }
-        if (vkCreateSemaphore(_device, &semaphoreCreateInfo, nullptr, &_waterReflectionReadySemaphores[i]) != VK_SUCCESS)
-        {
-            throw std::runtime_error("Failed to create Vulkan semaphore");
-        }
-        if (vkCreateSemaphore(_device, &semaphoreCreateInfo, nullptr, &_waterRefractionReadySemaphores[i]) != VK_SUCCESS)
-        {
-            throw std::runtime_error("Failed to create Vulkan semaphore");
-        }
-        if (vkCreateSemaphore(_device, &semaphoreCreateInfo, nullptr, &_screenQuadReadySemaphores[i]) != VK_SUCCESS)
-        {
-            throw std::runtime_error("Failed to create Vulkan semaphore");
-        }
-        if (vkCreateSemaphore(_device, &semaphoreCreateInfo, nullptr, &_screenQuadMrtReadySemaphores[i]) != VK_SUCCESS)
-        {
-            throw std::runtime_error("Failed to create Vulkan semaphore");
-        }
-        if (vkCreateSemaphore(_device, &semaphoreCreateInfo, nullptr, &_screenQuadLateReadySemaphores[i]) != VK_SUCCESS)
-        {
-            throw std::runtime_error("Failed to create Vulkan semaphore");
-        }
-        if (vkCreateSemaphore(_device, &semaphoreCreateInfo, nullptr, &_screenQuadDepthReadySemaphores[i]) != VK_SUCCESS)
-        {
-            throw std::runtime_error("Failed to create Vulkan semaphore");
-        }
-        if (vkCreateSemaphore(_device, &semaphoreCreateInfo, nullptr, &_computeParticlesReadySemaphore[i]) != VK_SUCCESS)
-        {
-            throw std::runtime_error("Failed to create Vulkan semaphore");
-        }
+    }
+    if (vkCreateSemaphore(_device, &semaphoreCreateInfo, nullptr, &_graphicsDoneSemaphore) != VK_SUCCESS)
+    {
+        throw std::runtime_error("Failed to create Vulkan semaphore");
     }
 
     VkFenceCreateInfo fenceCreateInfo{};
@@ -1213,17 +1847,11 @@ void VulkanInstance::deleteSyncPrimitives()
     for (auto i = 0u; i < MAX_FRAMES_IN_FLIGHT; i++)
     {
         vkDestroySemaphore(_device, _imageAvailableSemaphores[i], nullptr);
-        vkDestroySemaphore(_device, _renderFinishedSemaphores[i], nullptr);
-        vkDestroySemaphore(_device, _shadowMapDirectReadySemaphores[i], nullptr);
-        vkDestroySemaphore(_device, _shadowMapPointReadySemaphores[i], nullptr);
-        vkDestroySemaphore(_device, _waterRefractionReadySemaphores[i], nullptr);
-        vkDestroySemaphore(_device, _waterReflectionReadySemaphores[i], nullptr);
-        vkDestroySemaphore(_device, _screenQuadReadySemaphores[i], nullptr);
-        vkDestroySemaphore(_device, _screenQuadMrtReadySemaphores[i], nullptr);
-        vkDestroySemaphore(_device, _screenQuadLateReadySemaphores[i], nullptr);
-        vkDestroySemaphore(_device, _screenQuadDepthReadySemaphores[i], nullptr);
-        vkDestroySemaphore(_device, _computeParticlesReadySemaphore[i], nullptr);
+        for (auto semaphore : _submitSemaphores[i])
+            vkDestroySemaphore(_device, semaphore, nullptr);
+        _submitSemaphores[i].clear();
     }
+    vkDestroySemaphore(_device, _graphicsDoneSemaphore, nullptr);
 
 
     for (auto i = 0u; i < MAX_FRAMES_IN_FLIGHT; i++)
@@ -1232,6 +1860,61 @@ void VulkanInstance::deleteSyncPrimitives()
     }
 }
 
+void VulkanInstance::createTimestampQueryPool()
+{
+    _isComputeTimestampWritten.resize(MAX_FRAMES_IN_FLIGHT, false);
+    if (!_engineSettings.profileAsyncCompute || _timestampMask == 0)
+        return;
+
+    VkQueryPoolCreateInfo queryPoolCreateInfo{};
+    queryPoolCreateInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    queryPoolCreateInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    queryPoolCreateInfo.queryCount = TimestampsPerFrame * MAX_FRAMES_IN_FLIGHT;
+
+    if (vkCreateQueryPool(_device, &queryPoolCreateInfo, nullptr, &_timestampQueryPool) != VK_SUCCESS)
+    {
+        throw VulkanException("Can't create Vulkan timestamp query pool");
+    }
+}
+
+void VulkanInstance::deleteTimestampQueryPool()
+{
+    if (_timestampQueryPool != VK_NULL_HANDLE)
+        vkDestroyQueryPool(_device, _timestampQueryPool, nullptr);
+}
+
+void VulkanInstance::readTimestamps()
+{
+    // frame fence is signaled, so queries of its previous submit are available
+    if (_timestampQueryPool == VK_NULL_HANDLE || !_isComputeTimestampWritten[_currentFrame])
+        return;
+    _isComputeTimestampWritten[_currentFrame] = false;
+
+    uint64_t timestamps[TimestampsPerFrame];
+    auto result = vkGetQueryPoolResults(_device, _timestampQueryPool, _currentFrame * TimestampsPerFrame, TimestampsPerFrame,
+                                        sizeof(timestamps), timestamps, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+    if (result != VK_SUCCESS)
+        return;
+
+    for (auto& timestamp : timestamps)
+        timestamp &= _timestampMask;
+    auto toMilliseconds = [this](uint64_t begin, uint64_t end)
+    {
+        return end > begin ? (end - begin) * _gpuProps.limits.timestampPeriod / 1000000.0f : 0.0f;
+    };
+
+    _computeGpuTime = toMilliseconds(timestamps[ComputeBeginTimestamp], timestamps[ComputeEndTimestamp]);
+    // Queues of a device share timestamp clock on common GPUs (though it's not guaranteed),
+    // overlap is the part of compute interval inside graphics interval
+    _computeOverlapTime = 0;
+    if (_isAsyncCompute)
+    {
+        _computeOverlapTime = toMilliseconds(
+                std::max(timestamps[ComputeBeginTimestamp], timestamps[GraphicsBeginTimestamp]),
+                std::min(timestamps[ComputeEndTimestamp], timestamps[GraphicsEndTimestamp]));
+    }
+}
+
 void VulkanInstance::addPlatformSpecificExtensions(std::vector<const char *> &extensionsList)
 {
     unsigned int count;
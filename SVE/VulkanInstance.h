@@ -6,10 +6,12 @@
 #include "Engine.h"
 #include "VulkanUtils.h"
 #include "VulkanHeaders.h"
+#include "VulkanCommandsManager.h"
 #include <vulkan/vk_mem_alloc.h>
 #include <vector>
 #include <SDL2/SDL.h>
 #include <map>
+#include <functional>
 
 namespace SVE
 {
@@ -17,6 +19,13 @@ class VulkanMesh;
 class VulkanScreenQuad;
 class VulkanSamplerHolder;
 class VulkanPassInfo;
+class VulkanUniformArena;
+class VulkanPassUniforms;
+class VulkanDescriptorPoolSet;
+class VulkanTransformBuffer;
+class VulkanTextureTable;
+class VulkanUploadManager;
+class VulkanGeometryArena;
 
 // TODO: Create some mapping to external indexes instead of hardcoding
 enum
@@ -29,7 +38,9 @@ enum
     BUFFER_INDEX_SCREEN_QUAD = 400,
     BUFFER_INDEX_SCREEN_QUAD_MRT = 450,
     BUFFER_INDEX_SCREEN_QUAD_LATE = 451,
-    BUFFER_INDEX_COMPUTE_PARTICLES = 500
+    BUFFER_INDEX_COMPUTE_PARTICLES = 500,
+    BUFFER_INDEX_TIMESTAMP_BEGIN = 510,
+    BUFFER_INDEX_TIMESTAMP_END = 511
 };
 
 using PoolID = uint32_t;
@@ -51,6 +62,8 @@ public:
     VkInstance getInstance() const;
     VkPhysicalDevice getGPU() const;
     VkPhysicalDeviceProperties getGPUInfo() const;
+    // Indirect draws with several commands, GPU culled batches sharing material and geometry block use them
+    bool isMultiDrawIndirectSupported() const;
     VkDevice getLogicalDevice() const;
     VmaAllocator getAllocator() const;
     VkCommandPool getCommandPool(PoolID index) const;
@@ -72,18 +85,64 @@ public:
     const std::vector<VkCommandBuffer>& getCommandBuffersList();
 
     void waitAvailableFramebuffer();
-    void submitCommands(CommandsType commandsType, BufferIndex bufferIndex) const;
+    // Submits are executed in call order, frame end submit signals frame fence.
+    // Compute wait submit also waits for compute queue submit of the frame.
+    void submitCommands(BufferIndex bufferIndex, bool isFrameEnd, bool isComputeWait = false) const;
+    // All batches are sent with single queue submit, command buffers of a batch wait for previous batch,
+    // last batch signals frame fence
+    void submitCommands(const std::vector<BufferIndex>& bufferIndexList, const std::vector<uint32_t>& batchSizeList,
+                        uint32_t computeWaitBatch = NoComputeWait) const;
+    // Sent before graphics submits of the frame, it waits only for graphics submits of the previous frame
+    void submitComputeCommands(BufferIndex bufferIndex) const;
     void renderCommands() const;
     uint32_t getCurrentImageIndex() const;
     uint32_t getCurrentFrameIndex() const;
 
     void reallocateCommandBuffers();
-    void startRenderCommandBufferCreation();
+    void startRenderCommandBufferCreation(VkSubpassContents subpassContents = VK_SUBPASS_CONTENTS_INLINE);
     void endRenderCommandBufferCreation();
+    RenderPassRecordInfo getRecordInfo() const;
+    VulkanUtils::AttachmentTraffic getAttachmentTraffic() const;
+
+    // Secondary command buffers are allocated from per-thread pools, so they can be recorded in parallel.
+    // While secondary buffer is recorded, getCommandBuffer(bufferIndex) returns it on the recording thread.
+    void setRecordingThreadCount(uint32_t threadCount);
+    uint32_t getRecordingThreadCount() const;
+    VkCommandBuffer beginSecondaryCommandBuffer(BufferIndex bufferIndex, const RenderPassRecordInfo& recordInfo, uint32_t threadIndex);
+    void endSecondaryCommandBuffer(VkCommandBuffer commandBuffer);
+
+    // Compute passes are submitted to separate compute queue family if GPU has it and useAsyncCompute is set.
+    // Buffers written by compute and read by graphics passes are shared by both families (see VulkanUtils::createBuffer),
+    // so there are no ownership transfers, only semaphores between compute and graphics submits.
+    bool isAsyncCompute() const;
+    uint32_t getGraphicsQueueFamily() const;
+    uint32_t getComputeQueueFamily() const;
+    // Called at the start and at the end of compute command buffer recording
+    void beginComputeCommands(VkCommandBuffer commandBuffer) const;
+    void endComputeCommands(VkCommandBuffer commandBuffer);
+    // GPU milliseconds measured with profileAsyncCompute, they are from the previous use of current frame
+    float getComputeGpuTime() const;
+    float getComputeOverlapTime() const;
+
+    static constexpr uint32_t NoComputeWait = 0xFFFFFFFF;
+
+    // Separate transfer queue family is used for uploads if GPU has it and useTransferQueue is set,
+    // otherwise transfer queue is the graphics queue
+    bool isTransferQueue() const;
+    uint32_t getTransferQueueFamily() const;
+    VkQueue getTransferQueue() const;
 
     VulkanScreenQuad* getScreenQuad();
     VulkanSamplerHolder* getSamplerHolder();
     VulkanPassInfo* getPassInfo();
+    VulkanUniformArena* getUniformArena();
+    VulkanPassUniforms* getPassUniforms();
+    VulkanDescriptorPoolSet* getDescriptorPoolSet();
+    VulkanTransformBuffer* getTransformBuffer();
+    VulkanUploadManager* getUploadManager() const;
+    VulkanGeometryArena* getGeometryArena();
+    // nullptr if bindless textures are disabled or not supported by GPU
+    VulkanTextureTable* getTextureTable();
     void initScreenQuad(glm::ivec2 resolution);
 
 private:
@@ -106,6 +165,8 @@ private:
     void deleteRenderPass();
     void createCommandPool();
     void deleteCommandPool();
+    void createThreadCommandPools();
+    void deleteThreadCommandPools();
     void createMSAABuffer();
     void deleteMSAABuffer();
     void createDepthBuffer();
@@ -113,7 +174,15 @@ private:
     void createFramebuffers();
     void deleteFramebuffers();
     void createSyncPrimitives();
+    VkSemaphore getSubmitSemaphore() const;
     void deleteSyncPrimitives();
+    void createTimestampQueryPool();
+    void deleteTimestampQueryPool();
+    void readTimestamps();
+
+    void submitBatches(const BufferIndex* bufferIndexList, const uint32_t* batchSizeList, uint32_t batchCount,
+                       uint32_t computeWaitBatch, bool isFrameEnd) const;
+    void recordFrameCommands(BufferIndex bufferIndex, const std::function<void(VkCommandBuffer)>& commands);
 
     void createDebugCallback();
     void deleteDebugCallback();
@@ -123,6 +192,7 @@ private:
     void addPlatformSpecificExtensions(std::vector<const char*>& extensionsList);
     VkSampleCountFlagBits getMSAALevelsValue(int msaaLevels);
     size_t getGPUIndex(std::vector<VkPhysicalDevice>& deviceList);
+    void checkBindlessTexturesSupport(VkPhysicalDeviceDescriptorIndexingFeaturesEXT& indexingFeatures);
 
 private:
     EngineSettings _engineSettings;
@@ -136,6 +206,9 @@ private:
     VkPhysicalDevice _gpu = VK_NULL_HANDLE;
     VkPhysicalDeviceProperties _gpuProps;
     VkDevice _device = VK_NULL_HANDLE;
+    bool _physicalDeviceProperties2Enabled = false;
+    bool _bindlessTexturesSupported = false;
+    bool _multiDrawIndirectSupported = false;
 
     VmaAllocator _allocator = VK_NULL_HANDLE;
 
@@ -146,6 +219,13 @@ private:
 
     uint32_t _queueIndex;
     VkQueue _queue = VK_NULL_HANDLE;;
+    // same as graphics queue if async compute isn't used
+    uint32_t _computeQueueIndex;
+    VkQueue _computeQueue = VK_NULL_HANDLE;
+    bool _isAsyncCompute = false;
+    uint32_t _transferQueueIndex;
+    VkQueue _transferQueue = VK_NULL_HANDLE;
+    bool _isTransferQueue = false;
 
     VkSurfaceKHR _surface = VK_NULL_HANDLE;;
     VkSurfaceFormatKHR _surfaceFormat;
@@ -155,6 +235,7 @@ private:
     VkExtent2D _extent;
     VkSwapchainKHR _swapchain = VK_NULL_HANDLE;;
     VkRenderPass _renderPass = VK_NULL_HANDLE;;
+    VulkanUtils::AttachmentTraffic _attachmentTraffic;
 
     std::vector<VkImage> _swapchainImages;
     std::vector<VkImageView> _swapchainImageViews;
@@ -162,10 +243,22 @@ private:
 
     PoolID _currentPool = 0;
     std::vector<VkCommandPool> _commandPools;
+    // compute queue family pools, cycled together with main pools
+    std::vector<VkCommandPool> _computeCommandPools;
     std::vector<VkCommandBuffer> _commandBuffers;
     std::map<uint32_t, VkCommandBuffer> _externalBufferMap;
     std::map<std::pair<PoolID, BufferIndex>, VkCommandBuffer> _poolBufferMap;
 
+    struct ThreadCommandPool
+    {
+        VkCommandPool commandPool = VK_NULL_HANDLE;
+        std::vector<VkCommandBuffer> secondaryBuffers;
+        uint32_t usedCount = 0;
+    };
+    uint32_t _recordingThreadCount = 1;
+    // [pool][thread], pools are cycled together with main command pools
+    std::vector<std::vector<ThreadCommandPool>> _threadCommandPools;
+
     // color attachment for anti-aliasing
     VkImage _colorImage = VK_NULL_HANDLE;;
     VkDeviceMemory _colorImageMemory = VK_NULL_HANDLE;;
@@ -176,21 +269,35 @@ private:
     VkImageView _depthImageView = VK_NULL_HANDLE;;
 
     const uint32_t MAX_FRAMES_IN_FLIGHT = 2; // max parallel processing frame
-    std::vector<VkSemaphore> _computeParticlesReadySemaphore;
-    std::vector<VkSemaphore> _shadowMapDirectReadySemaphores;
-    std::vector<VkSemaphore> _shadowMapPointReadySemaphores;
-    std::vector<VkSemaphore> _waterReflectionReadySemaphores;
-    std::vector<VkSemaphore> _waterRefractionReadySemaphores;
-    std::vector<VkSemaphore> _screenQuadReadySemaphores;
-    std::vector<VkSemaphore> _screenQuadMrtReadySemaphores;
-    std::vector<VkSemaphore> _screenQuadLateReadySemaphores;
-    std::vector<VkSemaphore> _screenQuadDepthReadySemaphores;
     std::vector<VkSemaphore> _imageAvailableSemaphores;
-    std::vector<VkSemaphore> _renderFinishedSemaphores;
+    // [frame][submit], created on demand for render graph passes
+    mutable std::vector<std::vector<VkSemaphore>> _submitSemaphores;
 
     // TODO: Meh... mutable
     mutable int _currentFrame = 0;
     mutable VkSemaphore _currentWaitSemaphore = VK_NULL_HANDLE;;
+    mutable uint32_t _submitIndex = 0;
+    // reused by batched submit
+    mutable std::vector<VkSubmitInfo> _submitInfoList;
+    mutable std::vector<VkCommandBuffer> _submitCommandBuffers;
+    mutable std::vector<VkSemaphore> _submitWaitSemaphores;
+    mutable std::vector<VkPipelineStageFlags> _submitWaitStages;
+    mutable std::vector<VkSemaphore> _submitSignalSemaphores;
+    mutable bool _isFrameSubmitStarted = false;
+    // signaled by compute submit of current frame, until graphics submit waits for it
+    mutable VkSemaphore _computeSemaphore = VK_NULL_HANDLE;
+
+    // signaled by the last graphics submit of the frame with async compute, so next frame compute submit
+    // doesn't overwrite buffers read by graphics. Waited by graphics if there was no compute submit.
+    VkSemaphore _graphicsDoneSemaphore = VK_NULL_HANDLE;
+    mutable bool _isGraphicsDoneSignaled = false;
+
+    // compute begin/end and graphics begin/end timestamps per frame in flight
+    VkQueryPool _timestampQueryPool = VK_NULL_HANDLE;
+    uint64_t _timestampMask = 0;
+    mutable std::vector<bool> _isComputeTimestampWritten;
+    float _computeGpuTime = 0;
+    float _computeOverlapTime = 0;
 
     std::vector<VkFence> _inFlightFences;
     uint32_t _currentImageIndex = 0;
@@ -198,6 +305,13 @@ private:
     std::unique_ptr<VulkanScreenQuad> _screenQuad;
     std::unique_ptr<VulkanSamplerHolder> _samplerHolder;
     std::unique_ptr<VulkanPassInfo> _passInfo;
+    std::unique_ptr<VulkanDescriptorPoolSet> _descriptorPoolSet;
+    std::unique_ptr<VulkanUniformArena> _uniformArena;
+    std::unique_ptr<VulkanTransformBuffer> _transformBuffer;
+    std::unique_ptr<VulkanPassUniforms> _passUniforms;
+    std::unique_ptr<VulkanTextureTable> _textureTable;
+    std::unique_ptr<VulkanUploadManager> _uploadManager;
+    std::unique_ptr<VulkanGeometryArena> _geometryArena;
 };
 
 } // namespace SVE
\ No newline at end of file
@@ -0,0 +1,392 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#include "VulkanInstanceCulling.h"
+#include "VulkanInstance.h"
+#include "VulkanTransformBuffer.h"
+#include "VulkanShaderInfo.h"
+#include "VulkanUtils.h"
+#include "VulkanException.h"
+#include <algorithm>
+#include <iostream>
+
+namespace SVE
+{
+
+namespace
+{
+
+const uint32_t WorkgroupSize = 64;
+const float UnboundedSize = 1e30f;
+
+VkDeviceSize alignSize(VkDeviceSize size, VkDeviceSize alignment)
+{
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+bool lessPosition(const glm::vec3& a, const glm::vec3& b)
+{
+    if (a.x != b.x)
+        return a.x < b.x;
+    if (a.y != b.y)
+        return a.y < b.y;
+    return a.z < b.z;
+}
+
+} // anon namespace
+
+VulkanInstanceCulling::VulkanInstanceCulling(VulkanInstance* vulkanInstance, VulkanShaderInfo* computeShader, uint32_t maxBatchCount)
+    : _vulkanInstance(vulkanInstance)
+    , _device(vulkanInstance->getLogicalDevice())
+    , _computeShader(computeShader)
+    , _maxBatchCount(std::max(maxBatchCount, 1u))
+    , _instanceCapacity(vulkanInstance->getTransformBuffer()->getCapacity())
+{
+    auto swapchainSize = _vulkanInstance->getSwapchainSize();
+    _viewProjection.resize(swapchainSize);
+    _instanceCount.resize(swapchainSize, 0);
+    _batchCount.resize(swapchainSize, 0);
+
+    createBuffers();
+    createDescriptorSets();
+    createPipeline();
+}
+
+VulkanInstanceCulling::~VulkanInstanceCulling()
+{
+    deletePipeline();
+    deleteDescriptorSets();
+    deleteBuffers();
+}
+
+bool VulkanInstanceCulling::isCulledPass(CommandsType passType)
+{
+    switch (passType)
+    {
+        case CommandsType::MainPass:
+        case CommandsType::ScreenQuadPass:
+        case CommandsType::ScreenQuadMRTPass:
+        case CommandsType::ScreenQuadLatePass:
+        case CommandsType::ScreenQuadDepthPass:
+        case CommandsType::RefractionPass:
+            return true;
+        default:
+            return false;
+    }
+}
+
+uint32_t VulkanInstanceCulling::getMaxBatchCount() const
+{
+    return _maxBatchCount;
+}
+
+void VulkanInstanceCulling::setBatch(uint32_t batchIndex, uint32_t firstInstance, uint32_t indexCount, uint32_t firstIndex,
+                                     int32_t vertexOffset, const BoundingBox* boundingBox)
+{
+    auto imageIndex = _vulkanInstance->getCurrentImageIndex();
+
+    auto* bounds = reinterpret_cast<BatchBounds*>(_boundsBuffer.mappedData + _boundsBuffer.regionSize * imageIndex) + batchIndex;
+    if (boundingBox)
+    {
+        bounds->min = glm::vec4(boundingBox->min, 1.0f);
+        bounds->max = glm::vec4(boundingBox->max, 1.0f);
+    }
+    else
+    {
+        // meshes without bounds are never culled (finite size, so transformed bounds don't overflow)
+        bounds->min = glm::vec4(glm::vec3(-UnboundedSize), 1.0f);
+        bounds->max = glm::vec4(glm::vec3(UnboundedSize), 1.0f);
+    }
+
+    // instance count is filled by compute shader
+    auto* command = reinterpret_cast<VkDrawIndexedIndirectCommand*>(
+            _indirectBuffer.mappedData + _indirectBuffer.regionSize * imageIndex) + batchIndex;
+    command->indexCount = indexCount;
+    command->instanceCount = 0;
+    command->firstIndex = firstIndex;
+    command->vertexOffset = vertexOffset;
+    command->firstInstance = _vulkanInstance->getTransformBuffer()->getCulledInstanceOffset() + firstInstance;
+}
+
+void VulkanInstanceCulling::setInstanceBatch(uint32_t instanceIndex, uint32_t batchIndex)
+{
+    auto imageIndex = _vulkanInstance->getCurrentImageIndex();
+    auto* instanceBatches = reinterpret_cast<uint32_t*>(_instanceBatchBuffer.mappedData + _instanceBatchBuffer.regionSize * imageIndex);
+    instanceBatches[instanceIndex] = batchIndex;
+}
+
+void VulkanInstanceCulling::validate()
+{
+    auto imageIndex = _vulkanInstance->getCurrentImageIndex();
+    auto batchCount = _batchCount[imageIndex];
+    if (batchCount == 0)
+        return;
+
+    auto* transformBuffer = _vulkanInstance->getTransformBuffer();
+    const auto* transforms = transformBuffer->getMappedData(imageIndex);
+    const auto* bounds = reinterpret_cast<BatchBounds*>(_boundsBuffer.mappedData + _boundsBuffer.regionSize * imageIndex);
+    const auto* instanceBatches = reinterpret_cast<uint32_t*>(_instanceBatchBuffer.mappedData + _instanceBatchBuffer.regionSize * imageIndex);
+    const auto* commands = reinterpret_cast<VkDrawIndexedIndirectCommand*>(
+            _indirectBuffer.mappedData + _indirectBuffer.regionSize * imageIndex);
+
+    // visible instances are compared by positions, as compute shader writes them in any order
+    Frustum frustum(_viewProjection[imageIndex]);
+    std::vector<std::vector<glm::vec3>> expectedList(batchCount);
+    for (auto i = 0u; i < _instanceCount[imageIndex]; i++)
+    {
+        auto batchIndex = instanceBatches[i];
+        BoundingBox boundingBox { glm::vec3(bounds[batchIndex].min), glm::vec3(bounds[batchIndex].max) };
+        if (frustum.isVisible(transformBoundingBox(boundingBox, transforms[i])))
+            expectedList[batchIndex].emplace_back(transforms[i][3]);
+    }
+
+    uint32_t mismatchCount = 0;
+    for (auto batchIndex = 0u; batchIndex < batchCount; batchIndex++)
+    {
+        const auto& command = commands[batchIndex];
+        std::vector<glm::vec3> drawnList;
+        for (auto i = 0u; i < command.instanceCount; i++)
+            drawnList.emplace_back(transforms[command.firstInstance + i][3]);
+
+        auto& expected = expectedList[batchIndex];
+        std::sort(expected.begin(), expected.end(), lessPosition);
+        std::sort(drawnList.begin(), drawnList.end(), lessPosition);
+        if (drawnList != expected)
+        {
+            std::cout << "GPU culling mismatch in batch " << batchIndex << ": " << drawnList.size()
+                      << " instances drawn, " << expected.size() << " visible on CPU" << std::endl;
+            ++mismatchCount;
+        }
+    }
+
+    auto& frameStats = Engine::getInstance()->getCurrentFrameStats();
+    frameStats.gpuCullingMismatches += mismatchCount;
+    frameStats.gpuCullingValidatedBatches += batchCount;
+}
+
+void VulkanInstanceCulling::applyComputeCommands(VkCommandBuffer commandBuffer, const glm::mat4& viewProjection,
+                                                 uint32_t instanceCount, uint32_t batchCount)
+{
+    auto imageIndex = _vulkanInstance->getCurrentImageIndex();
+    instanceCount = std::min(instanceCount, _instanceCapacity);
+    _viewProjection[imageIndex] = viewProjection;
+    _instanceCount[imageIndex] = instanceCount;
+    _batchCount[imageIndex] = batchCount;
+    if (instanceCount == 0)
+        return;
+
+    CullingData cullingData {};
+    Frustum frustum(viewProjection);
+    std::copy(frustum.getPlanes(), frustum.getPlanes() + 6, cullingData.planes);
+    cullingData.instanceCount = instanceCount;
+
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, _pipeline);
+    vkCmdBindDescriptorSets(
+            commandBuffer,
+            VK_PIPELINE_BIND_POINT_COMPUTE,
+            _pipelineLayout,
+            0,
+            1,
+            &_descriptorSets[imageIndex], 0, nullptr);
+    vkCmdPushConstants(commandBuffer, _pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(CullingData), &cullingData);
+    vkCmdDispatch(commandBuffer, (instanceCount + WorkgroupSize - 1) / WorkgroupSize, 1, 1);
+
+    // on async compute queue they are made visible by semaphore, which graphics passes wait for
+    if (_vulkanInstance->isAsyncCompute())
+        return;
+
+    // culled transforms and draw commands are read by following passes
+    VkMemoryBarrier memoryBarrier {};
+    memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    memoryBarrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+    vkCmdPipelineBarrier(
+            commandBuffer,
+            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+            VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,
+            0,
+            1, &memoryBarrier,
+            0, nullptr,
+            0, nullptr);
+}
+
+VkBuffer VulkanInstanceCulling::getIndirectBuffer() const
+{
+    return _indirectBuffer.buffer;
+}
+
+VkDeviceSize VulkanInstanceCulling::getIndirectOffset(uint32_t imageIndex, uint32_t batchIndex) const
+{
+    return _indirectBuffer.regionSize * imageIndex + sizeof(VkDrawIndexedIndirectCommand) * batchIndex;
+}
+
+void VulkanInstanceCulling::createBuffers()
+{
+    auto swapchainSize = _vulkanInstance->getSwapchainSize();
+    auto alignment = std::max<VkDeviceSize>(_vulkanInstance->getGPUInfo().limits.minStorageBufferOffsetAlignment, 16);
+
+    auto createBuffer = [&](Buffer& buffer, VkDeviceSize size, VkBufferUsageFlags usage)
+    {
+        buffer.regionSize = alignSize(size, alignment);
+        _vulkanInstance->getVulkanUtils().createBuffer(
+                buffer.regionSize * swapchainSize,
+                usage,
+                VMA_MEMORY_USAGE_CPU_TO_GPU,
+                buffer.buffer,
+                buffer.allocation,
+                true);
+
+        void* data = nullptr;
+        if (vmaMapMemory(_vulkanInstance->getAllocator(), buffer.allocation, &data) != VK_SUCCESS)
+            throw VulkanException("Can't map instance culling buffer memory");
+        buffer.mappedData = reinterpret_cast<char*>(data);
+    };
+
+    createBuffer(_boundsBuffer, sizeof(BatchBounds) * _maxBatchCount, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+    createBuffer(_instanceBatchBuffer, sizeof(uint32_t) * _instanceCapacity, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+    createBuffer(_indirectBuffer, sizeof(VkDrawIndexedIndirectCommand) * _maxBatchCount,
+                 VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT);
+}
+
+void VulkanInstanceCulling::deleteBuffers()
+{
+    for (auto* buffer : { &_boundsBuffer, &_instanceBatchBuffer, &_indirectBuffer })
+    {
+        vmaUnmapMemory(_vulkanInstance->getAllocator(), buffer->allocation);
+        vmaDestroyBuffer(_vulkanInstance->getAllocator(), buffer->buffer, buffer->allocation);
+    }
+}
+
+void VulkanInstanceCulling::createDescriptorSets()
+{
+    // transforms, batch bounds, instance batches, draw commands
+    const uint32_t bindingCount = 4;
+    VkDescriptorSetLayoutBinding layoutBindings[bindingCount] {};
+    for (auto i = 0u; i < bindingCount; i++)
+    {
+        layoutBindings[i].binding = i;
+        layoutBindings[i].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        layoutBindings[i].descriptorCount = 1;
+        layoutBindings[i].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+
+    VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo {};
+    descriptorSetLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    descriptorSetLayoutCreateInfo.bindingCount = bindingCount;
+    descriptorSetLayoutCreateInfo.pBindings = layoutBindings;
+
+    if (vkCreateDescriptorSetLayout(_device, &descriptorSetLayoutCreateInfo, nullptr, &_descriptorSetLayout) != VK_SUCCESS)
+    {
+        throw VulkanException("Can't create Vulkan instance culling descriptor set layout");
+    }
+
+    auto swapchainSize = _vulkanInstance->getSwapchainSize();
+
+    VkDescriptorPoolSize poolSize {};
+    poolSize.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    poolSize.descriptorCount = bindingCount * swapchainSize;
+
+    VkDescriptorPoolCreateInfo poolInfo {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    poolInfo.maxSets = swapchainSize;
+
+    auto result = vkCreateDescriptorPool(_device, &poolInfo, nullptr, &_descriptorPool);
+    if (result != VK_SUCCESS)
+    {
+        throw VulkanException("Can't create Vulkan instance culling descriptor pool", result);
+    }
+
+    std::vector<VkDescriptorSetLayout> layouts(swapchainSize, _descriptorSetLayout);
+    VkDescriptorSetAllocateInfo allocInfo {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = _descriptorPool;
+    allocInfo.descriptorSetCount = swapchainSize;
+    allocInfo.pSetLayouts = layouts.data();
+
+    _descriptorSets.resize(swapchainSize);
+    if (vkAllocateDescriptorSets(_device, &allocInfo, _descriptorSets.data()) != VK_SUCCESS)
+    {
+        throw VulkanException("Can't allocate Vulkan instance culling descriptor sets");
+    }
+
+    auto* transformBuffer = _vulkanInstance->getTransformBuffer();
+    for (auto i = 0u; i < swapchainSize; i++)
+    {
+        VkDescriptorBufferInfo bufferInfos[bindingCount] {};
+        bufferInfos[0].buffer = transformBuffer->getBuffer();
+        bufferInfos[0].offset = transformBuffer->getRegionOffset(i);
+        bufferInfos[0].range = transformBuffer->getRegionSize();
+        auto bufferIndex = 1u;
+        for (auto* buffer : { &_boundsBuffer, &_instanceBatchBuffer, &_indirectBuffer })
+        {
+            bufferInfos[bufferIndex].buffer = buffer->buffer;
+            bufferInfos[bufferIndex].offset = buffer->regionSize * i;
+            bufferInfos[bufferIndex].range = buffer->regionSize;
+            ++bufferIndex;
+        }
+
+        VkWriteDescriptorSet descriptorWrites[bindingCount] {};
+        for (auto binding = 0u; binding < bindingCount; binding++)
+        {
+            descriptorWrites[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            descriptorWrites[binding].dstSet = _descriptorSets[i];
+            descriptorWrites[binding].dstBinding = binding;
+            descriptorWrites[binding].dstArrayElement = 0;
+            descriptorWrites[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            descriptorWrites[binding].descriptorCount = 1;
+            descriptorWrites[binding].pBufferInfo = &bufferInfos[binding];
+        }
+
+        vkUpdateDescriptorSets(_device, bindingCount, descriptorWrites, 0, nullptr);
+    }
+}
+
+void VulkanInstanceCulling::deleteDescriptorSets()
+{
+    vkDestroyDescriptorPool(_device, _descriptorPool, nullptr);
+    vkDestroyDescriptorSetLayout(_device, _descriptorSetLayout, nullptr);
+}
+
+void VulkanInstanceCulling::createPipeline()
+{
+    VkPushConstantRange pushConstantRange {};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(CullingData);
+
+    VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo {};
+    pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutCreateInfo.setLayoutCount = 1;
+    pipelineLayoutCreateInfo.pSetLayouts = &_descriptorSetLayout;
+    pipelineLayoutCreateInfo.pushConstantRangeCount = 1;
+    pipelineLayoutCreateInfo.pPushConstantRanges = &pushConstantRange;
+
+    if (vkCreatePipelineLayout(_device, &pipelineLayoutCreateInfo, nullptr, &_pipelineLayout) != VK_SUCCESS)
+    {
+        throw VulkanException("Can't create Vulkan instance culling pipeline layout");
+    }
+
+    VkComputePipelineCreateInfo pipelineCreateInfo {};
+    pipelineCreateInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipelineCreateInfo.stage = _computeShader->createShaderStage();
+    pipelineCreateInfo.layout = _pipelineLayout;
+    pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE;
+    pipelineCreateInfo.basePipelineIndex = -1;
+
+    auto result = vkCreateComputePipelines(_device, VK_NULL_HANDLE, 1, &pipelineCreateInfo, nullptr, &_pipeline);
+    _computeShader->freeShaderModule();
+    if (result != VK_SUCCESS)
+    {
+        throw VulkanException("Can't create Vulkan instance culling pipeline", result);
+    }
+}
+
+void VulkanInstanceCulling::deletePipeline()
+{
+    vkDestroyPipeline(_device, _pipeline, nullptr);
+    vkDestroyPipelineLayout(_device, _pipelineLayout, nullptr);
+}
+
+} // namespace SVE
@@ -0,0 +1,96 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include "VulkanHeaders.h"
+#include "MeshDefs.h"
+#include "Frustum.h"
+#include "Engine.h"
+#include <vulkan/vk_mem_alloc.h>
+#include <vector>
+
+namespace SVE
+{
+class VulkanInstance;
+class VulkanShaderInfo;
+
+// GPU frustum culling of instance batches.
+// Compute shader tests every instance transform against main camera frustum, copies visible ones
+// to the culled range of transform buffer and counts them in indirect draw commands (one per batch).
+// Commands of adjacent batches with the same material and geometry block are drawn by one multi draw call.
+class VulkanInstanceCulling
+{
+public:
+    VulkanInstanceCulling(VulkanInstance* vulkanInstance, VulkanShaderInfo* computeShader, uint32_t maxBatchCount);
+    ~VulkanInstanceCulling();
+
+    // Passes which are culled with main camera frustum on CPU, their instanced draws are indirect
+    static bool isCulledPass(CommandsType passType);
+
+    uint32_t getMaxBatchCount() const;
+    // firstIndex and vertexOffset are relative to geometry block, so adjacent batches from one block
+    // can be drawn with single multi draw call
+    void setBatch(uint32_t batchIndex, uint32_t firstInstance, uint32_t indexCount, uint32_t firstIndex,
+                  int32_t vertexOffset, const BoundingBox* boundingBox);
+    void setInstanceBatch(uint32_t instanceIndex, uint32_t batchIndex);
+
+    // Compares results of previous use of current image region with CPU culling, prints mismatches
+    void validate();
+    void applyComputeCommands(VkCommandBuffer commandBuffer, const glm::mat4& viewProjection,
+                              uint32_t instanceCount, uint32_t batchCount);
+
+    VkBuffer getIndirectBuffer() const;
+    VkDeviceSize getIndirectOffset(uint32_t imageIndex, uint32_t batchIndex) const;
+
+private:
+    void createBuffers();
+    void deleteBuffers();
+    void createDescriptorSets();
+    void deleteDescriptorSets();
+    void createPipeline();
+    void deletePipeline();
+
+private:
+    struct BatchBounds
+    {
+        glm::vec4 min;
+        glm::vec4 max;
+    };
+
+    struct CullingData
+    {
+        glm::vec4 planes[6];
+        uint32_t instanceCount;
+    };
+
+    struct Buffer
+    {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VmaAllocation allocation = VK_NULL_HANDLE;
+        char* mappedData = nullptr;
+        VkDeviceSize regionSize = 0;
+    };
+
+    VulkanInstance* _vulkanInstance;
+    VkDevice _device;
+    VulkanShaderInfo* _computeShader;
+    uint32_t _maxBatchCount;
+    uint32_t _instanceCapacity;
+
+    Buffer _boundsBuffer;
+    Buffer _instanceBatchBuffer;
+    Buffer _indirectBuffer;
+
+    VkDescriptorSetLayout _descriptorSetLayout = VK_NULL_HANDLE;
+    VkDescriptorPool _descriptorPool = VK_NULL_HANDLE;
+    std::vector<VkDescriptorSet> _descriptorSets;
+    VkPipelineLayout _pipelineLayout = VK_NULL_HANDLE;
+    VkPipeline _pipeline = VK_NULL_HANDLE;
+
+    // culling input of last dispatch per image, used for validation
+    std::vector<glm::mat4> _viewProjection;
+    std::vector<uint32_t> _instanceCount;
+    std::vector<uint32_t> _batchCount;
+};
+
+} // namespace SVE
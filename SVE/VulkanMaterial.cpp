@@ -8,6 +8,11 @@
 #include "VulkanDirectShadowMap.h"
 #include "VulkanSamplerHolder.h"
 #include "VulkanPassInfo.h"
+#include "VulkanPassUniforms.h"
+#include "VulkanDescriptorPoolSet.h"
+#include "VulkanTransformBuffer.h"
+#include "VulkanTextureTable.h"
+#include "VulkanUploadManager.h"
 #include "ShaderManager.h"
 #include "ResourceManager.h"
 #include "PostEffectManager.h"
@@ -20,6 +25,8 @@
 #include "VulkanWater.h"
 #include "Entity.h"
 #include "Engine.h"
+#include "FrameStats.h"
+#include "Utils.h"
 
 #include <fstream>
 #include <algorithm>
@@ -70,6 +77,7 @@ SVE::VulkanMaterial::VulkanMaterial(MaterialSettings materialSettings)
     , _device(_vulkanInstance->getLogicalDevice())
     , _allocator(_vulkanInstance->getAllocator())
     , _vulkanUtils(_vulkanInstance->getVulkanUtils())
+    , _uniformArena(_vulkanInstance->getUniformArena())
     , _hasExternals(false)
 {
     const auto& shaderManager = Engine::getInstance()->getShaderManager();
@@ -79,9 +87,27 @@ SVE::VulkanMaterial::VulkanMaterial(MaterialSettings materialSettings)
         _materialSettings.useMRT = true;
     }
 
+    // bindless shaders are replaced with their fallbacks if texture table isn't supported
+    auto* textureTable = _vulkanInstance->getTextureTable();
+    auto getShaderInfo = [&](const std::string& shaderName)
+    {
+        auto* shaderInfo = shaderManager->getShader(shaderName)->getVulkanShaderInfo();
+        const auto& shaderSettings = shaderInfo->getShaderSettings();
+        if (!shaderSettings.useBindlessTextures)
+            return shaderInfo;
+        if (textureTable)
+        {
+            _useBindlessTextures = true;
+            return shaderInfo;
+        }
+        if (shaderSettings.bindlessFallback.empty())
+            throw VulkanException("Shader " + shaderName + " needs bindless textures, but they are not supported");
+        return shaderManager->getShader(shaderSettings.bindlessFallback)->getVulkanShaderInfo();
+    };
+
     if (!_materialSettings.vertexShaderName.empty())
     {
-        _vertexShader = shaderManager->getShader(_materialSettings.vertexShaderName)->getVulkanShaderInfo();
+        _vertexShader = getShaderInfo(_materialSettings.vertexShaderName);
         _shaderList.push_back(_vertexShader);
     } else {
         throw VulkanException("Vertex shader is mandatory");
@@ -89,15 +115,18 @@ SVE::VulkanMaterial::VulkanMaterial(MaterialSettings materialSettings)
 
     if (!_materialSettings.geometryShaderName.empty())
     {
-        _geometryShader = shaderManager->getShader(_materialSettings.geometryShaderName)->getVulkanShaderInfo();
+        _geometryShader = getShaderInfo(_materialSettings.geometryShaderName);
         _shaderList.push_back(_geometryShader);
     }
     if (!_materialSettings.fragmentShaderName.empty())
     {
-        _fragmentShader = shaderManager->getShader(_materialSettings.fragmentShaderName)->getVulkanShaderInfo();
+        _fragmentShader = getShaderInfo(_materialSettings.fragmentShaderName);
         _shaderList.push_back(_fragmentShader);
     }
 
+    if (_useBindlessTextures)
+        _sharedPipeline = textureTable->acquirePipeline(getSharedPipelineKey());
+
     createPipelineLayout();
     createPipeline();
 
@@ -107,20 +136,26 @@ SVE::VulkanMaterial::VulkanMaterial(MaterialSettings materialSettings)
         createTextureImages();
     createTextureImageView();
     createTextureSampler();
+    if (_useBindlessTextures)
+        createTableTextures();
 
-    createUniformBuffers();
-    createStorageBuffers();
-    createDescriptorPool();
-    createDescriptorSets();
+    createUniformLayout();
+    createInstance();
 }
 
 VulkanMaterial::~VulkanMaterial()
 {
-    deleteDescriptorSets();
-    deleteDescriptorPool();
-    deleteUniformBuffers();
-    deleteStorageBuffers();
+    for (auto i = 0u; i < _instanceData.size(); i++)
+    {
+        deleteInstance(i);
+    }
+    for (auto& blockData : _blockDescriptorData)
+    {
+        deleteDescriptorSets(blockData);
+    }
 
+    if (_useBindlessTextures)
+        deleteTableTextures();
     deleteTextureSampler();
     deleteTextureImageView();
     deleteTextureImages();
@@ -142,20 +177,57 @@ VkPipelineLayout VulkanMaterial::getPipelineLayout() const
 
 void VulkanMaterial::applyDrawingCommands(uint32_t bufferIndex, uint32_t imageIndex, uint32_t materialIndex)
 {
-    if (_materialSettings.useInstancing && isInstancesRendered() && !isMainInstance(materialIndex))
-        return;
-
     auto commandBuffer = _vulkanInstance->getCommandBuffer(bufferIndex);
-    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, _pipeline);
-
-    auto descriptorSets = getDescriptorSets(materialIndex, imageIndex);
-    vkCmdBindDescriptorSets(
-            commandBuffer,
-            VK_PIPELINE_BIND_POINT_GRAPHICS,
-            _pipelineLayout,
-            0,
-            descriptorSets.size(),
-            descriptorSets.data(), 0, nullptr);
+    auto pipeline = _pipeline;
+    if (_subpassPipeline[0] != VK_NULL_HANDLE)
+    {
+        auto passType = Engine::getInstance()->getPassType();
+        if (passType == CommandsType::ScreenQuadPass)
+            pipeline = _subpassPipeline[0];
+        else if (passType == CommandsType::ScreenQuadLatePass)
+            pipeline = _subpassPipeline[1];
+    }
+    vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+
+    const auto& uniformSlot = _instanceData[materialIndex].uniformSlot;
+    const auto& blockData = _blockDescriptorData[uniformSlot.block];
+
+    // per-pass set 0 is bound by the pass, it stays bound as all pipeline layouts share it
+    for (auto i = 0u; i < _shaderList.size(); i++)
+    {
+        if (blockData.descriptorSets[i].empty())
+            continue;
+
+        uint32_t dynamicOffset = 0;
+        uint32_t offsetCount = 0;
+        if (_stageUniformSize[i] > 0)
+        {
+            dynamicOffset = _uniformArena->getDynamicOffset(uniformSlot, imageIndex) + _stageUniformOffset[i];
+            offsetCount = 1;
+        }
+
+        vkCmdBindDescriptorSets(
+                commandBuffer,
+                VK_PIPELINE_BIND_POINT_GRAPHICS,
+                _pipelineLayout,
+                VulkanPassUniforms::FirstMaterialSet + i,
+                1,
+                &blockData.descriptorSets[i][imageIndex],
+                offsetCount,
+                &dynamicOffset);
+    }
+
+    if (_useBindlessTextures)
+    {
+        _vulkanInstance->getTextureTable()->bind(commandBuffer, _pipelineLayout);
+        vkCmdPushConstants(
+                commandBuffer,
+                _pipelineLayout,
+                VK_SHADER_STAGE_ALL_GRAPHICS,
+                0,
+                sizeof(_tableTextureIndices),
+                _tableTextureIndices);
+    }
 }
 
 void VulkanMaterial::resetDescriptorSets()
@@ -171,21 +243,6 @@ void VulkanMaterial::resetPipeline()
     createPipeline();
 }
 
-std::vector<VkDescriptorSet> VulkanMaterial::getDescriptorSets(uint32_t materialIndex, size_t index) const
-{
-    std::vector<VkDescriptorSet> sets;
-    sets.reserve(_shaderList.size());
-    if (!_instanceData[materialIndex].vertexDescriptorSets.empty())
-        sets.push_back(_instanceData[materialIndex].vertexDescriptorSets[index]);
-    if (!_instanceData[materialIndex].geometryDescriptorSets.empty())
-        sets.push_back(_instanceData[materialIndex].geometryDescriptorSets[index]);
-    if (!_instanceData[materialIndex].fragmentDescriptorSets.empty())
-        sets.push_back(_instanceData[materialIndex].fragmentDescriptorSets[index]);
-
-
-    return sets;
-}
-
 uint32_t VulkanMaterial::getInstanceForEntity(const Entity* entity, uint32_t index)
 {
     auto instanceIter = _entityInstanceMap.find(entity);
@@ -201,12 +258,9 @@ uint32_t VulkanMaterial::getInstanceForEntity(const Entity* entity, uint32_t ind
         _entityInstanceMap[entity] = std::vector<uint32_t>(1);
     }
 
-    createUniformBuffers();
-    //createStorageBuffers();
-    createDescriptorPool();
-    createDescriptorSets();
-    _entityInstanceMap[entity][index] = _instanceData.size() - 1;
-    return _instanceData.size() - 1;
+    auto instanceIndex = createInstance();
+    _entityInstanceMap[entity][index] = instanceIndex;
+    return instanceIndex;
 }
 
 void VulkanMaterial::deleteInstancesForEntity(const Entity* entity)
@@ -217,17 +271,42 @@ void VulkanMaterial::deleteInstancesForEntity(const Entity* entity)
         return;
     }
 
-    for (auto& index : instanceIter->second)
+    for (auto index : instanceIter->second)
     {
-        deleteDescriptorSets(_instanceData[index]);
-        deleteDescriptorPool(_instanceData[index]);
-        deleteUniformBuffers(_instanceData[index]);
-        _instanceData[index] = {};
+        deleteInstance(index);
+        _freeInstances.push_back(index);
     }
 
     _entityInstanceMap.erase(instanceIter);
 }
 
+void VulkanMaterial::releaseFreeInstances()
+{
+    // trailing deleted instances are removed, others stay in free list (instance 0 is material's own)
+    while (_instanceData.size() > 1 && !_instanceData.back().isUsed)
+        _instanceData.pop_back();
+    auto instanceCount = static_cast<uint32_t>(_instanceData.size());
+    _freeInstances.erase(
+            std::remove_if(_freeInstances.begin(), _freeInstances.end(),
+                           [instanceCount](uint32_t index) { return index >= instanceCount; }),
+            _freeInstances.end());
+    _instanceData.shrink_to_fit();
+    _freeInstances.shrink_to_fit();
+
+    for (auto& blockData : _blockDescriptorData)
+    {
+        if (blockData.instanceCount == 0)
+            deleteDescriptorSets(blockData);
+    }
+    while (!_blockDescriptorData.empty() && !_blockDescriptorData.back().isCreated)
+        _blockDescriptorData.pop_back();
+}
+
+uint32_t VulkanMaterial::getUsedInstanceCount() const
+{
+    return static_cast<uint32_t>(_instanceData.size() - _freeInstances.size());
+}
+
 bool VulkanMaterial::isSkeletal() const
 {
     if (!_vertexShader)
@@ -236,71 +315,87 @@ bool VulkanMaterial::isSkeletal() const
     return _vertexShader->getShaderSettings().maxBonesSize > 0;
 }
 
-void VulkanMaterial::setUniformData(uint32_t materialIndex, const UniformData& uniformData)
+bool VulkanMaterial::isInstanced() const
 {
-    auto swapchainSize = _vulkanInstance->getSwapchainSize();
-    auto imageIndex = _vulkanInstance->getCurrentImageIndex();
-    for (auto i = 0u; i < _shaderList.size(); i++)
+    const auto& bufferList = _vertexShader->getShaderSettings().bufferList;
+    return std::find(bufferList.begin(), bufferList.end(), BufferType::ModelMatrixList) != bufferList.end();
+}
+
+std::string VulkanMaterial::getInstancedVertexShaderName() const
+{
+    for (const auto* shaderInfo : _shaderList)
     {
-        size_t uniformSize = _shaderList[i]->getShaderUniformsSize();
-        if (uniformSize == 0)
-            continue;
-        const auto& shaderSettings = _shaderList[i]->getShaderSettings();
-        void* data = nullptr;
-        vmaMapMemory(_allocator, _instanceData[materialIndex].uniformBuffersMemory[swapchainSize * i + imageIndex], &data);
-        char* mappedUniformData = reinterpret_cast<char*>(data);
-        for (const auto& r : shaderSettings.uniformList)
+        for (const auto& uniformInfo : shaderInfo->getShaderSettings().uniformList)
         {
-            auto uniformBytes = getUniformDataByType(uniformData, r.uniformType);
-            memcpy(mappedUniformData, uniformBytes.data(), uniformBytes.size());
-            mappedUniformData += uniformBytes.size();
+            switch (uniformInfo.uniformType)
+            {
+                case UniformType::ModelMatrix:
+                    if (shaderInfo != _vertexShader)
+                        return {};
+                    break;
+                case UniformType::InverseModelMatrix:
+                case UniformType::ModelViewProjectionMatrix:
+                case UniformType::BoneMatrices:
+                case UniformType::CustomFloat:
+                case UniformType::CustomVec4:
+                case UniformType::CustomMat4:
+                case UniformType::Time:
+                    return {};
+                default:
+                    break;
+            }
         }
-        vmaUnmapMemory(_allocator, _instanceData[materialIndex].uniformBuffersMemory[swapchainSize * i + imageIndex]);
     }
 
-    for (const auto& b : _vertexShader->getShaderSettings().bufferList)
-    {
-        updateStorageDataByUniforms(uniformData, _storageData, b);
-    }
-
-    if (_storageUpdated || !_materialSettings.useInstancing)
-        _currentInstanceCount = 0;
-
-    ++_currentInstanceCount;
-    _storageUpdated = false;
-    _mainInstance = materialIndex;
-    _instancesRendered = false;
+    return _vertexShader->getShaderSettings().instancedVariant;
 }
 
-void VulkanMaterial::updateInstancedData()
+void VulkanMaterial::setUniformData(uint32_t materialIndex, const UniformData& uniformData, const EntityUniformData* entityData)
 {
-    auto imageIndex = _vulkanInstance->getCurrentImageIndex();
-
-    if (_storageBufferSize == 0 || _mainInstance == 0 || _storageUpdated)
-        return;
-
-    if (!_materialSettings.useInstancing)
-        return;
-
-    void* data = nullptr;
-    vmaMapMemory(_allocator, _storageBuffersMemory[imageIndex], &data);
-    char* mappedBufferData = reinterpret_cast<char*>(data);
-    for (const auto& b : _vertexShader->getShaderSettings().bufferList)
+    const auto& uniformSlot = _instanceData[materialIndex].uniformSlot;
+    if (uniformSlot.size > 0)
     {
-        auto storageBytes = getStorageDataByType(_storageData, b);
-        if (!storageBytes.empty())
+        // arena memory is persistently mapped, write to current image region directly
+        auto imageIndex = _vulkanInstance->getCurrentImageIndex();
+        char* instanceUniformData = _uniformArena->getMappedData(uniformSlot, imageIndex);
+        size_t bytesWritten = 0;
+        for (auto i = 0u; i < _shaderList.size(); i++)
         {
-            memcpy(mappedBufferData, storageBytes.data(), storageBytes.size());
-            mappedBufferData += storageBytes.size();
+            if (_stageUniformSize[i] == 0)
+                continue;
+            char* stageUniformData = instanceUniformData + _stageUniformOffset[i];
+            for (const auto& entry : _shaderList[i]->getUniformLayout())
+            {
+                bytesWritten += writeUniformData(
+                        uniformData, entityData, entry.uniformType, stageUniformData + entry.offset, entry.size);
+            }
         }
+        Engine::getInstance()->getCurrentFrameStats().uniformBytesWritten += bytesWritten;
     }
-    vmaUnmapMemory(_allocator, _storageBuffersMemory[imageIndex]);
-    _storageData = {};
-    _storageUpdated = true;
 }
 
 void VulkanMaterial::createPipeline()
 {
+    auto extent = _vulkanInstance->getExtent();
+    if (_sharedPipeline && _sharedPipeline->pipeline != VK_NULL_HANDLE)
+    {
+        // pipeline with old extent is recreated by first reset material, others take the new one
+        if (_sharedPipeline->extent.width == extent.width && _sharedPipeline->extent.height == extent.height)
+        {
+            _pipeline = _sharedPipeline->pipeline;
+            _subpassPipeline[0] = _sharedPipeline->subpassPipeline[0];
+            _subpassPipeline[1] = _sharedPipeline->subpassPipeline[1];
+            return;
+        }
+        vkDestroyPipeline(_device, _sharedPipeline->pipeline, nullptr);
+        _sharedPipeline->pipeline = VK_NULL_HANDLE;
+        for (auto& subpassPipeline : _sharedPipeline->subpassPipeline)
+        {
+            vkDestroyPipeline(_device, subpassPipeline, nullptr);
+            subpassPipeline = VK_NULL_HANDLE;
+        }
+    }
+
     std::vector<VkPipelineShaderStageCreateInfo> shaderStages;
     for (auto * shader : _shaderList)
     {
@@ -323,7 +418,6 @@ void VulkanMaterial::createPipeline()
     inputAssemblyCreateInfo.primitiveRestartEnable = VK_FALSE;
 
     // Viewport
-    auto extent = _vulkanInstance->getExtent();
     VkViewport viewport;
     viewport.x = 0.0f;
     viewport.y = 0.0f;
@@ -464,8 +558,9 @@ void VulkanMaterial::createPipeline()
     pipelineCreateInfo.pColorBlendState = &blendingCreateInfo;
     pipelineCreateInfo.pDynamicState = &dynamicStateCreateInfo;
     pipelineCreateInfo.layout = _pipelineLayout;
-    pipelineCreateInfo.renderPass = _vulkanInstance->getPassInfo()->getPassData(_materialSettings.passType).renderPass;
-    pipelineCreateInfo.subpass = 0;
+    const auto& passData = _vulkanInstance->getPassInfo()->getPassData(_materialSettings.passType);
+    pipelineCreateInfo.renderPass = passData.renderPass;
+    pipelineCreateInfo.subpass = passData.subpass;
     pipelineCreateInfo.basePipelineHandle = VK_NULL_HANDLE; // no deriving from other pipeline
     pipelineCreateInfo.basePipelineIndex = -1;
 
@@ -474,11 +569,33 @@ void VulkanMaterial::createPipeline()
         loadPipelineCache();
     }
 
-    auto result = vkCreateGraphicsPipelines(_device, _pipelineCache, 1, &pipelineCreateInfo, nullptr, &_pipeline);
+    // merged render pass isn't compatible with single subpass passes, so variants are created for its subpasses
+    std::vector<VkGraphicsPipelineCreateInfo> pipelineCreateInfoList { pipelineCreateInfo };
+    auto* screenQuad = _vulkanInstance->getScreenQuad();
+    if (_materialSettings.passType == CommandsType::MainPass && screenQuad && screenQuad->isMerged())
+    {
+        for (auto passType : { CommandsType::ScreenQuadPass, CommandsType::ScreenQuadLatePass })
+        {
+            const auto& subpassData = _vulkanInstance->getPassInfo()->getPassData(passType);
+            pipelineCreateInfo.renderPass = subpassData.renderPass;
+            pipelineCreateInfo.subpass = subpassData.subpass;
+            pipelineCreateInfoList.push_back(pipelineCreateInfo);
+        }
+    }
+
+    std::vector<VkPipeline> pipelineList(pipelineCreateInfoList.size());
+    auto result = vkCreateGraphicsPipelines(
+            _device, _pipelineCache, pipelineCreateInfoList.size(), pipelineCreateInfoList.data(), nullptr, pipelineList.data());
     if (result != VK_SUCCESS)
     {
         throw VulkanException("Can't create Vulkan Graphics Pipeline");
     }
+    _pipeline = pipelineList[0];
+    if (pipelineList.size() > 1)
+    {
+        _subpassPipeline[0] = pipelineList[1];
+        _subpassPipeline[1] = pipelineList[2];
+    }
 
     for (auto * shader : _shaderList)
     {
@@ -490,11 +607,46 @@ void VulkanMaterial::createPipeline()
         createAndStorePipelineCache();
     }
 
+    if (_sharedPipeline)
+    {
+        _sharedPipeline->pipeline = _pipeline;
+        _sharedPipeline->subpassPipeline[0] = _subpassPipeline[0];
+        _sharedPipeline->subpassPipeline[1] = _subpassPipeline[1];
+        _sharedPipeline->extent = extent;
+    }
 }
 
 void VulkanMaterial::deletePipeline()
 {
-    vkDestroyPipeline(_device, _pipeline, nullptr);
+    // shared pipeline is destroyed by texture table, when last material releases it
+    if (!_sharedPipeline)
+    {
+        vkDestroyPipeline(_device, _pipeline, nullptr);
+        for (auto subpassPipeline : _subpassPipeline)
+            vkDestroyPipeline(_device, subpassPipeline, nullptr);
+    }
+    _subpassPipeline[0] = _subpassPipeline[1] = VK_NULL_HANDLE;
+}
+
+std::string VulkanMaterial::getSharedPipelineKey() const
+{
+    std::string key;
+    for (auto* shader : _shaderList)
+        key += shader->getShaderSettings().name + ";";
+
+    auto addValue = [&key](int value) { key += std::to_string(value) + ";"; };
+    addValue(static_cast<int>(_materialSettings.passType));
+    addValue(static_cast<int>(_materialSettings.cullFace));
+    addValue(_materialSettings.useDepthBias);
+    addValue(_materialSettings.useDepthTest);
+    addValue(_materialSettings.useDepthWrite);
+    addValue(_materialSettings.useMultisampling);
+    addValue(_materialSettings.useAlphaBlending);
+    addValue(static_cast<int>(_materialSettings.srcBlendFactor));
+    addValue(static_cast<int>(_materialSettings.dstBlendFactor));
+    addValue(_materialSettings.useMRT);
+
+    return key;
 }
 
 void VulkanMaterial::createAndStorePipelineCache()
@@ -551,21 +703,43 @@ void VulkanMaterial::deletePipelineCache()
 
 void VulkanMaterial::createPipelineLayout()
 {
-    std::vector<VkDescriptorSetLayout> descriptorLayouts;
+    if (_sharedPipeline && _sharedPipeline->pipelineLayout != VK_NULL_HANDLE)
+    {
+        _pipelineLayout = _sharedPipeline->pipelineLayout;
+        return;
+    }
+
+    // set 0 is shared per-pass data, then one set per shader stage
+    auto* passUniforms = _vulkanInstance->getPassUniforms();
+    std::vector<VkDescriptorSetLayout> descriptorLayouts { passUniforms->getDescriptorSetLayout() };
 
     for (auto* shader : _shaderList)
     {
         auto descriptorLayout = shader->getDescriptorSetLayout();
-        if (descriptorLayout != VK_NULL_HANDLE)
-            descriptorLayouts.push_back(descriptorLayout);
+        descriptorLayouts.push_back(descriptorLayout != VK_NULL_HANDLE
+                                    ? descriptorLayout
+                                    : passUniforms->getEmptyDescriptorSetLayout());
+    }
+
+    // texture table set goes after all possible stage sets, all layouts share its push constant range
+    VkPushConstantRange pushConstantRange {};
+    auto* textureTable = _vulkanInstance->getTextureTable();
+    if (textureTable)
+    {
+        if (_useBindlessTextures)
+        {
+            descriptorLayouts.resize(VulkanTextureTable::TableSet, passUniforms->getEmptyDescriptorSetLayout());
+            descriptorLayouts.push_back(textureTable->getDescriptorSetLayout());
+        }
+        pushConstantRange = textureTable->getPushConstantRange();
     }
 
     VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo{};
     pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
     pipelineLayoutCreateInfo.setLayoutCount = descriptorLayouts.size();
     pipelineLayoutCreateInfo.pSetLayouts = descriptorLayouts.data();
-    pipelineLayoutCreateInfo.pushConstantRangeCount = 0;
-    pipelineLayoutCreateInfo.pPushConstantRanges = nullptr;
+    pipelineLayoutCreateInfo.pushConstantRangeCount = textureTable ? 1 : 0;
+    pipelineLayoutCreateInfo.pPushConstantRanges = textureTable ? &pushConstantRange : nullptr;
 
     if (vkCreatePipelineLayout(
             _device,
@@ -575,10 +749,19 @@ void VulkanMaterial::createPipelineLayout()
     {
         throw VulkanException("Can't create Vulkan pipeline layout");
     }
+
+    if (_sharedPipeline)
+        _sharedPipeline->pipelineLayout = _pipelineLayout;
 }
 
 void VulkanMaterial::deletePipelineLayout()
 {
+    if (_sharedPipeline)
+    {
+        _vulkanInstance->getTextureTable()->releasePipeline(getSharedPipelineKey());
+        _sharedPipeline = nullptr;
+        return;
+    }
     vkDestroyPipelineLayout(_device, _pipelineLayout, nullptr);
 }
 
@@ -600,6 +783,7 @@ void VulkanMaterial::createTextureImages()
         {
             _hasExternals = true;
             _texturesData[i].external = true;
+            _externalTextureMask |= 1u << toInt(_materialSettings.textures[i].textureType);
 
             // TODO: For more generic cases, texture type should be string (or custom with additional string attr)
             _texturesData[i].type = _materialSettings.textures[i].textureType;
@@ -624,24 +808,6 @@ void VulkanMaterial::createTextureImages()
             throw VulkanException("Can't load texture " + _materialSettings.textures[i].filename);
         }
 
-        // Create temporary buffer to hold pixel data
-        VkBuffer stagingBuffer;
-        VmaAllocation stagingBufferMemory;
-        _vulkanUtils.createBuffer(imageSize,
-                                  VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                                  VMA_MEMORY_USAGE_CPU_TO_GPU,
-                                  stagingBuffer,
-                                  stagingBufferMemory);
-
-        // Copy pixel data into temporary buffer
-        void* data;
-        vmaMapMemory(_allocator, stagingBufferMemory, &data);
-        memcpy(data, pixels, static_cast<size_t>(imageSize));
-        vmaUnmapMemory(_allocator, stagingBufferMemory);
-
-        // Free pixel data
-        stbi_image_free(pixels);
-
         // Create texture image which will be used in shaders
         _vulkanUtils.createImage(static_cast<uint32_t>(texWidth),
                                  static_cast<uint32_t>(texHeight),
@@ -655,23 +821,17 @@ void VulkanMaterial::createTextureImages()
                                  _textureImages[i],
                                  _textureImageMemoryList[i]);
 
-        // Transition layout of the image to be optimal as a transfer destination
-        _vulkanUtils.transitionImageLayout(
-                _textureImages[i],
-                VK_FORMAT_R8G8B8A8_UNORM,
-                {VK_IMAGE_LAYOUT_UNDEFINED, 0, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT},
-                {VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT},
-                _mipLevels[i]);
-        // Copy image data from buffer to image
-        _vulkanUtils.copyBufferToImage(stagingBuffer,
-                                       _textureImages[i],
-                                       static_cast<uint32_t>(texWidth),
-                                       static_cast<uint32_t>(texHeight));
-
-        _vulkanUtils.generateMipmaps(_textureImages[i], VK_FORMAT_R8G8B8A8_UNORM, texWidth, texHeight, _mipLevels[i]);
-
-        // Free temporary buffer
-        vmaDestroyBuffer(_allocator, stagingBuffer, stagingBufferMemory);
+        // Copy pixel data to image and generate mipmaps, image is ready for shaders after upload flush
+        _vulkanInstance->getUploadManager()->uploadImage(pixels,
+                                                         imageSize,
+                                                         _textureImages[i],
+                                                         VK_FORMAT_R8G8B8A8_UNORM,
+                                                         static_cast<uint32_t>(texWidth),
+                                                         static_cast<uint32_t>(texHeight),
+                                                         _mipLevels[i]);
+
+        // Free pixel data
+        stbi_image_free(pixels);
     }
 }
 
@@ -712,25 +872,10 @@ void VulkanMaterial::createCubemapTextureImages()
     //_mipLevels.push_back(static_cast<uint32_t>(std::floor(std::log2(std::max(texWidth, texHeight)))) + 1);
     _mipLevels.push_back(1);
 
-    // Create temporary buffer to hold pixel data
-    VkBuffer stagingBuffer;
-    VmaAllocation stagingBufferMemory;
-    _vulkanUtils.createBuffer(imageSize,
-                              VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                              VMA_MEMORY_USAGE_CPU_TO_GPU,
-                              stagingBuffer,
-                              stagingBufferMemory);
-
-    // Copy pixel data into temporary buffer
-    void* data;
-    vmaMapMemory(_allocator, stagingBufferMemory, &data);
-    char* mappedData = reinterpret_cast<char*>(data);
+    // Faces are copied to consecutive image layers
+    std::vector<stbi_uc> facesData(imageSize);
     for (auto i = 0u; i < pixelsData.size(); i++)
-    {
-        memcpy(mappedData, pixelsData[i], singleImageSize);
-        mappedData += singleImageSize;
-    }
-    vmaUnmapMemory(_allocator, stagingBufferMemory);
+        memcpy(facesData.data() + i * singleImageSize, pixelsData[i], singleImageSize);
 
     // Free pixel data
     for (auto i = 0u; i < imageCount; i++)
@@ -751,61 +896,14 @@ void VulkanMaterial::createCubemapTextureImages()
                              VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT,
                              6);
 
-    // Transition layout of the image to be optimal as a transfer destination
-    _vulkanUtils.transitionImageLayout(
-            _textureImages[0],
-            VK_FORMAT_R8G8B8A8_UNORM,
-            {VK_IMAGE_LAYOUT_UNDEFINED, 0, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT},
-            {VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT},
-            _mipLevels[0],
-            VK_IMAGE_ASPECT_COLOR_BIT,
-            6);
-
-
-    // Copy image data from buffer to image
-    auto commandBuffer = _vulkanUtils.beginRecordingCommands();
-    std::vector<VkBufferImageCopy> bufferCopyRegions;
-    uint32_t offset = 0;
-    for (auto i = 0u; i < 6; i++)
-    {
-        VkBufferImageCopy bufferCopyRegion = {};
-        bufferCopyRegion.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-        bufferCopyRegion.imageSubresource.mipLevel = 0;
-        bufferCopyRegion.imageSubresource.baseArrayLayer = i;
-        bufferCopyRegion.imageSubresource.layerCount = 1;
-        bufferCopyRegion.imageExtent.width = static_cast<uint32_t>(texWidth);
-        bufferCopyRegion.imageExtent.height = static_cast<uint32_t>(texHeight);
-        bufferCopyRegion.imageExtent.depth = 1;
-        bufferCopyRegion.bufferOffset = offset;
-
-        bufferCopyRegions.push_back(bufferCopyRegion);
-
-        // Increase offset into staging buffer for next level / face
-        offset += texWidth * texHeight * 4;
-    }
-
-    vkCmdCopyBufferToImage(commandBuffer,
-                           stagingBuffer,
-                           _textureImages[0],
-                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                           bufferCopyRegions.size(),
-                           bufferCopyRegions.data());
-
-    _vulkanUtils.endRecordingAndSubmitCommands(commandBuffer);
-
-    _vulkanUtils.transitionImageLayout(
-         _textureImages[0],
-         VK_FORMAT_R8G8B8A8_UNORM,
-         {VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_ACCESS_TRANSFER_WRITE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT},
-         {VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_ACCESS_SHADER_READ_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT},
-         _mipLevels[0],
-         VK_IMAGE_ASPECT_COLOR_BIT,
-         6);
-
-    //_vulkanUtils.generateMipmaps(_textureImages[i], VK_FORMAT_R8G8B8A8_UNORM, texWidth, texHeight, _mipLevels[i]);
-
-    // Free temporary buffer
-    vmaDestroyBuffer(_allocator, stagingBuffer, stagingBufferMemory);
+    _vulkanInstance->getUploadManager()->uploadImage(facesData.data(),
+                                                     imageSize,
+                                                     _textureImages[0],
+                                                     VK_FORMAT_R8G8B8A8_UNORM,
+                                                     static_cast<uint32_t>(texWidth),
+                                                     static_cast<uint32_t>(texHeight),
+                                                     _mipLevels[0],
+                                                     6);
 
     _textureNames[0] = _materialSettings.textures[0].samplerName;
     _texturesData[0].external = false;
@@ -898,340 +996,184 @@ void VulkanMaterial::deleteTextureSampler()
     }
 }
 
-void VulkanMaterial::createUniformBuffers()
+void VulkanMaterial::createTableTextures()
 {
-    auto swapchainSize = _vulkanInstance->getSwapchainSize();
-    size_t memoryBufferOffset = 0;
-    PerInstanceData data {};
-
-    auto createUniformBuffers = [this, &data, &swapchainSize, &memoryBufferOffset](std::vector<VkBuffer>& buffers,
-                                                                                   const VulkanShaderInfo* shaderInfo)
+    // indices are pushed in sampler names order of all bindless stages
+    auto* textureTable = _vulkanInstance->getTextureTable();
+    for (auto* shader : _shaderList)
     {
-        if (!shaderInfo)
-            return;
+        const auto& shaderSettings = shader->getShaderSettings();
+        if (!shaderSettings.useBindlessTextures)
+            continue;
 
-        VkDeviceSize bufferSize = shaderInfo->getShaderUniformsSize();
-        data.uniformBuffersMemory.resize(data.uniformBuffersMemory.size() + swapchainSize);
-        if (bufferSize == 0)
+        for (const auto& samplerName : shaderSettings.samplerNamesList)
         {
-            memoryBufferOffset += swapchainSize;
-            return;
+            auto iter = std::find(_textureNames.cbegin(), _textureNames.cend(), samplerName);
+            if (iter == _textureNames.end())
+                throw VulkanException("Incorrect sampler name in material configuration");
+            auto index = std::distance(_textureNames.cbegin(), iter);
+            if (_texturesData[index].external)
+                throw VulkanException("External textures can't be used with bindless shader " + shaderSettings.name);
+            if (_tableTextureCount == VulkanTextureTable::MaxMaterialTextures)
+                throw VulkanException("Too many textures in bindless material " + _materialSettings.name);
+
+            _tableTextureIndices[_tableTextureCount++] = textureTable->addTexture(
+                    _textureImageViews[index], _textureSamplers[index]);
         }
-
-        buffers.resize(swapchainSize);
-
-        for (auto i = 0u; i < swapchainSize; i++)
-        {
-            _vulkanUtils.createBuffer(
-                    bufferSize,
-                    VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-                    VMA_MEMORY_USAGE_CPU_TO_GPU,
-                    buffers[i],
-                    data.uniformBuffersMemory[memoryBufferOffset + i]);
-        }
-        memoryBufferOffset += swapchainSize;
-    };
-
-    createUniformBuffers(data.vertexUniformBuffers, _vertexShader);
-    createUniformBuffers(data.geometryUniformBuffer, _geometryShader);
-    createUniformBuffers(data.fragmentUniformBuffer, _fragmentShader);
-
-    _instanceData.push_back(data);
+    }
 }
 
-void VulkanMaterial::deleteUniformBuffers()
+void VulkanMaterial::deleteTableTextures()
 {
-    for (auto& instance : _instanceData)
-    {
-        deleteUniformBuffers(instance);
-    }
+    auto* textureTable = _vulkanInstance->getTextureTable();
+    for (auto i = 0u; i < _tableTextureCount; i++)
+        textureTable->removeTexture(_tableTextureIndices[i]);
+    _tableTextureCount = 0;
 }
 
-void VulkanMaterial::deleteUniformBuffers(PerInstanceData& instance)
+void VulkanMaterial::createUniformLayout()
 {
-    auto memIndex = 0;
-    for (auto buffer : instance.vertexUniformBuffers)
-    {
-        vmaDestroyBuffer(_allocator, buffer, instance.uniformBuffersMemory[memIndex++]);
-    }
-    for (auto buffer : instance.geometryUniformBuffer)
-    {
-        vmaDestroyBuffer(_allocator, buffer, instance.uniformBuffersMemory[memIndex++]);
-    }
-    for (auto buffer : instance.fragmentUniformBuffer)
+    // all stages uniforms of an instance are placed in one arena slot
+    auto alignment = _uniformArena->getAlignment();
+    for (auto i = 0u; i < _shaderList.size(); i++)
     {
-        vmaDestroyBuffer(_allocator, buffer, instance.uniformBuffersMemory[memIndex++]);
+        _stageUniformSize[i] = static_cast<uint32_t>(_shaderList[i]->getShaderUniformsSize());
+        _stageUniformOffset[i] = static_cast<uint32_t>(_instanceUniformSize);
+        _instanceUniformSize += (_stageUniformSize[i] + alignment - 1) / alignment * alignment;
     }
 }
 
-void VulkanMaterial::createStorageBuffers()
+uint32_t VulkanMaterial::createInstance()
 {
-    if (!_storageBuffersMemory.empty())
-        return;
-
-    auto swapchainSize = _vulkanInstance->getSwapchainSize();
-
-    _storageBufferSize = _vertexShader->getShaderStorageBuffersSize();
-    if (_storageBufferSize == 0)
-        _storageBufferSize = _materialSettings.instanceMaxCount;
-
-    if (_storageBufferSize == 0)
-        return;
-    _storageBuffersMemory.resize(swapchainSize);
-    _vertexStorageBuffers.resize(swapchainSize);
+    PerInstanceData data {};
+    data.isUsed = true;
+    if (_instanceUniformSize > 0)
+        data.uniformSlot = _uniformArena->allocate(_instanceUniformSize);
+    createDescriptorSets(data.uniformSlot.block);
+    ++_blockDescriptorData[data.uniformSlot.block].instanceCount;
 
-    for (auto i = 0u; i < swapchainSize; i++)
+    if (!_freeInstances.empty())
     {
-        _vulkanUtils.createBuffer(
-                _storageBufferSize,
-                VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
-                VMA_MEMORY_USAGE_CPU_TO_GPU,
-                _vertexStorageBuffers[i],
-                _storageBuffersMemory[i]);
+        auto instanceIndex = _freeInstances.back();
+        _freeInstances.pop_back();
+        _instanceData[instanceIndex] = data;
+        return instanceIndex;
     }
-}
 
-void VulkanMaterial::deleteStorageBuffers()
-{
-    for (auto i = 0; i < _vertexStorageBuffers.size(); ++i)
-    {
-        vmaDestroyBuffer(_allocator, _vertexStorageBuffers[i], _storageBuffersMemory[i]);
-    }
+    _instanceData.push_back(data);
+    return static_cast<uint32_t>(_instanceData.size() - 1);
 }
 
-
-void VulkanMaterial::createDescriptorPool()
+void VulkanMaterial::deleteInstance(uint32_t instanceIndex)
 {
-    auto swapchainSize = _vulkanInstance->getSwapchainSize();
-
-    auto& instance = _instanceData.back();
-
-    std::vector<VkDescriptorPoolSize> poolSizes(3);
-    poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    poolSizes[0].descriptorCount = instance.vertexUniformBuffers.size() + instance.fragmentUniformBuffer.size() + instance.geometryUniformBuffer.size();
-    poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    poolSizes[1].descriptorCount = swapchainSize * _materialSettings.textures.size() * 2;
-    poolSizes[2].type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-    poolSizes[2].descriptorCount = _vertexStorageBuffers.size();
-    for (auto& poolSize : poolSizes)
-        if (poolSize.descriptorCount == 0)
-            poolSize.descriptorCount = 1;
-
-    VkDescriptorPoolCreateInfo poolInfo = {};
-    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
-    poolInfo.poolSizeCount = poolSizes.size();
-    poolInfo.pPoolSizes = poolSizes.data();
-    poolInfo.maxSets = _shaderList.size() * swapchainSize;
-
-    auto result = vkCreateDescriptorPool(_device, &poolInfo, nullptr, &instance.descriptorPool);
-    if (result != VK_SUCCESS)
-    {
-        throw SVE::VulkanException("Can't create Vulkan descriptor pool", result);
-    }
-}
+    auto& instance = _instanceData[instanceIndex];
+    if (!instance.isUsed)
+        return;
 
-void VulkanMaterial::deleteDescriptorPool()
-{
-    for (auto &instance : _instanceData)
-    {
-        deleteDescriptorPool(instance);
-    }
+    --_blockDescriptorData[instance.uniformSlot.block].instanceCount;
+    _uniformArena->free(instance.uniformSlot);
+    instance = {};
 }
 
-void VulkanMaterial::deleteDescriptorPool(PerInstanceData& instance)
+void VulkanMaterial::createDescriptorSets(uint32_t block)
 {
-    vkDestroyDescriptorPool(_device, instance.descriptorPool, nullptr);
-}
+    if (block < _blockDescriptorData.size() && _blockDescriptorData[block].isCreated)
+        return;
+    if (block >= _blockDescriptorData.size())
+        _blockDescriptorData.resize(block + 1);
 
-void VulkanMaterial::createDescriptorSets()
-{
     auto swapchainSize = _vulkanInstance->getSwapchainSize();
-    auto makeDescriptorSet = [this, swapchainSize](const std::vector<VkBuffer>& shaderBuffers,
-                                                   const std::vector<VkBuffer>* storageBuffers,
-                                                   const VulkanShaderInfo* shaderInfo,
-                                                   std::vector<VkDescriptorSet>& descriptorSets)
-    {
-        if (!shaderInfo)
-            return;
-        if (shaderInfo->getShaderSettings().samplerNamesList.empty() && shaderBuffers.empty())
-            return;
+    auto& blockData = _blockDescriptorData[block];
 
-        std::vector<VkDescriptorSetLayout> layouts(swapchainSize, shaderInfo->getDescriptorSetLayout());
+    // sets of all stages are allocated at once from shared pools
+    std::vector<VkDescriptorSetLayout> layouts;
+    for (auto stage = 0u; stage < _shaderList.size(); stage++)
+    {
+        if (!hasStageDescriptors(stage))
+            continue;
+        layouts.insert(layouts.end(), swapchainSize, _shaderList[stage]->getDescriptorSetLayout());
+        VulkanDescriptorPoolSet::addDescriptorCounts(blockData.descriptorCounts,
+                                                     _shaderList[stage]->getDescriptorCounts(), swapchainSize);
+    }
+    blockData.descriptorPool = _vulkanInstance->getDescriptorPoolSet()->allocate(
+            layouts, blockData.descriptorCounts, blockData.allDescriptorSets);
+    blockData.isCreated = true;
 
-        VkDescriptorSetAllocateInfo allocInfo {};
-        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-        allocInfo.descriptorPool = _instanceData.back().descriptorPool;
-        allocInfo.descriptorSetCount = swapchainSize;
-        allocInfo.pSetLayouts = layouts.data();
+    auto uniformBuffer = _uniformArena->getBuffer(block);
+    auto setIter = blockData.allDescriptorSets.begin();
+    for (auto stage = 0u; stage < _shaderList.size(); stage++)
+    {
+        if (!hasStageDescriptors(stage))
+            continue;
 
-        descriptorSets.resize(swapchainSize);
-        auto result = vkAllocateDescriptorSets(_device, &allocInfo, descriptorSets.data());
-        if (result != VK_SUCCESS)
-        {
-            throw VulkanException("Can't allocate Vulkan descriptor sets");
-        }
+        const auto* shaderInfo = _shaderList[stage];
 
-        auto uniformSize = shaderInfo->getShaderUniformsSize();
+        auto& descriptorSets = blockData.descriptorSets[stage];
+        descriptorSets.assign(setIter, setIter + swapchainSize);
+        setIter += swapchainSize;
 
         for (auto i = 0u; i < swapchainSize; i++)
         {
-            VkDescriptorBufferInfo bufferInfo {};
-            VkDescriptorBufferInfo storageBufferInfo {};
-            if (!shaderBuffers.empty())
-            {
-                bufferInfo.buffer = shaderBuffers[i];
-                bufferInfo.offset = 0;
-                bufferInfo.range = uniformSize;
-            }
-
-            std::vector<VkDescriptorImageInfo> imageInfoList;
-            for (const auto& samplerName : shaderInfo->getShaderSettings().samplerNamesList)
-            {
-                auto iter = std::find(_textureNames.cbegin(),
-                                      _textureNames.cend(),
-                                      samplerName);
-                if (iter == _textureNames.end())
-                {
-                    throw VulkanException("Incorrect sampler name in material configuration");
-                }
-                auto index = std::distance(_textureNames.cbegin(), iter);
-
-                if (!_texturesData[index].external)
-                {
-                    VkDescriptorImageInfo imageInfo{};
-                    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-                    imageInfo.imageView = _textureImageViews[index];
-                    imageInfo.sampler = _textureSamplers[index];
-
-                    imageInfoList.push_back(imageInfo);
-                } else {
-
-                    const auto& samplerInfoList =
-                            _texturesData[index].type == TextureType::ScreenQuad && _texturesData[index].subtype > 0
-                            ? _vulkanInstance->getSamplerHolder()->getPostEffectSamplerInfo(_texturesData[index].subtype)
-                            : _vulkanInstance->getSamplerHolder()->getSamplerInfo(_texturesData[index].type);
-                    if (!samplerInfoList.empty())
-                    {
-                        VkDescriptorImageInfo imageInfo{};
-                        imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-                        imageInfo.imageView = samplerInfoList[i].imageView;
-                        imageInfo.sampler = samplerInfoList[i].sampler;
-
-                        imageInfoList.push_back(imageInfo);
-                    }
-                }
-            }
-
-
-            std::vector<VkWriteDescriptorSet> descriptorWrites;
-            auto bindingIndex = 0u;
-            // Add texture samplers
-            if (!imageInfoList.empty())
-            {
-                for (auto& imageInfo : imageInfoList)
-                {
-                    VkWriteDescriptorSet imagesBuffer{};
-                    imagesBuffer.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                    imagesBuffer.dstSet = descriptorSets[i];
-                    imagesBuffer.dstBinding = bindingIndex;
-                    imagesBuffer.dstArrayElement = 0;
-                    imagesBuffer.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-                    imagesBuffer.descriptorCount = 1;
-                    imagesBuffer.pImageInfo = &imageInfo;
-                    descriptorWrites.push_back(imagesBuffer);
-                    bindingIndex ++;
-                }
-            }
-            // Add uniforms
-            if (!shaderBuffers.empty())
-            {
-                VkWriteDescriptorSet uniformsBuffer {};
-                uniformsBuffer.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                uniformsBuffer.dstSet = descriptorSets[i];
-                uniformsBuffer.dstBinding = bindingIndex;
-                uniformsBuffer.dstArrayElement = 0;
-                uniformsBuffer.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-                uniformsBuffer.descriptorCount = 1;
-                uniformsBuffer.pBufferInfo = &bufferInfo;
-                descriptorWrites.push_back(uniformsBuffer);
-                bindingIndex++;
-            }
-
-            if (storageBuffers && !storageBuffers->empty() && _storageBufferSize > 0)
-            {
-                storageBufferInfo.buffer = storageBuffers->at(i);
-                storageBufferInfo.offset = 0;
-                storageBufferInfo.range = _storageBufferSize;
-
-                VkWriteDescriptorSet storageBuffer {};
-                storageBuffer.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-                storageBuffer.dstSet = descriptorSets[i];
-                storageBuffer.dstBinding = bindingIndex;
-                storageBuffer.dstArrayElement = 0;
-                storageBuffer.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-                storageBuffer.descriptorCount = 1;
-                storageBuffer.pBufferInfo = &storageBufferInfo;
-                descriptorWrites.push_back(storageBuffer);
-            }
-
-            vkUpdateDescriptorSets(_device, descriptorWrites.size(), descriptorWrites.data(), 0, nullptr);
+            updateDescriptorSet(
+                    i,
+                    _stageUniformSize[stage] > 0 ? &uniformBuffer : nullptr,
+                    _stageUniformSize[stage],
+                    shaderInfo,
+                    descriptorSets[i]);
         }
-    };
-
-    makeDescriptorSet(_instanceData.back().vertexUniformBuffers, &_vertexStorageBuffers,  _vertexShader, _instanceData.back().vertexDescriptorSets);
-    makeDescriptorSet(_instanceData.back().geometryUniformBuffer, nullptr, _geometryShader, _instanceData.back().geometryDescriptorSets);
-    makeDescriptorSet(_instanceData.back().fragmentUniformBuffer, nullptr, _fragmentShader, _instanceData.back().fragmentDescriptorSets);
+    }
 }
 
-void VulkanMaterial::deleteDescriptorSets()
+void VulkanMaterial::deleteDescriptorSets(BlockDescriptorData& blockData)
 {
+    if (!blockData.isCreated)
+        return;
 
+    _vulkanInstance->getDescriptorPoolSet()->free(
+            blockData.descriptorPool, blockData.allDescriptorSets, blockData.descriptorCounts);
+    blockData = {};
 }
 
-void VulkanMaterial::deleteDescriptorSets(VulkanMaterial::PerInstanceData& instance)
+bool VulkanMaterial::hasStageDescriptors(uint32_t stage) const
 {
-
+    const auto& shaderSettings = _shaderList[stage]->getShaderSettings();
+    auto hasSamplers = !shaderSettings.samplerNamesList.empty() && !shaderSettings.useBindlessTextures;
+    return hasSamplers || !shaderSettings.bufferList.empty() || _stageUniformSize[stage] > 0;
 }
 
 void VulkanMaterial::updateDescriptorSets()
 {
     auto swapchainSize = _vulkanInstance->getSwapchainSize();
-    auto makeDescriptorSet = [this, swapchainSize](const std::vector<VkBuffer>& shaderBuffers,
-                                                   const std::vector<VkBuffer>* storageBuffers,
-                                                   const VulkanShaderInfo* shaderInfo,
-                                                   std::vector<VkDescriptorSet>& descriptorSets)
+    for (auto block = 0u; block < _blockDescriptorData.size(); block++)
     {
-        if (!shaderInfo)
-            return;
-        if (shaderInfo->getShaderSettings().samplerNamesList.empty() && shaderBuffers.empty())
-            return;
-
-        auto uniformSize = shaderInfo->getShaderUniformsSize();
+        auto& blockData = _blockDescriptorData[block];
+        if (!blockData.isCreated)
+            continue;
 
-        for (auto i = 0u; i < swapchainSize; i++)
+        auto uniformBuffer = _uniformArena->getBuffer(block);
+        for (auto stage = 0u; stage < _shaderList.size(); stage++)
         {
-            updateDescriptorSet(
-                    i,
-                    shaderBuffers.empty() ? nullptr : &shaderBuffers[i],
-                    storageBuffers && !storageBuffers->empty() ? &storageBuffers->at(i) : nullptr,
-                    uniformSize,
-                    storageBuffers ? _storageBufferSize : 0,
-                    shaderInfo,
-                    descriptorSets[i]);
-        }
-    };
+            if (blockData.descriptorSets[stage].empty())
+                continue;
 
-    makeDescriptorSet(_instanceData.back().vertexUniformBuffers, &_vertexStorageBuffers, _vertexShader, _instanceData.back().vertexDescriptorSets);
-    makeDescriptorSet(_instanceData.back().geometryUniformBuffer, nullptr, _geometryShader, _instanceData.back().geometryDescriptorSets);
-    makeDescriptorSet(_instanceData.back().fragmentUniformBuffer, nullptr, _fragmentShader, _instanceData.back().fragmentDescriptorSets);
+            const auto* shaderInfo = _shaderList[stage];
+            for (auto i = 0u; i < swapchainSize; i++)
+            {
+                updateDescriptorSet(
+                        i,
+                        _stageUniformSize[stage] > 0 ? &uniformBuffer : nullptr,
+                        _stageUniformSize[stage],
+                        shaderInfo,
+                        blockData.descriptorSets[stage][i]);
+            }
+        }
+    }
 }
 
 void VulkanMaterial::updateDescriptorSet(
         uint32_t imageIndex,
         const VkBuffer* shaderBuffer,
-        const VkBuffer* storageBuffer,
         const size_t uniformSize,
-        const size_t storageSize,
         const VulkanShaderInfo* shaderInfo,
         VkDescriptorSet descriptorSet)
 {
@@ -1243,16 +1185,23 @@ void VulkanMaterial::updateDescriptorSet(
         bufferInfo.offset = 0;
         bufferInfo.range = uniformSize;
     }
-    if (storageBuffer)
+    // instanced vertex shaders read model matrices from shared per-frame transform buffer
+    bool useTransformBuffer = shaderInfo == _vertexShader && !shaderInfo->getShaderSettings().bufferList.empty();
+    if (useTransformBuffer)
     {
-        storageBufferInfo.buffer = *storageBuffer;
-        storageBufferInfo.offset = 0;
-        storageBufferInfo.range = storageSize;
+        auto* transformBuffer = _vulkanInstance->getTransformBuffer();
+        storageBufferInfo.buffer = transformBuffer->getBuffer();
+        storageBufferInfo.offset = transformBuffer->getRegionOffset(imageIndex);
+        storageBufferInfo.range = transformBuffer->getRegionSize();
     }
 
     std::vector<VkDescriptorImageInfo> imageInfoList;
     for (const auto& samplerName : shaderInfo->getShaderSettings().samplerNamesList)
     {
+        // bindless stage samples from texture table
+        if (shaderInfo->getShaderSettings().useBindlessTextures)
+            break;
+
         auto iter = std::find(_textureNames.cbegin(),
                               _textureNames.cend(),
                               samplerName);
@@ -1314,14 +1263,14 @@ void VulkanMaterial::updateDescriptorSet(
         uniformsBuffer.dstSet = descriptorSet;
         uniformsBuffer.dstBinding = bindingIndex;
         uniformsBuffer.dstArrayElement = 0;
-        uniformsBuffer.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        uniformsBuffer.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
         uniformsBuffer.descriptorCount = 1;
         uniformsBuffer.pBufferInfo = &bufferInfo;
         descriptorWrites.push_back(uniformsBuffer);
         ++bindingIndex;
     }
 
-    if (storageBuffer)
+    if (useTransformBuffer)
     {
         VkWriteDescriptorSet storageBuffer {};
         storageBuffer.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
@@ -1338,6 +1287,11 @@ void VulkanMaterial::updateDescriptorSet(
 }
 
 // TODO: Refactor this
+uint32_t VulkanMaterial::getExternalTextureMask() const
+{
+    return _externalTextureMask;
+}
+
 glm::ivec2 VulkanMaterial::getSpritesheetSize() const
 {
     for (auto& texture :_materialSettings.textures)
@@ -1353,29 +1307,4 @@ const MaterialSettings &VulkanMaterial::getSettings() const
     return _materialSettings;
 }
 
-bool VulkanMaterial::isMainInstance(uint32_t materialIndex) const
-{
-    return _materialSettings.useInstancing && materialIndex == _mainInstance;
-}
-
-void VulkanMaterial::setMainInstance(uint32_t materialIndex)
-{
-    _mainInstance = materialIndex;
-}
-
-bool VulkanMaterial::isInstancesRendered() const
-{
-    return _instancesRendered;
-}
-
-void VulkanMaterial::setInstancedRendered()
-{
-    _instancesRendered = true;
-}
-
-uint32_t VulkanMaterial::getInstanceCount() const
-{
-    return _currentInstanceCount;//_instanceData.size() - 1;
-}
-
 } // namespace SVE
\ No newline at end of file
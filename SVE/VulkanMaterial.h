@@ -7,7 +7,10 @@
 #include "Libs.h"
 #include "MaterialSettings.h"
 #include "ShaderSettings.h"
+#include "VulkanUniformArena.h"
+#include "VulkanTextureTable.h"
 #include <vector>
+#include <unordered_map>
 #include <vulkan/vk_mem_alloc.h>
 
 namespace SVE
@@ -34,31 +37,36 @@ public:
     void updateDescriptorSets();
     void resetPipeline();
 
-    std::vector<VkDescriptorSet> getDescriptorSets(uint32_t materialIndex, size_t index) const;
-
     uint32_t getInstanceForEntity(const Entity* entity, uint32_t index = 0);
     void deleteInstancesForEntity(const Entity* entity);
+    // Trims deleted instances and frees descriptor sets of unused arena blocks (e.g. when level ends)
+    void releaseFreeInstances();
+    uint32_t getUsedInstanceCount() const;
     bool isSkeletal() const;
-    bool isMainInstance(uint32_t materialIndex) const;
-    void setMainInstance(uint32_t materialIndex);
-    bool isInstancesRendered() const;
-    void setInstancedRendered();
-    uint32_t getInstanceCount() const;
+    // Vertex shader reads model matrices from transform buffer, entities are drawn by render list instance batches
+    bool isInstanced() const;
+    // Instanced variant of vertex shader, empty if there is none or material uniforms differ per entity in other ways
+    // than model matrix and material info (such entities can't share draw calls)
+    std::string getInstancedVertexShaderName() const;
     glm::ivec2 getSpritesheetSize() const;
+    // Bit per TextureType of render target textures sampled by material
+    uint32_t getExternalTextureMask() const;
 
     const MaterialSettings& getSettings() const;
 
-    void setUniformData(uint32_t materialIndex, const UniformData& data);
-    void updateInstancedData();
+    void setUniformData(uint32_t materialIndex, const UniformData& data, const EntityUniformData* entityData = nullptr);
 
 private:
     struct PerInstanceData;
+    struct BlockDescriptorData;
 
     void createPipelineLayout();
     void deletePipelineLayout();
 
     void createPipeline();
     void deletePipeline();
+    // key of pipeline shared by bindless materials, textures aren't a part of it
+    std::string getSharedPipelineKey() const;
 
     void createAndStorePipelineCache();
     void loadPipelineCache();
@@ -71,26 +79,21 @@ private:
     void deleteTextureImageView();
     void createTextureSampler();
     void deleteTextureSampler();
+    void createTableTextures();
+    void deleteTableTextures();
 
-    void createUniformBuffers();
-    void deleteUniformBuffers();
-    void deleteUniformBuffers(PerInstanceData& instance);
-
-    void createStorageBuffers();
-    void deleteStorageBuffers();
+    void createUniformLayout();
+    uint32_t createInstance();
+    void deleteInstance(uint32_t instanceIndex);
 
-    void createDescriptorPool();
-    void deleteDescriptorPool();
-    void deleteDescriptorPool(PerInstanceData& instance);
-    void createDescriptorSets();
-    void deleteDescriptorSets();
-    void deleteDescriptorSets(PerInstanceData& instance);
+    // descriptor sets are shared by all instances with uniform data in the same arena block
+    void createDescriptorSets(uint32_t block);
+    void deleteDescriptorSets(BlockDescriptorData& blockData);
+    bool hasStageDescriptors(uint32_t stage) const;
 
     void updateDescriptorSet(uint32_t imageIndex,
                              const VkBuffer* shaderBuffer,
-                             const VkBuffer* storageBuffer,
                              const size_t uniformSize,
-                             const size_t storageSize,
                              const VulkanShaderInfo* shaderInfo,
                              VkDescriptorSet descriptorSet);
 
@@ -101,6 +104,7 @@ private:
     VkDevice _device;
     VmaAllocator _allocator;
     const VulkanUtils& _vulkanUtils;
+    VulkanUniformArena* _uniformArena;
 
     VulkanShaderInfo* _vertexShader = nullptr;
     VulkanShaderInfo* _fragmentShader = nullptr;
@@ -109,6 +113,8 @@ private:
 
     VkPipelineLayout _pipelineLayout = VK_NULL_HANDLE;
     VkPipeline _pipeline;
+    // Main pass materials also draw in Normal and Late subpasses of merged screen quad pass
+    VkPipeline _subpassPipeline[2] = {};
     VkPipelineCache _pipelineCache = VK_NULL_HANDLE;
 
     std::vector<uint32_t> _mipLevels;
@@ -119,7 +125,14 @@ private:
     std::vector<std::string> _textureNames;
 
     bool _hasExternals;
+    uint32_t _externalTextureMask = 0;
     bool _useCache = true;
+
+    // textures are taken from global texture table by indices (pushed as constants)
+    bool _useBindlessTextures = false;
+    VulkanTextureTable::SharedPipeline* _sharedPipeline = nullptr;
+    uint32_t _tableTextureIndices[VulkanTextureTable::MaxMaterialTextures] = {};
+    uint32_t _tableTextureCount = 0;
     struct TextureData
     {
         bool external;
@@ -128,32 +141,37 @@ private:
     };
     std::vector<TextureData> _texturesData;
 
+    static const size_t MaxStageCount = 3;
+
     struct PerInstanceData
     {
-        std::vector<VkBuffer> vertexUniformBuffers;
-        std::vector<VkBuffer> fragmentUniformBuffer;
-        std::vector<VkBuffer> geometryUniformBuffer;
-        std::vector<VmaAllocation> uniformBuffersMemory;
+        // uniforms of all shader stages, placed at _stageUniformOffset
+        UniformSlot uniformSlot;
+        bool isUsed = false;
+    };
 
+    struct BlockDescriptorData
+    {
+        bool isCreated = false;
+        uint32_t instanceCount = 0;
+        // pool from shared pool set, all sets are allocated from it at once
         VkDescriptorPool descriptorPool = VK_NULL_HANDLE;
-
-        std::vector<VkDescriptorSet> vertexDescriptorSets;
-        std::vector<VkDescriptorSet> fragmentDescriptorSets;
-        std::vector<VkDescriptorSet> geometryDescriptorSets;
+        std::vector<VkDescriptorSet> allDescriptorSets;
+        // descriptors of all sets by type, returned to the pool with sets
+        std::vector<VkDescriptorPoolSize> descriptorCounts;
+        // per shader stage (in _shaderList order), per swapchain image
+        std::vector<VkDescriptorSet> descriptorSets[MaxStageCount];
     };
 
-    // for all instances
-    StorageData _storageData;
-    bool _storageUpdated = true;
-    VkDeviceSize _storageBufferSize = 0;
-    std::vector<VkBuffer> _vertexStorageBuffers;
-    std::vector<VmaAllocation> _storageBuffersMemory;
-    uint32_t _mainInstance = 0;
-    uint32_t _currentInstanceCount = 0;
-    bool _instancesRendered = false;
-
-    std::map<const Entity*, std::vector<uint32_t>> _entityInstanceMap;
+    uint32_t _stageUniformSize[MaxStageCount] = {};
+    uint32_t _stageUniformOffset[MaxStageCount] = {};
+    VkDeviceSize _instanceUniformSize = 0;
+    std::vector<BlockDescriptorData> _blockDescriptorData;
+
+    std::unordered_map<const Entity*, std::vector<uint32_t>> _entityInstanceMap;
     std::vector<PerInstanceData> _instanceData;
+    // indices of deleted instances, reused by new ones
+    std::vector<uint32_t> _freeInstances;
 };
 
 } // namespace SVE
\ No newline at end of file
@@ -7,15 +7,103 @@
 #include "Engine.h"
 #include "VulkanMaterial.h"
 #include "VulkanInstance.h"
-#include "VulkanUtils.h"
+#include "VulkanUploadManager.h"
 #include "VulkanException.h"
+#include <glm/gtc/packing.hpp>
 
 namespace SVE
 {
 
+namespace
+{
+
+template <typename T>
+T getVertexData(const std::vector<T>& data, size_t index)
+{
+    return index < data.size() ? data[index] : T(0);
+}
+
+void fillVertices(const MeshSettings& meshSettings, char* vertexData, char* skinData)
+{
+    auto* vertices = reinterpret_cast<MeshVertex*>(vertexData);
+    for (auto i = 0u; i < meshSettings.vertexPosData.size(); i++)
+    {
+        auto& vertex = vertices[i];
+        vertex.position = meshSettings.vertexPosData[i];
+        vertex.color = getVertexData(meshSettings.vertexColorData, i);
+        vertex.texCoord = getVertexData(meshSettings.vertexTexData, i);
+        vertex.normal = getVertexData(meshSettings.vertexNormalData, i);
+        vertex.binormal = getVertexData(meshSettings.vertexBinormalData, i);
+        vertex.tangent = getVertexData(meshSettings.vertexTangentData, i);
+    }
+
+    if (meshSettings.boneNum > 0)
+    {
+        auto* skinVertices = reinterpret_cast<MeshSkinVertex*>(skinData);
+        for (auto i = 0u; i < meshSettings.vertexPosData.size(); i++)
+        {
+            skinVertices[i].boneWeights = meshSettings.vertexBoneWeightData[i];
+            skinVertices[i].boneIds = meshSettings.vertexBoneIndexData[i];
+        }
+    }
+}
+
+// Bone weights are rounded so that their sum stays exactly 1
+uint32_t packBoneWeights(glm::vec4 weights)
+{
+    auto quantized = glm::ivec4(glm::round(glm::clamp(weights, 0.0f, 1.0f) * 255.0f));
+    auto sum = quantized.x + quantized.y + quantized.z + quantized.w;
+    if (sum > 0)
+    {
+        auto maxIndex = 0;
+        for (auto i = 1; i < 4; i++)
+        {
+            if (quantized[i] > quantized[maxIndex])
+                maxIndex = i;
+        }
+        quantized[maxIndex] += 255 - sum;
+    }
+
+    return glm::packUnorm4x8(glm::vec4(quantized) / 255.0f);
+}
+
+uint32_t packBoneIds(glm::ivec4 ids)
+{
+    return (static_cast<uint32_t>(ids.x) & 0xFF)
+           | (static_cast<uint32_t>(ids.y) & 0xFF) << 8
+           | (static_cast<uint32_t>(ids.z) & 0xFF) << 16
+           | (static_cast<uint32_t>(ids.w) & 0xFF) << 24;
+}
+
+void fillCompactVertices(const MeshSettings& meshSettings, char* vertexData, char* skinData)
+{
+    auto* vertices = reinterpret_cast<CompactMeshVertex*>(vertexData);
+    for (auto i = 0u; i < meshSettings.vertexPosData.size(); i++)
+    {
+        auto& vertex = vertices[i];
+        vertex.position = meshSettings.vertexPosData[i];
+        vertex.color = glm::packUnorm4x8(glm::vec4(getVertexData(meshSettings.vertexColorData, i), 1.0f));
+        vertex.texCoord = glm::packHalf2x16(getVertexData(meshSettings.vertexTexData, i));
+        vertex.normal = glm::packSnorm4x8(glm::vec4(getVertexData(meshSettings.vertexNormalData, i), 0.0f));
+        vertex.binormal = glm::packSnorm4x8(glm::vec4(getVertexData(meshSettings.vertexBinormalData, i), 0.0f));
+        vertex.tangent = glm::packSnorm4x8(glm::vec4(getVertexData(meshSettings.vertexTangentData, i), 0.0f));
+    }
+
+    if (meshSettings.boneNum > 0)
+    {
+        auto* skinVertices = reinterpret_cast<CompactMeshSkinVertex*>(skinData);
+        for (auto i = 0u; i < meshSettings.vertexPosData.size(); i++)
+        {
+            skinVertices[i].boneWeights = packBoneWeights(meshSettings.vertexBoneWeightData[i]);
+            skinVertices[i].boneIds = packBoneIds(meshSettings.vertexBoneIndexData[i]);
+        }
+    }
+}
+
+} // anon namespace
+
 VulkanMesh::VulkanMesh(MeshSettings meshSettings)
     : _vulkanInstance(Engine::getInstance()->getVulkanInstance())
-    , _vulkanUtils(_vulkanInstance->getVulkanUtils())
     , _meshSettings(std::move(meshSettings))
 {
     createGeometryBuffers();
@@ -33,15 +121,35 @@ void VulkanMesh::updateMesh(MeshSettings meshSettings)
     createGeometryBuffers();
 }
 
-void VulkanMesh::applyDrawingCommands(uint32_t bufferIndex, uint32_t instanceCount)
+void VulkanMesh::applyDrawingCommands(uint32_t bufferIndex, uint32_t instanceCount, uint32_t firstInstance)
 {
     auto commandBuffer = _vulkanInstance->getCommandBuffer(bufferIndex);
+    bindGeometryBuffers(commandBuffer);
+    vkCmdDrawIndexed(commandBuffer, _meshSettings.indexData.size(), instanceCount, 0, 0, firstInstance);
+}
 
-    std::vector<VkDeviceSize> offsets(_vertexBufferList.size());
-    vkCmdBindVertexBuffers(commandBuffer, 0, _vertexBufferList.size(), _vertexBufferList.data(), offsets.data());
-    vkCmdBindIndexBuffer(commandBuffer, _indexBuffer, 0, VK_INDEX_TYPE_UINT32);
+void VulkanMesh::applyIndirectDrawingCommands(uint32_t bufferIndex, VkBuffer indirectBuffer, VkDeviceSize indirectOffset,
+                                              uint32_t drawCount)
+{
+    if (_hasSkin)
+        throw VulkanException("Mesh " + _meshSettings.name + " with skin can't be drawn indirectly");
 
-    vkCmdDrawIndexed(commandBuffer, _meshSettings.indexData.size(), instanceCount, 0, 0, 0);
+    auto commandBuffer = _vulkanInstance->getCommandBuffer(bufferIndex);
+    VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(commandBuffer, 0, 1, &_geometryBuffer, &offset);
+    vkCmdBindIndexBuffer(commandBuffer, _geometryBuffer, 0, _indexType);
+    _vulkanInstance->getGeometryArena()->addBindings(1);
+    vkCmdDrawIndexedIndirect(commandBuffer, indirectBuffer, indirectOffset, drawCount, sizeof(VkDrawIndexedIndirectCommand));
+}
+
+void VulkanMesh::applySubmeshDrawingCommands(uint32_t bufferIndex, uint32_t submesh, bool isGeometryBound)
+{
+    auto commandBuffer = _vulkanInstance->getCommandBuffer(bufferIndex);
+    if (!isGeometryBound)
+        bindGeometryBuffers(commandBuffer);
+
+    const auto& submeshSettings = _meshSettings.submeshes[submesh];
+    vkCmdDrawIndexed(commandBuffer, submeshSettings.indexCount, 1, submeshSettings.firstIndex, 0, 0);
 }
 
 const MeshSettings& VulkanMesh::getMeshSettings() const
@@ -49,147 +157,103 @@ const MeshSettings& VulkanMesh::getMeshSettings() const
     return _meshSettings;
 }
 
+uint32_t VulkanMesh::getGeometryBlock() const
+{
+    return _geometrySlot.block;
+}
+
+VkIndexType VulkanMesh::getIndexType() const
+{
+    return _indexType;
+}
+
+uint32_t VulkanMesh::getFirstIndex() const
+{
+    auto indexSize = _indexType == VK_INDEX_TYPE_UINT16 ? sizeof(uint16_t) : sizeof(uint32_t);
+    return static_cast<uint32_t>((_geometrySlot.offset + _indexOffset) / indexSize);
+}
+
+int32_t VulkanMesh::getVertexOffset() const
+{
+    return static_cast<int32_t>((_geometrySlot.offset + _vertexOffset) / _vertexSize);
+}
+
 void VulkanMesh::createGeometryBuffers()
 {
-    // TODO: This can be optimized to use single buffer
-    if (!_meshSettings.vertexPosData.empty())
-    {
-        _vertexBufferList.push_back(VK_NULL_HANDLE);
-        _vertexBufferMemoryList.push_back(VK_NULL_HANDLE);
-        createOptimizedBuffer(_meshSettings.vertexPosData, 
-                              _vertexBufferList.back(), 
-                              _vertexBufferMemoryList.back(),
-                              VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
-    }
-    if (!_meshSettings.vertexColorData.empty())
-    {
-        _vertexBufferList.push_back(VK_NULL_HANDLE);
-        _vertexBufferMemoryList.push_back(VK_NULL_HANDLE);
-        createOptimizedBuffer(_meshSettings.vertexColorData,
-                              _vertexBufferList.back(),
-                              _vertexBufferMemoryList.back(),
-                              VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
-    }
-    if (!_meshSettings.vertexTexData.empty())
-    {
-        _vertexBufferList.push_back(VK_NULL_HANDLE);
-        _vertexBufferMemoryList.push_back(VK_NULL_HANDLE);
-        createOptimizedBuffer(_meshSettings.vertexTexData,
-                              _vertexBufferList.back(),
-                              _vertexBufferMemoryList.back(),
-                              VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
-    }
+    auto vertexCount = _meshSettings.vertexPosData.size();
+    auto indexCount = _meshSettings.indexData.size();
+    auto isCompact = _vulkanInstance->getEngineSettings().useCompactVertices;
+    _hasSkin = _meshSettings.boneNum > 0;
+    _indexType = vertexCount < 65536 ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
 
-    if (!_meshSettings.vertexNormalData.empty())
-    {
-        _vertexBufferList.push_back(VK_NULL_HANDLE);
-        _vertexBufferMemoryList.push_back(VK_NULL_HANDLE);
-        createOptimizedBuffer(_meshSettings.vertexNormalData,
-                              _vertexBufferList.back(),
-                              _vertexBufferMemoryList.back(),
-                              VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
-    }
+    auto* geometryArena = _vulkanInstance->getGeometryArena();
+    auto alignment = geometryArena->getAlignment();
+    auto alignSize = [alignment](VkDeviceSize size) { return (size + alignment - 1) / alignment * alignment; };
 
-    if (!_meshSettings.vertexBinormalData.empty())
-    {
-        _vertexBufferList.push_back(VK_NULL_HANDLE);
-        _vertexBufferMemoryList.push_back(VK_NULL_HANDLE);
-        createOptimizedBuffer(_meshSettings.vertexBinormalData,
-                              _vertexBufferList.back(),
-                              _vertexBufferMemoryList.back(),
-                              VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
-    }
+    auto vertexSize = isCompact ? sizeof(CompactMeshVertex) : sizeof(MeshVertex);
+    auto skinVertexSize = _hasSkin ? (isCompact ? sizeof(CompactMeshSkinVertex) : sizeof(MeshSkinVertex)) : 0;
+    auto indexSize = _indexType == VK_INDEX_TYPE_UINT16 ? sizeof(uint16_t) : sizeof(uint32_t);
+    auto skinOffset = alignSize(vertexCount * vertexSize);
+    auto indexOffset = skinOffset + alignSize(vertexCount * skinVertexSize);
+    auto dataSize = indexOffset + indexCount * indexSize;
+
+    // slot has room for padding of vertices start, it's known only after allocation
+    _geometrySlot = geometryArena->allocate(dataSize + vertexSize);
+    _geometryBuffer = geometryArena->getBuffer(_geometrySlot.block);
+    _vertexSize = vertexSize;
+    _vertexOffset = (vertexSize - _geometrySlot.offset % vertexSize) % vertexSize;
+    _skinOffset = _vertexOffset + skinOffset;
+    _indexOffset = _vertexOffset + indexOffset;
 
-    if (!_meshSettings.vertexTangentData.empty())
+    // Fill interleaved streams, then upload whole mesh with single copy
+    std::vector<char> geometryData(_indexOffset + indexCount * indexSize);
+    if (isCompact)
+        fillCompactVertices(_meshSettings, geometryData.data() + _vertexOffset, geometryData.data() + _skinOffset);
+    else
+        fillVertices(_meshSettings, geometryData.data() + _vertexOffset, geometryData.data() + _skinOffset);
+
+    if (_indexType == VK_INDEX_TYPE_UINT16)
     {
-        _vertexBufferList.push_back(VK_NULL_HANDLE);
-        _vertexBufferMemoryList.push_back(VK_NULL_HANDLE);
-        createOptimizedBuffer(_meshSettings.vertexTangentData,
-                              _vertexBufferList.back(),
-                              _vertexBufferMemoryList.back(),
-                              VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+        auto* indices = reinterpret_cast<uint16_t*>(geometryData.data() + _indexOffset);
+        for (auto i = 0u; i < indexCount; i++)
+            indices[i] = static_cast<uint16_t>(_meshSettings.indexData[i]);
     }
-
-    if (_meshSettings.boneNum > 0)
+    else
     {
-        _vertexBufferList.push_back(VK_NULL_HANDLE);
-        _vertexBufferMemoryList.push_back(VK_NULL_HANDLE);
-        createOptimizedBuffer(_meshSettings.vertexBoneWeightData,
-                              _vertexBufferList.back(),
-                              _vertexBufferMemoryList.back(),
-                              VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
-
-        _vertexBufferList.push_back(VK_NULL_HANDLE);
-        _vertexBufferMemoryList.push_back(VK_NULL_HANDLE);
-        createOptimizedBuffer(_meshSettings.vertexBoneIndexData,
-                              _vertexBufferList.back(),
-                              _vertexBufferMemoryList.back(),
-                              VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+        memcpy(geometryData.data() + _indexOffset, _meshSettings.indexData.data(), indexCount * indexSize);
     }
 
-    if (!_meshSettings.vertexTangentData.empty())
+    _vulkanInstance->getUploadManager()->uploadBuffer(geometryData.data(), geometryData.size(),
+                                                      _geometryBuffer, _geometrySlot.offset, true);
+
+    if (_vulkanInstance->getEngineSettings().reportMeshMemory)
     {
-        _vertexBufferList.push_back(VK_NULL_HANDLE);
-        _vertexBufferMemoryList.push_back(VK_NULL_HANDLE);
-        createOptimizedBuffer(_meshSettings.vertexTangentData,
-                              _vertexBufferList.back(),
-                              _vertexBufferMemoryList.back(),
-                              VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+        // each vertex is assumed to be fetched once per draw
+        auto fullSize = vertexCount * (sizeof(MeshVertex) + (_hasSkin ? sizeof(MeshSkinVertex) : 0))
+                        + indexCount * sizeof(uint32_t);
+        auto fetchSize = vertexCount * (vertexSize + skinVertexSize) + indexCount * indexSize;
+        std::cout << "Mesh " << _meshSettings.name << ": " << vertexCount << " vertices, " << indexCount << " indices ("
+                  << indexSize * 8 << " bit), " << dataSize << " bytes (" << fullSize
+                  << " in full float layout), vertex fetch " << fetchSize << " bytes per draw" << std::endl;
     }
-    
-    createOptimizedBuffer(_meshSettings.indexData, _indexBuffer, _indexBufferMemory, VK_BUFFER_USAGE_INDEX_BUFFER_BIT);
 }
 
 void VulkanMesh::deleteGeometryBuffers()
 {
-    vmaDestroyBuffer(_vulkanInstance->getAllocator(), _indexBuffer, _indexBufferMemory);
+    _vulkanInstance->getGeometryArena()->free(_geometrySlot);
+    _geometrySlot = {};
+    _geometryBuffer = VK_NULL_HANDLE;
+}
 
-    for (auto i = 0; i < _vertexBufferList.size(); ++i)
-    {
-        vmaDestroyBuffer(_vulkanInstance->getAllocator(), _vertexBufferList[i], _vertexBufferMemoryList[i]);
-    }
+void VulkanMesh::bindGeometryBuffers(VkCommandBuffer commandBuffer)
+{
+    VkBuffer buffers[] = { _geometryBuffer, _geometryBuffer };
+    VkDeviceSize offsets[] = { _geometrySlot.offset + _vertexOffset, _geometrySlot.offset + _skinOffset };
+    uint32_t bufferCount = _hasSkin ? 2 : 1;
 
-    _vertexBufferList.clear();
-    _vertexBufferMemoryList.clear();
+    vkCmdBindVertexBuffers(commandBuffer, 0, bufferCount, buffers, offsets);
+    vkCmdBindIndexBuffer(commandBuffer, _geometryBuffer, _geometrySlot.offset + _indexOffset, _indexType);
+    _vulkanInstance->getGeometryArena()->addBindings(bufferCount);
 }
 
-// This method will create fast GPU-local buffer (using transitional temporary CPU visible buffer)
-template <typename T>
-void VulkanMesh::createOptimizedBuffer(
-        const std::vector<T>& bufferData,
-        VkBuffer& buffer,
-        VmaAllocation& allocation,
-        VkBufferUsageFlags usage)
-{
-    VkDeviceSize bufferSize = sizeof(bufferData[0]) * bufferData.size();
-
-    // create temporary slow CPU visible memory
-    VkBuffer stagingBuffer;
-    VmaAllocation stagingBufferMemory;
-    _vulkanUtils.createBuffer(bufferSize,
-                              VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                              VMA_MEMORY_USAGE_CPU_TO_GPU,
-                              stagingBuffer,
-                              stagingBufferMemory);
-
-    // Fill temporary buffer with vertex/index data
-    void* data;
-    vmaMapMemory(_vulkanInstance->getAllocator(), stagingBufferMemory, &data);
-    memcpy(data, bufferData.data(), (size_t) bufferSize);
-    vmaUnmapMemory(_vulkanInstance->getAllocator(), stagingBufferMemory);
-
-    // create fast GPU-local buffer for data
-    _vulkanUtils.createBuffer(bufferSize,
-                              VK_BUFFER_USAGE_TRANSFER_DST_BIT | usage,
-                              VMA_MEMORY_USAGE_GPU_ONLY,
-                              buffer,
-                              allocation);
-
-    // copy slow CPU-visible buffer to fast GPU-local
-    _vulkanUtils.copyBuffer(stagingBuffer, buffer, bufferSize);
-
-    // destroy CPU-visible buffer
-    vmaDestroyBuffer(_vulkanInstance->getAllocator(), stagingBuffer, stagingBufferMemory);
-}
-
-} // namespace SVE
\ No newline at end of file
+} // namespace SVE
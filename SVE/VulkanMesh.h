@@ -4,6 +4,7 @@
 #pragma once
 #include "MeshSettings.h"
 #include "VulkanHeaders.h"
+#include "VulkanGeometryArena.h"
 #include <memory>
 #include <vulkan/vk_mem_alloc.h>
 
@@ -11,7 +12,42 @@ namespace SVE
 {
 class VulkanMaterial;
 class VulkanInstance;
-class VulkanUtils;
+
+// Interleaved vertex streams of meshes in geometry arena: attributes used by all shaders and skinning data.
+// Attributes missing in mesh settings are zero.
+struct MeshVertex
+{
+    glm::vec3 position;
+    glm::vec3 color;
+    glm::vec2 texCoord;
+    glm::vec3 normal;
+    glm::vec3 binormal;
+    glm::vec3 tangent;
+};
+
+struct MeshSkinVertex
+{
+    glm::vec4 boneWeights;
+    glm::ivec4 boneIds;
+};
+
+// Quantized layout (useCompactVertices): RGBA8 unorm color, half float texture coordinates,
+// RGBA8 snorm normal, binormal and tangent, RGBA8 unorm bone weights and RGBA8 sint bone ids
+struct CompactMeshVertex
+{
+    glm::vec3 position;
+    uint32_t color;
+    uint32_t texCoord;
+    uint32_t normal;
+    uint32_t binormal;
+    uint32_t tangent;
+};
+
+struct CompactMeshSkinVertex
+{
+    uint32_t boneWeights;
+    uint32_t boneIds;
+};
 
 class VulkanMesh
 {
@@ -21,32 +57,43 @@ public:
 
     void updateMesh(MeshSettings meshSettings);
 
-    void applyDrawingCommands(uint32_t bufferIndex, uint32_t instanceCount = 1);
+    void applyDrawingCommands(uint32_t bufferIndex, uint32_t instanceCount = 1, uint32_t firstInstance = 0);
+    // Indirect commands address geometry relative to the arena block (see getFirstIndex and getVertexOffset),
+    // so commands of meshes from the same block are drawn together. Meshes with skin can't be drawn this way.
+    void applyIndirectDrawingCommands(uint32_t bufferIndex, VkBuffer indirectBuffer, VkDeviceSize indirectOffset,
+                                      uint32_t drawCount = 1);
+    // Draws index range of submesh. Geometry buffers bound by previous draw of this mesh in the same
+    // command buffer are reused if isGeometryBound is set.
+    void applySubmeshDrawingCommands(uint32_t bufferIndex, uint32_t submesh, bool isGeometryBound);
 
     const MeshSettings& getMeshSettings() const;
+    uint32_t getGeometryBlock() const;
+    VkIndexType getIndexType() const;
+    // Mesh location in its geometry block for indirect draw commands
+    uint32_t getFirstIndex() const;
+    int32_t getVertexOffset() const;
 
 private:
     void createGeometryBuffers();
     void deleteGeometryBuffers();
-
-private:
-    template <typename T>
-    void createOptimizedBuffer(
-            const std::vector<T>& data,
-            VkBuffer &buffer,
-            VmaAllocation& allocation,
-            VkBufferUsageFlags usage);
+    void bindGeometryBuffers(VkCommandBuffer commandBuffer);
 
 private:
     VulkanInstance* _vulkanInstance;
-    const VulkanUtils& _vulkanUtils;
 
     MeshSettings _meshSettings;
 
-    std::vector<VkBuffer> _vertexBufferList;
-    std::vector<VmaAllocation> _vertexBufferMemoryList;
-    VkBuffer _indexBuffer = VK_NULL_HANDLE;
-    VmaAllocation _indexBufferMemory = VK_NULL_HANDLE;
+    // vertices, skin vertices (for meshes with bones) and indices are stored one after another in single slot
+    GeometrySlot _geometrySlot;
+    VkBuffer _geometryBuffer = VK_NULL_HANDLE;
+    // vertices start is padded, so that vertex offset in block is a multiple of vertex size
+    VkDeviceSize _vertexOffset = 0;
+    VkDeviceSize _vertexSize = 0;
+    VkDeviceSize _skinOffset = 0;
+    VkDeviceSize _indexOffset = 0;
+    bool _hasSkin = false;
+    // 16 bit indices are used for meshes with less than 65536 vertices
+    VkIndexType _indexType = VK_INDEX_TYPE_UINT32;
 };
 
 } // namespace SVE
\ No newline at end of file
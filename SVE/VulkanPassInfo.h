@@ -15,6 +15,8 @@ public:
     struct PassData
     {
         VkRenderPass renderPass;
+        // passes merged into one render pass have different subpasses
+        uint32_t subpass = 0;
     };
 
     const PassData& getPassData(CommandsType pass) const;
@@ -0,0 +1,209 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#include "VulkanPassUniforms.h"
+#include "VulkanInstance.h"
+#include "VulkanException.h"
+#include "VulkanTextureTable.h"
+#include "Utils.h"
+#include <cstring>
+
+namespace SVE
+{
+
+VulkanPassUniforms::VulkanPassUniforms(VulkanInstance* vulkanInstance)
+    : _vulkanInstance(vulkanInstance)
+    , _device(vulkanInstance->getLogicalDevice())
+    , _uniformArena(vulkanInstance->getUniformArena())
+{
+    auto alignment = _uniformArena->getAlignment();
+    _passStride = (sizeof(PassUniformData) + alignment - 1) / alignment * alignment;
+    _frameOffset = _passStride * PassCount;
+    _uniformSlot = _uniformArena->allocate(_frameOffset + sizeof(FrameUniformData));
+
+    createDescriptorSetLayouts();
+    createPipelineLayout();
+    createDescriptorSet();
+}
+
+VulkanPassUniforms::~VulkanPassUniforms()
+{
+    deleteDescriptorSet();
+    deletePipelineLayout();
+    deleteDescriptorSetLayouts();
+    _uniformArena->free(_uniformSlot);
+}
+
+VkDescriptorSetLayout VulkanPassUniforms::getDescriptorSetLayout() const
+{
+    return _descriptorSetLayout;
+}
+
+VkDescriptorSetLayout VulkanPassUniforms::getEmptyDescriptorSetLayout() const
+{
+    return _emptyDescriptorSetLayout;
+}
+
+void VulkanPassUniforms::update(CommandsType passType, const UniformData& uniformData)
+{
+    // fill in cached memory first, as arena memory may be write-combined
+    fillPassUniformData(uniformData, _passData);
+
+    auto imageIndex = _vulkanInstance->getCurrentImageIndex();
+    char* data = _uniformArena->getMappedData(_uniformSlot, imageIndex) + _passStride * toInt(passType);
+    memcpy(data, &_passData, sizeof(PassUniformData));
+    Engine::getInstance()->getCurrentFrameStats().uniformBytesWritten += sizeof(PassUniformData);
+}
+
+void VulkanPassUniforms::updateLights(const UniformData& uniformData)
+{
+    fillFrameUniformData(uniformData, _frameData);
+
+    auto imageIndex = _vulkanInstance->getCurrentImageIndex();
+    char* data = _uniformArena->getMappedData(_uniformSlot, imageIndex) + _frameOffset;
+    memcpy(data, &_frameData, sizeof(FrameUniformData));
+    Engine::getInstance()->getCurrentFrameStats().uniformBytesWritten += sizeof(FrameUniformData);
+}
+
+void VulkanPassUniforms::bind(VkCommandBuffer commandBuffer, CommandsType passType, uint32_t imageIndex) const
+{
+    auto imageOffset = _uniformArena->getDynamicOffset(_uniformSlot, imageIndex);
+    uint32_t dynamicOffsets[] = {
+            imageOffset + static_cast<uint32_t>(_passStride * toInt(passType)),
+            imageOffset
+    };
+    vkCmdBindDescriptorSets(
+            commandBuffer,
+            VK_PIPELINE_BIND_POINT_GRAPHICS,
+            _pipelineLayout,
+            0,
+            1,
+            &_descriptorSet,
+            2,
+            dynamicOffsets);
+}
+
+void VulkanPassUniforms::createDescriptorSetLayouts()
+{
+    // pass data and frame lights
+    VkDescriptorSetLayoutBinding uboLayoutBindings[2] {};
+    for (auto i = 0u; i < 2; i++)
+    {
+        uboLayoutBindings[i].binding = i;
+        uboLayoutBindings[i].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+        uboLayoutBindings[i].descriptorCount = 1;
+        uboLayoutBindings[i].stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_GEOMETRY_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+        uboLayoutBindings[i].pImmutableSamplers = nullptr;
+    }
+
+    VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo {};
+    descriptorSetLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    descriptorSetLayoutCreateInfo.bindingCount = 2;
+    descriptorSetLayoutCreateInfo.pBindings = uboLayoutBindings;
+
+    if (vkCreateDescriptorSetLayout(_device, &descriptorSetLayoutCreateInfo, nullptr, &_descriptorSetLayout) != VK_SUCCESS)
+    {
+        throw VulkanException("Can't create Vulkan pass descriptor set layout");
+    }
+
+    descriptorSetLayoutCreateInfo.bindingCount = 0;
+    descriptorSetLayoutCreateInfo.pBindings = nullptr;
+    if (vkCreateDescriptorSetLayout(_device, &descriptorSetLayoutCreateInfo, nullptr, &_emptyDescriptorSetLayout) != VK_SUCCESS)
+    {
+        throw VulkanException("Can't create Vulkan empty descriptor set layout");
+    }
+}
+
+void VulkanPassUniforms::deleteDescriptorSetLayouts()
+{
+    vkDestroyDescriptorSetLayout(_device, _emptyDescriptorSetLayout, nullptr);
+    vkDestroyDescriptorSetLayout(_device, _descriptorSetLayout, nullptr);
+}
+
+void VulkanPassUniforms::createPipelineLayout()
+{
+    // Set 0 is the same in all material pipeline layouts, so binding it with this layout is compatible with them.
+    // With texture table all layouts also have the same push constant range (it's a part of compatibility).
+    VkPipelineLayoutCreateInfo pipelineLayoutCreateInfo {};
+    pipelineLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipelineLayoutCreateInfo.setLayoutCount = 1;
+    pipelineLayoutCreateInfo.pSetLayouts = &_descriptorSetLayout;
+
+    VkPushConstantRange pushConstantRange {};
+    if (auto* textureTable = _vulkanInstance->getTextureTable())
+    {
+        pushConstantRange = textureTable->getPushConstantRange();
+        pipelineLayoutCreateInfo.pushConstantRangeCount = 1;
+        pipelineLayoutCreateInfo.pPushConstantRanges = &pushConstantRange;
+    }
+
+    if (vkCreatePipelineLayout(_device, &pipelineLayoutCreateInfo, nullptr, &_pipelineLayout) != VK_SUCCESS)
+    {
+        throw VulkanException("Can't create Vulkan pass pipeline layout");
+    }
+}
+
+void VulkanPassUniforms::deletePipelineLayout()
+{
+    vkDestroyPipelineLayout(_device, _pipelineLayout, nullptr);
+}
+
+void VulkanPassUniforms::createDescriptorSet()
+{
+    VkDescriptorPoolSize poolSize {};
+    poolSize.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    poolSize.descriptorCount = 2;
+
+    VkDescriptorPoolCreateInfo poolInfo {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    poolInfo.maxSets = 1;
+
+    auto result = vkCreateDescriptorPool(_device, &poolInfo, nullptr, &_descriptorPool);
+    if (result != VK_SUCCESS)
+    {
+        throw VulkanException("Can't create Vulkan pass descriptor pool", result);
+    }
+
+    VkDescriptorSetAllocateInfo allocInfo {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = _descriptorPool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &_descriptorSetLayout;
+
+    if (vkAllocateDescriptorSets(_device, &allocInfo, &_descriptorSet) != VK_SUCCESS)
+    {
+        throw VulkanException("Can't allocate Vulkan pass descriptor set");
+    }
+
+    // pass and image are selected by dynamic offsets, so single set covers all of them
+    VkDescriptorBufferInfo bufferInfos[2] {};
+    bufferInfos[0].buffer = _uniformArena->getBuffer(_uniformSlot.block);
+    bufferInfos[0].offset = 0;
+    bufferInfos[0].range = sizeof(PassUniformData);
+    bufferInfos[1].buffer = bufferInfos[0].buffer;
+    bufferInfos[1].offset = _frameOffset;
+    bufferInfos[1].range = sizeof(FrameUniformData);
+
+    VkWriteDescriptorSet descriptorWrites[2] {};
+    for (auto i = 0u; i < 2; i++)
+    {
+        descriptorWrites[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        descriptorWrites[i].dstSet = _descriptorSet;
+        descriptorWrites[i].dstBinding = i;
+        descriptorWrites[i].dstArrayElement = 0;
+        descriptorWrites[i].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+        descriptorWrites[i].descriptorCount = 1;
+        descriptorWrites[i].pBufferInfo = &bufferInfos[i];
+    }
+
+    vkUpdateDescriptorSets(_device, 2, descriptorWrites, 0, nullptr);
+}
+
+void VulkanPassUniforms::deleteDescriptorSet()
+{
+    vkDestroyDescriptorPool(_device, _descriptorPool, nullptr);
+}
+
+} // namespace SVE
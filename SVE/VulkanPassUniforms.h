@@ -0,0 +1,61 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include "VulkanHeaders.h"
+#include "VulkanUniformArena.h"
+#include "ShaderSettings.h"
+#include "Engine.h"
+
+namespace SVE
+{
+class VulkanInstance;
+
+// Per-pass uniform block (camera, time) and per-frame lights block shared by all materials.
+// They are bound to set 0 once per pass, material sets start from FirstMaterialSet.
+class VulkanPassUniforms
+{
+public:
+    static const uint32_t FirstMaterialSet = 1;
+
+    explicit VulkanPassUniforms(VulkanInstance* vulkanInstance);
+    ~VulkanPassUniforms();
+
+    VkDescriptorSetLayout getDescriptorSetLayout() const;
+    // Layout without bindings, used for material stages without any resources
+    VkDescriptorSetLayout getEmptyDescriptorSetLayout() const;
+
+    void update(CommandsType passType, const UniformData& uniformData);
+    void updateLights(const UniformData& uniformData);
+    void bind(VkCommandBuffer commandBuffer, CommandsType passType, uint32_t imageIndex) const;
+
+private:
+    void createDescriptorSetLayouts();
+    void deleteDescriptorSetLayouts();
+    void createPipelineLayout();
+    void deletePipelineLayout();
+    void createDescriptorSet();
+    void deleteDescriptorSet();
+
+
+
+private:
+    VulkanInstance* _vulkanInstance;
+    VkDevice _device;
+    VulkanUniformArena* _uniformArena;
+    UniformSlot _uniformSlot;
+    VkDeviceSize _passStride;
+    // frame data is placed after data of all passes
+    VkDeviceSize _frameOffset;
+
+    VkDescriptorSetLayout _descriptorSetLayout = VK_NULL_HANDLE;
+    VkDescriptorSetLayout _emptyDescriptorSetLayout = VK_NULL_HANDLE;
+    VkPipelineLayout _pipelineLayout = VK_NULL_HANDLE;
+    VkDescriptorPool _descriptorPool = VK_NULL_HANDLE;
+    VkDescriptorSet _descriptorSet = VK_NULL_HANDLE;
+
+    PassUniformData _passData {};
+    FrameUniformData _frameData {};
+};
+
+} // namespace SVE
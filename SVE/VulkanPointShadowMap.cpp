@@ -41,7 +41,8 @@ void VulkanPointShadowMap::reallocateCommandBuffers()
     }
 }
 
-uint32_t VulkanPointShadowMap::startRenderCommandBufferCreation(uint32_t bufferNumber, uint32_t imageIndex)
+uint32_t VulkanPointShadowMap::startRenderCommandBufferCreation(uint32_t bufferNumber, uint32_t imageIndex,
+                                                                VkSubpassContents subpassContents)
 {
     VkCommandBufferBeginInfo beginInfo{};
     beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
@@ -67,7 +68,11 @@ uint32_t VulkanPointShadowMap::startRenderCommandBufferCreation(uint32_t bufferN
     renderPassBeginInfo.clearValueCount = clearValues.size();
     renderPassBeginInfo.pClearValues = clearValues.data();
 
-    vkCmdBeginRenderPass(_commandBuffers[bufferNumber], &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+    vkCmdBeginRenderPass(_commandBuffers[bufferNumber], &renderPassBeginInfo, subpassContents);
+
+    // dynamic state isn't allowed in primary buffer, secondary buffers set it from record info
+    if (subpassContents == VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS)
+        return BUFFER_INDEX_SHADOWMAP_POINT + bufferNumber;
 
     // TODO: Add depth bias constants to configuration
     vkCmdSetDepthBias(
@@ -107,6 +112,19 @@ void VulkanPointShadowMap::endRenderCommandBufferCreation(uint32_t bufferIndex)
     }
 }
 
+RenderPassRecordInfo VulkanPointShadowMap::getRecordInfo(uint32_t imageIndex) const
+{
+    RenderPassRecordInfo recordInfo;
+    recordInfo.renderPass = _renderPass;
+    recordInfo.framebuffer = _framebuffers[imageIndex];
+    recordInfo.extent = { _shadowMapSize, _shadowMapSize };
+    recordInfo.useDepthBias = true;
+    recordInfo.depthBiasConstant = 5.25f;
+    recordInfo.depthBiasSlope = 5.75f;
+
+    return recordInfo;
+}
+
 VkSampler VulkanPointShadowMap::getSampler(uint32_t index) const
 {
     return _shadowSampler[index];
@@ -48,6 +48,11 @@ VkImageView VulkanPostEffect::getImageView()
     return _resolveImageView;
 }
 
+VulkanUtils::AttachmentTraffic VulkanPostEffect::getAttachmentTraffic() const
+{
+    return _attachmentTraffic;
+}
+
 VkCommandBuffer VulkanPostEffect::reallocateCommandBuffers()
 {
     _commandBuffer = _vulkanInstance->createCommandBuffer(BUFFER_INDEX_SCREEN_QUAD + _index);
@@ -128,7 +133,8 @@ void VulkanPostEffect::createRenderPass()
     colorAttachment.format = _vulkanInstance->getSurfaceColorFormat();
     colorAttachment.samples = sampleCount;
     colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR; // clear every frame
-    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE; // should be STORE for rendering
+    // only resolved image is sampled
+    colorAttachment.storeOp = sampleCount == VK_SAMPLE_COUNT_1_BIT ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE;
     colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
     colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
@@ -151,11 +157,11 @@ void VulkanPostEffect::createRenderPass()
     depthAttachment.format = depthFormat;
     depthAttachment.samples = sampleCount;
     depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
     depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
     depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    depthAttachment.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 
     VkAttachmentReference colorAttachmentRef {};
     colorAttachmentRef.attachment = 0;
@@ -197,6 +203,7 @@ void VulkanPostEffect::createRenderPass()
     std::vector<VkAttachmentDescription> attachments { colorAttachment, depthAttachment, colorAttachmentResolve };
     if (sampleCount == VK_SAMPLE_COUNT_1_BIT)
         attachments.resize(2);
+    _attachmentTraffic = VulkanUtils::getAttachmentTraffic(attachments, { _width, _height });
 
     VkRenderPassCreateInfo renderPassCreateInfo{};
     renderPassCreateInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
@@ -215,7 +222,7 @@ void VulkanPostEffect::createRenderPass()
     VulkanPassInfo::PassData data {
             _renderPass
     };
-    _vulkanInstance->getPassInfo()->setPassData(CommandsType::ScreenQuadPass, data);
+    _vulkanInstance->getPassInfo()->setPassData(CommandsType::PostEffectPasses, data);
 }
 
 void VulkanPostEffect::deleteRenderPass()
@@ -292,7 +299,7 @@ void VulkanPostEffect::createImages()
             sampleCount,
             depthFormat,
             VK_IMAGE_TILING_OPTIMAL,
-            VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+            VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
             VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
             _depthImage,
             _depthImageMemory);
@@ -3,11 +3,11 @@
 // Licensed under the MIT License
 #pragma once
 #include "VulkanHeaders.h"
+#include "VulkanUtils.h"
 #include <memory>
 
 namespace SVE
 {
-class VulkanUtils;
 class VulkanInstance;
 struct UniformData;
 
@@ -19,6 +19,7 @@ public:
 
     VkSampler getSampler();
     VkImageView getImageView();
+    VulkanUtils::AttachmentTraffic getAttachmentTraffic() const;
 
     VkCommandBuffer reallocateCommandBuffers();
     void startRenderCommandBufferCreation();
@@ -40,6 +41,7 @@ private:
     const VulkanUtils& _vulkanUtils;
 
     VkRenderPass _renderPass = VK_NULL_HANDLE;
+    VulkanUtils::AttachmentTraffic _attachmentTraffic;
 
     VkImage _colorImage = VK_NULL_HANDLE;
     VkImage _resolveImage = VK_NULL_HANDLE;
@@ -17,6 +17,7 @@ VulkanScreenQuad::VulkanScreenQuad(glm::ivec2 resolution)
     : _vulkanInstance(Engine::getInstance()->getVulkanInstance())
     , _width(resolution.x > 0 ? resolution.x : _vulkanInstance->getExtent().width)
     , _height(resolution.y > 0 ? resolution.y : _vulkanInstance->getExtent().height)
+    , _isMerged(_vulkanInstance->getEngineSettings().mergeScreenQuadPasses)
     , _vulkanUtils(_vulkanInstance->getVulkanUtils())
 {
     createRenderPass();
@@ -61,6 +62,16 @@ VkImageView VulkanScreenQuad::getImageView()
     return _resolveImageView[0];
 }
 
+bool VulkanScreenQuad::isMerged() const
+{
+    return _isMerged;
+}
+
+VulkanUtils::AttachmentTraffic VulkanScreenQuad::getAttachmentTraffic(bool merged) const
+{
+    return merged ? _mergedTraffic : _separateTraffic;
+}
+
 void VulkanScreenQuad::reallocateCommandBuffers(ScreenQuadPass screenQuadPass)
 {
     switch (screenQuadPass)
@@ -80,7 +91,7 @@ void VulkanScreenQuad::reallocateCommandBuffers(ScreenQuadPass screenQuadPass)
     }
 }
 
-void VulkanScreenQuad::startRenderCommandBufferCreation(ScreenQuadPass screenQuadPass)
+void VulkanScreenQuad::startRenderCommandBufferCreation(ScreenQuadPass screenQuadPass, VkSubpassContents subpassContents)
 {
     VkCommandBufferBeginInfo beginInfo{};
     beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
@@ -96,7 +107,7 @@ void VulkanScreenQuad::startRenderCommandBufferCreation(ScreenQuadPass screenQua
     clearValues[0].color = {0.0f, 0.0f, 0.0f, 0.0f};
     clearValues[1].depthStencil = {1.0f, 0};
     clearValues[2].color = {0.0f, 0.0f, 0.0f, 0.0f};
-    if (screenQuadPass == ScreenQuadPass::MRT)
+    if (screenQuadPass == ScreenQuadPass::MRT || (_isMerged && screenQuadPass == ScreenQuadPass::Normal))
     {
         clearValues.resize(5);
         clearValues[3].color = {0.0f, 0.0f, 0.0f, 0.0f};
@@ -115,7 +126,11 @@ void VulkanScreenQuad::startRenderCommandBufferCreation(ScreenQuadPass screenQua
     renderPassBeginInfo.clearValueCount = clearValues.size();
     renderPassBeginInfo.pClearValues = clearValues.data();
 
-    vkCmdBeginRenderPass(_commandBuffer[screenQuadPass], &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+    vkCmdBeginRenderPass(_commandBuffer[screenQuadPass], &renderPassBeginInfo, subpassContents);
+
+    // dynamic state isn't allowed in primary buffer, secondary buffers set it from record info
+    if (subpassContents == VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS)
+        return;
 
     // TODO: Add depth bias constants to configuration
     vkCmdSetDepthBias(
@@ -142,6 +157,11 @@ void VulkanScreenQuad::startRenderCommandBufferCreation(ScreenQuadPass screenQua
     vkCmdSetScissor(_commandBuffer[screenQuadPass], 0, 1, &scissor);
 }
 
+void VulkanScreenQuad::nextSubpass(VkSubpassContents subpassContents)
+{
+    vkCmdNextSubpass(_commandBuffer[Normal], subpassContents);
+}
+
 void VulkanScreenQuad::endRenderCommandBufferCreation(ScreenQuadPass screenQuadPass)
 {
     vkCmdEndRenderPass(_commandBuffer[screenQuadPass]);
@@ -153,6 +173,27 @@ void VulkanScreenQuad::endRenderCommandBufferCreation(ScreenQuadPass screenQuadP
     }
 }
 
+RenderPassRecordInfo VulkanScreenQuad::getRecordInfo(ScreenQuadPass screenQuadPass) const
+{
+    RenderPassRecordInfo recordInfo;
+    if (_isMerged && screenQuadPass != Depth)
+    {
+        recordInfo.renderPass = _renderPass[Normal];
+        recordInfo.framebuffer = _framebuffer[Normal];
+        recordInfo.subpass = screenQuadPass;
+    } else
+    {
+        recordInfo.renderPass = _renderPass[screenQuadPass];
+        recordInfo.framebuffer = _framebuffer[screenQuadPass];
+    }
+    recordInfo.extent = { _width, _height };
+    recordInfo.useDepthBias = true;
+    recordInfo.depthBiasConstant = 1.25f;
+    recordInfo.depthBiasSlope = 1.75f;
+
+    return recordInfo;
+}
+
 void VulkanScreenQuad::createRenderPass()
 {
     auto depthFormat = _vulkanInstance->getDepthFormat();
@@ -254,87 +295,101 @@ void VulkanScreenQuad::createRenderPass()
     dependencies[1].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
     dependencies[1].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
 
-    // TODO: Create 4 subpasses instead of 3 passes
+    // color isn't needed after late pass if it's resolved, and depth isn't needed at all
+    auto lateColorAttachment = colorAttachment[1];
+    if (sampleCount != VK_SAMPLE_COUNT_1_BIT)
+        lateColorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthAttachment[2].storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+
+    std::vector<VkAttachmentDescription> normalAttachments{colorAttachment[0], depthAttachment[0], colorAttachmentResolve[0]};
+    std::vector<VkAttachmentDescription> mrtAttachments;
+    if (sampleCount != VK_SAMPLE_COUNT_1_BIT)
+        mrtAttachments = {colorAttachment[1], depthAttachment[1], colorAttachmentResolve[1], colorAttachment[2], colorAttachmentResolve[2]};
+    else
+        mrtAttachments = {colorAttachment[1], depthAttachment[1], colorAttachment[2]};
+    std::vector<VkAttachmentDescription> lateAttachments{lateColorAttachment, depthAttachment[2], colorAttachmentResolve[1]};
+    if (sampleCount == VK_SAMPLE_COUNT_1_BIT)
     {
-        std::vector<VkAttachmentDescription> attachments{colorAttachment[0], depthAttachment[0],
-                                                         colorAttachmentResolve[0]};
+        normalAttachments.resize(2);
+        lateAttachments.resize(2);
+    }
 
-        if (sampleCount == VK_SAMPLE_COUNT_1_BIT)
-            attachments.resize(2);
+    VkExtent2D extent { _width, _height };
+    _separateTraffic = VulkanUtils::getAttachmentTraffic(normalAttachments, extent);
+    _separateTraffic += VulkanUtils::getAttachmentTraffic(mrtAttachments, extent);
+    _separateTraffic += VulkanUtils::getAttachmentTraffic(lateAttachments, extent);
 
-        VkRenderPassCreateInfo renderPassCreateInfo{};
-        renderPassCreateInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-        renderPassCreateInfo.attachmentCount = attachments.size();
-        renderPassCreateInfo.pAttachments = attachments.data();
-        renderPassCreateInfo.subpassCount = 1;
-        renderPassCreateInfo.pSubpasses = &subpass[0];
-        //renderPassCreateInfo.dependencyCount = dependencies.size();
-        //renderPassCreateInfo.pDependencies = dependencies.data();
-
-        if (vkCreateRenderPass(_vulkanInstance->getLogicalDevice(), &renderPassCreateInfo, nullptr, &_renderPass[Normal]) !=
-            VK_SUCCESS)
+    // merged pass is created instead of separate ones, but both are estimated for comparison
+    createMergedRenderPass();
+    if (!_isMerged)
+    {
         {
-            throw VulkanException("Can't create Vulkan render pass");
+            auto& attachments = normalAttachments;
+            VkRenderPassCreateInfo renderPassCreateInfo{};
+            renderPassCreateInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+            renderPassCreateInfo.attachmentCount = attachments.size();
+            renderPassCreateInfo.pAttachments = attachments.data();
+            renderPassCreateInfo.subpassCount = 1;
+            renderPassCreateInfo.pSubpasses = &subpass[0];
+            //renderPassCreateInfo.dependencyCount = dependencies.size();
+            //renderPassCreateInfo.pDependencies = dependencies.data();
+
+            if (vkCreateRenderPass(_vulkanInstance->getLogicalDevice(), &renderPassCreateInfo, nullptr, &_renderPass[Normal]) !=
+                VK_SUCCESS)
+            {
+                throw VulkanException("Can't create Vulkan render pass");
+            }
+
+            VulkanPassInfo::PassData data{
+                    _renderPass[Normal]
+            };
+            _vulkanInstance->getPassInfo()->setPassData(CommandsType::ScreenQuadPass, data);
         }
-
-        VulkanPassInfo::PassData data{
-                _renderPass[Normal]
-        };
-        _vulkanInstance->getPassInfo()->setPassData(CommandsType::ScreenQuadPass, data);
-    }
-    {
-        std::vector<VkAttachmentDescription> attachments;
-        if (sampleCount != VK_SAMPLE_COUNT_1_BIT)
-            attachments = {colorAttachment[1], depthAttachment[1], colorAttachmentResolve[1], colorAttachment[2], colorAttachmentResolve[2]};
-        else
-            attachments = {colorAttachment[1], depthAttachment[1], colorAttachment[2]};
-
-        VkRenderPassCreateInfo renderPassCreateInfo{};
-        renderPassCreateInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-        renderPassCreateInfo.attachmentCount = attachments.size();
-        renderPassCreateInfo.pAttachments = attachments.data();
-        renderPassCreateInfo.subpassCount = 1;
-        renderPassCreateInfo.pSubpasses = &subpass[1];
-        //renderPassCreateInfo.dependencyCount = dependencies.size();
-        //renderPassCreateInfo.pDependencies = dependencies.data();
-
-        if (vkCreateRenderPass(_vulkanInstance->getLogicalDevice(), &renderPassCreateInfo, nullptr, &_renderPass[MRT]) !=
-            VK_SUCCESS)
         {
-            throw VulkanException("Can't create Vulkan render pass");
+            auto& attachments = mrtAttachments;
+            VkRenderPassCreateInfo renderPassCreateInfo{};
+            renderPassCreateInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+            renderPassCreateInfo.attachmentCount = attachments.size();
+            renderPassCreateInfo.pAttachments = attachments.data();
+            renderPassCreateInfo.subpassCount = 1;
+            renderPassCreateInfo.pSubpasses = &subpass[1];
+            //renderPassCreateInfo.dependencyCount = dependencies.size();
+            //renderPassCreateInfo.pDependencies = dependencies.data();
+
+            if (vkCreateRenderPass(_vulkanInstance->getLogicalDevice(), &renderPassCreateInfo, nullptr, &_renderPass[MRT]) !=
+                VK_SUCCESS)
+            {
+                throw VulkanException("Can't create Vulkan render pass");
+            }
+
+            VulkanPassInfo::PassData data{
+                    _renderPass[MRT]
+            };
+            _vulkanInstance->getPassInfo()->setPassData(CommandsType::ScreenQuadMRTPass, data);
         }
 
-        VulkanPassInfo::PassData data{
-                _renderPass[MRT]
-        };
-        _vulkanInstance->getPassInfo()->setPassData(CommandsType::ScreenQuadMRTPass, data);
-    }
-
-    {
-        std::vector<VkAttachmentDescription> attachments{colorAttachment[1], depthAttachment[2],
-                                                         colorAttachmentResolve[1]};
-        if (sampleCount == VK_SAMPLE_COUNT_1_BIT)
-            attachments.resize(2);
-
-        VkRenderPassCreateInfo renderPassCreateInfo{};
-        renderPassCreateInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
-        renderPassCreateInfo.attachmentCount = attachments.size();
-        renderPassCreateInfo.pAttachments = attachments.data();
-        renderPassCreateInfo.subpassCount = 1;
-        renderPassCreateInfo.pSubpasses = &subpass[0];
-        //renderPassCreateInfo.dependencyCount = dependencies.size();
-        //renderPassCreateInfo.pDependencies = dependencies.data();
-
-        if (vkCreateRenderPass(_vulkanInstance->getLogicalDevice(), &renderPassCreateInfo, nullptr, &_renderPass[Late]) !=
-            VK_SUCCESS)
         {
-            throw VulkanException("Can't create Vulkan render pass");
+            auto& attachments = lateAttachments;
+            VkRenderPassCreateInfo renderPassCreateInfo{};
+            renderPassCreateInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+            renderPassCreateInfo.attachmentCount = attachments.size();
+            renderPassCreateInfo.pAttachments = attachments.data();
+            renderPassCreateInfo.subpassCount = 1;
+            renderPassCreateInfo.pSubpasses = &subpass[0];
+            //renderPassCreateInfo.dependencyCount = dependencies.size();
+            //renderPassCreateInfo.pDependencies = dependencies.data();
+
+            if (vkCreateRenderPass(_vulkanInstance->getLogicalDevice(), &renderPassCreateInfo, nullptr, &_renderPass[Late]) !=
+                VK_SUCCESS)
+            {
+                throw VulkanException("Can't create Vulkan render pass");
+            }
+
+            VulkanPassInfo::PassData data{
+                    _renderPass[Late]
+            };
+            _vulkanInstance->getPassInfo()->setPassData(CommandsType::ScreenQuadLatePass, data);
         }
-
-        VulkanPassInfo::PassData data{
-                _renderPass[Late]
-        };
-        _vulkanInstance->getPassInfo()->setPassData(CommandsType::ScreenQuadLatePass, data);
     }
 
     {
@@ -362,6 +417,124 @@ void VulkanScreenQuad::createRenderPass()
     }
 }
 
+void VulkanScreenQuad::createMergedRenderPass()
+{
+    auto sampleCount = _vulkanInstance->getMSAASamples();
+    auto isMultisampled = sampleCount != VK_SAMPLE_COUNT_1_BIT;
+
+    // Stages only draw to the same attachments, so they stay in tile memory between subpasses,
+    // and only resolved (or single sampled) colors are stored
+    VkAttachmentDescription colorAttachment {};
+    colorAttachment.format = _vulkanInstance->getSurfaceColorFormat();
+    colorAttachment.samples = sampleCount;
+    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    colorAttachment.storeOp = isMultisampled ? VK_ATTACHMENT_STORE_OP_DONT_CARE : VK_ATTACHMENT_STORE_OP_STORE;
+    colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    colorAttachment.finalLayout = isMultisampled ? VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    VkAttachmentDescription colorAttachmentResolve {};
+    colorAttachmentResolve.format = _vulkanInstance->getSurfaceColorFormat();
+    colorAttachmentResolve.samples = VK_SAMPLE_COUNT_1_BIT;
+    colorAttachmentResolve.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    colorAttachmentResolve.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    colorAttachmentResolve.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    colorAttachmentResolve.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    colorAttachmentResolve.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    colorAttachmentResolve.finalLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    VkAttachmentDescription depthAttachment {};
+    depthAttachment.format = _vulkanInstance->getDepthFormat();
+    depthAttachment.samples = sampleCount;
+    depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+    // color, depth, [color resolve], second color, [second color resolve]
+    std::vector<VkAttachmentDescription> attachments { colorAttachment, depthAttachment };
+    if (isMultisampled)
+        attachments.push_back(colorAttachmentResolve);
+    attachments.push_back(colorAttachment);
+    if (isMultisampled)
+        attachments.push_back(colorAttachmentResolve);
+
+    _mergedTraffic = VulkanUtils::getAttachmentTraffic(attachments, { _width, _height });
+    if (!_isMerged)
+        return;
+
+    uint32_t secondColorIndex = isMultisampled ? 3 : 2;
+    VkAttachmentReference colorAttachmentRef[2] = {
+            { 0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL },
+            { secondColorIndex, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL } };
+    VkAttachmentReference depthAttachmentRef { 1, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL };
+    // each color is resolved once, after the last subpass writing it
+    VkAttachmentReference mrtResolveRef[2] = {
+            { VK_ATTACHMENT_UNUSED, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL },
+            { 4, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL } };
+    VkAttachmentReference lateResolveRef { 2, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL };
+    // second color is stored at the end of render pass
+    uint32_t preserveAttachment = isMultisampled ? 4 : 2;
+
+    VkSubpassDescription subpass[3] = {};
+    for (auto i = 0; i < 3; ++i)
+    {
+        subpass[i].pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+        subpass[i].colorAttachmentCount = i == MRT ? 2 : 1;
+        subpass[i].pColorAttachments = colorAttachmentRef;
+        subpass[i].pDepthStencilAttachment = &depthAttachmentRef;
+    }
+    if (isMultisampled)
+    {
+        subpass[MRT].pResolveAttachments = mrtResolveRef;
+        subpass[Late].pResolveAttachments = &lateResolveRef;
+    }
+    subpass[Late].preserveAttachmentCount = 1;
+    subpass[Late].pPreserveAttachments = &preserveAttachment;
+
+    std::vector<VkSubpassDependency> dependencies(3);
+    for (auto i = 0; i < 2; ++i)
+    {
+        dependencies[i].srcSubpass = i;
+        dependencies[i].dstSubpass = i + 1;
+        dependencies[i].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        dependencies[i].dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+        dependencies[i].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        dependencies[i].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT
+                                        | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        dependencies[i].dependencyFlags = VK_DEPENDENCY_BY_REGION_BIT;
+    }
+    // results are sampled by post effects and main pass
+    dependencies[2].srcSubpass = Late;
+    dependencies[2].dstSubpass = VK_SUBPASS_EXTERNAL;
+    dependencies[2].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    dependencies[2].dstStageMask = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+    dependencies[2].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    dependencies[2].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+
+    VkRenderPassCreateInfo renderPassCreateInfo{};
+    renderPassCreateInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    renderPassCreateInfo.attachmentCount = attachments.size();
+    renderPassCreateInfo.pAttachments = attachments.data();
+    renderPassCreateInfo.subpassCount = 3;
+    renderPassCreateInfo.pSubpasses = subpass;
+    renderPassCreateInfo.dependencyCount = dependencies.size();
+    renderPassCreateInfo.pDependencies = dependencies.data();
+
+    if (vkCreateRenderPass(_vulkanInstance->getLogicalDevice(), &renderPassCreateInfo, nullptr, &_renderPass[Normal]) !=
+        VK_SUCCESS)
+    {
+        throw VulkanException("Can't create Vulkan render pass");
+    }
+
+    _vulkanInstance->getPassInfo()->setPassData(CommandsType::ScreenQuadPass, { _renderPass[Normal], Normal });
+    _vulkanInstance->getPassInfo()->setPassData(CommandsType::ScreenQuadMRTPass, { _renderPass[Normal], MRT });
+    _vulkanInstance->getPassInfo()->setPassData(CommandsType::ScreenQuadLatePass, { _renderPass[Normal], Late });
+}
+
 void VulkanScreenQuad::deleteRenderPass()
 {
     for (auto & _renderPas : _renderPass)
@@ -435,6 +608,10 @@ void VulkanScreenQuad::createImages()
     // create depth attachment image
     for (auto i = 0; i < 2; ++i)
     {
+        // depth of merged passes lives only inside render pass
+        VkImageUsageFlags depthImageFlags = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+        if (_isMerged && i == 0)
+            depthImageFlags = VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
         _vulkanUtils.createImage(
                 _width,
                 _height,
@@ -442,7 +619,7 @@ void VulkanScreenQuad::createImages()
                 i == 0 ? sampleCount : VK_SAMPLE_COUNT_1_BIT,
                 depthFormat,
                 VK_IMAGE_TILING_OPTIMAL,
-                VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                depthImageFlags,
                 VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
                 _depthImage[i],
                 _depthImageMemory[i]);
@@ -537,25 +714,29 @@ void VulkanScreenQuad::createFramebuffers()
     framebufferCreateInfo.height = _height;
     framebufferCreateInfo.layers = 1;
 
-    if (vkCreateFramebuffer(_vulkanInstance->getLogicalDevice(), &framebufferCreateInfo, nullptr, &_framebuffer[Normal]) != VK_SUCCESS)
+    if (!_isMerged)
     {
-        throw VulkanException("Can't create Vulkan Framebuffer");
-    }
+        if (vkCreateFramebuffer(_vulkanInstance->getLogicalDevice(), &framebufferCreateInfo, nullptr, &_framebuffer[Normal]) != VK_SUCCESS)
+        {
+            throw VulkanException("Can't create Vulkan Framebuffer");
+        }
 
-    framebufferCreateInfo.renderPass = _renderPass[Late];
-    if (vkCreateFramebuffer(_vulkanInstance->getLogicalDevice(), &framebufferCreateInfo, nullptr, &_framebuffer[Late]) != VK_SUCCESS)
-    {
-        throw VulkanException("Can't create Vulkan Framebuffer");
+        framebufferCreateInfo.renderPass = _renderPass[Late];
+        if (vkCreateFramebuffer(_vulkanInstance->getLogicalDevice(), &framebufferCreateInfo, nullptr, &_framebuffer[Late]) != VK_SUCCESS)
+        {
+            throw VulkanException("Can't create Vulkan Framebuffer");
+        }
     }
 
+    // merged pass has the same attachments as MRT pass
     attachments.push_back(_colorImageView[1]);
     if (sampleCount != VK_SAMPLE_COUNT_1_BIT)
         attachments.push_back(_resolveImageView[1]);
-    framebufferCreateInfo.renderPass = _renderPass[MRT];
+    framebufferCreateInfo.renderPass = _isMerged ? _renderPass[Normal] : _renderPass[MRT];
     framebufferCreateInfo.attachmentCount = attachments.size();
     framebufferCreateInfo.pAttachments = attachments.data();
 
-    if (vkCreateFramebuffer(_vulkanInstance->getLogicalDevice(), &framebufferCreateInfo, nullptr, &_framebuffer[MRT]) != VK_SUCCESS)
+    if (vkCreateFramebuffer(_vulkanInstance->getLogicalDevice(), &framebufferCreateInfo, nullptr, &_framebuffer[_isMerged ? Normal : MRT]) != VK_SUCCESS)
     {
         throw VulkanException("Can't create Vulkan Framebuffer");
     }
@@ -3,6 +3,8 @@
 // Licensed under the MIT License
 #pragma once
 #include "VulkanHeaders.h"
+#include "VulkanCommandsManager.h"
+#include "VulkanUtils.h"
 #include <memory>
 #include <glm/glm.hpp>
 
@@ -31,11 +33,20 @@ public:
     VkSampler getSampler();
     VkImageView getImageView();
 
+    // Normal, MRT and Late are subpasses of Normal render pass, recorded to its command buffer
+    bool isMerged() const;
+    // Estimate for Normal, MRT and Late passes per frame (merged or separate)
+    VulkanUtils::AttachmentTraffic getAttachmentTraffic(bool merged) const;
+
     void reallocateCommandBuffers(ScreenQuadPass screenQuadPass);
-    void startRenderCommandBufferCreation(ScreenQuadPass screenQuadPass);
+    void startRenderCommandBufferCreation(ScreenQuadPass screenQuadPass, VkSubpassContents subpassContents = VK_SUBPASS_CONTENTS_INLINE);
+    // Starts next stage of merged passes
+    void nextSubpass(VkSubpassContents subpassContents = VK_SUBPASS_CONTENTS_INLINE);
     void endRenderCommandBufferCreation(ScreenQuadPass screenQuadPass);
+    RenderPassRecordInfo getRecordInfo(ScreenQuadPass screenQuadPass) const;
 private:
     void createRenderPass();
+    void createMergedRenderPass();
     void deleteRenderPass();
     void createImages();
     void deleteImages();
@@ -46,8 +57,11 @@ private:
     VulkanInstance* _vulkanInstance;
     uint32_t _width;
     uint32_t _height;
+    bool _isMerged;
 
     const VulkanUtils& _vulkanUtils;
+    VulkanUtils::AttachmentTraffic _separateTraffic;
+    VulkanUtils::AttachmentTraffic _mergedTraffic;
 
     VkRenderPass _renderPass[ScreenQuadBufferCount] = {};
 
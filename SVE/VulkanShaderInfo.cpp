@@ -4,10 +4,12 @@
 #include "VulkanShaderInfo.h"
 #include "VulkanException.h"
 #include "VulkanInstance.h"
+#include "VulkanMesh.h"
 #include "Engine.h"
 #include "LightManager.h"
 #include "ResourceManager.h"
 #include <fstream>
+#include <cstddef>
 
 namespace SVE
 {
@@ -27,13 +29,137 @@ VkShaderStageFlagBits getVulkanShaderStage(const ShaderSettings& shaderSettings)
     return stageMap[static_cast<uint8_t>(shaderSettings.shaderType)];
 }
 
+// attributes locations are assigned in this order
+const VertexInfo::VertexDataType VertexDataOrder[] =
+        {
+                VertexInfo::Position,
+                VertexInfo::Color,
+                VertexInfo::TexCoord,
+                VertexInfo::Normal,
+                VertexInfo::Binormal,
+                VertexInfo::Tangent,
+                VertexInfo::BoneWeights,
+                VertexInfo::BoneIds,
+                VertexInfo::Custom
+        };
+
+const uint32_t MeshVertexData = VertexInfo::Position | VertexInfo::Color | VertexInfo::TexCoord |
+                                VertexInfo::Normal | VertexInfo::Binormal | VertexInfo::Tangent;
+const uint32_t MeshSkinData = VertexInfo::BoneWeights | VertexInfo::BoneIds;
+
+const uint32_t MeshVertexBinding = 0;
+const uint32_t MeshSkinBinding = 1;
+const uint32_t CustomBinding = 2;
+
+VkFormat getVertexDataFormat(VertexInfo::VertexDataType vertexDataType)
+{
+    switch (vertexDataType)
+    {
+        case VertexInfo::TexCoord:
+            return VK_FORMAT_R32G32_SFLOAT;
+        case VertexInfo::BoneWeights:
+        case VertexInfo::Custom:
+            return VK_FORMAT_R32G32B32A32_SFLOAT;
+        case VertexInfo::BoneIds:
+            return VK_FORMAT_R32G32B32A32_SINT;
+        default:
+            return VK_FORMAT_R32G32B32_SFLOAT;
+    }
+}
+
+// compact mesh layout is decoded by vertex input, so shaders get the same types as with full layout
+VkFormat getMeshFormat(VertexInfo::VertexDataType vertexDataType, bool isCompact)
+{
+    if (isCompact)
+    {
+        switch (vertexDataType)
+        {
+            case VertexInfo::Color:
+                return VK_FORMAT_R8G8B8A8_UNORM;
+            case VertexInfo::TexCoord:
+                return VK_FORMAT_R16G16_SFLOAT;
+            case VertexInfo::Normal:
+            case VertexInfo::Binormal:
+            case VertexInfo::Tangent:
+                return VK_FORMAT_R8G8B8A8_SNORM;
+            case VertexInfo::BoneWeights:
+                return VK_FORMAT_R8G8B8A8_UNORM;
+            case VertexInfo::BoneIds:
+                return VK_FORMAT_R8G8B8A8_SINT;
+            default:
+                break;
+        }
+    }
+
+    return getVertexDataFormat(vertexDataType);
+}
+
+uint32_t getMeshBinding(VertexInfo::VertexDataType vertexDataType)
+{
+    if (vertexDataType == VertexInfo::Custom)
+        return CustomBinding;
+    return (vertexDataType & MeshSkinData) ? MeshSkinBinding : MeshVertexBinding;
+}
+
+uint32_t getMeshOffset(VertexInfo::VertexDataType vertexDataType, bool isCompact)
+{
+    if (isCompact)
+    {
+        switch (vertexDataType)
+        {
+            case VertexInfo::Position:
+                return offsetof(CompactMeshVertex, position);
+            case VertexInfo::Color:
+                return offsetof(CompactMeshVertex, color);
+            case VertexInfo::TexCoord:
+                return offsetof(CompactMeshVertex, texCoord);
+            case VertexInfo::Normal:
+                return offsetof(CompactMeshVertex, normal);
+            case VertexInfo::Binormal:
+                return offsetof(CompactMeshVertex, binormal);
+            case VertexInfo::Tangent:
+                return offsetof(CompactMeshVertex, tangent);
+            case VertexInfo::BoneWeights:
+                return offsetof(CompactMeshSkinVertex, boneWeights);
+            case VertexInfo::BoneIds:
+                return offsetof(CompactMeshSkinVertex, boneIds);
+            default:
+                return 0;
+        }
+    }
+
+    switch (vertexDataType)
+    {
+        case VertexInfo::Position:
+            return offsetof(MeshVertex, position);
+        case VertexInfo::Color:
+            return offsetof(MeshVertex, color);
+        case VertexInfo::TexCoord:
+            return offsetof(MeshVertex, texCoord);
+        case VertexInfo::Normal:
+            return offsetof(MeshVertex, normal);
+        case VertexInfo::Binormal:
+            return offsetof(MeshVertex, binormal);
+        case VertexInfo::Tangent:
+            return offsetof(MeshVertex, tangent);
+        case VertexInfo::BoneWeights:
+            return offsetof(MeshSkinVertex, boneWeights);
+        case VertexInfo::BoneIds:
+            return offsetof(MeshSkinVertex, boneIds);
+        default:
+            return 0;
+    }
+}
+
 } // anon namespace
 
 VulkanShaderInfo::VulkanShaderInfo(ShaderSettings shaderSettings)
         : _shaderSettings(std::move(shaderSettings))
         , _device(Engine::getInstance()->getVulkanInstance()->getLogicalDevice())
         , _shaderStage(getVulkanShaderStage(_shaderSettings))
+        , _isCompactVertices(Engine::getInstance()->getVulkanInstance()->getEngineSettings().useCompactVertices)
 {
+    _uniformsSize = computeUniformLayout(_shaderSettings, _uniformLayout);
     createDescriptorSetLayout();
 }
 
@@ -64,49 +190,12 @@ void VulkanShaderInfo::freeShaderModule()
 
 size_t VulkanShaderInfo::getShaderUniformsSize() const
 {
-    size_t size = 0;
-    const auto& sizeMap = getUniformSizeMap();
-    for (const auto& info : _shaderSettings.uniformList)
-    {
-        if (info.uniformType == UniformType::BoneMatrices)
-        {
-            size += sizeMap.at(info.uniformType) * _shaderSettings.maxBonesSize;
-        } else if (info.uniformType == UniformType::LightPoint)
-        {
-            size += sizeMap.at(info.uniformType) * _shaderSettings.maxShadowPointLightSize;
-        } else if (info.uniformType == UniformType::LightPointSimple)
-        {
-            size += sizeMap.at(info.uniformType) * _shaderSettings.maxPointLightSize;
-        } else if (info.uniformType == UniformType::LightLine)
-        {
-            size += sizeMap.at(info.uniformType) * _shaderSettings.maxLineLightSize;
-        } else if (info.uniformType == UniformType::LightPointViewProjectionList)
-        {
-            size += sizeMap.at(info.uniformType) * _shaderSettings.maxLightSize;
-        } else if (info.uniformType == UniformType::LightDirectViewProjectionList)
-        {
-            size += sizeMap.at(info.uniformType) * _shaderSettings.maxCascadeLightSize;
-        }
-        else if (info.uniformType == UniformType::ViewProjectionMatrixList)
-        {
-            size += sizeMap.at(info.uniformType) * _shaderSettings.maxViewProjectionMatrices;
-        }
-        else if (info.uniformType == UniformType::GlyphInfoList)
-        {
-            size += sizeMap.at(info.uniformType) * _shaderSettings.maxGlyphCount;
-        }
-        else if (info.uniformType == UniformType::TextSymbolList)
-        {
-            size += sizeMap.at(info.uniformType) * _shaderSettings.maxTextSize;
-        }
-        else
-        {
-            if (sizeMap.find(info.uniformType) != sizeMap.end())
-                size += sizeMap.at(info.uniformType);
-        }
-    }
+    return _uniformsSize;
+}
 
-    return size;
+const std::vector<UniformLayoutEntry>& VulkanShaderInfo::getUniformLayout() const
+{
+    return _uniformLayout;
 }
 
 size_t VulkanShaderInfo::getShaderStorageBuffersSize() const
@@ -131,232 +220,101 @@ VkDescriptorSetLayout VulkanShaderInfo::getDescriptorSetLayout() const
     return _descriptorSetLayout;
 }
 
+const std::vector<VkDescriptorPoolSize>& VulkanShaderInfo::getDescriptorCounts() const
+{
+    return _descriptorCounts;
+}
+
 std::vector<VkVertexInputBindingDescription> VulkanShaderInfo::getBindingDescription() const
 {
     std::vector<VkVertexInputBindingDescription> bindingDescriptions;
-    uint32_t binding = 0;
-    uint32_t stride = 0;
-
-    if (_shaderSettings.vertexInfo.vertexDataFlags & VertexInfo::Position)
-    {
-        VkVertexInputBindingDescription positionBinding {};
-        positionBinding.binding = binding++;
-        positionBinding.stride = getVertexDataSize(VertexInfo::Position);
-        positionBinding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX; // per vertex or per instance
-        bindingDescriptions.push_back(positionBinding);
-        stride += positionBinding.stride;
-    }
-
-    if (_shaderSettings.vertexInfo.vertexDataFlags & VertexInfo::Color)
-    {
-        VkVertexInputBindingDescription colorBinding {};
-        colorBinding.binding = binding++;
-        colorBinding.stride = getVertexDataSize(VertexInfo::Color);
-        colorBinding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-        bindingDescriptions.push_back(colorBinding);
-        stride += colorBinding.stride;
-    }
+    const auto& vertexInfo = _shaderSettings.vertexInfo;
 
-    if (_shaderSettings.vertexInfo.vertexDataFlags & VertexInfo::TexCoord)
+    // for combined binding only one struct should be set
+    if (!vertexInfo.separateBinding)
     {
-        VkVertexInputBindingDescription texCoordBinding {};
-        texCoordBinding.binding = binding++;
-        texCoordBinding.stride = getVertexDataSize(VertexInfo::TexCoord);
-        texCoordBinding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-        bindingDescriptions.push_back(texCoordBinding);
-        stride += texCoordBinding.stride;
-    }
+        uint32_t stride = 0;
+        for (auto dataType : VertexDataOrder)
+        {
+            if (vertexInfo.vertexDataFlags & dataType)
+                stride += getVertexDataSize(dataType) * (dataType == VertexInfo::Custom ? vertexInfo.customCount : 1);
+        }
 
-    if (_shaderSettings.vertexInfo.vertexDataFlags & VertexInfo::Normal)
-    {
-        VkVertexInputBindingDescription normalBinding {};
-        normalBinding.binding = binding++;
-        normalBinding.stride = getVertexDataSize(VertexInfo::Normal);
-        normalBinding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-        bindingDescriptions.push_back(normalBinding);
-        stride += normalBinding.stride;
-    }
+        VkVertexInputBindingDescription combinedBindingDescription {};
+        combinedBindingDescription.binding = 0;
+        combinedBindingDescription.stride = stride;
+        combinedBindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+        bindingDescriptions.push_back(combinedBindingDescription);
 
-    if (_shaderSettings.vertexInfo.vertexDataFlags & VertexInfo::Binormal)
-    {
-        VkVertexInputBindingDescription binormalBinding {};
-        binormalBinding.binding = binding++;
-        binormalBinding.stride = getVertexDataSize(VertexInfo::Binormal);
-        binormalBinding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-        bindingDescriptions.push_back(binormalBinding);
-        stride += binormalBinding.stride;
+        return bindingDescriptions;
     }
 
-    if (_shaderSettings.vertexInfo.vertexDataFlags & VertexInfo::Tangent)
+    // mesh attributes are interleaved in vertex and skin streams (see VulkanMesh)
+    if (vertexInfo.vertexDataFlags & MeshVertexData)
     {
-        VkVertexInputBindingDescription tangentBinding {};
-        tangentBinding.binding = binding++;
-        tangentBinding.stride = getVertexDataSize(VertexInfo::Tangent);
-        tangentBinding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-        bindingDescriptions.push_back(tangentBinding);
-        stride += tangentBinding.stride;
+        VkVertexInputBindingDescription vertexBinding {};
+        vertexBinding.binding = MeshVertexBinding;
+        vertexBinding.stride = _isCompactVertices ? sizeof(CompactMeshVertex) : sizeof(MeshVertex);
+        vertexBinding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX; // per vertex or per instance
+        bindingDescriptions.push_back(vertexBinding);
     }
 
-    if (_shaderSettings.vertexInfo.vertexDataFlags & VertexInfo::BoneWeights)
+    if (vertexInfo.vertexDataFlags & MeshSkinData)
     {
-        VkVertexInputBindingDescription boneWeightBinding {};
-        boneWeightBinding.binding = binding++;
-        boneWeightBinding.stride = getVertexDataSize(VertexInfo::BoneWeights);
-        boneWeightBinding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-        bindingDescriptions.push_back(boneWeightBinding);
-        stride += boneWeightBinding.stride;
+        VkVertexInputBindingDescription skinBinding {};
+        skinBinding.binding = MeshSkinBinding;
+        skinBinding.stride = _isCompactVertices ? sizeof(CompactMeshSkinVertex) : sizeof(MeshSkinVertex);
+        skinBinding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+        bindingDescriptions.push_back(skinBinding);
     }
 
-    if (_shaderSettings.vertexInfo.vertexDataFlags & VertexInfo::BoneIds)
-    {
-        VkVertexInputBindingDescription boneIdsBinding {};
-        boneIdsBinding.binding = binding++;
-        boneIdsBinding.stride = getVertexDataSize(VertexInfo::BoneIds);
-        boneIdsBinding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-        bindingDescriptions.push_back(boneIdsBinding);
-        stride += boneIdsBinding.stride;
-    }
-    if (_shaderSettings.vertexInfo.vertexDataFlags & VertexInfo::Custom)
+    if (vertexInfo.vertexDataFlags & VertexInfo::Custom)
     {
-        for (auto i = 0; i < _shaderSettings.vertexInfo.customCount; i++)
+        for (auto i = 0u; i < vertexInfo.customCount; i++)
         {
             VkVertexInputBindingDescription customBinding {};
-            customBinding.binding = binding++;
+            customBinding.binding = CustomBinding + i;
             customBinding.stride = getVertexDataSize(VertexInfo::Custom);
             customBinding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
             bindingDescriptions.push_back(customBinding);
-            stride += customBinding.stride;
         }
     }
 
-    // for combined binding only one struct should be set
-    if (!_shaderSettings.vertexInfo.separateBinding)
-    {
-        bindingDescriptions.clear();
-        VkVertexInputBindingDescription combinedBindingDescription {};
-        combinedBindingDescription.binding = 0;
-        combinedBindingDescription.stride = stride;
-        combinedBindingDescription.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
-        bindingDescriptions.push_back(combinedBindingDescription);
-    }
-
     return bindingDescriptions;
 }
 
 std::vector<VkVertexInputAttributeDescription> VulkanShaderInfo::getAttributeDescriptions() const
 {
     std::vector<VkVertexInputAttributeDescription> attributeDescriptions;
-    uint32_t binding = 0;
+    const auto& vertexInfo = _shaderSettings.vertexInfo;
     uint32_t location = 0;
     uint32_t offset = 0;
 
-    if (_shaderSettings.vertexInfo.vertexDataFlags & VertexInfo::Position)
-    {
-        VkVertexInputAttributeDescription vertexAttrib {};
-        vertexAttrib.binding = _shaderSettings.vertexInfo.separateBinding ? binding++ : binding;
-        vertexAttrib.location = location++;
-        vertexAttrib.format = VK_FORMAT_R32G32B32_SFLOAT;
-        attributeDescriptions.push_back(vertexAttrib);
-
-        offset += getVertexDataSize(VertexInfo::Position);
-    }
-
-    if (_shaderSettings.vertexInfo.vertexDataFlags & VertexInfo::Color)
-    {
-        VkVertexInputAttributeDescription colorAttrib {};
-        colorAttrib.binding = _shaderSettings.vertexInfo.separateBinding ? binding++ : binding;
-        colorAttrib.location = location++;
-        colorAttrib.format = VK_FORMAT_R32G32B32_SFLOAT;
-        colorAttrib.offset = _shaderSettings.vertexInfo.separateBinding ? 0 : offset;
-        attributeDescriptions.push_back(colorAttrib);
-
-        offset += getVertexDataSize(VertexInfo::Color);
-    }
-
-    if (_shaderSettings.vertexInfo.vertexDataFlags & VertexInfo::TexCoord)
-    {
-        VkVertexInputAttributeDescription texCoordAttrib {};
-        texCoordAttrib.binding = _shaderSettings.vertexInfo.separateBinding ? binding++ : binding;
-        texCoordAttrib.location = location++;
-        texCoordAttrib.format = VK_FORMAT_R32G32_SFLOAT;
-        texCoordAttrib.offset = _shaderSettings.vertexInfo.separateBinding ? 0 : offset;
-        attributeDescriptions.push_back(texCoordAttrib);
-
-        offset += getVertexDataSize(VertexInfo::TexCoord);
-    }
-
-    if (_shaderSettings.vertexInfo.vertexDataFlags & VertexInfo::Normal)
-    {
-        VkVertexInputAttributeDescription normalAttrib {};
-        normalAttrib.binding = _shaderSettings.vertexInfo.separateBinding ? binding++ : binding;
-        normalAttrib.location = location++;
-        normalAttrib.format = VK_FORMAT_R32G32B32_SFLOAT;
-        normalAttrib.offset = _shaderSettings.vertexInfo.separateBinding ? 0 : offset;
-        attributeDescriptions.push_back(normalAttrib);
-
-        offset += getVertexDataSize(VertexInfo::Normal);
-    }
-
-    if (_shaderSettings.vertexInfo.vertexDataFlags & VertexInfo::Binormal)
+    for (auto dataType : VertexDataOrder)
     {
-        VkVertexInputAttributeDescription binormalAttrib {};
-        binormalAttrib.binding = _shaderSettings.vertexInfo.separateBinding ? binding++ : binding;
-        binormalAttrib.location = location++;
-        binormalAttrib.format = VK_FORMAT_R32G32B32_SFLOAT;
-        binormalAttrib.offset = _shaderSettings.vertexInfo.separateBinding ? 0 : offset;
-        attributeDescriptions.push_back(binormalAttrib);
-
-        offset += getVertexDataSize(VertexInfo::Binormal);
-    }
-
-    if (_shaderSettings.vertexInfo.vertexDataFlags & VertexInfo::Tangent)
-    {
-        VkVertexInputAttributeDescription tangentAttrib {};
-        tangentAttrib.binding = _shaderSettings.vertexInfo.separateBinding ? binding++ : binding;
-        tangentAttrib.location = location++;
-        tangentAttrib.format = VK_FORMAT_R32G32B32_SFLOAT;
-        tangentAttrib.offset = _shaderSettings.vertexInfo.separateBinding ? 0 : offset;
-        attributeDescriptions.push_back(tangentAttrib);
-
-        offset += getVertexDataSize(VertexInfo::Tangent);
-    }
+        if (!(vertexInfo.vertexDataFlags & dataType))
+            continue;
 
-    if (_shaderSettings.vertexInfo.vertexDataFlags & VertexInfo::BoneWeights)
-    {
-        VkVertexInputAttributeDescription boneWeightAttrib {};
-        boneWeightAttrib.binding = _shaderSettings.vertexInfo.separateBinding ? binding++ : binding;
-        boneWeightAttrib.location = location++;
-        boneWeightAttrib.format = VK_FORMAT_R32G32B32A32_SFLOAT;
-        boneWeightAttrib.offset = _shaderSettings.vertexInfo.separateBinding ? 0 : offset;
-        attributeDescriptions.push_back(boneWeightAttrib);
-
-        offset += getVertexDataSize(VertexInfo::BoneWeights);
-    }
-
-    if (_shaderSettings.vertexInfo.vertexDataFlags & VertexInfo::BoneIds)
-    {
-        VkVertexInputAttributeDescription boneIndexAttrib {};
-        boneIndexAttrib.binding = _shaderSettings.vertexInfo.separateBinding ? binding++ : binding;
-        boneIndexAttrib.location = location++;
-        boneIndexAttrib.format = VK_FORMAT_R32G32B32A32_SINT;
-        boneIndexAttrib.offset = _shaderSettings.vertexInfo.separateBinding ? 0 : offset;
-        attributeDescriptions.push_back(boneIndexAttrib);
-
-        offset += getVertexDataSize(VertexInfo::BoneIds);
-    }
-
-    if (_shaderSettings.vertexInfo.vertexDataFlags & VertexInfo::Custom)
-    {
-        for (auto i = 0; i < _shaderSettings.vertexInfo.customCount; i++)
+        auto attributeCount = dataType == VertexInfo::Custom ? vertexInfo.customCount : 1u;
+        for (auto i = 0u; i < attributeCount; i++)
         {
-            VkVertexInputAttributeDescription customAttribute {};
-            customAttribute.binding = _shaderSettings.vertexInfo.separateBinding ? binding++ : binding;
-            customAttribute.location = location++;
-            customAttribute.format = VK_FORMAT_R32G32B32A32_SFLOAT;
-            customAttribute.offset = _shaderSettings.vertexInfo.separateBinding ? 0 : offset;
-            attributeDescriptions.push_back(customAttribute);
-
-            offset += getVertexDataSize(VertexInfo::Custom);
+            VkVertexInputAttributeDescription attribute {};
+            attribute.location = location++;
+            if (vertexInfo.separateBinding)
+            {
+                attribute.binding = getMeshBinding(dataType) + i;
+                attribute.offset = getMeshOffset(dataType, _isCompactVertices);
+                attribute.format = getMeshFormat(dataType, _isCompactVertices);
+            }
+            else
+            {
+                attribute.binding = 0;
+                attribute.offset = offset;
+                attribute.format = getVertexDataFormat(dataType);
+            }
+            attributeDescriptions.push_back(attribute);
+
+            offset += getVertexDataSize(dataType);
         }
     }
 
@@ -381,7 +339,9 @@ void VulkanShaderInfo::createDescriptorSetLayout()
         bindingNum++;
     }
 
-    for (auto i = 0u; i < _shaderSettings.samplerNamesList.size(); i++)
+    // bindless shaders sample from texture table, sampler names only define texture indices order
+    auto samplerCount = _shaderSettings.useBindlessTextures ? 0u : _shaderSettings.samplerNamesList.size();
+    for (auto i = 0u; i < samplerCount; i++)
     {
         VkDescriptorSetLayoutBinding samplerLayoutBinding {};
         samplerLayoutBinding.binding = bindingNum;
@@ -398,7 +358,10 @@ void VulkanShaderInfo::createDescriptorSetLayout()
     {
         VkDescriptorSetLayoutBinding uboLayoutBinding{};
         uboLayoutBinding.binding = bindingNum; // binding in shader
-        uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        // materials bind uniforms from the shared arena with dynamic offsets
+        uboLayoutBinding.descriptorType = _shaderSettings.shaderType == ShaderType::ComputeShader
+                                          ? VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER
+                                          : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
         uboLayoutBinding.descriptorCount = 1;
         uboLayoutBinding.stageFlags = _shaderStage;
         uboLayoutBinding.pImmutableSamplers = nullptr; // used for image sampling
@@ -425,6 +388,10 @@ void VulkanShaderInfo::createDescriptorSetLayout()
         return;
     }
 
+    _descriptorCounts.clear();
+    for (const auto& descriptor : descriptorList)
+        _descriptorCounts.push_back({ descriptor.descriptorType, descriptor.descriptorCount });
+
     VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo {};
     descriptorSetLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
     descriptorSetLayoutCreateInfo.bindingCount = descriptorList.size();
@@ -24,10 +24,13 @@ public:
     std::vector<VkVertexInputAttributeDescription> getAttributeDescriptions() const;
 
     size_t getShaderUniformsSize() const;
+    const std::vector<UniformLayoutEntry>& getUniformLayout() const;
     size_t getShaderStorageBuffersSize() const;
     const ShaderSettings& getShaderSettings() const;
 
     VkDescriptorSetLayout getDescriptorSetLayout() const;
+    // Descriptors of each type in descriptor set layout
+    const std::vector<VkDescriptorPoolSize>& getDescriptorCounts() const;
 private:
     void createDescriptorSetLayout();
     void deleteDescriptorSetLayout();
@@ -39,9 +42,14 @@ private:
     VkDevice _device;
     ShaderSettings _shaderSettings;
     VkShaderStageFlagBits _shaderStage;
+    // mesh vertex streams layout, same for all meshes
+    bool _isCompactVertices;
+    std::vector<UniformLayoutEntry> _uniformLayout;
+    size_t _uniformsSize = 0;
     VkShaderModule _shaderModule = VK_NULL_HANDLE;
 
     VkDescriptorSetLayout _descriptorSetLayout = VK_NULL_HANDLE;
+    std::vector<VkDescriptorPoolSize> _descriptorCounts;
 };
 
 } // namespace SVE
\ No newline at end of file
@@ -0,0 +1,184 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#include "VulkanTextureTable.h"
+#include "VulkanInstance.h"
+#include "VulkanException.h"
+
+namespace SVE
+{
+
+VulkanTextureTable::VulkanTextureTable(VulkanInstance* vulkanInstance, uint32_t maxTextureCount)
+    : _vulkanInstance(vulkanInstance)
+    , _device(vulkanInstance->getLogicalDevice())
+    , _maxTextureCount(maxTextureCount)
+{
+    createDescriptorSet();
+}
+
+VulkanTextureTable::~VulkanTextureTable()
+{
+    for (auto& item : _pipelineMap)
+    {
+        vkDestroyPipeline(_device, item.second.pipeline, nullptr);
+        for (auto subpassPipeline : item.second.subpassPipeline)
+            vkDestroyPipeline(_device, subpassPipeline, nullptr);
+        vkDestroyPipelineLayout(_device, item.second.pipelineLayout, nullptr);
+    }
+    deleteDescriptorSet();
+}
+
+VkDescriptorSetLayout VulkanTextureTable::getDescriptorSetLayout() const
+{
+    return _descriptorSetLayout;
+}
+
+VkPushConstantRange VulkanTextureTable::getPushConstantRange() const
+{
+    VkPushConstantRange pushConstantRange {};
+    pushConstantRange.stageFlags = VK_SHADER_STAGE_ALL_GRAPHICS;
+    pushConstantRange.offset = 0;
+    pushConstantRange.size = sizeof(uint32_t) * MaxMaterialTextures;
+    return pushConstantRange;
+}
+
+uint32_t VulkanTextureTable::addTexture(VkImageView imageView, VkSampler sampler)
+{
+    uint32_t index;
+    if (!_freeIndices.empty())
+    {
+        index = _freeIndices.back();
+        _freeIndices.pop_back();
+    }
+    else
+    {
+        if (_textureCount == _maxTextureCount)
+            throw VulkanException("Bindless texture table is full");
+        index = _textureCount++;
+    }
+
+    VkDescriptorImageInfo imageInfo {};
+    imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    imageInfo.imageView = imageView;
+    imageInfo.sampler = sampler;
+
+    // set is created with update after bind, so it can be updated while previous frames use it
+    VkWriteDescriptorSet descriptorWrite {};
+    descriptorWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptorWrite.dstSet = _descriptorSet;
+    descriptorWrite.dstBinding = 0;
+    descriptorWrite.dstArrayElement = index;
+    descriptorWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    descriptorWrite.descriptorCount = 1;
+    descriptorWrite.pImageInfo = &imageInfo;
+    vkUpdateDescriptorSets(_device, 1, &descriptorWrite, 0, nullptr);
+
+    return index;
+}
+
+void VulkanTextureTable::removeTexture(uint32_t index)
+{
+    // descriptor is left as is (binding is partially bound), it's overwritten on reuse
+    _freeIndices.push_back(index);
+}
+
+VulkanTextureTable::SharedPipeline* VulkanTextureTable::acquirePipeline(const std::string& key)
+{
+    auto& sharedPipeline = _pipelineMap[key];
+    ++sharedPipeline.materialCount;
+    return &sharedPipeline;
+}
+
+void VulkanTextureTable::releasePipeline(const std::string& key)
+{
+    auto iter = _pipelineMap.find(key);
+    if (iter == _pipelineMap.end())
+        return;
+
+    if (--iter->second.materialCount == 0)
+    {
+        vkDestroyPipeline(_device, iter->second.pipeline, nullptr);
+        for (auto subpassPipeline : iter->second.subpassPipeline)
+            vkDestroyPipeline(_device, subpassPipeline, nullptr);
+        vkDestroyPipelineLayout(_device, iter->second.pipelineLayout, nullptr);
+        _pipelineMap.erase(iter);
+    }
+}
+
+void VulkanTextureTable::bind(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout) const
+{
+    vkCmdBindDescriptorSets(
+            commandBuffer,
+            VK_PIPELINE_BIND_POINT_GRAPHICS,
+            pipelineLayout,
+            TableSet,
+            1,
+            &_descriptorSet,
+            0,
+            nullptr);
+}
+
+void VulkanTextureTable::createDescriptorSet()
+{
+    VkDescriptorSetLayoutBinding layoutBinding {};
+    layoutBinding.binding = 0;
+    layoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    layoutBinding.descriptorCount = _maxTextureCount;
+    layoutBinding.stageFlags = VK_SHADER_STAGE_ALL_GRAPHICS;
+    layoutBinding.pImmutableSamplers = nullptr;
+
+    VkDescriptorBindingFlagsEXT bindingFlags = VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT
+                                               | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT;
+    VkDescriptorSetLayoutBindingFlagsCreateInfoEXT bindingFlagsCreateInfo {};
+    bindingFlagsCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+    bindingFlagsCreateInfo.bindingCount = 1;
+    bindingFlagsCreateInfo.pBindingFlags = &bindingFlags;
+
+    VkDescriptorSetLayoutCreateInfo descriptorSetLayoutCreateInfo {};
+    descriptorSetLayoutCreateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    descriptorSetLayoutCreateInfo.pNext = &bindingFlagsCreateInfo;
+    descriptorSetLayoutCreateInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;
+    descriptorSetLayoutCreateInfo.bindingCount = 1;
+    descriptorSetLayoutCreateInfo.pBindings = &layoutBinding;
+
+    if (vkCreateDescriptorSetLayout(_device, &descriptorSetLayoutCreateInfo, nullptr, &_descriptorSetLayout) != VK_SUCCESS)
+    {
+        throw VulkanException("Can't create Vulkan texture table descriptor set layout");
+    }
+
+    VkDescriptorPoolSize poolSize {};
+    poolSize.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    poolSize.descriptorCount = _maxTextureCount;
+
+    VkDescriptorPoolCreateInfo poolInfo {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.flags = VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    poolInfo.maxSets = 1;
+
+    auto result = vkCreateDescriptorPool(_device, &poolInfo, nullptr, &_descriptorPool);
+    if (result != VK_SUCCESS)
+    {
+        throw VulkanException("Can't create Vulkan texture table descriptor pool", result);
+    }
+
+    VkDescriptorSetAllocateInfo allocInfo {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = _descriptorPool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &_descriptorSetLayout;
+
+    if (vkAllocateDescriptorSets(_device, &allocInfo, &_descriptorSet) != VK_SUCCESS)
+    {
+        throw VulkanException("Can't allocate Vulkan texture table descriptor set");
+    }
+}
+
+void VulkanTextureTable::deleteDescriptorSet()
+{
+    vkDestroyDescriptorPool(_device, _descriptorPool, nullptr);
+    vkDestroyDescriptorSetLayout(_device, _descriptorSetLayout, nullptr);
+}
+
+} // namespace SVE
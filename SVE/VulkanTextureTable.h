@@ -0,0 +1,69 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include "VulkanHeaders.h"
+#include <vector>
+#include <string>
+#include <unordered_map>
+
+namespace SVE
+{
+class VulkanInstance;
+
+// Global bindless texture array (VK_EXT_descriptor_indexing).
+// Materials with bindless shaders register their textures here and pass indices with push constants,
+// so materials which differ only in textures share pipeline and don't have per-material samplers.
+class VulkanTextureTable
+{
+public:
+    // Table set follows per-pass set and all material stage sets
+    static const uint32_t TableSet = 4;
+    // Texture indices of a material are pushed as uvec4
+    static const uint32_t MaxMaterialTextures = 4;
+
+    // Pipeline and layout shared by bindless materials with the same shaders and render state
+    struct SharedPipeline
+    {
+        VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        VkPipeline subpassPipeline[2] = {};
+        // pipeline is recreated by first material reset after resize
+        VkExtent2D extent {};
+        uint32_t materialCount = 0;
+    };
+
+    VulkanTextureTable(VulkanInstance* vulkanInstance, uint32_t maxTextureCount);
+    ~VulkanTextureTable();
+
+    VkDescriptorSetLayout getDescriptorSetLayout() const;
+    VkPushConstantRange getPushConstantRange() const;
+
+    uint32_t addTexture(VkImageView imageView, VkSampler sampler);
+    void removeTexture(uint32_t index);
+
+    SharedPipeline* acquirePipeline(const std::string& key);
+    void releasePipeline(const std::string& key);
+
+    void bind(VkCommandBuffer commandBuffer, VkPipelineLayout pipelineLayout) const;
+
+private:
+    void createDescriptorSet();
+    void deleteDescriptorSet();
+
+private:
+    VulkanInstance* _vulkanInstance;
+    VkDevice _device;
+    uint32_t _maxTextureCount;
+
+    VkDescriptorSetLayout _descriptorSetLayout = VK_NULL_HANDLE;
+    VkDescriptorPool _descriptorPool = VK_NULL_HANDLE;
+    VkDescriptorSet _descriptorSet = VK_NULL_HANDLE;
+
+    uint32_t _textureCount = 0;
+    // indices of removed textures, reused by new ones
+    std::vector<uint32_t> _freeIndices;
+    std::unordered_map<std::string, SharedPipeline> _pipelineMap;
+};
+
+} // namespace SVE
@@ -0,0 +1,70 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#include "VulkanTransformBuffer.h"
+#include "VulkanInstance.h"
+#include "VulkanException.h"
+#include <algorithm>
+
+namespace SVE
+{
+
+VulkanTransformBuffer::VulkanTransformBuffer(VulkanInstance* vulkanInstance, uint32_t capacity, uint32_t regionCount)
+    : _vulkanInstance(vulkanInstance)
+    , _capacity(std::max(capacity, 1u))
+{
+    auto alignment = std::max<VkDeviceSize>(vulkanInstance->getGPUInfo().limits.minStorageBufferOffsetAlignment, 16);
+    _regionSize = (sizeof(glm::mat4) * _capacity * 2 + alignment - 1) / alignment * alignment;
+
+    // culled range is written by instance culling compute shader
+    _vulkanInstance->getVulkanUtils().createBuffer(
+            _regionSize * regionCount,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+            VMA_MEMORY_USAGE_CPU_TO_GPU,
+            _buffer,
+            _allocation,
+            true);
+
+    void* data = nullptr;
+    if (vmaMapMemory(_vulkanInstance->getAllocator(), _allocation, &data) != VK_SUCCESS)
+        throw VulkanException("Can't map transform buffer memory");
+    _mappedData = reinterpret_cast<char*>(data);
+}
+
+VulkanTransformBuffer::~VulkanTransformBuffer()
+{
+    vmaUnmapMemory(_vulkanInstance->getAllocator(), _allocation);
+    vmaDestroyBuffer(_vulkanInstance->getAllocator(), _buffer, _allocation);
+}
+
+uint32_t VulkanTransformBuffer::getCapacity() const
+{
+    return _capacity;
+}
+
+uint32_t VulkanTransformBuffer::getCulledInstanceOffset() const
+{
+    return _capacity;
+}
+
+VkBuffer VulkanTransformBuffer::getBuffer() const
+{
+    return _buffer;
+}
+
+VkDeviceSize VulkanTransformBuffer::getRegionOffset(uint32_t imageIndex) const
+{
+    return _regionSize * imageIndex;
+}
+
+VkDeviceSize VulkanTransformBuffer::getRegionSize() const
+{
+    return _regionSize;
+}
+
+glm::mat4* VulkanTransformBuffer::getMappedData(uint32_t imageIndex) const
+{
+    return reinterpret_cast<glm::mat4*>(_mappedData + getRegionOffset(imageIndex));
+}
+
+} // namespace SVE
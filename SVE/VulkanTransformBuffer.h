@@ -0,0 +1,39 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include "VulkanHeaders.h"
+#include "Libs.h"
+#include <vulkan/vk_mem_alloc.h>
+
+namespace SVE
+{
+class VulkanInstance;
+
+// Per-frame model matrices of all instanced entities, shared by instanced materials.
+// Persistently mapped storage buffer, split to regions per swapchain image.
+// Instance batches are drawn with firstInstance set to their offset in the region.
+// Second half of the region is filled by GPU culling with visible transforms only.
+class VulkanTransformBuffer
+{
+public:
+    VulkanTransformBuffer(VulkanInstance* vulkanInstance, uint32_t capacity, uint32_t regionCount);
+    ~VulkanTransformBuffer();
+
+    uint32_t getCapacity() const;
+    uint32_t getCulledInstanceOffset() const;
+    VkBuffer getBuffer() const;
+    VkDeviceSize getRegionOffset(uint32_t imageIndex) const;
+    VkDeviceSize getRegionSize() const;
+    glm::mat4* getMappedData(uint32_t imageIndex) const;
+
+private:
+    VulkanInstance* _vulkanInstance;
+    uint32_t _capacity;
+    VkDeviceSize _regionSize;
+    VkBuffer _buffer = VK_NULL_HANDLE;
+    VmaAllocation _allocation = VK_NULL_HANDLE;
+    char* _mappedData = nullptr;
+};
+
+} // namespace SVE
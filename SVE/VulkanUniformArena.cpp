@@ -0,0 +1,149 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#include "VulkanUniformArena.h"
+#include "VulkanInstance.h"
+#include "VulkanException.h"
+#include <algorithm>
+#include <iterator>
+
+namespace SVE
+{
+
+namespace
+{
+
+VkDeviceSize alignSize(VkDeviceSize size, VkDeviceSize alignment)
+{
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+} // anon namespace
+
+VulkanUniformArena::VulkanUniformArena(VulkanInstance* vulkanInstance, VkDeviceSize blockSize, uint32_t regionCount)
+    : _vulkanInstance(vulkanInstance)
+    , _alignment(std::max<VkDeviceSize>(vulkanInstance->getGPUInfo().limits.minUniformBufferOffsetAlignment, 16))
+    , _regionCount(regionCount)
+{
+    _regionSize = alignSize(blockSize, _alignment);
+    createBlock();
+}
+
+VulkanUniformArena::~VulkanUniformArena()
+{
+    deleteBlocks();
+}
+
+UniformSlot VulkanUniformArena::allocate(VkDeviceSize size)
+{
+    size = alignSize(size, _alignment);
+    if (size > _regionSize)
+        throw VulkanException("Uniform data is bigger than uniform arena block");
+
+    for (auto block = 0u; ; block++)
+    {
+        if (block == _blocks.size())
+            createBlock();
+
+        auto& freeRanges = _blocks[block].freeRanges;
+        for (auto iter = freeRanges.begin(); iter != freeRanges.end(); ++iter)
+        {
+            if (iter->second < size)
+                continue;
+
+            UniformSlot slot;
+            slot.block = block;
+            slot.offset = iter->first;
+            slot.size = size;
+
+            auto rangeSize = iter->second;
+            freeRanges.erase(iter);
+            if (rangeSize > size)
+                freeRanges.emplace(slot.offset + size, rangeSize - size);
+
+            return slot;
+        }
+    }
+}
+
+void VulkanUniformArena::free(const UniformSlot& slot)
+{
+    if (slot.size == 0)
+        return;
+
+    auto& freeRanges = _blocks[slot.block].freeRanges;
+    auto iter = freeRanges.emplace(slot.offset, slot.size).first;
+
+    // merge with neighbour ranges
+    auto next = std::next(iter);
+    if (next != freeRanges.end() && iter->first + iter->second == next->first)
+    {
+        iter->second += next->second;
+        freeRanges.erase(next);
+    }
+    if (iter != freeRanges.begin())
+    {
+        auto prev = std::prev(iter);
+        if (prev->first + prev->second == iter->first)
+        {
+            prev->second += iter->second;
+            freeRanges.erase(iter);
+        }
+    }
+}
+
+VkDeviceSize VulkanUniformArena::getAlignment() const
+{
+    return _alignment;
+}
+
+uint32_t VulkanUniformArena::getBlockCount() const
+{
+    return static_cast<uint32_t>(_blocks.size());
+}
+
+VkBuffer VulkanUniformArena::getBuffer(uint32_t block) const
+{
+    return _blocks[block].buffer;
+}
+
+uint32_t VulkanUniformArena::getDynamicOffset(const UniformSlot& slot, uint32_t imageIndex) const
+{
+    return static_cast<uint32_t>(_regionSize * imageIndex + slot.offset);
+}
+
+char* VulkanUniformArena::getMappedData(const UniformSlot& slot, uint32_t imageIndex) const
+{
+    return _blocks[slot.block].mappedData + getDynamicOffset(slot, imageIndex);
+}
+
+void VulkanUniformArena::createBlock()
+{
+    Block block;
+    _vulkanInstance->getVulkanUtils().createBuffer(
+            _regionSize * _regionCount,
+            VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+            VMA_MEMORY_USAGE_CPU_TO_GPU,
+            block.buffer,
+            block.allocation);
+
+    void* data = nullptr;
+    if (vmaMapMemory(_vulkanInstance->getAllocator(), block.allocation, &data) != VK_SUCCESS)
+        throw VulkanException("Can't map uniform arena memory");
+    block.mappedData = reinterpret_cast<char*>(data);
+    block.freeRanges.emplace(0, _regionSize);
+
+    _blocks.push_back(std::move(block));
+}
+
+void VulkanUniformArena::deleteBlocks()
+{
+    for (auto& block : _blocks)
+    {
+        vmaUnmapMemory(_vulkanInstance->getAllocator(), block.allocation);
+        vmaDestroyBuffer(_vulkanInstance->getAllocator(), block.buffer, block.allocation);
+    }
+    _blocks.clear();
+}
+
+} // namespace SVE
@@ -0,0 +1,61 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include "VulkanHeaders.h"
+#include <vulkan/vk_mem_alloc.h>
+#include <vector>
+#include <map>
+
+namespace SVE
+{
+class VulkanInstance;
+
+// Location of instance uniform data in the arena (same in every swapchain image region)
+struct UniformSlot
+{
+    uint32_t block = 0;
+    VkDeviceSize offset = 0;
+    VkDeviceSize size = 0;
+};
+
+// Persistently mapped uniform memory, shared by all materials.
+// Each block is a single buffer, split to regions per swapchain image. Slots are suballocated in blocks,
+// so creating material instances doesn't create any Vulkan objects, and data is bound with dynamic offsets.
+class VulkanUniformArena
+{
+public:
+    VulkanUniformArena(VulkanInstance* vulkanInstance, VkDeviceSize blockSize, uint32_t regionCount);
+    ~VulkanUniformArena();
+
+    UniformSlot allocate(VkDeviceSize size);
+    void free(const UniformSlot& slot);
+
+    VkDeviceSize getAlignment() const;
+    uint32_t getBlockCount() const;
+    VkBuffer getBuffer(uint32_t block) const;
+    uint32_t getDynamicOffset(const UniformSlot& slot, uint32_t imageIndex) const;
+    char* getMappedData(const UniformSlot& slot, uint32_t imageIndex) const;
+
+private:
+    void createBlock();
+    void deleteBlocks();
+
+private:
+    struct Block
+    {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VmaAllocation allocation = VK_NULL_HANDLE;
+        char* mappedData = nullptr;
+        // free ranges, offset -> size
+        std::map<VkDeviceSize, VkDeviceSize> freeRanges;
+    };
+
+    VulkanInstance* _vulkanInstance;
+    VkDeviceSize _alignment;
+    VkDeviceSize _regionSize;
+    uint32_t _regionCount;
+    std::vector<Block> _blocks;
+};
+
+} // namespace SVE
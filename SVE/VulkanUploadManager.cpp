@@ -0,0 +1,512 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#include "VulkanUploadManager.h"
+#include "VulkanInstance.h"
+#include "VulkanUtils.h"
+#include "VulkanException.h"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+
+namespace SVE
+{
+
+namespace
+{
+
+VkDeviceSize alignSize(VkDeviceSize size, VkDeviceSize alignment)
+{
+    return (size + alignment - 1) / alignment * alignment;
+}
+
+} // anon namespace
+
+VulkanUploadManager::VulkanUploadManager(VulkanInstance* vulkanInstance, VkDeviceSize ringSize)
+    : _vulkanInstance(vulkanInstance)
+    , _device(vulkanInstance->getLogicalDevice())
+    , _isTransferQueue(vulkanInstance->isTransferQueue())
+    , _isReportEnabled(vulkanInstance->getEngineSettings().reportUploads)
+    , _ringSize(ringSize)
+    , _alignment(std::max<VkDeviceSize>(vulkanInstance->getGPUInfo().limits.optimalBufferCopyOffsetAlignment, 16))
+{
+    createRing();
+    createCommandPools();
+}
+
+VulkanUploadManager::~VulkanUploadManager()
+{
+    finish();
+
+    for (auto& batch : _freeBatches)
+        deleteBatch(batch);
+
+    deleteCommandPools();
+    deleteRing();
+}
+
+void VulkanUploadManager::uploadBuffer(const void* data, VkDeviceSize size, VkBuffer buffer, VkDeviceSize offset,
+                                       bool isShared)
+{
+    if (size == 0)
+        return;
+
+    VkDeviceSize stagingOffset;
+    auto stagingBuffer = allocateStaging(data, size, stagingOffset);
+
+    VkBufferCopy copyRegion {};
+    copyRegion.srcOffset = stagingOffset;
+    copyRegion.dstOffset = offset;
+    copyRegion.size = size;
+    vkCmdCopyBuffer(_currentBatch.commandBuffer, stagingBuffer, buffer, 1, &copyRegion);
+
+    // shared buffers don't change owner, so they only need memory barrier
+    if (isShared)
+        _isSharedBufferUploaded = true;
+    else if (std::find(_uploadedBuffers.begin(), _uploadedBuffers.end(), buffer) == _uploadedBuffers.end())
+        _uploadedBuffers.push_back(buffer);
+}
+
+void VulkanUploadManager::uploadImage(const void* data, VkDeviceSize size, VkImage image, VkFormat format,
+                                      uint32_t width, uint32_t height, uint32_t mipLevels, uint32_t layerCount)
+{
+    VkDeviceSize stagingOffset;
+    auto stagingBuffer = allocateStaging(data, size, stagingOffset);
+
+    // all levels are transfer destination, upper levels are blitted from the first one later
+    VkImageMemoryBarrier barrier {};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = image;
+    barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, mipLevels, 0, layerCount };
+    barrier.srcAccessMask = 0;
+    barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    vkCmdPipelineBarrier(_currentBatch.commandBuffer,
+                         VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0,
+                         0, nullptr,
+                         0, nullptr,
+                         1, &barrier);
+
+    // layers are tightly packed, so single region copies all of them
+    VkBufferImageCopy region {};
+    region.bufferOffset = stagingOffset;
+    region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, layerCount };
+    region.imageExtent = { width, height, 1 };
+    vkCmdCopyBufferToImage(_currentBatch.commandBuffer, stagingBuffer, image,
+                           VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+    _uploadedImages.push_back({ image, format, width, height, mipLevels, layerCount });
+}
+
+void VulkanUploadManager::flush()
+{
+    submitBatch();
+    retireBatches(false);
+}
+
+void VulkanUploadManager::finish()
+{
+    submitBatch();
+    retireBatches(true);
+}
+
+uint32_t VulkanUploadManager::getPendingBatchCount() const
+{
+    return static_cast<uint32_t>(_pendingBatches.size());
+}
+
+VkBuffer VulkanUploadManager::allocateStaging(const void* data, VkDeviceSize size, VkDeviceSize& offset)
+{
+    beginBatch();
+    _reportBytes += size;
+    _reportUploads++;
+
+    if (size > _ringSize)
+    {
+        VkBuffer stagingBuffer;
+        VmaAllocation stagingBufferMemory;
+        VulkanUtils(_vulkanInstance).createBuffer(size,
+                                                  VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                                  VMA_MEMORY_USAGE_CPU_ONLY,
+                                                  stagingBuffer,
+                                                  stagingBufferMemory);
+
+        void* stagingData;
+        vmaMapMemory(_vulkanInstance->getAllocator(), stagingBufferMemory, &stagingData);
+        memcpy(stagingData, data, static_cast<size_t>(size));
+        vmaUnmapMemory(_vulkanInstance->getAllocator(), stagingBufferMemory);
+
+        _currentBatch.stagingBuffers.emplace_back(stagingBuffer, stagingBufferMemory);
+        offset = 0;
+        return stagingBuffer;
+    }
+
+    while (!allocateRing(size, offset))
+    {
+        // ring space is freed by finished batches, current one should be submitted if it's the only user
+        if (_pendingBatches.empty())
+            submitBatch();
+        _reportRingWaits++;
+        waitOldestBatch();
+        beginBatch();
+    }
+
+    memcpy(_ringData + offset, data, static_cast<size_t>(size));
+    return _ringBuffer;
+}
+
+bool VulkanUploadManager::allocateRing(VkDeviceSize size, VkDeviceSize& offset)
+{
+    if (_ringUsed == 0)
+        _ringHead = 0;
+
+    auto ringOffset = alignSize(_ringHead, _alignment);
+    auto padding = ringOffset - _ringHead;
+    if (ringOffset + size > _ringSize)
+    {
+        // wrap, space till the end of ring is used by batch as padding
+        ringOffset = 0;
+        padding = _ringSize - _ringHead;
+    }
+
+    if (_ringUsed + padding + size > _ringSize)
+        return false;
+
+    offset = ringOffset;
+    _ringHead = ringOffset + size;
+    _ringUsed += padding + size;
+    _currentBatch.ringBytes += padding + size;
+    return true;
+}
+
+void VulkanUploadManager::beginBatch()
+{
+    if (_isRecording)
+        return;
+
+    if (!_freeBatches.empty())
+    {
+        _currentBatch = std::move(_freeBatches.back());
+        _freeBatches.pop_back();
+    }
+    else
+    {
+        _currentBatch = {};
+
+        VkCommandBufferAllocateInfo allocInfo {};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandPool = _commandPool;
+        allocInfo.commandBufferCount = 1;
+        if (vkAllocateCommandBuffers(_device, &allocInfo, &_currentBatch.commandBuffer) != VK_SUCCESS)
+            throw VulkanException("Can't allocate upload command buffer");
+
+        VkFenceCreateInfo fenceCreateInfo {};
+        fenceCreateInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        if (vkCreateFence(_device, &fenceCreateInfo, nullptr, &_currentBatch.fence) != VK_SUCCESS)
+            throw VulkanException("Can't create upload fence");
+
+        if (_isTransferQueue)
+        {
+            allocInfo.commandPool = _acquireCommandPool;
+            if (vkAllocateCommandBuffers(_device, &allocInfo, &_currentBatch.acquireCommandBuffer) != VK_SUCCESS)
+                throw VulkanException("Can't allocate upload command buffer");
+
+            VkSemaphoreCreateInfo semaphoreCreateInfo {};
+            semaphoreCreateInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+            if (vkCreateSemaphore(_device, &semaphoreCreateInfo, nullptr, &_currentBatch.semaphore) != VK_SUCCESS)
+                throw VulkanException("Can't create upload semaphore");
+        }
+    }
+    _currentBatch.ringBytes = 0;
+
+    VkCommandBufferBeginInfo beginInfo {};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vkBeginCommandBuffer(_currentBatch.commandBuffer, &beginInfo);
+    _isRecording = true;
+
+    if (!_isReportActive)
+    {
+        _isReportActive = true;
+        _reportStartTime = std::chrono::high_resolution_clock::now();
+    }
+}
+
+void VulkanUploadManager::submitBatch()
+{
+    if (!_isRecording)
+        return;
+
+    VkSubmitInfo submitInfo {};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+
+    if (_isTransferQueue)
+    {
+        // copies are made on transfer queue, then graphics queue acquires resources and generates mipmaps
+        recordReleaseBarriers(_currentBatch.commandBuffer);
+        vkEndCommandBuffer(_currentBatch.commandBuffer);
+
+        submitInfo.pCommandBuffers = &_currentBatch.commandBuffer;
+        submitInfo.signalSemaphoreCount = 1;
+        submitInfo.pSignalSemaphores = &_currentBatch.semaphore;
+        if (vkQueueSubmit(_vulkanInstance->getTransferQueue(), 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS)
+            throw VulkanException("Can't submit upload commands to transfer queue");
+
+        VkCommandBufferBeginInfo beginInfo {};
+        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+        vkBeginCommandBuffer(_currentBatch.acquireCommandBuffer, &beginInfo);
+        recordAcquireBarriers(_currentBatch.acquireCommandBuffer);
+        recordImagesFinalization(_currentBatch.acquireCommandBuffer);
+        vkEndCommandBuffer(_currentBatch.acquireCommandBuffer);
+
+        VkPipelineStageFlags waitStage = VK_PIPELINE_STAGE_TRANSFER_BIT;
+        submitInfo.pCommandBuffers = &_currentBatch.acquireCommandBuffer;
+        submitInfo.waitSemaphoreCount = 1;
+        submitInfo.pWaitSemaphores = &_currentBatch.semaphore;
+        submitInfo.pWaitDstStageMask = &waitStage;
+        submitInfo.signalSemaphoreCount = 0;
+        submitInfo.pSignalSemaphores = nullptr;
+    }
+    else
+    {
+        // buffers copies should be visible to all following graphics queue submits
+        if (!_uploadedBuffers.empty() || _isSharedBufferUploaded)
+        {
+            VkMemoryBarrier memoryBarrier {};
+            memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+            memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+            memoryBarrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+            vkCmdPipelineBarrier(_currentBatch.commandBuffer,
+                                 VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0,
+                                 1, &memoryBarrier,
+                                 0, nullptr,
+                                 0, nullptr);
+        }
+        recordImagesFinalization(_currentBatch.commandBuffer);
+        vkEndCommandBuffer(_currentBatch.commandBuffer);
+
+        submitInfo.pCommandBuffers = &_currentBatch.commandBuffer;
+    }
+
+    if (vkQueueSubmit(_vulkanInstance->getGraphicsQueue(), 1, &submitInfo, _currentBatch.fence) != VK_SUCCESS)
+        throw VulkanException("Can't submit upload commands to graphics queue");
+
+    _uploadedBuffers.clear();
+    _uploadedImages.clear();
+    _isSharedBufferUploaded = false;
+    _pendingBatches.push_back(std::move(_currentBatch));
+    _currentBatch = {};
+    _isRecording = false;
+    _reportBatches++;
+}
+
+void VulkanUploadManager::waitOldestBatch()
+{
+    vkWaitForFences(_device, 1, &_pendingBatches.front().fence, VK_TRUE, UINT64_MAX);
+    retireBatches(false);
+}
+
+void VulkanUploadManager::retireBatches(bool isWait)
+{
+    while (!_pendingBatches.empty())
+    {
+        auto& batch = _pendingBatches.front();
+        if (isWait)
+            vkWaitForFences(_device, 1, &batch.fence, VK_TRUE, UINT64_MAX);
+        else if (vkGetFenceStatus(_device, batch.fence) != VK_SUCCESS)
+            break;
+
+        _ringUsed -= batch.ringBytes;
+        for (auto& staging : batch.stagingBuffers)
+            vmaDestroyBuffer(_vulkanInstance->getAllocator(), staging.first, staging.second);
+        batch.stagingBuffers.clear();
+        vkResetFences(_device, 1, &batch.fence);
+
+        _freeBatches.push_back(std::move(batch));
+        _pendingBatches.pop_front();
+    }
+
+    updateReport();
+}
+
+void VulkanUploadManager::recordReleaseBarriers(VkCommandBuffer commandBuffer) const
+{
+    std::vector<VkBufferMemoryBarrier> bufferBarriers(_uploadedBuffers.size());
+    for (auto i = 0u; i < _uploadedBuffers.size(); i++)
+    {
+        auto& barrier = bufferBarriers[i];
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = 0;
+        barrier.srcQueueFamilyIndex = _vulkanInstance->getTransferQueueFamily();
+        barrier.dstQueueFamilyIndex = _vulkanInstance->getGraphicsQueueFamily();
+        barrier.buffer = _uploadedBuffers[i];
+        barrier.offset = 0;
+        barrier.size = VK_WHOLE_SIZE;
+    }
+
+    // images stay in transfer dst layout, mipmaps are generated after acquire
+    std::vector<VkImageMemoryBarrier> imageBarriers(_uploadedImages.size());
+    for (auto i = 0u; i < _uploadedImages.size(); i++)
+    {
+        auto& barrier = imageBarriers[i];
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = 0;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcQueueFamilyIndex = _vulkanInstance->getTransferQueueFamily();
+        barrier.dstQueueFamilyIndex = _vulkanInstance->getGraphicsQueueFamily();
+        barrier.image = _uploadedImages[i].image;
+        barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, _uploadedImages[i].mipLevels,
+                                     0, _uploadedImages[i].layerCount };
+    }
+
+    vkCmdPipelineBarrier(commandBuffer,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0,
+                         0, nullptr,
+                         static_cast<uint32_t>(bufferBarriers.size()), bufferBarriers.data(),
+                         static_cast<uint32_t>(imageBarriers.size()), imageBarriers.data());
+}
+
+void VulkanUploadManager::recordAcquireBarriers(VkCommandBuffer commandBuffer) const
+{
+    std::vector<VkBufferMemoryBarrier> bufferBarriers(_uploadedBuffers.size());
+    for (auto i = 0u; i < _uploadedBuffers.size(); i++)
+    {
+        auto& barrier = bufferBarriers[i];
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+        barrier.srcQueueFamilyIndex = _vulkanInstance->getTransferQueueFamily();
+        barrier.dstQueueFamilyIndex = _vulkanInstance->getGraphicsQueueFamily();
+        barrier.buffer = _uploadedBuffers[i];
+        barrier.offset = 0;
+        barrier.size = VK_WHOLE_SIZE;
+    }
+
+    std::vector<VkImageMemoryBarrier> imageBarriers(_uploadedImages.size());
+    for (auto i = 0u; i < _uploadedImages.size(); i++)
+    {
+        auto& barrier = imageBarriers[i];
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = 0;
+        barrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+        barrier.srcQueueFamilyIndex = _vulkanInstance->getTransferQueueFamily();
+        barrier.dstQueueFamilyIndex = _vulkanInstance->getGraphicsQueueFamily();
+        barrier.image = _uploadedImages[i].image;
+        barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, _uploadedImages[i].mipLevels,
+                                     0, _uploadedImages[i].layerCount };
+    }
+
+    VkMemoryBarrier memoryBarrier {};
+    memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    memoryBarrier.dstAccessMask = VK_ACCESS_MEMORY_READ_BIT;
+
+    vkCmdPipelineBarrier(commandBuffer,
+                         VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0,
+                         _isSharedBufferUploaded ? 1 : 0, &memoryBarrier,
+                         static_cast<uint32_t>(bufferBarriers.size()), bufferBarriers.data(),
+                         static_cast<uint32_t>(imageBarriers.size()), imageBarriers.data());
+}
+
+void VulkanUploadManager::recordImagesFinalization(VkCommandBuffer commandBuffer) const
+{
+    // blits need graphics queue, so mipmaps are generated here even with separate transfer queue
+    VulkanUtils vulkanUtils(_vulkanInstance);
+    for (const auto& image : _uploadedImages)
+    {
+        vulkanUtils.recordMipmapsGeneration(commandBuffer,
+                                            image.image,
+                                            image.format,
+                                            static_cast<int32_t>(image.width),
+                                            static_cast<int32_t>(image.height),
+                                            image.mipLevels,
+                                            image.layerCount);
+    }
+}
+
+void VulkanUploadManager::updateReport()
+{
+    if (!_isReportActive || _isRecording || !_pendingBatches.empty())
+        return;
+
+    // completion is detected on flush, so time includes up to a frame of latency
+    if (_isReportEnabled)
+    {
+        auto time = std::chrono::duration<double, std::milli>(std::chrono::high_resolution_clock::now() - _reportStartTime);
+        std::cout << "Uploaded " << _reportBytes / 1024 << " KB (" << _reportUploads << " copies, "
+                  << _reportBatches << " batches, " << _reportRingWaits << " ring waits) in "
+                  << time.count() << " ms" << std::endl;
+    }
+
+    _isReportActive = false;
+    _reportBytes = 0;
+    _reportUploads = 0;
+    _reportBatches = 0;
+    _reportRingWaits = 0;
+}
+
+void VulkanUploadManager::createRing()
+{
+    VulkanUtils(_vulkanInstance).createBuffer(_ringSize,
+                                              VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                              VMA_MEMORY_USAGE_CPU_ONLY,
+                                              _ringBuffer,
+                                              _ringAllocation);
+
+    void* data;
+    if (vmaMapMemory(_vulkanInstance->getAllocator(), _ringAllocation, &data) != VK_SUCCESS)
+        throw VulkanException("Can't map upload staging ring");
+    _ringData = reinterpret_cast<char*>(data);
+}
+
+void VulkanUploadManager::deleteRing()
+{
+    vmaUnmapMemory(_vulkanInstance->getAllocator(), _ringAllocation);
+    vmaDestroyBuffer(_vulkanInstance->getAllocator(), _ringBuffer, _ringAllocation);
+}
+
+void VulkanUploadManager::createCommandPools()
+{
+    VkCommandPoolCreateInfo poolInfo {};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    poolInfo.queueFamilyIndex = _vulkanInstance->getTransferQueueFamily();
+
+    if (vkCreateCommandPool(_device, &poolInfo, nullptr, &_commandPool) != VK_SUCCESS)
+        throw VulkanException("Can't create upload command pool");
+
+    if (_isTransferQueue)
+    {
+        poolInfo.queueFamilyIndex = _vulkanInstance->getGraphicsQueueFamily();
+        if (vkCreateCommandPool(_device, &poolInfo, nullptr, &_acquireCommandPool) != VK_SUCCESS)
+            throw VulkanException("Can't create upload command pool");
+    }
+}
+
+void VulkanUploadManager::deleteCommandPools()
+{
+    vkDestroyCommandPool(_device, _commandPool, nullptr);
+    if (_acquireCommandPool != VK_NULL_HANDLE)
+        vkDestroyCommandPool(_device, _acquireCommandPool, nullptr);
+}
+
+void VulkanUploadManager::deleteBatch(Batch& batch)
+{
+    // command buffers are freed with pools
+    vkDestroyFence(_device, batch.fence, nullptr);
+    if (batch.semaphore != VK_NULL_HANDLE)
+        vkDestroySemaphore(_device, batch.semaphore, nullptr);
+}
+
+} // namespace SVE
@@ -0,0 +1,120 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+#pragma once
+#include "VulkanHeaders.h"
+#include <vulkan/vk_mem_alloc.h>
+#include <vector>
+#include <deque>
+#include <chrono>
+
+namespace SVE
+{
+class VulkanInstance;
+
+// Uploads buffers and textures data to GPU-local memory without waiting for copies to finish.
+// Data is copied to persistently mapped staging ring, and copy commands are batched to a single command buffer,
+// which is submitted to transfer queue (graphics queue if there is no separate transfer family) on flush.
+// Fence of the batch frees its part of the ring. With separate transfer family, ownership of uploaded resources
+// is acquired by graphics queue submit, so graphics submits after flush can use them.
+class VulkanUploadManager
+{
+public:
+    VulkanUploadManager(VulkanInstance* vulkanInstance, VkDeviceSize ringSize);
+    ~VulkanUploadManager();
+
+    // Shared buffer is created with concurrent sharing by graphics and transfer queues (see VulkanUtils::createBuffer),
+    // so its parts can be uploaded while other parts are used by graphics queue
+    void uploadBuffer(const void* data, VkDeviceSize size, VkBuffer buffer, VkDeviceSize offset = 0,
+                      bool isShared = false);
+    // Layers are consecutive in data. Image should have transfer src and dst usage, it's left in shader read layout
+    // with mipmaps generated from the first level.
+    void uploadImage(const void* data, VkDeviceSize size, VkImage image, VkFormat format,
+                     uint32_t width, uint32_t height, uint32_t mipLevels, uint32_t layerCount = 1);
+
+    // Submits recorded uploads and frees ring space of finished batches
+    void flush();
+    // Submits recorded uploads and waits for all of them
+    void finish();
+
+    uint32_t getPendingBatchCount() const;
+
+private:
+    struct Batch
+    {
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        // ownership acquire and mipmaps generation on graphics queue, only with separate transfer family
+        VkCommandBuffer acquireCommandBuffer = VK_NULL_HANDLE;
+        VkSemaphore semaphore = VK_NULL_HANDLE;
+        VkFence fence = VK_NULL_HANDLE;
+        // ring bytes used by batch (with alignment and wrap padding)
+        VkDeviceSize ringBytes = 0;
+        // uploads larger than the ring have their own staging buffers
+        std::vector<std::pair<VkBuffer, VmaAllocation>> stagingBuffers;
+    };
+
+    struct UploadedImage
+    {
+        VkImage image;
+        VkFormat format;
+        uint32_t width;
+        uint32_t height;
+        uint32_t mipLevels;
+        uint32_t layerCount;
+    };
+
+    VkBuffer allocateStaging(const void* data, VkDeviceSize size, VkDeviceSize& offset);
+    bool allocateRing(VkDeviceSize size, VkDeviceSize& offset);
+    void beginBatch();
+    void submitBatch();
+    void waitOldestBatch();
+    void retireBatches(bool isWait);
+    void recordReleaseBarriers(VkCommandBuffer commandBuffer) const;
+    void recordAcquireBarriers(VkCommandBuffer commandBuffer) const;
+    void recordImagesFinalization(VkCommandBuffer commandBuffer) const;
+    void updateReport();
+
+    void createRing();
+    void deleteRing();
+    void createCommandPools();
+    void deleteCommandPools();
+    void deleteBatch(Batch& batch);
+
+private:
+    VulkanInstance* _vulkanInstance;
+    VkDevice _device;
+    bool _isTransferQueue;
+    bool _isReportEnabled;
+
+    VkDeviceSize _ringSize;
+    VkDeviceSize _alignment;
+    VkBuffer _ringBuffer = VK_NULL_HANDLE;
+    VmaAllocation _ringAllocation = VK_NULL_HANDLE;
+    char* _ringData = nullptr;
+    VkDeviceSize _ringHead = 0;
+    VkDeviceSize _ringUsed = 0;
+
+    VkCommandPool _commandPool = VK_NULL_HANDLE;
+    VkCommandPool _acquireCommandPool = VK_NULL_HANDLE;
+
+    // batch which is recorded, submitted batches in submit order and finished ones ready for reuse
+    Batch _currentBatch;
+    bool _isRecording = false;
+    std::deque<Batch> _pendingBatches;
+    std::vector<Batch> _freeBatches;
+
+    // resources of current batch, which need barriers after copies
+    std::vector<VkBuffer> _uploadedBuffers;
+    bool _isSharedBufferUploaded = false;
+    std::vector<UploadedImage> _uploadedImages;
+
+    // uploads since there were no pending batches, reported when all of them are finished
+    bool _isReportActive = false;
+    std::chrono::high_resolution_clock::time_point _reportStartTime;
+    uint64_t _reportBytes = 0;
+    uint32_t _reportUploads = 0;
+    uint32_t _reportBatches = 0;
+    uint32_t _reportRingWaits = 0;
+};
+
+} // namespace SVE
@@ -9,11 +9,33 @@
 #include "VulkanUtils.h"
 #include "VulkanInstance.h"
 #include "VulkanException.h"
+#include "VulkanUploadManager.h"
 
 
 namespace SVE
 {
 
+namespace
+{
+
+uint32_t getFormatSize(VkFormat format)
+{
+    switch (format)
+    {
+        case VK_FORMAT_D16_UNORM:
+            return 2;
+        case VK_FORMAT_D32_SFLOAT_S8_UINT:
+            return 8;
+        case VK_FORMAT_R16G16B16A16_SFLOAT:
+            return 8;
+        default:
+            // 8 bit RGBA surface formats, D32 and D24S8
+            return 4;
+    }
+}
+
+} // anon namespace
+
 VulkanUtils::VulkanUtils(const VulkanInstance *instance)
     : _vulkanInstance(instance)
 {
@@ -30,7 +52,9 @@ void VulkanUtils::createBuffer(
         VkBufferUsageFlags usage,
         VmaMemoryUsage memoryUsage,
         VkBuffer& buffer,
-        VmaAllocation& allocation) const
+        VmaAllocation& allocation,
+        bool isSharedWithCompute,
+        bool isSharedWithTransfer) const
 {
     // Create buffer
     VkBufferCreateInfo bufferInfo {};
@@ -39,6 +63,19 @@ void VulkanUtils::createBuffer(
     bufferInfo.usage = usage;
     bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 
+    uint32_t queueFamilies[3] = { _vulkanInstance->getGraphicsQueueFamily() };
+    uint32_t queueFamilyCount = 1;
+    if (isSharedWithCompute && _vulkanInstance->isAsyncCompute())
+        queueFamilies[queueFamilyCount++] = _vulkanInstance->getComputeQueueFamily();
+    if (isSharedWithTransfer && _vulkanInstance->isTransferQueue())
+        queueFamilies[queueFamilyCount++] = _vulkanInstance->getTransferQueueFamily();
+    if (queueFamilyCount > 1)
+    {
+        bufferInfo.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        bufferInfo.queueFamilyIndexCount = queueFamilyCount;
+        bufferInfo.pQueueFamilyIndices = queueFamilies;
+    }
+
 
     VmaAllocationCreateInfo allocInfo = {};
     allocInfo.usage = memoryUsage;
@@ -89,35 +126,19 @@ void VulkanUtils::copyBufferToImage(VkBuffer buffer, VkImage image, uint32_t wid
 }
 
 void VulkanUtils::createOptimizedBuffer(const void *bufferData, VkDeviceSize bufferSize, VkBuffer &buffer,
-                                        VmaAllocation& allocation, VkBufferUsageFlags usage) const
+                                        VmaAllocation& allocation, VkBufferUsageFlags usage, bool isSharedWithCompute) const
 {
-    // create temporary slow CPU visible memory
-    VkBuffer stagingBuffer;
-    VmaAllocation stagingBufferMemory;
-    createBuffer(bufferSize,
-                 VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
-                 VMA_MEMORY_USAGE_CPU_ONLY,
-                 stagingBuffer,
-                 stagingBufferMemory);
-
-    // Fill temporary buffer with vertex/index data
-    void* data;
-    vmaMapMemory(_vulkanInstance->getAllocator(), stagingBufferMemory, &data);
-    memcpy(data, bufferData, (size_t) bufferSize);
-    vmaUnmapMemory(_vulkanInstance->getAllocator(), stagingBufferMemory);
-
-    // create fast GPU-local buffer for data
+    // create fast GPU-local buffer for data, buffer shared with compute is concurrent, so it's shared with transfer too
     createBuffer(bufferSize,
                  VK_BUFFER_USAGE_TRANSFER_DST_BIT | usage,
                  VMA_MEMORY_USAGE_GPU_ONLY,
                  buffer,
-                 allocation);
-
-    // copy slow CPU-visible buffer to fast GPU-local
-    copyBuffer(stagingBuffer, buffer, bufferSize);
+                 allocation,
+                 isSharedWithCompute,
+                 isSharedWithCompute);
 
-    // destroy CPU-visible buffer
-    vmaDestroyBuffer(_vulkanInstance->getAllocator(), stagingBuffer, stagingBufferMemory);
+    // copy data through staging ring, it will be available for graphics submits after upload flush
+    _vulkanInstance->getUploadManager()->uploadBuffer(bufferData, bufferSize, buffer, 0, isSharedWithCompute);
 }
 
 void VulkanUtils::createImage(uint32_t width,
@@ -160,7 +181,14 @@ void VulkanUtils::createImage(uint32_t width,
     VkMemoryAllocateInfo allocInfo {};
     allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
     allocInfo.allocationSize = memoryRequirements.size;
-    allocInfo.memoryTypeIndex = findVulkanMemoryType(memoryRequirements.memoryTypeBits, properties);
+    // transient attachments which are never stored don't need memory on tile-based GPUs
+    if (!(usage & VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT)
+        || !findVulkanMemoryType(memoryRequirements.memoryTypeBits,
+                                 properties | VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT,
+                                 allocInfo.memoryTypeIndex))
+    {
+        allocInfo.memoryTypeIndex = findVulkanMemoryType(memoryRequirements.memoryTypeBits, properties);
+    }
 
     if (vkAllocateMemory(_vulkanInstance->getLogicalDevice(), &allocInfo, nullptr, &imageMemory) != VK_SUCCESS)
     {
@@ -254,17 +282,29 @@ void VulkanUtils::generateMipmaps(
         int32_t texWidth,
         int32_t texHeight,
         uint32_t mipLevels) const
+{
+    VkCommandBuffer commandBuffer = beginRecordingCommands();
+    recordMipmapsGeneration(commandBuffer, image, imageFormat, texWidth, texHeight, mipLevels);
+    endRecordingAndSubmitCommands(commandBuffer);
+}
+
+void VulkanUtils::recordMipmapsGeneration(
+        VkCommandBuffer commandBuffer,
+        VkImage image,
+        VkFormat imageFormat,
+        int32_t texWidth,
+        int32_t texHeight,
+        uint32_t mipLevels,
+        uint32_t layersCount) const
 {
     // Check if image format supports linear blitting
     VkFormatProperties formatProperties;
     vkGetPhysicalDeviceFormatProperties(_vulkanInstance->getGPU(), imageFormat, &formatProperties);
 
-    if (!(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)) {
+    if (mipLevels > 1 && !(formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)) {
         throw std::runtime_error("GPU does not support linear blitting!");
     }
 
-    VkCommandBuffer commandBuffer = beginRecordingCommands();
-
     // Create template struct for transition commands
     VkImageMemoryBarrier barrier {};
     barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
@@ -273,7 +313,7 @@ void VulkanUtils::generateMipmaps(
     barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
     barrier.subresourceRange.baseArrayLayer = 0;
-    barrier.subresourceRange.layerCount = 1;
+    barrier.subresourceRange.layerCount = layersCount;
     barrier.subresourceRange.levelCount = 1;
 
     int32_t mipWidth = texWidth;
@@ -299,13 +339,13 @@ void VulkanUtils::generateMipmaps(
         blit.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
         blit.srcSubresource.mipLevel = i - 1;
         blit.srcSubresource.baseArrayLayer = 0;
-        blit.srcSubresource.layerCount = 1;
+        blit.srcSubresource.layerCount = layersCount;
         blit.dstOffsets[0] = {0, 0, 0};  // destination region to blit
         blit.dstOffsets[1] = { mipWidth > 1 ? mipWidth / 2 : 1, mipHeight > 1 ? mipHeight / 2 : 1, 1 };
         blit.dstSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
         blit.dstSubresource.mipLevel = i;
         blit.dstSubresource.baseArrayLayer = 0;
-        blit.dstSubresource.layerCount = 1;
+        blit.dstSubresource.layerCount = layersCount;
 
         // Blit previous mip image (or source image) to smaller mip level image
         vkCmdBlitImage(commandBuffer,
@@ -341,8 +381,6 @@ void VulkanUtils::generateMipmaps(
                          0, nullptr,
                          0, nullptr,
                          1, &barrier);
-
-    endRecordingAndSubmitCommands(commandBuffer);
 }
 
 VkCommandBuffer VulkanUtils::beginRecordingCommands() const
@@ -429,6 +467,15 @@ void VulkanUtils::transitionImageLayout(VkImage image,
 }
 
 uint32_t VulkanUtils::findVulkanMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const
+{
+    uint32_t typeIndex;
+    if (!findVulkanMemoryType(typeFilter, properties, typeIndex))
+        throw VulkanException("Can't find suitable Vulkan device memory");
+
+    return typeIndex;
+}
+
+bool VulkanUtils::findVulkanMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties, uint32_t& typeIndex) const
 {
     VkPhysicalDeviceMemoryProperties memoryProperties;
     vkGetPhysicalDeviceMemoryProperties(_vulkanInstance->getGPU(), &memoryProperties);
@@ -437,11 +484,28 @@ uint32_t VulkanUtils::findVulkanMemoryType(uint32_t typeFilter, VkMemoryProperty
     {
         if ((typeFilter & (1 << i)) && (memoryProperties.memoryTypes[i].propertyFlags & properties) == properties)
         {
-            return i;
+            typeIndex = i;
+            return true;
         }
     }
 
-    throw VulkanException("Can't find suitable Vulkan device memory");
+    return false;
+}
+
+VulkanUtils::AttachmentTraffic VulkanUtils::getAttachmentTraffic(const std::vector<VkAttachmentDescription>& attachments,
+                                                                 VkExtent2D extent)
+{
+    AttachmentTraffic traffic;
+    for (const auto& attachment : attachments)
+    {
+        uint64_t size = static_cast<uint64_t>(extent.width) * extent.height * attachment.samples
+                        * getFormatSize(attachment.format);
+        if (attachment.loadOp == VK_ATTACHMENT_LOAD_OP_LOAD)
+            traffic.loadBytes += size;
+        if (attachment.storeOp == VK_ATTACHMENT_STORE_OP_STORE)
+            traffic.storeBytes += size;
+    }
+    return traffic;
 }
 
 VkFormat VulkanUtils::findSupportedFormat(const std::vector<VkFormat>& candidates,
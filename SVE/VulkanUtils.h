@@ -21,25 +21,44 @@ public:
         VkPipelineStageFlags pipelineStageFlags;
     };
 
+    // Estimated bytes moved between tile memory and main memory by render pass attachments
+    struct AttachmentTraffic
+    {
+        uint64_t loadBytes = 0;
+        uint64_t storeBytes = 0;
+
+        AttachmentTraffic& operator+=(const AttachmentTraffic& other)
+        {
+            loadBytes += other.loadBytes;
+            storeBytes += other.storeBytes;
+            return *this;
+        }
+    };
+
     VulkanUtils();
     explicit VulkanUtils(const VulkanInstance* instance);
 
+    // Shared buffer is used concurrently by graphics and async compute (or transfer) queues,
+    // without ownership transfers
     void createBuffer(
             VkDeviceSize size,
             VkBufferUsageFlags usage,
             VmaMemoryUsage memoryUsage,
             VkBuffer& buffer,
-            VmaAllocation& allocation) const;
+            VmaAllocation& allocation,
+            bool isSharedWithCompute = false,
+            bool isSharedWithTransfer = false) const;
     void copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size) const;
     void copyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height) const;
 
-    // This method will create fast GPU-local buffer (using transitional temporary CPU visible buffer)
+    // This method will create fast GPU-local buffer, data is copied by upload manager without waiting for it
     void createOptimizedBuffer(
             const void* bufferData,
             VkDeviceSize bufferSize,
             VkBuffer &buffer,
             VmaAllocation& allocation,
-            VkBufferUsageFlags usage) const;
+            VkBufferUsageFlags usage,
+            bool isSharedWithCompute = false) const;
 
     void createImage(uint32_t width,
                      uint32_t height,
@@ -75,6 +94,14 @@ public:
                          int32_t texWidth,
                          int32_t texHeight,
                          uint32_t mipLevels) const;
+    // Image should be in transfer dst layout, all levels are left in shader read layout
+    void recordMipmapsGeneration(VkCommandBuffer commandBuffer,
+                                 VkImage image,
+                                 VkFormat imageFormat,
+                                 int32_t texWidth,
+                                 int32_t texHeight,
+                                 uint32_t mipLevels,
+                                 uint32_t layersCount = 1) const;
 
     VkCommandBuffer beginRecordingCommands() const;
     void endRecordingAndSubmitCommands(VkCommandBuffer commandBuffer) const;
@@ -89,10 +116,16 @@ public:
                                uint32_t baseLayer = 0) const;
 
     uint32_t findVulkanMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) const;
+    // Same as above, but returns false instead of throwing if there is no such memory
+    bool findVulkanMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties, uint32_t& typeIndex) const;
     VkFormat findSupportedFormat(const std::vector<VkFormat>& candidates,
                                  VkImageTiling tiling,
                                  VkFormatFeatureFlags features) const;
 
+    // Attachments which are loaded or stored once per render pass, extent is render area
+    static AttachmentTraffic getAttachmentTraffic(const std::vector<VkAttachmentDescription>& attachments,
+                                                  VkExtent2D extent);
+
 private:
     const VulkanInstance* _vulkanInstance;
 };
@@ -92,7 +92,7 @@ void VulkanWater::reallocateCommandBuffers()
     _commandBuffer[1] = _vulkanInstance->createCommandBuffer(BUFFER_INDEX_WATER_REFRACTION);
 }
 
-void VulkanWater::startRenderCommandBufferCreation(VulkanWater::PassType passType)
+void VulkanWater::startRenderCommandBufferCreation(VulkanWater::PassType passType, VkSubpassContents subpassContents)
 {
     auto passIndex = static_cast<uint8_t>(passType);
 
@@ -121,7 +121,11 @@ void VulkanWater::startRenderCommandBufferCreation(VulkanWater::PassType passTyp
     renderPassBeginInfo.clearValueCount = clearValues.size();
     renderPassBeginInfo.pClearValues = clearValues.data();
 
-    vkCmdBeginRenderPass(_commandBuffer[passIndex], &renderPassBeginInfo, VK_SUBPASS_CONTENTS_INLINE);
+    vkCmdBeginRenderPass(_commandBuffer[passIndex], &renderPassBeginInfo, subpassContents);
+
+    // dynamic state isn't allowed in primary buffer, secondary buffers set it from record info
+    if (subpassContents == VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS)
+        return;
 
     // TODO: Add depth bias constants to configuration
     vkCmdSetDepthBias(
@@ -161,6 +165,21 @@ void VulkanWater::endRenderCommandBufferCreation(VulkanWater::PassType passType)
     }
 }
 
+RenderPassRecordInfo VulkanWater::getRecordInfo(VulkanWater::PassType passType) const
+{
+    auto passIndex = static_cast<uint8_t>(passType);
+
+    RenderPassRecordInfo recordInfo;
+    recordInfo.renderPass = _renderPass[passIndex];
+    recordInfo.framebuffer = _framebuffer[passIndex];
+    recordInfo.extent = { _width[passIndex], _height[passIndex] };
+    recordInfo.useDepthBias = true;
+    recordInfo.depthBiasConstant = 1.25f;
+    recordInfo.depthBiasSlope = 1.75f;
+
+    return recordInfo;
+}
+
 void VulkanWater::createRenderPasses()
 {
     auto depthFormat = _vulkanInstance->getDepthFormat();
@@ -3,6 +3,7 @@
 // Licensed under the MIT License
 #pragma once
 #include "VulkanHeaders.h"
+#include "VulkanCommandsManager.h"
 #include <memory>
 
 namespace SVE
@@ -31,8 +32,9 @@ public:
     void fillUniformData(UniformData& data, PassType passType);
 
     void reallocateCommandBuffers();
-    void startRenderCommandBufferCreation(PassType passType);
+    void startRenderCommandBufferCreation(PassType passType, VkSubpassContents subpassContents = VK_SUBPASS_CONTENTS_INLINE);
     void endRenderCommandBufferCreation(PassType passType);
+    RenderPassRecordInfo getRecordInfo(PassType passType) const;
 private:
     void createRenderPasses();
     void deleteRenderPasses();
@@ -16,10 +16,18 @@ LOCAL_CPP_FEATURES := exceptions
 LOCAL_SRC_FILES := vulkan_wrapper.cpp \
     AndroidFS.h \
     AndroidFS.cpp \
+    SVE/AllocationCounter.cpp \
+    SVE/AllocationCounter.h \
+    SVE/AnimationPoseCache.cpp \
+    SVE/AnimationPoseCache.h \
+    SVE/AnimationUpdater.cpp \
+    SVE/AnimationUpdater.h \
     SVE/CameraNode.cpp \
     SVE/CameraNode.h \
     SVE/CameraSettings.cpp \
     SVE/CameraSettings.h \
+    SVE/CommandsRecorder.cpp \
+    SVE/CommandsRecorder.h \
     SVE/ComputeEntity.cpp \
     SVE/ComputeEntity.h \
     SVE/ComputeSettings.cpp \
@@ -32,6 +40,11 @@ LOCAL_SRC_FILES := vulkan_wrapper.cpp \
     SVE/Entity.h \
     SVE/FontManager.cpp \
     SVE/FontManager.h \
+    SVE/FrameBenchmark.cpp \
+    SVE/FrameBenchmark.h \
+    SVE/FrameStats.h \
+    SVE/Frustum.cpp \
+    SVE/Frustum.h \
     SVE/Libs.h \
     SVE/LightManager.cpp \
     SVE/LightManager.h \
@@ -46,11 +59,15 @@ LOCAL_SRC_FILES := vulkan_wrapper.cpp \
     SVE/MaterialSettings.h \
     SVE/Mesh.cpp \
     SVE/Mesh.h \
+    SVE/MeshBaker.cpp \
+    SVE/MeshBaker.h \
     SVE/MeshDefs.h \
     SVE/MeshEntity.cpp \
     SVE/MeshEntity.h \
     SVE/MeshManager.cpp \
     SVE/MeshManager.h \
+    SVE/MeshOptimizer.cpp \
+    SVE/MeshOptimizer.h \
     SVE/MeshSettings.cpp \
     SVE/MeshSettings.h \
     SVE/OverlayEntity.cpp \
@@ -68,6 +85,10 @@ LOCAL_SRC_FILES := vulkan_wrapper.cpp \
     SVE/PipelineCacheManager.h \
     SVE/PostEffectManager.cpp \
     SVE/PostEffectManager.h \
+    SVE/RenderGraph.cpp \
+    SVE/RenderGraph.h \
+    SVE/RenderList.cpp \
+    SVE/RenderList.h \
     SVE/ResourceManager.cpp \
     SVE/ResourceManager.h \
     SVE/SceneManager.cpp \
@@ -82,21 +103,31 @@ LOCAL_SRC_FILES := vulkan_wrapper.cpp \
     SVE/ShaderSettings.h \
     SVE/ShadowMap.cpp \
     SVE/ShadowMap.h \
+    SVE/SkeletalAnimation.cpp \
+    SVE/SkeletalAnimation.h \
     SVE/Skybox.cpp \
     SVE/Skybox.h \
     SVE/TextEntity.cpp \
     SVE/TextEntity.h \
     SVE/TextSettings.h \
+    SVE/ThreadPool.cpp \
+    SVE/ThreadPool.h \
     SVE/Utils.h \
     SVE/VulkanCommandsManager.h \
     SVE/VulkanComputeEntity.cpp \
     SVE/VulkanComputeEntity.h \
+    SVE/VulkanDescriptorPoolSet.cpp \
+    SVE/VulkanDescriptorPoolSet.h \
     SVE/VulkanDirectShadowMap.cpp \
     SVE/VulkanDirectShadowMap.h \
     SVE/VulkanException.cpp \
     SVE/VulkanException.h \
+    SVE/VulkanGeometryArena.cpp \
+    SVE/VulkanGeometryArena.h \
     SVE/VulkanInstance.cpp \
     SVE/VulkanInstance.h \
+    SVE/VulkanInstanceCulling.cpp \
+    SVE/VulkanInstanceCulling.h \
     SVE/VulkanMaterial.cpp \
     SVE/VulkanMaterial.h \
     SVE/VulkanMesh.cpp \
@@ -105,6 +136,8 @@ LOCAL_SRC_FILES := vulkan_wrapper.cpp \
     SVE/VulkanParticleSystem.h \
     SVE/VulkanPassInfo.cpp \
     SVE/VulkanPassInfo.h \
+    SVE/VulkanPassUniforms.cpp \
+    SVE/VulkanPassUniforms.h \
     SVE/VulkanPointShadowMap.cpp \
     SVE/VulkanPointShadowMap.h \
     SVE/VulkanPostEffect.cpp \
@@ -115,6 +148,14 @@ LOCAL_SRC_FILES := vulkan_wrapper.cpp \
     SVE/VulkanScreenQuad.h \
     SVE/VulkanShaderInfo.cpp \
     SVE/VulkanShaderInfo.h \
+    SVE/VulkanTextureTable.cpp \
+    SVE/VulkanTextureTable.h \
+    SVE/VulkanTransformBuffer.cpp \
+    SVE/VulkanTransformBuffer.h \
+    SVE/VulkanUniformArena.cpp \
+    SVE/VulkanUniformArena.h \
+    SVE/VulkanUploadManager.cpp \
+    SVE/VulkanUploadManager.h \
     SVE/VulkanUtils.cpp \
     SVE/VulkanUtils.h \
     SVE/VulkanWater.cpp \
@@ -12,6 +12,37 @@
 namespace SVE
 {
 
+namespace
+{
+
+// Uncompressed assets are mapped from apk, buffer is valid while asset is open
+class AssetFileContent : public FileContent
+{
+public:
+    AssetFileContent(FSEntityPtr file, const void* data, size_t size)
+        : _file(std::move(file))
+        , _data(static_cast<const char*>(data))
+        , _size(size)
+    {}
+
+    const char* getData() const override
+    {
+        return _data;
+    }
+
+    size_t getSize() const override
+    {
+        return _size;
+    }
+
+private:
+    FSEntityPtr _file;
+    const char* _data;
+    size_t _size;
+};
+
+} // anon namespace
+
 AndroidFS::AndroidFS(AAssetManager *mgr)
     : _assetManager(mgr)
 {
@@ -80,6 +111,16 @@ std::string AndroidFS::getFileContent(FSEntityPtr file) const
     return result;
 }
 
+FileContentPtr AndroidFS::mapFileContent(FSEntityPtr file) const
+{
+    auto* fileHandle = std::static_pointer_cast<AndroidFSEntity>(file)->Handle;
+    const auto* data = AAsset_getBuffer(fileHandle);
+    if (!data)
+        return FileSystem::mapFileContent(file);
+
+    return std::make_shared<AssetFileContent>(file, data, AAsset_getLength(fileHandle));
+}
+
 FSEntityPtr AndroidFS::getEntity(const std::string& localPath, bool isDirectory) const
 {
     return std::make_shared<AndroidFSEntity>(localPath, isDirectory, _assetManager);
@@ -121,7 +162,7 @@ AndroidFSEntity::AndroidFSEntity(std::string path, bool isDir, AAssetManager* as
 
 AndroidFSEntity::~AndroidFSEntity()
 {
-    if (!_isDirectory)
+    if (!_isDirectory && Handle)
         AAsset_close(Handle);
     else
         AAssetDir_close(Dir);
@@ -134,7 +175,7 @@ bool AndroidFSEntity::isDirectory() const
 
 bool AndroidFSEntity::exist() const
 {
-    return true;
+    return _isDirectory || Handle != nullptr;
 }
 
 std::string AndroidFSEntity::getPath() const
@@ -4,8 +4,8 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
 
-layout(set = 1, binding = 0) uniform sampler2D texSampler;
-layout(set = 1, binding = 0) uniform sampler2D noiseSampler;
+layout(set = 2, binding = 0) uniform sampler2D texSampler;
+layout(set = 2, binding = 0) uniform sampler2D noiseSampler;
 
 layout(location = 0) in vec2 fragTexCoord;
 
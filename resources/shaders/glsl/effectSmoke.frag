@@ -4,7 +4,7 @@
 #extension GL_ARB_separate_shader_objects : enable
 #include "lighting.glsl"
 
-layout(set = 1, binding = 0) uniform UBO
+layout(set = 2, binding = 0) uniform UBO
 {
     vec4 cameraPos;
     MaterialInfo materialInfo;
@@ -3,9 +3,9 @@
 #extension GL_ARB_separate_shader_objects : enable
 #include "lighting.glsl"
 
-layout(set = 1, binding = 0) uniform sampler2D mainSampler;
-layout(set = 1, binding = 1) uniform sampler2D reflectSampler;
-layout(set = 1, binding = 2) uniform UBO
+layout(set = 2, binding = 0) uniform sampler2D mainSampler;
+layout(set = 2, binding = 1) uniform sampler2D reflectSampler;
+layout(set = 2, binding = 2) uniform UBO
 {
     vec4 cameraPos;
     DirLight dirLight;
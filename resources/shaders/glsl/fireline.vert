@@ -2,7 +2,7 @@
 #extension GL_ARB_separate_shader_objects : enable
 #include "staticrandom.glsl"
 
-layout (set = 0, binding = 0) uniform UBO
+layout (set = 1, binding = 0) uniform UBO
 {
     mat4 model;
     mat4 view;
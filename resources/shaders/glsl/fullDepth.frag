@@ -2,7 +2,7 @@
 #extension GL_ARB_separate_shader_objects : enable
 #include "lighting.glsl"
 
-layout(set = 2, binding = 0) uniform UBO
+layout(set = 3, binding = 0) uniform UBO
 {
 	PointLight pointLight[4];
 } ubo;
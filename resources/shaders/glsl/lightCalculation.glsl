@@ -44,38 +44,38 @@ vec3 calculateLight(vec3 normal, vec3 viewDir)
     vec3 lightEffect = vec3(ubo.materialInfo.ambient);
     float shadow = 1;
 
-    //if ((ubo.lightInfo.lightFlags & LI_DirectionalLight) != 0)
+    //if ((frameData.lightInfo.lightFlags & LI_DirectionalLight) != 0)
     //{
-        vec3 curLight = CalcDirLight(ubo.dirLight, normal, viewDir, ubo.materialInfo);
-        if (ubo.lightInfo.enableShadows != 0 && ubo.materialInfo.ignoreShadow == 0)
+        vec3 curLight = CalcDirLight(frameData.dirLight, normal, viewDir, ubo.materialInfo);
+        if (frameData.lightInfo.enableShadows != 0 && ubo.materialInfo.ignoreShadow == 0)
         {
             shadow = PCFShadowSunLight();
         }
         lightEffect += curLight * (shadow);
     //}
 
-    for (uint i = 0; i < ubo.lightInfo.lightLineNum; i++)
+    for (uint i = 0; i < frameData.lightInfo.lightLineNum; i++)
     {
-        lightEffect += CalcLineLight(ubo.lineLight[i], normal, fragPos, viewDir, ubo.materialInfo);
+        lightEffect += CalcLineLight(frameData.lineLight[i], normal, fragPos, viewDir, ubo.materialInfo);
     }
 
-    if (ubo.lightInfo.isSimpleLight != 0)
+    if (frameData.lightInfo.isSimpleLight != 0)
     {
-        for (uint i = 0; i < ubo.lightInfo.lightPointsNum; i++)
+        for (uint i = 0; i < frameData.lightInfo.lightPointsNum; i++)
         {
-            lightEffect += CalcSimplePointLight(ubo.pointLight[i], fragPos, ubo.materialInfo);
+            lightEffect += CalcSimplePointLight(frameData.pointLight[i], fragPos, ubo.materialInfo);
         }
     }
     else
     {
-        for (uint i = 0; i < ubo.lightInfo.lightPointsNum; i++)
+        for (uint i = 0; i < frameData.lightInfo.lightPointsNum; i++)
         {
-            lightEffect += CalcPointLight(ubo.pointLight[i], normal, fragPos, viewDir, ubo.materialInfo);
+            lightEffect += CalcPointLight(frameData.pointLight[i], normal, fragPos, viewDir, ubo.materialInfo);
         }
     }
 
-    //if ((ubo.lightInfo.lightFlags & LI_SpotLight) != 0)
-    //    lightEffect += CalcSpotLight(ubo.spotLight, normal, fragPos, viewDir, ubo.materialInfo);
+    //if ((frameData.lightInfo.lightFlags & LI_SpotLight) != 0)
+    //    lightEffect += CalcSpotLight(frameData.spotLight, normal, fragPos, viewDir, ubo.materialInfo);
 
     return lightEffect;
 }
\ No newline at end of file
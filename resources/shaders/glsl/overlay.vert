@@ -2,7 +2,7 @@
 #extension GL_ARB_separate_shader_objects : enable
 #include "overlay.glsl"
 
-layout (std140, set = 0, binding = 0) uniform UBO
+layout (std140, set = 1, binding = 0) uniform UBO
 {
     OverlayInfo overlayInfo;
     ivec4 imageSize;
@@ -0,0 +1,20 @@
+#version 450
+#extension GL_ARB_separate_shader_objects : enable
+#extension GL_EXT_nonuniform_qualifier : enable
+
+// global texture table, material textures are selected by pushed indices
+layout(set = 4, binding = 0) uniform sampler2D textures[];
+
+layout(push_constant) uniform TextureIndices
+{
+    uvec4 index;
+} textureIndices;
+
+layout(location = 0) in vec2 fragTexCoord;
+
+layout(location = 0) out vec4 outColor;
+
+void main()
+{
+    outColor = texture(textures[textureIndices.index.x], fragTexCoord);
+}
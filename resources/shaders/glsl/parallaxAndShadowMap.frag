@@ -1,20 +1,15 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
 #include "lighting.glsl"
+#include "passData.glsl"
 
-layout(set = 1, binding = 0) uniform sampler2D diffuseTex;
-layout(set = 1, binding = 1) uniform sampler2D normalTex;
-layout(set = 1, binding = 2) uniform sampler2D depthTex;
-layout(set = 1, binding = 3) uniform sampler2D directShadowTex;
-layout(set = 1, binding = 4) uniform UBO
+layout(set = 2, binding = 0) uniform sampler2D diffuseTex;
+layout(set = 2, binding = 1) uniform sampler2D normalTex;
+layout(set = 2, binding = 2) uniform sampler2D depthTex;
+layout(set = 2, binding = 3) uniform sampler2D directShadowTex;
+layout(set = 2, binding = 4) uniform UBO
 {
-	vec4 cameraPos;
     mat4 invModel;
-	DirLight dirLight;
-	SpotLight spotLight;
-    LineLight lineLight[15];
-    PointLight pointLight[20];
-	LightInfo lightInfo;
 	MaterialInfo materialInfo;
 } ubo;
 
@@ -90,7 +85,7 @@ void main()
 {
     mat3 tanToModel = mat3(fragTangent, fragBinormal, fragNormal);
     mat3 modelToTan = transpose(tanToModel);
-    vec3 viewDir = normalize(ubo.cameraPos.xyz - fragPos);
+    vec3 viewDir = normalize(passData.cameraPos.xyz - fragPos);
     vec3 tangentViewDir = normalize(modelToTan * viewDir);
     vec2 texCoord = steepParallaxMapping(fragTexCoord, tangentViewDir);
 
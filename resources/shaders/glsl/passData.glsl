@@ -0,0 +1,24 @@
+// Copyright (c) 2018-2019, Igor Barinov
+// Data shared by all draws in a pass, bound once per pass (requires lighting.glsl)
+
+layout(set = 0, binding = 0) uniform PassUBO
+{
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    mat4 lightDirectViewProjection;
+    vec4 cameraPos;
+    vec4 clipPlane;
+    float time;
+    float deltaTime;
+} passData;
+
+// Lights are the same in all passes, they are written once per frame
+layout(set = 0, binding = 1) uniform FrameUBO
+{
+    DirLight dirLight;
+    SpotLight spotLight;
+    LineLight lineLight[15];
+    PointLight pointLight[20];
+    LightInfo lightInfo;
+} frameData;
@@ -1,11 +1,11 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
+#include "lighting.glsl"
+#include "passData.glsl"
 
-layout (set = 0, binding = 0) uniform UBO
+layout (set = 1, binding = 0) uniform UBO
 {
 	mat4 model;
-	mat4 view;
-	mat4 projection;
 } matrices;
 
 layout (location = 0) in vec3 inPosition;
@@ -23,7 +23,7 @@ out gl_PerVertex {
 };
 
 void main() {
-    gl_Position = matrices.projection * matrices.view * matrices.model * vec4(inPosition, 1.0);
+    gl_Position = passData.viewProjection * matrices.model * vec4(inPosition, 1.0);
     fragColor = inColor;
     fragTexCoord = inTexCoord;
     fragPos = vec3(matrices.model * vec4(inPosition, 1.0));
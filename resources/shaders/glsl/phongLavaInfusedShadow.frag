@@ -1,18 +1,13 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
 #include "lighting.glsl"
+#include "passData.glsl"
 
-layout(set = 1, binding = 0) uniform sampler2D diffuseTex;
-layout(set = 1, binding = 1) uniform sampler2D noiseSampler;
-layout(set = 1, binding = 2) uniform sampler2D directShadowTex;
-layout(set = 1, binding = 3) uniform UBO
+layout(set = 2, binding = 0) uniform sampler2D diffuseTex;
+layout(set = 2, binding = 1) uniform sampler2D noiseSampler;
+layout(set = 2, binding = 2) uniform sampler2D directShadowTex;
+layout(set = 2, binding = 3) uniform UBO
 {
-	vec4 cameraPos;
-	DirLight dirLight;
-	SpotLight spotLight;
-    LineLight lineLight[15];
-    PointLight pointLight[20];
-	LightInfo lightInfo;
 	MaterialInfo materialInfo;
     float time;
 } ubo;
@@ -87,7 +82,7 @@ void main()
         outColorBloom = vec4(outColor.rgb * brightness * brightness, 0.3);
     } else {
         vec3 normal = normalize(fragNormal);
-        vec3 viewDir = normalize(ubo.cameraPos.xyz - fragPos);
+        vec3 viewDir = normalize(passData.cameraPos.xyz - fragPos);
 
         vec3 lightEffect = calculateLight(normal, viewDir);
 
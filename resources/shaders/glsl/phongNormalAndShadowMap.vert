@@ -1,12 +1,10 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
-layout (set = 0, binding = 0) uniform UBO
+#include "lighting.glsl"
+#include "passData.glsl"
+layout (set = 1, binding = 0) uniform UBO
 {
 	mat4 model;
-	mat4 view;
-	mat4 projection;
-	mat4 lightDirectViewProjection;
-	vec4 clipPlane;
 } uniforms;
 
 layout (location = 0) in vec3 inPosition;
@@ -31,10 +29,10 @@ out gl_PerVertex {
 
 void main() {
     vec4 worldPos = uniforms.model * vec4(inPosition, 1.0);
-    vec4 camPos = uniforms.view * worldPos;
+    vec4 camPos = passData.view * worldPos;
 
-    gl_Position = uniforms.projection * camPos;
-    gl_ClipDistance[0] = dot(worldPos, uniforms.clipPlane);
+    gl_Position = passData.projection * camPos;
+    gl_ClipDistance[0] = dot(worldPos, passData.clipPlane);
     fragColor = inColor;
     fragTexCoord = inTexCoord;
 
@@ -44,6 +42,6 @@ void main() {
     fragBinormal = vec3(invWMap * vec4(inBinormal.xyz, 1.0));
     fragTangent = vec3(invWMap * vec4(inTangent.xyz, 1.0));
 
-    fragDirectLightSpacePos =  uniforms.lightDirectViewProjection * worldPos;
+    fragDirectLightSpacePos =  passData.lightDirectViewProjection * worldPos;
     fragDirectLightSpacePos.xyzw = fragDirectLightSpacePos.xyzw / fragDirectLightSpacePos.w;
 }
\ No newline at end of file
@@ -1,15 +1,13 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
-layout (set = 0, binding = 0) uniform UBO
+#include "lighting.glsl"
+#include "passData.glsl"
+layout (set = 1, binding = 0) uniform UBO
 {
     mat4 model;
-    mat4 view;
-    mat4 projection;
-    mat4 lightDirectViewProjection;
-    vec4 clipPlane;
 } uniforms;
 
-layout(set = 0, binding = 1) buffer SSBO
+layout(set = 1, binding = 1) buffer SSBO
 {
     mat4 modelList[];
 } ssbo;
@@ -37,16 +35,16 @@ out gl_PerVertex
 void main()
 {
     vec4 worldPos = ssbo.modelList[gl_InstanceIndex] * vec4(inPosition, 1.0);
-    vec4 camPos = uniforms.view * worldPos;
+    vec4 camPos = passData.view * worldPos;
 
-    gl_Position = uniforms.projection * camPos;
-    gl_ClipDistance[0] = dot(worldPos, uniforms.clipPlane);
+    gl_Position = passData.projection * camPos;
+    gl_ClipDistance[0] = dot(worldPos, passData.clipPlane);
     fragColor = inColor;
     fragTexCoord = inTexCoord;
 
     fragPos = vec3(worldPos);
     fragNormal = vec3(transpose(inverse(ssbo.modelList[gl_InstanceIndex])) * vec4(inNormal.xyz, 1.0));
 
-    fragDirectLightSpacePos =  uniforms.lightDirectViewProjection * worldPos;
+    fragDirectLightSpacePos =  passData.lightDirectViewProjection * worldPos;
     fragDirectLightSpacePos.xyzw = fragDirectLightSpacePos.xyzw / fragDirectLightSpacePos.w;
 }
\ No newline at end of file
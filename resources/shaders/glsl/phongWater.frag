@@ -2,10 +2,10 @@
 #extension GL_ARB_separate_shader_objects : enable
 #include "lighting.glsl"
 
-layout(set = 1, binding = 0) uniform sampler2D reflectionSampler;
-layout(set = 1, binding = 1) uniform sampler2D refractionSampler;
-layout(set = 1, binding = 2) uniform sampler2D dudvSampler;
-layout(set = 1, binding = 3) uniform UBO
+layout(set = 2, binding = 0) uniform sampler2D reflectionSampler;
+layout(set = 2, binding = 1) uniform sampler2D refractionSampler;
+layout(set = 2, binding = 2) uniform sampler2D dudvSampler;
+layout(set = 2, binding = 3) uniform UBO
 {
     vec4 cameraPos;
     DirLight dirLight;
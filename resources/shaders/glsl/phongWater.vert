@@ -1,11 +1,11 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
+#include "lighting.glsl"
+#include "passData.glsl"
 
-layout (set = 0, binding = 0) uniform UBO
+layout (set = 1, binding = 0) uniform UBO
 {
 	mat4 model;
-	mat4 view;
-	mat4 projection;
 } uniforms;
 
 layout (location = 0) in vec3 inPosition;
@@ -25,7 +25,7 @@ out gl_PerVertex {
 
 void main() {
     vec4 worldPos = uniforms.model * vec4(inPosition, 1.0);
-    fragClipPosition = uniforms.projection * uniforms.view * worldPos;
+    fragClipPosition = passData.viewProjection * worldPos;
     gl_Position = fragClipPosition;
     fragColor = inColor;
     fragTexCoord = inTexCoord;
@@ -1,13 +1,13 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
-layout (set = 0, binding = 0) uniform UBO
+layout (set = 1, binding = 0) uniform UBO
 {
     mat4 model;
     mat4 view;
     mat4 projection;
 } uniforms;
 
-layout(set = 0, binding = 1) readonly buffer SSBO
+layout(set = 1, binding = 1) readonly buffer SSBO
 {
     mat4 modelList[];
 } ssbo;
@@ -1,10 +1,9 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
 
-layout (set = 0, binding = 0) uniform UBO
+layout (set = 1, binding = 0) uniform UBO
 {
 	mat4 model;
-	mat4 viewProjection;
 } matrices;
 
 layout (location = 0) in vec3 inPosition;
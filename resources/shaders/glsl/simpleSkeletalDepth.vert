@@ -2,10 +2,9 @@
 #extension GL_ARB_separate_shader_objects : enable
 
 #define MAX_BONES 64
-layout (set = 0, binding = 0) uniform UBO
+layout (set = 1, binding = 0) uniform UBO
 {
 	mat4 model;
-	mat4 viewProjection;
 	mat4 bones[MAX_BONES];
 } matrices;
 
@@ -1,14 +1,12 @@
 #version 450
 #extension GL_ARB_separate_shader_objects : enable
+#include "lighting.glsl"
+#include "passData.glsl"
 
 #define MAX_BONES 64
-layout (set = 0, binding = 0) uniform UBO
+layout (set = 1, binding = 0) uniform UBO
 {
 	mat4 model;
-	mat4 view;
-	mat4 projection;
-    mat4 lightDirectViewProjection;
-	vec4 clipPlane;
 	mat4 bones[MAX_BONES];
 } uniforms;
 
@@ -43,14 +41,14 @@ void main() {
 
     vec4 worldPos = uniforms.model * boneTransform * vec4(inPosition, 1.0);
 
-    gl_Position = uniforms.projection * uniforms.view * worldPos;
-    gl_ClipDistance[0] = dot(worldPos, uniforms.clipPlane);
+    gl_Position = passData.viewProjection * worldPos;
+    gl_ClipDistance[0] = dot(worldPos, passData.clipPlane);
 
     fragColor = inColor;
     fragTexCoord = inTexCoord;
     fragPos = vec3(worldPos);
     fragNormal = mat3(inverse(transpose(uniforms.model * boneTransform))) * inNormal;
 
-    fragDirectLightSpacePos =  uniforms.lightDirectViewProjection * worldPos;
+    fragDirectLightSpacePos =  passData.lightDirectViewProjection * worldPos;
     fragDirectLightSpacePos.xyzw = fragDirectLightSpacePos.xyzw / fragDirectLightSpacePos.w;
 }
\ No newline at end of file
@@ -2,7 +2,7 @@
 
 #extension GL_ARB_separate_shader_objects : enable
 
-layout(set = 1, binding = 0) uniform samplerCube samplerCubeMap;
+layout(set = 2, binding = 0) uniform samplerCube samplerCubeMap;
 
 layout(location = 0) in vec3 fragTexCoord;
 
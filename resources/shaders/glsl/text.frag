@@ -3,8 +3,8 @@
 precision highp float;
 #include "text.glsl"
 
-layout(set = 1, binding = 0) uniform sampler2D texSampler;
-layout(std140, set = 1, binding = 1) uniform UBO
+layout(set = 2, binding = 0) uniform sampler2D texSampler;
+layout(std140, set = 2, binding = 1) uniform UBO
 {
     TextInfo textInfo;
     TextSymbolInfo textSymbolInfo[100];
@@ -3,7 +3,7 @@
 precision highp float;
 #include "text.glsl"
 
-layout (std140, set = 0, binding = 0) uniform UBO
+layout (std140, set = 1, binding = 0) uniform UBO
 {
     mat4 model;
     mat4 viewProjection;
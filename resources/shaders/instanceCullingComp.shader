@@ -0,0 +1,9 @@
+{
+    "name": "instanceCullingComputeShader",
+    "filename": "glsl/instanceCulling.comp.spv",
+    "shaderType": "ComputeShader",
+    "vertexInfo": {
+        "vertexDataFlags": []
+    },
+    "uniformList": []
+}
@@ -0,0 +1,10 @@
+{
+    "name": "overlayBindlessFragmentShader",
+    "filename": "glsl/overlayBindless.frag.spv",
+    "shaderType": "FragmentShader",
+    "useBindlessTextures": true,
+    "bindlessFallback": "overlayFragmentShader",
+    "samplerNamesList": [
+        "texSampler"
+    ]
+}
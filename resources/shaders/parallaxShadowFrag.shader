@@ -9,13 +9,7 @@
         "directShadowTex"
     ],
     "uniformList": [
-        { "uniformType": "CameraPosition" },
         { "uniformType": "InverseModelMatrix" },
-        { "uniformType": "LightDirectional" },
-        { "uniformType": "LightSpot" },
-        { "uniformType": "LightLine" },
-        { "uniformType": "LightPointSimple" },
-        { "uniformType": "LightInfo" },
         { "uniformType": "MaterialInfo" }
     ]
 }
\ No newline at end of file
@@ -4,10 +4,6 @@
     "shaderType": "VertexShader",
     "uniformList": [
         { "uniformType": "ModelMatrix" },
-        { "uniformType": "ViewMatrix" },
-        { "uniformType": "ProjectionMatrix" },
-        { "uniformType": "LightDirectViewProjection" },
-        { "uniformType": "ClipPlane" },
         { "uniformType": "BoneMatrices" }
     ],
     "maxBonesSize": 64
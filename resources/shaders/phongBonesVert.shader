@@ -4,9 +4,6 @@
     "shaderType": "VertexShader",
     "uniformList": [
         { "uniformType": "ModelMatrix" },
-        { "uniformType": "ViewMatrix" },
-        { "uniformType": "ProjectionMatrix" },
-        { "uniformType": "ClipPlane" },
         { "uniformType": "BoneMatrices" }
     ],
     "maxBonesSize": 64
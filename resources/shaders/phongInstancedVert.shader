@@ -0,0 +1,19 @@
+{
+    "name": "phongInstancedVertexShader",
+    "filename": "glsl/phongInstanced.vert.spv",
+    "shaderType": "VertexShader",
+    "vertexInfo": {
+        "vertexDataFlags": [
+            "Position",
+            "Color",
+            "TexCoord",
+            "Normal"
+        ]
+    },
+    "uniformList": [
+        { "uniformType": "ModelMatrix" }
+    ],
+    "bufferList": [
+        "ModelMatrixList"
+    ]
+}
\ No newline at end of file
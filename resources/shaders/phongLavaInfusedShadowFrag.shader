@@ -8,12 +8,6 @@
         "directShadowTex"
     ],
     "uniformList": [
-        { "uniformType": "CameraPosition" },
-        { "uniformType": "LightDirectional" },
-        { "uniformType": "LightSpot" },
-        { "uniformType": "LightLine" },
-        { "uniformType": "LightPointSimple" },
-        { "uniformType": "LightInfo" },
         { "uniformType": "MaterialInfo" },
         { "uniformType": "Time" }
     ]
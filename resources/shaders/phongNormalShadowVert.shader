@@ -13,10 +13,6 @@
         ]
     },
     "uniformList": [
-        { "uniformType": "ModelMatrix" },
-        { "uniformType": "ViewMatrix" },
-        { "uniformType": "ProjectionMatrix" },
-        { "uniformType": "LightDirectViewProjection" },
-        { "uniformType": "ClipPlane" }
+        { "uniformType": "ModelMatrix" }
     ]
 }
\ No newline at end of file
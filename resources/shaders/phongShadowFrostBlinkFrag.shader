@@ -7,12 +7,6 @@
         "directShadowTex"
     ],
     "uniformList": [
-        { "uniformType": "CameraPosition" },
-        { "uniformType": "LightDirectional" },
-        { "uniformType": "LightSpot" },
-        { "uniformType": "LightLine" },
-        { "uniformType": "LightPointSimple" },
-        { "uniformType": "LightInfo" },
         { "uniformType": "MaterialInfo" },
         { "uniformType": "Time" }
     ]
@@ -11,11 +11,7 @@
         ]
     },
     "uniformList": [
-        { "uniformType": "ModelMatrix" },
-        { "uniformType": "ViewMatrix" },
-        { "uniformType": "ProjectionMatrix" },
-        { "uniformType": "LightDirectViewProjection" },
-        { "uniformType": "ClipPlane" }
+        { "uniformType": "ModelMatrix" }
     ],
     "bufferList": [
         "ModelMatrixList"
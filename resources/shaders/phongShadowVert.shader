@@ -2,6 +2,7 @@
     "name": "phongShadowVertexShader",
     "filename": "glsl/phongShadowMap.vert.spv",
     "shaderType": "VertexShader",
+    "instancedVariant": "phongShadowInstancedVertexShader",
     "vertexInfo": {
         "vertexDataFlags": [
             "Position",
@@ -11,10 +12,6 @@
         ]
     },
     "uniformList": [
-        { "uniformType": "ModelMatrix" },
-        { "uniformType": "ViewMatrix" },
-        { "uniformType": "ProjectionMatrix" },
-        { "uniformType": "LightDirectViewProjection" },
-        { "uniformType": "ClipPlane" }
+        { "uniformType": "ModelMatrix" }
     ]
 }
\ No newline at end of file
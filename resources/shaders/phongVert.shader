@@ -2,6 +2,7 @@
     "name": "phongVertexShader",
     "filename": "glsl/phong.vert.spv",
     "shaderType": "VertexShader",
+    "instancedVariant": "phongInstancedVertexShader",
     "vertexInfo": {
         "vertexDataFlags": [
             "Position",
@@ -11,8 +12,6 @@
         ]
     },
     "uniformList": [
-        { "uniformType": "ModelMatrix" },
-        { "uniformType": "ViewMatrix" },
-        { "uniformType": "ProjectionMatrix" }
+        { "uniformType": "ModelMatrix" }
     ]
 }
\ No newline at end of file
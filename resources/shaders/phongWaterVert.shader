@@ -11,8 +11,6 @@
         ]
     },
     "uniformList": [
-        { "uniformType": "ModelMatrix" },
-        { "uniformType": "ViewMatrix" },
-        { "uniformType": "ProjectionMatrix" }
+        { "uniformType": "ModelMatrix" }
     ]
 }
\ No newline at end of file
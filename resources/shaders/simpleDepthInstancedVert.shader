@@ -8,8 +8,7 @@
         ]
     },
     "uniformList": [
-        { "uniformType": "ModelMatrix" },
-        { "uniformType": "ViewProjectionMatrix" }
+        { "uniformType": "ModelMatrix" }
     ],
     "bufferList": [
         "ModelMatrixList"
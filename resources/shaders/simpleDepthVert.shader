@@ -2,13 +2,13 @@
     "name": "simpleDepthVertexShader",
     "filename": "glsl/simpleDepth.vert.spv",
     "shaderType": "VertexShader",
+    "instancedVariant": "simpleDepthInstancedVertexShader",
     "vertexInfo": {
         "vertexDataFlags": [
             "Position"
         ]
     },
     "uniformList": [
-        { "uniformType": "ModelMatrix" },
-        { "uniformType": "ViewProjectionMatrix" }
+        { "uniformType": "ModelMatrix" }
     ]
 }
\ No newline at end of file
@@ -4,7 +4,6 @@
     "shaderType": "VertexShader",
     "uniformList": [
         { "uniformType": "ModelMatrix" },
-        { "uniformType": "ViewProjectionMatrix" },
         { "uniformType": "BoneMatrices" }
     ],
     "maxBonesSize": 64
@@ -0,0 +1,212 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+
+// Measures bones update cost per animated character: assimp node tree walk (getAnimationTransforms)
+// against baked SkeletalAnimation, and scaling of animation phase with thread count.
+// Usage: AnimationBenchmark resources/models/*.mesh
+
+#include "SVE/VulkanException.h"
+#include "SVE/MeshBaker.h"
+#include "SVE/SkeletalAnimation.h"
+#include "SVE/AnimationUpdater.h"
+
+#include <rapidjson/document.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace
+{
+
+using Clock = std::chrono::high_resolution_clock;
+
+const uint32_t CharacterCount = 100;
+const uint32_t FrameCount = 600;
+const float FrameTime = 1.0f / 60.0f;
+const uint32_t ScalingCharacterCount = 500;
+const uint32_t ScalingFrameCount = 300;
+const uint32_t ScalingThreadCounts[] = { 1, 2, 4, 8 };
+
+// characters are desynchronized as in game, every one has its own time
+float getTime(uint32_t frame, uint32_t character)
+{
+    return frame * FrameTime + character * 0.37f;
+}
+
+float getMilliseconds(Clock::time_point startTime)
+{
+    return std::chrono::duration<float, std::chrono::milliseconds::period>(Clock::now() - startTime).count();
+}
+
+std::string readFile(const std::string& filename)
+{
+    std::ifstream file(filename, std::ios::in | std::ios::binary);
+    if (!file)
+        throw SVE::VulkanException("Can't open file " + filename);
+    return std::string(std::istreambuf_iterator<char>(file), {});
+}
+
+SVE::MeshSettings loadMesh(const std::string& filename)
+{
+    rapidjson::Document document;
+    document.Parse(readFile(filename).c_str());
+
+    auto directoryPos = filename.find_last_of("/\\");
+    auto directory = directoryPos == std::string::npos ? std::string() : filename.substr(0, directoryPos + 1);
+
+    SVE::MeshLoadSettings meshLoadSettings {};
+    meshLoadSettings.name = document["name"].GetString();
+    meshLoadSettings.filename = directory + document["filename"].GetString();
+    if (document.HasMember("switchYZ"))
+        meshLoadSettings.switchYZ = document["switchYZ"].GetBool();
+    if (document.HasMember("scale"))
+    {
+        const auto& scale = document["scale"].GetArray();
+        meshLoadSettings.scale = glm::vec3(scale[0].GetFloat(), scale[1].GetFloat(), scale[2].GetFloat());
+    }
+    if (document.HasMember("animationSpeed"))
+        meshLoadSettings.animationSpeed = document["animationSpeed"].GetFloat();
+
+    auto sourceContent = readFile(meshLoadSettings.filename);
+    std::ifstream bakedFile(SVE::getBakedMeshFilename(meshLoadSettings.filename), std::ios::in | std::ios::binary);
+    if (bakedFile)
+    {
+        auto bakedData = std::string(std::istreambuf_iterator<char>(bakedFile), {});
+        auto sourceHash = SVE::getMeshSourceHash(sourceContent.data(), sourceContent.size());
+        SVE::MeshSettings meshSettings;
+        if (SVE::loadBakedMesh(bakedData.data(), bakedData.size(), meshLoadSettings, sourceHash, meshSettings))
+            return meshSettings;
+    }
+
+    return SVE::importMesh(meshLoadSettings, sourceContent);
+}
+
+// FNV-1a of all palettes, so frames of different runs can be compared bit for bit
+uint64_t getPalettesHash(const std::vector<std::vector<glm::mat4>>& palettes)
+{
+    uint64_t hash = 14695981039346656037ull;
+    for (const auto& palette : palettes)
+    {
+        const auto* data = reinterpret_cast<const uint8_t*>(palette.data());
+        for (size_t i = 0; i < palette.size() * sizeof(glm::mat4); i++)
+            hash = (hash ^ data[i]) * 1099511628211ull;
+    }
+    return hash;
+}
+
+void benchmarkScaling(const SVE::SkeletalAnimation& skeletalAnimation)
+{
+    std::vector<uint64_t> referenceHashes;
+    float referenceTime = 0;
+    for (auto threadCount : ScalingThreadCounts)
+    {
+        SVE::AnimationUpdater animationUpdater(threadCount);
+        std::vector<SVE::AnimationInstance> instances(ScalingCharacterCount);
+        std::vector<std::vector<glm::mat4>> palettes(ScalingCharacterCount);
+        std::vector<uint64_t> hashes;
+
+        float updateTime = 0;
+        for (auto frame = 0u; frame < ScalingFrameCount; frame++)
+        {
+            animationUpdater.begin();
+            for (auto character = 0u; character < ScalingCharacterCount; character++)
+            {
+                auto clipTime = skeletalAnimation.getClipTime(0, getTime(frame, character));
+                animationUpdater.addEvaluation(&skeletalAnimation, 0, clipTime, &instances[character], &palettes[character]);
+            }
+
+            auto startTime = Clock::now();
+            animationUpdater.update();
+            updateTime += getMilliseconds(startTime);
+            hashes.push_back(getPalettesHash(palettes));
+        }
+
+        updateTime /= ScalingFrameCount;
+        if (referenceHashes.empty())
+        {
+            referenceHashes = hashes;
+            referenceTime = updateTime;
+        }
+        std::cout << "    " << ScalingCharacterCount << " characters, " << animationUpdater.getThreadCount()
+                  << " thread(s): " << updateTime << " ms per frame, speedup " << referenceTime / updateTime
+                  << (hashes == referenceHashes ? ", matches" : ", DOESN'T match") << " single thread result"
+                  << std::endl;
+    }
+}
+
+void benchmarkMesh(const std::string& filename)
+{
+    auto meshSettings = loadMesh(filename);
+    if (meshSettings.boneNum == 0 || !meshSettings.animation || meshSettings.animation->animationCount == 0)
+    {
+        std::cout << meshSettings.name << ": not animated" << std::endl;
+        return;
+    }
+
+    SVE::SkeletalAnimation skeletalAnimation(meshSettings);
+    std::vector<SVE::AnimationInstance> instances(CharacterCount);
+    std::vector<glm::mat4> bones;
+    std::vector<glm::mat4> referenceBones;
+    SVE::BonesAttachments attachments;
+
+    auto treeStartTime = Clock::now();
+    for (auto frame = 0u; frame < FrameCount; frame++)
+        for (auto character = 0u; character < CharacterCount; character++)
+            SVE::getAnimationTransforms(meshSettings, 0, getTime(frame, character), attachments, referenceBones);
+    auto treeTime = getMilliseconds(treeStartTime);
+
+    auto bakedStartTime = Clock::now();
+    for (auto frame = 0u; frame < FrameCount; frame++)
+        for (auto character = 0u; character < CharacterCount; character++)
+            skeletalAnimation.evaluate(0, getTime(frame, character), instances[character], attachments, bones);
+    auto bakedTime = getMilliseconds(bakedStartTime);
+
+    // results should match up to float precision (keys aren't extrapolated past the last one)
+    float maxDifference = 0.0f;
+    for (auto frame = 0u; frame < FrameCount; frame += 7)
+    {
+        auto time = getTime(frame, 0);
+        SVE::getAnimationTransforms(meshSettings, 0, time, attachments, referenceBones);
+        skeletalAnimation.evaluate(0, time, instances[0], attachments, bones);
+        for (auto bone = 0u; bone < bones.size(); bone++)
+            for (auto column = 0; column < 4; column++)
+                maxDifference = std::max(maxDifference, glm::length(bones[bone][column] - referenceBones[bone][column]));
+    }
+
+    auto evaluationCount = static_cast<float>(FrameCount * CharacterCount);
+    std::cout << meshSettings.name << ": " << meshSettings.boneNum << " bones, per character "
+              << treeTime * 1000.0f / evaluationCount << " us (node tree) -> "
+              << bakedTime * 1000.0f / evaluationCount << " us (baked), max difference " << maxDifference << std::endl;
+
+    benchmarkScaling(skeletalAnimation);
+}
+
+} // anon namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::cout << "Usage: AnimationBenchmark <file.mesh>..." << std::endl;
+        return 1;
+    }
+
+    auto result = 0;
+    for (auto i = 1; i < argc; i++)
+    {
+        try
+        {
+            benchmarkMesh(argv[i]);
+        }
+        catch (const std::exception& exception)
+        {
+            std::cout << "Can't benchmark " << argv[i] << ": " << exception.what() << std::endl;
+            result = 1;
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,113 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+
+// Offline mesh baker: imports source files of .mesh resources with assimp, optimizes them
+// and writes .smesh files next to source files. Usage: MeshBaker resources/models/*.mesh
+
+#include "SVE/VulkanException.h"
+#include "SVE/MeshBaker.h"
+#include "SVE/MeshOptimizer.h"
+
+#include <rapidjson/document.h>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+namespace
+{
+
+using Clock = std::chrono::high_resolution_clock;
+
+float getMilliseconds(Clock::time_point startTime)
+{
+    return std::chrono::duration<float, std::chrono::milliseconds::period>(Clock::now() - startTime).count();
+}
+
+std::string readFile(const std::string& filename)
+{
+    std::ifstream file(filename, std::ios::in | std::ios::binary);
+    if (!file)
+        throw SVE::VulkanException("Can't open file " + filename);
+    return std::string(std::istreambuf_iterator<char>(file), {});
+}
+
+SVE::MeshLoadSettings loadMeshDescription(const std::string& filename)
+{
+    rapidjson::Document document;
+    document.Parse(readFile(filename).c_str());
+
+    auto directoryPos = filename.find_last_of("/\\");
+    auto directory = directoryPos == std::string::npos ? std::string() : filename.substr(0, directoryPos + 1);
+
+    SVE::MeshLoadSettings meshLoadSettings {};
+    meshLoadSettings.name = document["name"].GetString();
+    meshLoadSettings.filename = directory + document["filename"].GetString();
+    if (document.HasMember("switchYZ"))
+        meshLoadSettings.switchYZ = document["switchYZ"].GetBool();
+    if (document.HasMember("scale"))
+    {
+        const auto& scale = document["scale"].GetArray();
+        meshLoadSettings.scale = glm::vec3(scale[0].GetFloat(), scale[1].GetFloat(), scale[2].GetFloat());
+    }
+
+    return meshLoadSettings;
+}
+
+void bakeMeshFile(const std::string& filename)
+{
+    auto meshLoadSettings = loadMeshDescription(filename);
+    auto sourceContent = readFile(meshLoadSettings.filename);
+
+    auto importStartTime = Clock::now();
+    auto meshSettings = SVE::importMesh(meshLoadSettings, sourceContent);
+    auto importTime = getMilliseconds(importStartTime);
+
+    auto stats = SVE::optimizeMesh(meshSettings);
+    meshSettings.isOptimized = true;
+    auto sourceHash = SVE::getMeshSourceHash(sourceContent.data(), sourceContent.size());
+    auto bakedData = SVE::bakeMesh(meshSettings, meshLoadSettings, sourceHash);
+
+    auto bakedFilename = SVE::getBakedMeshFilename(meshLoadSettings.filename);
+    std::ofstream bakedFile(bakedFilename, std::ios::out | std::ios::binary);
+    bakedFile.write(bakedData.data(), bakedData.size());
+    if (!bakedFile)
+        throw SVE::VulkanException("Can't write file " + bakedFilename);
+
+    auto loadStartTime = Clock::now();
+    SVE::MeshSettings bakedSettings;
+    SVE::loadBakedMesh(bakedData.data(), bakedData.size(), meshLoadSettings, sourceHash, bakedSettings);
+    auto loadTime = getMilliseconds(loadStartTime);
+
+    std::cout << meshLoadSettings.name << ": " << bakedFilename << " (" << bakedData.size() / 1024 << " KB, "
+              << stats.vertexCount << " vertices, ACMR " << stats.originalAcmr << " -> " << stats.acmr << "), "
+              << "import " << importTime << " ms, baked load " << loadTime << " ms" << std::endl;
+}
+
+} // anon namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        std::cout << "Usage: MeshBaker <file.mesh>..." << std::endl;
+        return 1;
+    }
+
+    auto result = 0;
+    for (auto i = 1; i < argc; i++)
+    {
+        try
+        {
+            bakeMeshFile(argv[i]);
+        }
+        catch (const std::exception& exception)
+        {
+            std::cout << "Can't bake " << argv[i] << ": " << exception.what() << std::endl;
+            result = 1;
+        }
+    }
+
+    return result;
+}
@@ -0,0 +1,404 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+
+// Renders test scenes and game levels in hidden window, for measurements and checks which need full engine.
+// Returns non-zero exit code if check fails.
+// Usage:
+//   SceneRunner allocations [entityCount] - prints heap allocations per frame in scene of mesh entities, fails
+//                                           only if allocations aren't counted (build with SVE_COUNT_ALLOCATIONS).
+//                                           Not run yet, there are no reference numbers for uniforms update
+//   SceneRunner instancing [entityCount]  - draw calls and frame CPU time in scene of static mesh entities with
+//                                           instance batching off and on, fails if batching doesn't reduce
+//                                           draw calls or instances don't fit into transform buffer
+//   SceneRunner gpu-culling [entityCount] - static mesh entities seen from several directions with GPU culling,
+//                                           fails if instances drawn by indirect commands differ from CPU
+//                                           culling or batches sharing material aren't drawn by one multi draw
+//                                           call (if multiDrawIndirect is supported). Not run on a device yet,
+//                                           there are no recorded results
+//   SceneRunner soak [levelCount]         - plays game levels one after another, fails if material instances,
+//                                           descriptor pools, geometry or VMA usage after level end grow
+//                                           above the first round of levels
+
+#include "SVE/Engine.h"
+#include "SVE/SceneManager.h"
+#include "SVE/CameraNode.h"
+#include "SVE/MeshEntity.h"
+#include "SVE/ResourceManager.h"
+#include "SVE/FrameStats.h"
+#include "SVE/FrameBenchmark.h"
+#include "SVE/RenderList.h"
+#include "SVE/VulkanInstance.h"
+#include "SVE/AllocationCounter.h"
+#include "SVE/VulkanException.h"
+#include "Game/Game.h"
+#include "Game/Level/GameUtils.h"
+#include "Game/Level/GameMap.h"
+#include "Game/Level/GameMapLoader.h"
+#include "DesktopFS.h"
+
+#include <SDL2/SDL.h>
+#include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+const float FrameTime = 1.0f / 60.0f;
+const uint32_t DefaultEntityCount = 500;
+const uint32_t DefaultInstancingEntityCount = 2000;
+const bool InstanceBatchingSteps[] = { false, true };
+// camera looks along the ground from the grid center, so entities behind it are culled
+const glm::vec3 GpuCullingViewTargets[] = { { 1, 2, 0 }, { 0, 2, 1 }, { -1, 2, 0 }, { 0, 2, -1 } };
+const uint32_t DefaultSoakLevelCount = 50;
+const uint32_t GameLevelCount = 8;
+const uint32_t SoakLevelFrames = 600;
+
+struct SceneEntityInfo
+{
+    const char* meshName;
+    const char* materialName;
+};
+
+// the most common level objects and enemies
+const std::vector<SceneEntityInfo> LevelEntities = {
+        { "tomb", "TombMaterial" },
+        { "pot", "PotMaterial" },
+        { "coin", "CoinMaterial" },
+        { "nun", "NunMaterial" },
+        { "knight", "KnightMaterial" },
+};
+
+// static level objects, entities of the same kind can be batched
+const std::vector<SceneEntityInfo> StaticEntities = {
+        { "tomb", "TombMaterial" },
+        { "pot", "PotMaterial" },
+        { "coin", "CoinMaterial" },
+};
+
+// batches of tomb and pot share material, so they are culled separately and drawn together
+const std::vector<SceneEntityInfo> GpuCullingEntities = {
+        { "tomb", "TombMaterial" },
+        { "pot", "TombMaterial" },
+        { "coin", "CoinMaterial" },
+};
+
+SVE::Engine* initEngine(SDL_Window* window, const std::string& mode)
+{
+    auto fileSystem = std::make_shared<SVE::DesktopFS>();
+    auto settings = SVE::Engine::loadSettings("resources/main.engine", fileSystem);
+    if (mode == "gpu-culling")
+    {
+        // culling results of the previous use of frame image are compared with CPU culling every frame
+        settings.useGpuCulling = true;
+        settings.validateGpuCulling = true;
+    }
+
+    auto* engine = SVE::Engine::createInstance(window, settings, fileSystem);
+    engine->getSceneManager()->createMainCamera();
+    for (auto* folder : { "resources/shaders",
+                          "resources/materials",
+                          "resources/materials/skins",
+                          "resources/models",
+                          "resources/fonts",
+                          "resources" })
+    {
+        engine->getResourceManager()->loadFolder(folder);
+    }
+
+    Chewman::Game::getInstance();
+    Chewman::setSunLight(Chewman::SunLightType::Day);
+    engine->getSceneManager()->setSkybox("Skybox4");
+
+    return engine;
+}
+
+// Grid of entities in front of camera, entities of the same kind have different animation time
+void createScene(SVE::Engine* engine, uint32_t entityCount, const std::vector<SceneEntityInfo>& sceneEntities)
+{
+    auto* sceneManager = engine->getSceneManager();
+    auto gridSize = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(entityCount))));
+    auto halfSize = static_cast<float>(gridSize);
+
+    auto camera = sceneManager->getMainCamera();
+    camera->setNearFarPlane(0.1f, 400.0f);
+    camera->setLookAt(glm::vec3(0.0f, halfSize * 1.5f, halfSize * 1.5f), glm::vec3(0), glm::vec3(0, 1, 0));
+
+    for (auto i = 0u; i < entityCount; i++)
+    {
+        const auto& entityInfo = sceneEntities[i % sceneEntities.size()];
+        auto position = glm::vec3((i % gridSize) * 2.0f - halfSize, 0.0f, (i / gridSize) * 2.0f - halfSize);
+
+        auto node = sceneManager->createSceneNode();
+        node->setNodeTransformation(glm::translate(glm::mat4(1), position));
+        auto entity = std::make_shared<SVE::MeshEntity>(entityInfo.meshName);
+        entity->setMaterial(entityInfo.materialName);
+        entity->resetTime(i * 0.37f);
+        node->attachEntity(entity);
+        sceneManager->getRootNode()->attachSceneNode(node);
+    }
+}
+
+uint32_t getDrawCount(const SVE::FrameStats& frameStats)
+{
+    uint32_t drawCount = 0;
+    for (auto count : frameStats.drawCount)
+        drawCount += count;
+    return drawCount;
+}
+
+void renderBenchmark(SVE::Engine* engine, SVE::FrameBenchmark& frameBenchmark)
+{
+    while (!frameBenchmark.isFinished())
+    {
+        // window is hidden, events are only drained
+        SDL_Event event;
+        while (SDL_PollEvent(&event))
+            continue;
+
+        engine->renderFrame(FrameTime);
+        frameBenchmark.update(engine->getFrameStats());
+    }
+}
+
+bool runAllocations(SVE::Engine* engine, uint32_t entityCount)
+{
+    createScene(engine, entityCount, LevelEntities);
+
+    SVE::FrameBenchmark frameBenchmark(1, nullptr, [&](uint32_t /*step*/, const SVE::FrameStats& sum, uint32_t frameCount)
+    {
+        std::cout << "Allocations: " << entityCount << " entities, " << getDrawCount(sum) / frameCount
+                  << " draw calls, per frame " << static_cast<float>(sum.heapAllocations) / frameCount
+                  << " heap allocations, " << static_cast<float>(sum.uniformUpdateAllocations) / frameCount
+                  << " in uniforms update, frame CPU time " << sum.cpuTime / frameCount << " ms" << std::endl;
+    });
+    renderBenchmark(engine, frameBenchmark);
+
+    if (SVE::getAllocationCount() == 0)
+    {
+        std::cout << "Allocations aren't counted, build with SVE_COUNT_ALLOCATIONS" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool runInstancing(SVE::Engine* engine, uint32_t entityCount)
+{
+    createScene(engine, entityCount, StaticEntities);
+
+    const auto stepCount = static_cast<uint32_t>(sizeof(InstanceBatchingSteps) / sizeof(InstanceBatchingSteps[0]));
+    std::vector<float> drawCounts(stepCount);
+    std::vector<float> cpuTimes(stepCount);
+    auto isPassed = true;
+    SVE::FrameBenchmark frameBenchmark(stepCount, [&](uint32_t step)
+    {
+        engine->getRenderList()->setInstanceBatching(step < stepCount ? InstanceBatchingSteps[step] : true);
+    }, [&](uint32_t step, const SVE::FrameStats& sum, uint32_t frameCount)
+    {
+        drawCounts[step] = static_cast<float>(getDrawCount(sum)) / frameCount;
+        cpuTimes[step] = sum.cpuTime / frameCount;
+        std::cout << "Instancing: batching " << (InstanceBatchingSteps[step] ? "on" : "off") << ", " << entityCount
+                  << " entities, " << sum.instancedEntityCount / frameCount << " instanced in "
+                  << sum.instanceBatchCount / frameCount << " batches, " << drawCounts[step]
+                  << " draw calls, frame CPU time " << cpuTimes[step] << " ms" << std::endl;
+        if (sum.skippedInstanceCount > 0)
+        {
+            std::cout << "Instancing: " << sum.skippedInstanceCount / frameCount
+                      << " instances per frame don't fit into transform buffer" << std::endl;
+            isPassed = false;
+        }
+    });
+    renderBenchmark(engine, frameBenchmark);
+
+    std::cout << "Instancing: draw calls " << drawCounts.front() << " -> " << drawCounts.back()
+              << ", frame CPU time " << cpuTimes.front() << " -> " << cpuTimes.back() << " ms" << std::endl;
+    return isPassed && drawCounts.back() < drawCounts.front();
+}
+
+bool runGpuCulling(SVE::Engine* engine, uint32_t entityCount)
+{
+    createScene(engine, entityCount, GpuCullingEntities);
+
+    auto camera = engine->getSceneManager()->getMainCamera();
+    const auto stepCount = static_cast<uint32_t>(sizeof(GpuCullingViewTargets) / sizeof(GpuCullingViewTargets[0]));
+    auto isMultiDrawSupported = engine->getVulkanInstance()->isMultiDrawIndirectSupported();
+    auto isPassed = true;
+    SVE::FrameBenchmark frameBenchmark(stepCount, [&](uint32_t step)
+    {
+        if (step < stepCount)
+            camera->setLookAt(glm::vec3(0, 2, 0), GpuCullingViewTargets[step], glm::vec3(0, 1, 0));
+    }, [&](uint32_t step, const SVE::FrameStats& sum, uint32_t frameCount)
+    {
+        auto culledCount = sum.culledDrawCount[static_cast<uint32_t>(SVE::CommandsType::MainPass)] / frameCount;
+        std::cout << "GPU culling: view " << step << ", " << entityCount << " entities, " << culledCount
+                  << " culled on CPU, " << sum.gpuCulledBatchCount / frameCount << " batches culled on GPU, drawn by "
+                  << sum.gpuCulledBucketCount / frameCount << " indirect calls per pass, "
+                  << sum.gpuCullingValidatedBatches << " batches validated, " << sum.gpuCullingMismatches
+                  << " mismatches" << std::endl;
+
+        if (sum.gpuCullingValidatedBatches == 0 || culledCount == 0)
+        {
+            std::cout << "GPU culling: view doesn't check culling (no validated batches or culled entities)" << std::endl;
+            isPassed = false;
+        }
+        if (sum.gpuCullingMismatches > 0)
+            isPassed = false;
+        if (isMultiDrawSupported && sum.gpuCulledBucketCount >= sum.gpuCulledBatchCount)
+        {
+            std::cout << "GPU culling: batches sharing material aren't drawn together" << std::endl;
+            isPassed = false;
+        }
+    });
+    renderBenchmark(engine, frameBenchmark);
+
+    if (!isMultiDrawSupported)
+        std::cout << "GPU culling: multiDrawIndirect isn't supported, batches are drawn one by one" << std::endl;
+    return isPassed;
+}
+
+void printResourceUsage(const std::string& title, const SVE::ResourceUsage& resourceUsage)
+{
+    std::cout << title << ": " << resourceUsage.materialInstances << " material instances, "
+              << resourceUsage.descriptorPools << " descriptor pools, " << resourceUsage.geometrySlots << " meshes in "
+              << resourceUsage.geometryBlocks << " geometry blocks, " << resourceUsage.vmaAllocations
+              << " VMA allocations (" << resourceUsage.vmaUsedBytes << " bytes)" << std::endl;
+}
+
+bool isResourceUsageGrown(const SVE::ResourceUsage& resourceUsage, const SVE::ResourceUsage& maxUsage)
+{
+    return resourceUsage.materialInstances > maxUsage.materialInstances
+           || resourceUsage.descriptorPools > maxUsage.descriptorPools
+           || resourceUsage.geometrySlots > maxUsage.geometrySlots
+           || resourceUsage.geometryBlocks > maxUsage.geometryBlocks
+           || resourceUsage.vmaAllocations > maxUsage.vmaAllocations
+           || resourceUsage.vmaUsedBytes > maxUsage.vmaUsedBytes;
+}
+
+void updateMaxUsage(const SVE::ResourceUsage& resourceUsage, SVE::ResourceUsage& maxUsage)
+{
+    maxUsage.materialInstances = std::max(maxUsage.materialInstances, resourceUsage.materialInstances);
+    maxUsage.descriptorPools = std::max(maxUsage.descriptorPools, resourceUsage.descriptorPools);
+    maxUsage.geometrySlots = std::max(maxUsage.geometrySlots, resourceUsage.geometrySlots);
+    maxUsage.geometryBlocks = std::max(maxUsage.geometryBlocks, resourceUsage.geometryBlocks);
+    maxUsage.vmaAllocations = std::max(maxUsage.vmaAllocations, resourceUsage.vmaAllocations);
+    maxUsage.vmaUsedBytes = std::max(maxUsage.vmaUsedBytes, resourceUsage.vmaUsedBytes);
+}
+
+// Levels are played without input, so enemies, fireballs, coins and effects are created and destroyed as in game.
+// The first round of levels may grow pools to the biggest level size, later levels should fit into them.
+bool runSoak(SVE::Engine* engine, uint32_t levelCount)
+{
+    auto* game = Chewman::Game::getInstance();
+    auto& progressManager = game->getProgressManager();
+
+    SVE::ResourceUsage maxUsage {};
+    auto isPassed = true;
+    for (auto level = 0u; level < levelCount; level++)
+    {
+        auto levelNum = level % GameLevelCount + 1;
+        progressManager.setCurrentLevel(levelNum);
+        {
+            auto gameMap = game->getGameMapLoader().loadMap("resources/game/levels/level" + std::to_string(levelNum) + ".map");
+            auto gameMapProcessor = std::make_unique<Chewman::GameMapProcessor>(std::move(gameMap));
+            progressManager.setGameMapService(gameMapProcessor.get());
+            for (auto frame = 0u; frame < SoakLevelFrames; frame++)
+            {
+                SDL_Event event;
+                while (SDL_PollEvent(&event))
+                    continue;
+
+                gameMapProcessor->update(FrameTime);
+                engine->renderFrame(FrameTime);
+            }
+            progressManager.setGameMapService(nullptr);
+        }
+
+        // level resources are released by game map processor destruction
+        auto resourceUsage = engine->getResourceUsage();
+        printResourceUsage("Level " + std::to_string(level + 1) + " (level" + std::to_string(levelNum) + ".map)",
+                           resourceUsage);
+        if (level < GameLevelCount)
+        {
+            updateMaxUsage(resourceUsage, maxUsage);
+        }
+        else if (isResourceUsageGrown(resourceUsage, maxUsage))
+        {
+            printResourceUsage("Resources grew above the first round of levels", maxUsage);
+            isPassed = false;
+        }
+    }
+
+    return isPassed;
+}
+
+void printUsage()
+{
+    std::cout << "Usage: SceneRunner allocations [entityCount]" << std::endl;
+    std::cout << "       SceneRunner instancing [entityCount]" << std::endl;
+    std::cout << "       SceneRunner gpu-culling [entityCount]" << std::endl;
+    std::cout << "       SceneRunner soak [levelCount]" << std::endl;
+}
+
+} // anon namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2)
+    {
+        printUsage();
+        return 1;
+    }
+
+    std::string mode = argv[1];
+    auto getArgument = [argc, argv](int index, uint32_t defaultValue)
+    {
+        return argc > index ? static_cast<uint32_t>(std::stoul(argv[index])) : defaultValue;
+    };
+
+    SDL_Init(SDL_INIT_VIDEO | SDL_INIT_EVENTS);
+    auto* window = SDL_CreateWindow("SceneRunner", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, 1280, 720,
+                                    SDL_WINDOW_HIDDEN | SDL_WINDOW_VULKAN);
+    if (!window)
+    {
+        std::cout << "Could not create window: " << SDL_GetError() << std::endl;
+        return 1;
+    }
+
+    auto isPassed = false;
+    try
+    {
+        auto* engine = initEngine(window, mode);
+        if (mode == "allocations")
+        {
+            isPassed = runAllocations(engine, getArgument(2, DefaultEntityCount));
+        } else if (mode == "instancing")
+        {
+            isPassed = runInstancing(engine, getArgument(2, DefaultInstancingEntityCount));
+        } else if (mode == "gpu-culling")
+        {
+            isPassed = runGpuCulling(engine, getArgument(2, DefaultInstancingEntityCount));
+        } else if (mode == "soak")
+        {
+            isPassed = runSoak(engine, getArgument(2, DefaultSoakLevelCount));
+        } else
+        {
+            printUsage();
+        }
+        engine->finishRendering();
+    }
+    catch (const std::exception& exception)
+    {
+        std::cout << "SceneRunner failed: " << exception.what() << std::endl;
+        isPassed = false;
+    }
+
+    SVE::Engine::destroyInstance();
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+
+    return isPassed ? 0 : 1;
+}
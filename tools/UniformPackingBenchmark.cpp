@@ -0,0 +1,93 @@
+// VSE (Vulkan Simple Engine) Library
+// Copyright (c) 2018-2019, Igor Barinov
+// Licensed under the MIT License
+
+// Measures packing of shader uniforms: per-uniform temporary copies (getUniformDataByType, as materials used to
+// pack uniforms) against writes through precomputed shader layout (computeUniformLayout + writeUniformData).
+// Usage: UniformPackingBenchmark [file.shader] [iterations]
+
+#include "SVE/ResourceManager.h"
+#include "SVE/ShaderSettings.h"
+#include "SVE/VulkanException.h"
+#include "DesktopFS.h"
+
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+namespace
+{
+
+using Clock = std::chrono::high_resolution_clock;
+
+const char* DefaultShaderFile = "resources/shaders/phongShadowInstancedVert.shader";
+const uint32_t DefaultIterations = 1000000;
+
+SVE::ShaderSettings loadShader(const std::string& filename)
+{
+    auto loadData = SVE::ResourceManager::getLoadDataFromFolder(filename, false, std::make_shared<SVE::DesktopFS>());
+    if (loadData.shaderList.empty())
+        throw SVE::VulkanException("Can't load shader " + filename);
+    return loadData.shaderList.front();
+}
+
+void runBenchmark(const SVE::ShaderSettings& shaderSettings, uint32_t iterations)
+{
+    std::vector<SVE::UniformLayoutEntry> uniformLayout;
+    auto uniformsSize = SVE::computeUniformLayout(shaderSettings, uniformLayout);
+
+    SVE::UniformData uniformData {};
+    uniformData.lightDirectViewProjectionList.resize(1);
+    std::vector<char> uniformBuffer(uniformsSize);
+    volatile char checksum = 0;
+
+    auto measure = [&](auto pack)
+    {
+        auto startTime = Clock::now();
+        for (auto i = 0u; i < iterations; i++)
+        {
+            uniformData.time = static_cast<float>(i);
+            pack();
+            checksum = checksum + uniformBuffer.back();
+        }
+        return std::chrono::duration<float, std::chrono::milliseconds::period>(Clock::now() - startTime).count();
+    };
+
+    auto copiesTime = measure([&]()
+    {
+        char* data = uniformBuffer.data();
+        for (const auto& info : shaderSettings.uniformList)
+        {
+            auto uniformBytes = SVE::getUniformDataByType(uniformData, info.uniformType);
+            memcpy(data, uniformBytes.data(), uniformBytes.size());
+            data += uniformBytes.size();
+        }
+    });
+    auto layoutTime = measure([&]()
+    {
+        for (const auto& entry : uniformLayout)
+            SVE::writeUniformData(uniformData, nullptr, entry.uniformType, uniformBuffer.data() + entry.offset, entry.size);
+    });
+
+    std::cout << shaderSettings.name << ": " << uniformLayout.size() << " uniforms, " << uniformsSize << " bytes, "
+              << iterations << " iterations: temporary copies " << copiesTime << " ms, precomputed layout "
+              << layoutTime << " ms" << std::endl;
+}
+
+} // anon namespace
+
+int main(int argc, char* argv[])
+{
+    try
+    {
+        auto shaderSettings = loadShader(argc > 1 ? argv[1] : DefaultShaderFile);
+        runBenchmark(shaderSettings, argc > 2 ? static_cast<uint32_t>(std::stoul(argv[2])) : DefaultIterations);
+    }
+    catch (const std::exception& exception)
+    {
+        std::cout << "Can't run benchmark: " << exception.what() << std::endl;
+        return 1;
+    }
+
+    return 0;
+}